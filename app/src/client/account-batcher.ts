@@ -0,0 +1,247 @@
+import { AccountInfo, Commitment, Connection, PublicKey } from '@solana/web3.js';
+
+/** Ausschnitt der Account-Daten (`dataSlice` von `getMultipleAccounts`) */
+export interface AccountSlice {
+  offset: number;
+  length: number;
+}
+
+/** Einstellungen des Account-Batchers */
+export interface AccountBatcherConfig {
+  /** Zeitfenster, in dem gleichzeitige Abfragen gesammelt werden (ms) */
+  windowMs: number;
+  /** Höchstens so viele Accounts pro `getMultipleAccounts` (RPC-Grenze: 100) */
+  maxBatchSize: number;
+  /** Gültigkeit eines Cache-Eintrags, ungefähr ein Slot (ms) */
+  slotTtlMs: number;
+  /** Commitment der Abfragen */
+  commitment: Commitment;
+}
+
+export const DEFAULT_ACCOUNT_BATCHER_CONFIG: AccountBatcherConfig = {
+  windowMs: 5,
+  maxBatchSize: 100,
+  slotTtlMs: 400,
+  commitment: 'confirmed'
+};
+
+/**
+ * Heiße Felder des Transfer-States: das erste 8-Byte-Wort nach dem
+ * Anchor-Discriminator (`current_hop`, `batch_count`, `completed`,
+ * `refund_triggered`, `bump`, `recipient_count`, `version`, `fake_mode`)
+ */
+export const TRANSFER_STATE_STATUS_SLICE: AccountSlice = { offset: 8, length: 8 };
+
+/** Nur die Lamports eines Accounts, ohne Daten */
+const BALANCE_SLICE: AccountSlice = { offset: 0, length: 0 };
+
+/** Fortschritt aus den heißen Feldern des Transfer-States */
+export interface TransferStatus {
+  currentHop: number;
+  batchCount: number;
+  completed: boolean;
+  refundTriggered: boolean;
+  version: number;
+  /** Fake-Splits nur als Commitments (`FAKE_MODE_COMMITTED`) */
+  committedFakes: boolean;
+}
+
+/** Dekodiert `TRANSFER_STATE_STATUS_SLICE` (Offsets wie im `repr(C)`-Layout) */
+export function decodeTransferStatus(data: Buffer): TransferStatus {
+  return {
+    currentHop: data[0],
+    batchCount: data[1],
+    completed: data[2] !== 0,
+    refundTriggered: data[3] !== 0,
+    version: data[6],
+    committedFakes: data[7] === 1
+  };
+}
+
+interface CacheEntry {
+  info: AccountInfo<Buffer> | null;
+  slot: number;
+  fetchedAt: number;
+}
+
+interface PendingRead {
+  resolve: (info: AccountInfo<Buffer> | null) => void;
+  reject: (error: unknown) => void;
+}
+
+/** Offene Abfragen eines Ausschnitts, je Account alle Wartenden */
+interface PendingBatch {
+  slice?: AccountSlice;
+  reads: Map<string, { pubkey: PublicKey; waiters: PendingRead[] }>;
+}
+
+/** Ab dieser Größe werden abgelaufene Cache-Einträge beim nächsten Abruf entfernt */
+const MAX_CACHE_ENTRIES = 4096;
+
+/** Gemeinsame Batcher pro RPC-Endpunkt (Connections ohne Endpunkt, z.B. Mocks, pro Objekt) */
+const sharedBatchers = new Map<string, AccountBatcher>();
+const sharedBatchersByConnection = new WeakMap<Connection, AccountBatcher>();
+
+function sliceKey(slice?: AccountSlice): string {
+  return slice ? `${slice.offset}:${slice.length}` : '*';
+}
+
+/**
+ * Gebündelter Account-Zugriff
+ *
+ * Alle Abfragen, die innerhalb von `windowMs` eingehen, werden je
+ * Datenausschnitt zu `getMultipleAccounts`-Aufrufen zusammengefasst;
+ * gleichzeitige Abfragen desselben Accounts teilen sich einen Eintrag.
+ * Ergebnisse werden mit ihrem Slot zwischengespeichert und gelten, bis eine
+ * Antwort einen neueren Slot meldet oder `slotTtlMs` verstrichen ist.
+ * Nach eigenen Schreibzugriffen verwirft `invalidate` die Einträge.
+ */
+export class AccountBatcher {
+  private readonly connection: Connection;
+  private readonly config: AccountBatcherConfig;
+  private readonly cache = new Map<string, CacheEntry>();
+  private pending = new Map<string, PendingBatch>();
+  private timer: NodeJS.Timeout | null = null;
+  /** Neuester Slot aus einer Antwort */
+  private latestSlot = 0;
+  private rpcCalls = 0;
+
+  constructor(connection: Connection, config: Partial<AccountBatcherConfig> = {}) {
+    this.connection = connection;
+    this.config = { ...DEFAULT_ACCOUNT_BATCHER_CONFIG, ...config };
+  }
+
+  /** Gemeinsame Instanz für den RPC-Endpunkt der Connection */
+  static forConnection(connection: Connection): AccountBatcher {
+    const key = connection.rpcEndpoint;
+    let batcher = key ? sharedBatchers.get(key) : sharedBatchersByConnection.get(connection);
+    if (!batcher) {
+      batcher = new AccountBatcher(connection);
+      if (key) {
+        sharedBatchers.set(key, batcher);
+      } else {
+        sharedBatchersByConnection.set(connection, batcher);
+      }
+    }
+    return batcher;
+  }
+
+  /** Anzahl bisheriger `getMultipleAccounts`-Aufrufe */
+  get rpcCallCount(): number {
+    return this.rpcCalls;
+  }
+
+  /**
+   * Account-Info, optional nur ein Ausschnitt der Daten. Fehlende Accounts
+   * ergeben `null`.
+   */
+  getAccountInfo(pubkey: PublicKey, slice?: AccountSlice): Promise<AccountInfo<Buffer> | null> {
+    const address = pubkey.toBase58();
+    const group = sliceKey(slice);
+    const cached = this.cache.get(`${group}/${address}`);
+    if (cached && this.isFresh(cached)) {
+      return Promise.resolve(cached.info);
+    }
+
+    return new Promise((resolve, reject) => {
+      let batch = this.pending.get(group);
+      if (!batch) {
+        batch = { slice, reads: new Map() };
+        this.pending.set(group, batch);
+      }
+      let read = batch.reads.get(address);
+      if (!read) {
+        read = { pubkey, waiters: [] };
+        batch.reads.set(address, read);
+      }
+      read.waiters.push({ resolve, reject });
+      this.armTimer();
+    });
+  }
+
+  /** Mehrere Accounts desselben Ausschnitts, in Eingabereihenfolge */
+  getMultipleAccountsInfo(pubkeys: PublicKey[], slice?: AccountSlice): Promise<(AccountInfo<Buffer> | null)[]> {
+    return Promise.all(pubkeys.map(pubkey => this.getAccountInfo(pubkey, slice)));
+  }
+
+  /** Lamports eines Accounts (0, wenn er nicht existiert), ohne Daten zu laden */
+  async getBalance(pubkey: PublicKey): Promise<number> {
+    const info = await this.getAccountInfo(pubkey, BALANCE_SLICE);
+    return info?.lamports ?? 0;
+  }
+
+  /** Fortschritt eines Transfer-States aus den heißen Feldern oder `null`, wenn er nicht existiert */
+  async getTransferStatus(transferState: PublicKey): Promise<TransferStatus | null> {
+    const info = await this.getAccountInfo(transferState, TRANSFER_STATE_STATUS_SLICE);
+    if (!info || info.data.length < TRANSFER_STATE_STATUS_SLICE.length) {
+      return null;
+    }
+    return decodeTransferStatus(info.data);
+  }
+
+  /** Verwirft die Cache-Einträge der Accounts (alle Ausschnitte), etwa nach einem Schreibzugriff */
+  invalidate(pubkeys: PublicKey[]): void {
+    const addresses = new Set(pubkeys.map(pubkey => pubkey.toBase58()));
+    for (const key of [...this.cache.keys()]) {
+      if (addresses.has(key.slice(key.indexOf('/') + 1))) {
+        this.cache.delete(key);
+      }
+    }
+  }
+
+  private isFresh(entry: CacheEntry): boolean {
+    return entry.slot >= this.latestSlot && Date.now() - entry.fetchedAt < this.config.slotTtlMs;
+  }
+
+  private armTimer(): void {
+    if (this.timer) return;
+    this.timer = setTimeout(() => {
+      this.timer = null;
+      void this.flush();
+    }, this.config.windowMs);
+  }
+
+  /** Sendet alle gesammelten Abfragen, je Ausschnitt in Blöcken von `maxBatchSize` */
+  private async flush(): Promise<void> {
+    const batches = this.pending;
+    this.pending = new Map();
+    if (this.cache.size > MAX_CACHE_ENTRIES) {
+      for (const [key, entry] of this.cache) {
+        if (!this.isFresh(entry)) this.cache.delete(key);
+      }
+    }
+
+    const requests: Promise<void>[] = [];
+    for (const [group, batch] of batches) {
+      const reads = [...batch.reads.entries()];
+      for (let start = 0; start < reads.length; start += this.config.maxBatchSize) {
+        requests.push(this.fetchChunk(group, batch.slice, reads.slice(start, start + this.config.maxBatchSize)));
+      }
+    }
+    await Promise.all(requests);
+  }
+
+  private async fetchChunk(
+    group: string,
+    slice: AccountSlice | undefined,
+    reads: [string, { pubkey: PublicKey; waiters: PendingRead[] }][]
+  ): Promise<void> {
+    try {
+      this.rpcCalls++;
+      const response = await this.connection.getMultipleAccountsInfoAndContext(
+        reads.map(([, read]) => read.pubkey),
+        { commitment: this.config.commitment, dataSlice: slice }
+      );
+      const slot = response.context.slot;
+      this.latestSlot = Math.max(this.latestSlot, slot);
+      const fetchedAt = Date.now();
+      reads.forEach(([address, read], index) => {
+        const info = response.value[index] ?? null;
+        this.cache.set(`${group}/${address}`, { info, slot, fetchedAt });
+        read.waiters.forEach(waiter => waiter.resolve(info));
+      });
+    } catch (error) {
+      reads.forEach(([, read]) => read.waiters.forEach(waiter => waiter.reject(error)));
+    }
+  }
+}
@@ -0,0 +1,155 @@
+import { PublicKey } from '@solana/web3.js';
+import { findStealthPda, STEALTH_MAX_HOPS } from './stealth-pda';
+
+/**
+ * Account-Layout des Batch-Hops (muss mit `batch_plan.rs` übereinstimmen).
+ *
+ * Die Split-PDAs werden als `remainingAccounts` übergeben; `splitKeys[i]`
+ * (`hop << 8 | split`) benennt das Hop/Split-Paar von Account `i`. Nur Splits,
+ * die Lamports erhalten, brauchen einen Account: die echten Splits und die
+ * ersten `PRIMARY_FAKE_SPLITS` Fake-Splits jedes Hops.
+ */
+export const PRIMARY_FAKE_SPLITS = 4;
+export const MAX_TRANSACTION_CU = 1_400_000;
+export const BATCH_CU_HEADROOM = 60_000;
+export const BATCH_BASE_CU = 90_000;
+export const HOP_CU = 4_000;
+export const SPLIT_ACCOUNT_CU = 3_000;
+export const MAX_TX_ACCOUNT_LOCKS = 64;
+export const BATCH_HOP_FIXED_ACCOUNTS = 4;
+export const MAX_BATCH_SPLIT_ACCOUNTS = MAX_TX_ACCOUNT_LOCKS - BATCH_HOP_FIXED_ACCOUNTS;
+export const RECLAIM_FIXED_ACCOUNTS = 6;
+export const MAX_RECLAIM_SPLIT_ACCOUNTS = MAX_TX_ACCOUNT_LOCKS - RECLAIM_FIXED_ACCOUNTS;
+export const RECLAIM_BASE_CU = 15_000;
+export const RECLAIM_ACCOUNT_CU = 5_000;
+
+/** Split-Account eines Batch-Hops */
+export interface BatchSplitAccount {
+  hopIndex: number;
+  splitIndex: number;
+  splitKey: number;
+  pubkey: PublicKey;
+}
+
+/** Ein Batch-Hop: zusammenhängende Hops mit ihren Split-Accounts */
+export interface BatchHopPlan {
+  batchIndex: number;
+  firstHop: number;
+  hopCount: number;
+  accounts: BatchSplitAccount[];
+}
+
+/** Eine Reclaim-Transaktion: zu schließende Split-Accounts */
+export interface ReclaimPlan {
+  accounts: BatchSplitAccount[];
+  /** Schließt zusätzlich den Transfer-State (nur der letzte Reclaim) */
+  closeState: boolean;
+}
+
+/** Packt ein Hop/Split-Paar in einen Split-Key */
+export function splitKey(hopIndex: number, splitIndex: number): number {
+  return ((hopIndex & 0xff) << 8) | (splitIndex & 0xff);
+}
+
+/** Geschätzte Compute Units eines Batches (inklusive Reserve) */
+export function batchCuEstimate(hops: number, splitAccounts: number): number {
+  const accounts = Math.min(splitAccounts, MAX_BATCH_SPLIT_ACCOUNTS);
+  return BATCH_CU_HEADROOM + BATCH_BASE_CU + hops * HOP_CU + accounts * SPLIT_ACCOUNT_CU;
+}
+
+/** Prüft CU- und Account-Lock-Limit einer Transaktion */
+export function batchFits(hops: number, splitAccounts: number): boolean {
+  return splitAccounts <= MAX_BATCH_SPLIT_ACCOUNTS
+    && batchCuEstimate(hops, splitAccounts) <= MAX_TRANSACTION_CU;
+}
+
+/** Geschätzte Compute Units eines Reclaims (inklusive Reserve) */
+export function reclaimCuEstimate(splitAccounts: number): number {
+  return BATCH_CU_HEADROOM + RECLAIM_BASE_CU + splitAccounts * RECLAIM_ACCOUNT_CU;
+}
+
+/**
+ * Teilt die Split-Accounts eines beendeten Transfers in möglichst wenige
+ * Reclaims auf; der letzte schließt den Transfer-State. Ein Standard-Transfer
+ * (32 Split-Accounts) braucht genau eine Transaktion.
+ */
+export function planReclaim(accounts: BatchSplitAccount[]): ReclaimPlan[] {
+  const plans: ReclaimPlan[] = [];
+  for (let i = 0; i < accounts.length; i += MAX_RECLAIM_SPLIT_ACCOUNTS) {
+    plans.push({ accounts: accounts.slice(i, i + MAX_RECLAIM_SPLIT_ACCOUNTS), closeState: false });
+  }
+  if (plans.length === 0) {
+    plans.push({ accounts: [], closeState: false });
+  }
+  plans[plans.length - 1].closeState = true;
+  return plans;
+}
+
+/**
+ * Split-Accounts eines Hops, die Lamports erhalten
+ * (echte Splits + primäre Fake-Splits), in Split-Reihenfolge.
+ * Mit nur committeten Fake-Splits (`committedFakes`) nur die echten Splits.
+ */
+export function hopSplitAccounts(
+  programId: PublicKey,
+  seed: Uint8Array,
+  hopIndex: number,
+  realSplits: number = 4,
+  committedFakes: boolean = false
+): BatchSplitAccount[] {
+  const accounts: BatchSplitAccount[] = [];
+  const fundedFakes = committedFakes ? 0 : PRIMARY_FAKE_SPLITS;
+  for (let split = 0; split < realSplits + fundedFakes; split++) {
+    const [pubkey] = findStealthPda(programId, seed, hopIndex, split, split >= realSplits);
+    accounts.push({ hopIndex, splitIndex: split, splitKey: splitKey(hopIndex, split), pubkey });
+  }
+  return accounts;
+}
+
+/**
+ * Echte Split-Accounts in Hop/Split-Reihenfolge, wie sie `finalizeTransfer`
+ * nach den Empfängern erwartet (die Batch-Pläne liefern die Hops geordnet).
+ */
+export function realSplitAccounts(accounts: BatchSplitAccount[], realSplits: number = 4): BatchSplitAccount[] {
+  return accounts.filter(account => account.splitIndex < realSplits);
+}
+
+/**
+ * Teilt die verbleibenden Hops in möglichst wenige Batch-Hops auf.
+ * Jeder Batch enthält so viele ganze Hops, wie unter das CU- und
+ * Account-Limit einer Transaktion passen.
+ */
+export function planBatchHops(
+  programId: PublicKey,
+  seed: Uint8Array,
+  firstHop: number = 0,
+  numHops: number = STEALTH_MAX_HOPS,
+  realSplits: number = 4,
+  committedFakes: boolean = false
+): BatchHopPlan[] {
+  const plans: BatchHopPlan[] = [];
+  let hop = firstHop;
+
+  while (hop < numHops) {
+    const accounts: BatchSplitAccount[] = [];
+    let hopCount = 0;
+
+    while (hop + hopCount < numHops) {
+      const next = hopSplitAccounts(programId, seed, hop + hopCount, realSplits, committedFakes);
+      if (!batchFits(hopCount + 1, accounts.length + next.length)) {
+        break;
+      }
+      accounts.push(...next);
+      hopCount++;
+    }
+
+    if (hopCount === 0) {
+      throw new Error(`Hop ${hop} passt nicht in eine einzelne Transaktion`);
+    }
+
+    plans.push({ batchIndex: plans.length, firstHop: hop, hopCount, accounts });
+    hop += hopCount;
+  }
+
+  return plans;
+}
@@ -0,0 +1,127 @@
+import {
+  AddressLookupTableAccount,
+  ComputeBudgetProgram,
+  Connection,
+  Keypair,
+  TransactionInstruction
+} from '@solana/web3.js';
+import { buildV0Transaction } from './lookup-table';
+import { MAX_TRANSACTION_CU } from './batch-plan';
+
+/** Einstellungen der CU-Schätzung */
+export interface ComputeEstimatorConfig {
+  /** Relativer Sicherheitsaufschlag auf die gemessenen CUs */
+  marginRatio: number;
+  /** Absoluter Mindestaufschlag */
+  minMargin: number;
+}
+
+export const DEFAULT_COMPUTE_ESTIMATOR_CONFIG: ComputeEstimatorConfig = {
+  marginRatio: 0.1,
+  minMargin: 1_000
+};
+
+/**
+ * Form einer Instruktionsliste: Programm, Anchor-Diskriminator und Anzahl
+ * der Accounts je Instruktion. Gleiche Formen verbrauchen (nahezu) gleich
+ * viele CUs, z.B. jeder Batch-Hop mit 4 Hops und 32 Split-Accounts.
+ */
+export function instructionShape(instructions: TransactionInstruction[]): string {
+  return instructions
+    .map(ix => `${ix.programId.toBase58()}:${ix.data.subarray(0, 8).toString('hex')}:${ix.keys.length}`)
+    .join('|');
+}
+
+/**
+ * CU-Schätzung per Simulation
+ *
+ * Jede Instruktionsform wird einmal über `simulateTransaction` gemessen (oder
+ * aus einer gelandeten Transaktion übernommen); der Messwert plus
+ * Sicherheitsaufschlag wird pro Form zwischengespeichert und als
+ * `SetComputeUnitLimit` gesetzt. Ein zu hohes Limit erhöht die
+ * Prioritätsgebühr, die pro angefordertem CU bezahlt wird.
+ */
+export class ComputeUnitEstimator {
+  private readonly connection: Connection;
+  private readonly config: ComputeEstimatorConfig;
+  private readonly limits = new Map<string, number>();
+
+  constructor(connection: Connection, config: Partial<ComputeEstimatorConfig> = {}) {
+    this.connection = connection;
+    this.config = { ...DEFAULT_COMPUTE_ESTIMATOR_CONFIG, ...config };
+  }
+
+  /** Zwischengespeichertes Limit der Form, ohne RPC-Aufruf */
+  cachedLimit(instructions: TransactionInstruction[]): number | undefined {
+    return this.limits.get(instructionShape(instructions));
+  }
+
+  /** Übernimmt einen Messwert (z.B. `computeUnitsConsumed` einer gelandeten Transaktion) */
+  record(instructions: TransactionInstruction[], unitsConsumed: number): number {
+    const limit = this.withMargin(unitsConsumed);
+    this.limits.set(instructionShape(instructions), limit);
+    return limit;
+  }
+
+  /**
+   * Limit für die Instruktionen: aus dem Cache oder per Simulation gemessen.
+   * Schlägt die Simulation fehl (z.B. weil ein vorheriger Schritt noch nicht
+   * gelandet ist), wird `fallback` verwendet und nichts gespeichert.
+   */
+  async estimate(
+    payer: Keypair,
+    instructions: TransactionInstruction[],
+    lookupTables: AddressLookupTableAccount[] = [],
+    fallback: number = MAX_TRANSACTION_CU
+  ): Promise<number> {
+    const cached = this.cachedLimit(instructions);
+    if (cached !== undefined) {
+      return cached;
+    }
+
+    // Mit maximalem Limit simulieren, damit das Standardlimit (200k) die
+    // Messung nicht abschneidet; Blockhash und Signaturen ersetzt der Knoten
+    const tx = buildV0Transaction(
+      payer,
+      [ComputeBudgetProgram.setComputeUnitLimit({ units: MAX_TRANSACTION_CU }), ...instructions],
+      '11111111111111111111111111111111',
+      lookupTables
+    );
+    try {
+      const { value } = await this.connection.simulateTransaction(tx, {
+        sigVerify: false,
+        replaceRecentBlockhash: true
+      });
+      if (value.err || value.unitsConsumed === undefined) {
+        return fallback;
+      }
+      return this.record(instructions, value.unitsConsumed);
+    } catch (error) {
+      console.warn('CU-Simulation fehlgeschlagen, verwende Fallback-Limit:', error);
+      return fallback;
+    }
+  }
+
+  /**
+   * Übernimmt die tatsächlich verbrauchten CUs gelandeter Transaktionen für
+   * Formen, die noch nicht gemessen wurden
+   */
+  async recordLanded(steps: { instructions: TransactionInstruction[]; signature: string }[]): Promise<void> {
+    const unmeasured = steps.filter(step => this.cachedLimit(step.instructions) === undefined);
+    await Promise.all(unmeasured.map(async step => {
+      const tx = await this.connection.getTransaction(step.signature, {
+        commitment: 'confirmed',
+        maxSupportedTransactionVersion: 0
+      });
+      const consumed = tx?.meta?.computeUnitsConsumed;
+      if (consumed !== undefined) {
+        this.record(step.instructions, consumed);
+      }
+    }));
+  }
+
+  private withMargin(units: number): number {
+    const margin = Math.max(this.config.minMargin, Math.ceil(units * this.config.marginRatio));
+    return Math.min(MAX_TRANSACTION_CU, units + margin);
+  }
+}
@@ -0,0 +1,464 @@
+import { createHash } from 'crypto';
+import * as fs from 'fs';
+import { Commitment, Connection, Logs, PublicKey } from '@solana/web3.js';
+
+/**
+ * Ereignis-Indexer für den Transferfortschritt
+ *
+ * Statt den Transfer-State jedes laufenden Transfers per RPC abzufragen,
+ * abonniert der Indexer die Logs des Programms (`logsSubscribe`) und
+ * dekodiert die Anchor-Events direkt aus den `Program data:`-Zeilen. Der
+ * Fortschritt wird pro Transfer-State-Adresse im Speicher gehalten; jedes
+ * Event wird zusätzlich roh an ein Append-Log angehängt, aus dem der Index
+ * beim Neustart wiederhergestellt wird.
+ *
+ * Die Quelle der Logs ist austauschbar: ein Geyser-Plugin oder ein Backfill
+ * über `getTransaction` speist dieselben Logzeilen über `ingestLogs` ein.
+ */
+
+/** Feldtypen der Event-Layouts (Borsh) */
+type FieldKind = 'pubkey' | 'u8' | 'u16' | 'u32' | 'u64' | 'i64' | 'bool';
+
+const FIELD_SIZE: Record<FieldKind, number> = {
+  pubkey: 32, u8: 1, u16: 2, u32: 4, u64: 8, i64: 8, bool: 1
+};
+
+/**
+ * Layouts der indizierten Events, Felder in der Reihenfolge der
+ * `#[event]`-Structs im Programm
+ */
+const EVENT_LAYOUTS = {
+  TransferInitialized: [
+    ['owner', 'pubkey'], ['recipient', 'pubkey'], ['amount', 'u64'], ['totalAmount', 'u64'],
+    ['numHops', 'u8'], ['realSplits', 'u8'], ['fakeSplits', 'u8'], ['totalPaths', 'u64'],
+    ['transferState', 'pubkey'], ['nonce', 'u32']
+  ],
+  HopExecuted: [
+    ['owner', 'pubkey'], ['hopIndex', 'u8'], ['splitsProcessed', 'u8'], ['totalTransferred', 'u64'],
+    ['progressPercent', 'u8'], ['transferState', 'pubkey'], ['timestamp', 'i64']
+  ],
+  BatchHopExecuted: [
+    ['owner', 'pubkey'], ['batchIndex', 'u8'], ['hopsProcessed', 'u8'], ['splitsProcessed', 'u8'],
+    ['computeUnitsConsumed', 'u32'], ['progressPercent', 'u8'], ['remainingHops', 'u8'],
+    ['transferState', 'pubkey'], ['poseidonHashes', 'u32'], ['poseidonComputeUnits', 'u64']
+  ],
+  TransferFinalized: [
+    ['owner', 'pubkey'], ['recipient', 'pubkey'], ['amount', 'u64'], ['reserve', 'u64'],
+    ['totalAmount', 'u64'], ['transferState', 'pubkey'], ['timestamp', 'i64'], ['recipientCount', 'u8'],
+    ['share0', 'u64'], ['share1', 'u64'], ['share2', 'u64'], ['share3', 'u64'], ['share4', 'u64'], ['share5', 'u64']
+  ],
+  RefundExecuted: [
+    ['owner', 'pubkey'], ['refundAmount', 'u64'], ['devAmount', 'u64'], ['totalAmount', 'u64'],
+    ['transferState', 'pubkey'], ['currentHop', 'u8'], ['progressPercent', 'u8'], ['timestamp', 'i64']
+  ],
+  FakeRevealed: [
+    ['owner', 'pubkey'], ['hopIndex', 'u8'], ['splitIndex', 'u8'], ['fakePda', 'pubkey'],
+    ['transferState', 'pubkey'], ['materializedLamports', 'u64']
+  ],
+  TransferReclaimed: [
+    ['owner', 'pubkey'], ['transferState', 'pubkey'], ['accountsClosed', 'u16'],
+    ['lamportsReclaimed', 'u64'], ['stateClosed', 'bool']
+  ]
+} as const satisfies Record<string, ReadonlyArray<readonly [string, FieldKind]>>;
+
+export type IndexedEventName = keyof typeof EVENT_LAYOUTS;
+
+/**
+ * Dekodiertes Event. Public Keys kommen als Base58, u64/i64 als `number`
+ * (Lamport-Beträge und Zeitstempel bleiben weit unter 2^53).
+ */
+export interface IndexedEvent {
+  name: IndexedEventName;
+  slot: number;
+  data: Record<string, string | number | boolean>;
+}
+
+/** Anchor-Discriminator eines Events: sha256("event:<Name>")[0..8] */
+export function eventDiscriminator(name: string): Buffer {
+  return createHash('sha256').update(`event:${name}`).digest().subarray(0, 8);
+}
+
+/** Discriminator (als u64 LE gelesen) -> Eventname, für die Zuordnung ohne Vergleich von Buffern */
+const EVENTS_BY_DISCRIMINATOR = new Map<bigint, IndexedEventName>(
+  (Object.keys(EVENT_LAYOUTS) as IndexedEventName[]).map(name => [
+    eventDiscriminator(name).readBigUInt64LE(0),
+    name
+  ])
+);
+
+/**
+ * Dekodiert ein Event direkt aus dem Borsh-Puffer (Discriminator + Felder).
+ * Gelesen wird über Offsets im Puffer, ohne Zwischenkopien; unbekannte
+ * Discriminatoren und zu kurze Puffer ergeben `null`.
+ */
+export function decodeEvent(buffer: Buffer, slot: number = 0): IndexedEvent | null {
+  if (buffer.length < 8) return null;
+  const name = EVENTS_BY_DISCRIMINATOR.get(buffer.readBigUInt64LE(0));
+  if (!name) return null;
+
+  const layout: ReadonlyArray<readonly [string, FieldKind]> = EVENT_LAYOUTS[name];
+  const size = layout.reduce((total, [, kind]) => total + FIELD_SIZE[kind], 8);
+  if (buffer.length < size) return null;
+
+  const data: Record<string, string | number | boolean> = {};
+  let offset = 8;
+  for (const [field, kind] of layout) {
+    switch (kind) {
+      case 'pubkey':
+        data[field] = new PublicKey(buffer.subarray(offset, offset + 32)).toBase58();
+        break;
+      case 'u8':
+        data[field] = buffer.readUInt8(offset);
+        break;
+      case 'u16':
+        data[field] = buffer.readUInt16LE(offset);
+        break;
+      case 'u32':
+        data[field] = buffer.readUInt32LE(offset);
+        break;
+      case 'u64':
+        data[field] = Number(buffer.readBigUInt64LE(offset));
+        break;
+      case 'i64':
+        data[field] = Number(buffer.readBigInt64LE(offset));
+        break;
+      case 'bool':
+        data[field] = buffer.readUInt8(offset) !== 0;
+        break;
+    }
+    offset += FIELD_SIZE[kind];
+  }
+  return { name, slot, data };
+}
+
+/** Lebenszyklus eines Transfers, wie er aus den Events hervorgeht */
+export type TransferPhase = 'initialized' | 'hopping' | 'finalized' | 'refunded' | 'reclaimed';
+
+/** Indizierter Fortschritt eines Transfers */
+export interface TransferProgress {
+  transferState: string;
+  owner: string;
+  /** Transfer-Nonce (0, solange das Initialisierungs-Event nicht gesehen wurde) */
+  nonce: number;
+  phase: TransferPhase;
+  /** Anzahl Hops laut Initialisierung, sonst `null` */
+  numHops: number | null;
+  /** Abgeschlossene Hops */
+  completedHops: number;
+  progressPercent: number;
+  amount: number;
+  recipient: string | null;
+  /** Aufgedeckte Fake-Splits als Split-Schlüssel (`hop << 8 | split`) */
+  revealedFakes: number[];
+  lamportsReclaimed: number;
+  /** Slot des jüngsten angewandten Events */
+  lastSlot: number;
+  /** Zeitstempel (Unix-Sekunden) des jüngsten Events mit Zeitstempel */
+  lastTimestamp: number | null;
+}
+
+/** Einstellungen des Indexers */
+export interface EventIndexerConfig {
+  /** Pfad des Append-Logs; ohne Pfad wird nur im Speicher indiziert */
+  logPath?: string;
+  /** Commitment des Log-Abonnements */
+  commitment: Commitment;
+}
+
+export const DEFAULT_EVENT_INDEXER_CONFIG: EventIndexerConfig = {
+  commitment: 'confirmed'
+};
+
+/** Präfix der Anchor-Eventzeilen im Programmlog */
+const PROGRAM_DATA_PREFIX = 'Program data: ';
+
+/** Kopf eines Log-Eintrags: Länge des Events (u32 LE) + Slot (u64 LE) */
+const RECORD_HEADER_SIZE = 12;
+
+/**
+ * Extrahiert die Event-Puffer des Programms aus den Logzeilen einer
+ * Transaktion. Über den Aufrufstapel (`invoke [n]` / `success` / `failed`)
+ * werden nur `Program data:`-Zeilen berücksichtigt, die das Programm selbst
+ * geschrieben hat, nicht die per CPI aufgerufener Programme.
+ */
+export function extractEventData(programId: PublicKey, logs: string[]): Buffer[] {
+  const program = programId.toBase58();
+  const stack: string[] = [];
+  const events: Buffer[] = [];
+
+  for (const line of logs) {
+    if (line.startsWith(PROGRAM_DATA_PREFIX)) {
+      if (stack[stack.length - 1] === program) {
+        events.push(Buffer.from(line.slice(PROGRAM_DATA_PREFIX.length), 'base64'));
+      }
+      continue;
+    }
+    const parts = line.split(' ');
+    if (parts[0] !== 'Program' || parts.length < 3) continue;
+    if (parts[2] === 'invoke') {
+      stack.push(parts[1]);
+    } else if (parts[2] === 'success' || parts[2] === 'failed:') {
+      stack.pop();
+    }
+  }
+  return events;
+}
+
+/**
+ * In-Memory-Index des Transferfortschritts mit Append-Log
+ *
+ * Fortschrittsevents setzen absolute Werte und schreiten nur voran, sodass
+ * doppelt oder verspätet zugestellte Logs, etwa nach einem Neuverbinden des
+ * Abonnements, den Fortschritt nicht verfälschen. Nur `lamportsReclaimed`
+ * summiert die Reclaim-Batches auf.
+ */
+export class EventIndexer {
+  private readonly connection: Connection;
+  private readonly programId: PublicKey;
+  private readonly config: EventIndexerConfig;
+  private readonly transfers = new Map<string, TransferProgress>();
+  private readonly listeners = new Set<(progress: TransferProgress, event: IndexedEvent) => void>();
+  private subscription: number | null = null;
+  private logFd: number | null = null;
+
+  constructor(connection: Connection, programId: PublicKey, config: Partial<EventIndexerConfig> = {}) {
+    this.connection = connection;
+    this.programId = programId;
+    this.config = { ...DEFAULT_EVENT_INDEXER_CONFIG, ...config };
+  }
+
+  /**
+   * Stellt den Index aus dem Append-Log wieder her und abonniert die
+   * Programmlogs. Gibt die Anzahl wiederhergestellter Events zurück.
+   */
+  start(): number {
+    if (this.subscription !== null) return 0;
+    const replayed = this.replay();
+    if (this.config.logPath) {
+      this.logFd = fs.openSync(this.config.logPath, 'a');
+    }
+    this.subscription = this.connection.onLogs(
+      this.programId,
+      (logs: Logs, context) => { this.ingestLogs(logs, context.slot); },
+      this.config.commitment
+    );
+    return replayed;
+  }
+
+  /** Beendet das Abonnement und schließt das Append-Log */
+  async stop(): Promise<void> {
+    if (this.subscription !== null) {
+      const subscription = this.subscription;
+      this.subscription = null;
+      await this.connection.removeOnLogsListener(subscription);
+    }
+    if (this.logFd !== null) {
+      fs.closeSync(this.logFd);
+      this.logFd = null;
+    }
+  }
+
+  /**
+   * Verarbeitet die Logs einer Transaktion. Fehlgeschlagene Transaktionen
+   * werden übersprungen, da ihre Zustandsänderungen verworfen wurden.
+   */
+  ingestLogs(logs: Pick<Logs, 'err' | 'logs'>, slot: number): IndexedEvent[] {
+    if (logs.err) return [];
+    const events: IndexedEvent[] = [];
+    for (const data of extractEventData(this.programId, logs.logs)) {
+      const event = decodeEvent(data, slot);
+      if (!event) continue;
+      this.appendToLog(data, slot);
+      this.apply(event);
+      events.push(event);
+    }
+    return events;
+  }
+
+  /** Fortschritt eines Transfers oder `undefined`, wenn keine Events vorliegen */
+  get(transferState: PublicKey | string): TransferProgress | undefined {
+    const key = typeof transferState === 'string' ? transferState : transferState.toBase58();
+    return this.transfers.get(key);
+  }
+
+  /** Alle indizierten Transfers, optional auf einen Owner beschränkt */
+  list(owner?: PublicKey): TransferProgress[] {
+    const all = [...this.transfers.values()];
+    if (!owner) return all;
+    const ownerKey = owner.toBase58();
+    return all.filter(progress => progress.owner === ownerKey);
+  }
+
+  /** Transfers, die weder finalisiert noch erstattet wurden */
+  active(): TransferProgress[] {
+    return this.list().filter(progress => progress.phase === 'initialized' || progress.phase === 'hopping');
+  }
+
+  /** Registriert einen Listener für jede Indexänderung; liefert die Abmeldung zurück */
+  onUpdate(listener: (progress: TransferProgress, event: IndexedEvent) => void): () => void {
+    this.listeners.add(listener);
+    return () => { this.listeners.delete(listener); };
+  }
+
+  /**
+   * Wartet, bis der Fortschritt eines Transfers `predicate` erfüllt, etwa
+   * bis ein Hop gelandet ist, ohne den Transfer-State abzufragen
+   */
+  waitFor(
+    transferState: PublicKey,
+    predicate: (progress: TransferProgress) => boolean,
+    timeoutMs: number = 60_000
+  ): Promise<TransferProgress> {
+    const key = transferState.toBase58();
+    const current = this.transfers.get(key);
+    if (current && predicate(current)) {
+      return Promise.resolve(current);
+    }
+    return new Promise((resolve, reject) => {
+      const timer = setTimeout(() => {
+        unsubscribe();
+        reject(new Error(`Zeitüberschreitung beim Warten auf Transfer ${key}`));
+      }, timeoutMs);
+      const unsubscribe = this.onUpdate(progress => {
+        if (progress.transferState === key && predicate(progress)) {
+          clearTimeout(timer);
+          unsubscribe();
+          resolve(progress);
+        }
+      });
+    });
+  }
+
+  /** Wendet ein Event auf den Index an */
+  apply(event: IndexedEvent): TransferProgress {
+    const data = event.data;
+    const key = data.transferState as string;
+    let progress = this.transfers.get(key);
+    if (!progress) {
+      progress = {
+        transferState: key,
+        owner: data.owner as string,
+        nonce: 0,
+        phase: 'initialized',
+        numHops: null,
+        completedHops: 0,
+        progressPercent: 0,
+        amount: 0,
+        recipient: null,
+        revealedFakes: [],
+        lamportsReclaimed: 0,
+        lastSlot: 0,
+        lastTimestamp: null
+      };
+      this.transfers.set(key, progress);
+    }
+
+    switch (event.name) {
+      case 'TransferInitialized':
+        // Eine wiederverwendete Adresse (gleiche Nonce nach dem Reclaim)
+        // beginnt einen neuen Transfer
+        if (progress.phase === 'reclaimed' && event.slot >= progress.lastSlot) {
+          progress.completedHops = 0;
+          progress.progressPercent = 0;
+          progress.revealedFakes = [];
+          progress.lamportsReclaimed = 0;
+          progress.phase = 'initialized';
+        }
+        progress.nonce = data.nonce as number;
+        progress.numHops = data.numHops as number;
+        progress.amount = data.amount as number;
+        progress.recipient = data.recipient as string;
+        break;
+      case 'HopExecuted':
+        progress.completedHops = Math.max(progress.completedHops, (data.hopIndex as number) + 1);
+        progress.progressPercent = Math.max(progress.progressPercent, data.progressPercent as number);
+        progress.lastTimestamp = data.timestamp as number;
+        this.advance(progress, 'hopping');
+        break;
+      case 'BatchHopExecuted':
+        if (progress.numHops !== null) {
+          progress.completedHops = Math.max(progress.completedHops, progress.numHops - (data.remainingHops as number));
+        }
+        progress.progressPercent = Math.max(progress.progressPercent, data.progressPercent as number);
+        this.advance(progress, 'hopping');
+        break;
+      case 'TransferFinalized':
+        progress.recipient = data.recipient as string;
+        progress.progressPercent = 100;
+        progress.lastTimestamp = data.timestamp as number;
+        this.advance(progress, 'finalized');
+        break;
+      case 'RefundExecuted':
+        progress.completedHops = Math.max(progress.completedHops, data.currentHop as number);
+        progress.lastTimestamp = data.timestamp as number;
+        this.advance(progress, 'refunded');
+        break;
+      case 'FakeRevealed': {
+        const splitKey = ((data.hopIndex as number) << 8) | (data.splitIndex as number);
+        if (!progress.revealedFakes.includes(splitKey)) {
+          progress.revealedFakes.push(splitKey);
+        }
+        break;
+      }
+      case 'TransferReclaimed':
+        progress.lamportsReclaimed += data.lamportsReclaimed as number;
+        if (data.stateClosed) {
+          this.advance(progress, 'reclaimed');
+        }
+        break;
+    }
+    progress.lastSlot = Math.max(progress.lastSlot, event.slot);
+
+    this.listeners.forEach(listener => listener(progress!, event));
+    return progress;
+  }
+
+  /** Phasen schreiten nur voran; verspätet zugestellte Events setzen sie nicht zurück */
+  private advance(progress: TransferProgress, phase: TransferPhase): void {
+    const order: TransferPhase[] = ['initialized', 'hopping', 'finalized', 'refunded', 'reclaimed'];
+    const terminal = progress.phase === 'finalized' || progress.phase === 'refunded';
+    if (terminal && (phase === 'finalized' || phase === 'refunded')) return;
+    if (order.indexOf(phase) > order.indexOf(progress.phase)) {
+      progress.phase = phase;
+    }
+  }
+
+  /** Hängt ein rohes Event an das Log an: [Länge u32][Slot u64][Event-Bytes] */
+  private appendToLog(data: Buffer, slot: number): void {
+    if (this.logFd === null) return;
+    const record = Buffer.alloc(RECORD_HEADER_SIZE + data.length);
+    record.writeUInt32LE(data.length, 0);
+    record.writeBigUInt64LE(BigInt(slot), 4);
+    data.copy(record, RECORD_HEADER_SIZE);
+    fs.writeSync(this.logFd, record);
+  }
+
+  /**
+   * Spielt das Append-Log in den Index ein. Ein abgeschnittener letzter
+   * Eintrag (Absturz während des Schreibens) wird ignoriert.
+   */
+  private replay(): number {
+    const path = this.config.logPath;
+    if (!path || !fs.existsSync(path)) return 0;
+
+    const log = fs.readFileSync(path);
+    let offset = 0;
+    let replayed = 0;
+    while (offset + RECORD_HEADER_SIZE <= log.length) {
+      const length = log.readUInt32LE(offset);
+      const slot = Number(log.readBigUInt64LE(offset + 4));
+      const end = offset + RECORD_HEADER_SIZE + length;
+      if (end > log.length) break;
+      const event = decodeEvent(log.subarray(offset + RECORD_HEADER_SIZE, end), slot);
+      if (event) {
+        this.apply(event);
+        replayed++;
+      }
+      offset = end;
+    }
+    if (offset < log.length) {
+      fs.truncateSync(path, offset);
+    }
+    return replayed;
+  }
+}
@@ -0,0 +1,81 @@
+import { Commitment, Connection, VersionedTransaction } from '@solana/web3.js';
+
+/**
+ * Pipelined Submission der Transfer-Schritte (Initialisierung, Batch-Hops,
+ * Finalisierung).
+ *
+ * Alle Transaktionen werden vorab mit demselben Blockhash signiert. Schritt
+ * N+1 wird gesendet, sobald Schritt N mit `processed` gelandet ist, statt auf
+ * `confirmed` zu warten; nur der letzte Schritt wird mit `confirmed`
+ * bestätigt. Die Schritte bleiben in Reihenfolge, weil jeder Hop den
+ * Zustand des vorherigen voraussetzt.
+ */
+
+/** Ein vorab signierter Schritt der Pipeline */
+export interface PipelineStep {
+  label: string;
+  transaction: VersionedTransaction;
+}
+
+/** Blockhash, mit dem alle Schritte signiert wurden */
+export interface PipelineBlockhash {
+  blockhash: string;
+  lastValidBlockHeight: number;
+}
+
+/**
+ * Fehler eines Pipeline-Schritts. `landed` enthält die Signaturen der
+ * Schritte, die bereits erfolgreich gelandet sind (für Refund-Entscheidungen).
+ */
+export class PipelineError extends Error {
+  constructor(
+    public readonly stepIndex: number,
+    public readonly label: string,
+    public readonly landed: string[],
+    public readonly reason: unknown
+  ) {
+    super(`Pipeline-Schritt ${stepIndex} (${label}) fehlgeschlagen: ${reason instanceof Error ? reason.message : JSON.stringify(reason)}`);
+    this.name = 'PipelineError';
+  }
+}
+
+/**
+ * Sendet die Schritte der Reihe nach und wartet jeweils nur bis `processed`
+ * (der letzte Schritt bis `finalCommitment`). Gibt die Signaturen aller
+ * Schritte zurück.
+ */
+export async function submitPipelined(
+  connection: Connection,
+  steps: PipelineStep[],
+  { blockhash, lastValidBlockHeight }: PipelineBlockhash,
+  finalCommitment: Commitment = 'confirmed',
+  onLanded?: (step: PipelineStep, signature: string) => void
+): Promise<string[]> {
+  const landed: string[] = [];
+
+  for (let i = 0; i < steps.length; i++) {
+    const step = steps[i];
+    const commitment: Commitment = i === steps.length - 1 ? finalCommitment : 'processed';
+
+    try {
+      // Preflight würde gegen einen Bank-Zustand simulieren, in dem der
+      // vorherige Schritt eventuell noch fehlt
+      const signature = await connection.sendTransaction(step.transaction, {
+        skipPreflight: i > 0
+      });
+      const confirmation = await connection.confirmTransaction(
+        { signature, blockhash, lastValidBlockHeight },
+        commitment
+      );
+      if (confirmation.value.err) {
+        throw confirmation.value.err;
+      }
+      landed.push(signature);
+      onLanded?.(step, signature);
+    } catch (error) {
+      throw new PipelineError(i, step.label, landed, error);
+    }
+  }
+
+  return landed;
+}
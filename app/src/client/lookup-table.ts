@@ -0,0 +1,222 @@
+import {
+  AddressLookupTableAccount,
+  AddressLookupTableProgram,
+  Connection,
+  Keypair,
+  PublicKey,
+  Signer,
+  SystemProgram,
+  TransactionInstruction,
+  TransactionMessage,
+  VersionedTransaction
+} from '@solana/web3.js';
+import { findStealthPda, STEALTH_MAX_HOPS, STEALTH_SPLITS_PER_HOP } from './stealth-pda';
+import { NetworkStateCache } from './network-state-cache';
+
+/** Maximale Anzahl Adressen einer Address Lookup Table */
+export const LOOKUP_TABLE_MAX_ADDRESSES = 256;
+
+/** Adressen pro `extendLookupTable`-Instruktion (passt in eine Transaktion) */
+export const LOOKUP_TABLE_EXTEND_CHUNK = 30;
+
+/** Adressen, die zusammen mit `createLookupTable` in die erste Transaktion passen */
+const LOOKUP_TABLE_FIRST_CHUNK = 20;
+
+/**
+ * Sammelt alle Adressen eines Transfers für die Lookup Table:
+ * Transfer-State-PDA, System Program, Empfänger und alle Stealth-PDAs
+ * (4 Hops x 48 Splits), ohne Duplikate. Der Signer gehört nicht in die
+ * Tabelle, er muss statisch in der Nachricht stehen.
+ */
+export function collectTransferAddresses(
+  programId: PublicKey,
+  transferStatePda: PublicKey,
+  seed: Uint8Array,
+  recipients: PublicKey[],
+  realSplits: number = 4
+): PublicKey[] {
+  const addresses: PublicKey[] = [];
+  const seen = new Set<string>();
+  const add = (key: PublicKey) => {
+    const id = key.toBase58();
+    if (!seen.has(id)) {
+      seen.add(id);
+      addresses.push(key);
+    }
+  };
+
+  add(transferStatePda);
+  add(SystemProgram.programId);
+  recipients.forEach(add);
+
+  for (let hop = 0; hop < STEALTH_MAX_HOPS; hop++) {
+    for (let split = 0; split < STEALTH_SPLITS_PER_HOP; split++) {
+      const [pda] = findStealthPda(programId, seed, hop, split, split >= realSplits);
+      add(pda);
+    }
+  }
+
+  if (addresses.length > LOOKUP_TABLE_MAX_ADDRESSES) {
+    throw new Error(`Zu viele Adressen für eine Lookup Table: ${addresses.length}`);
+  }
+  return addresses;
+}
+
+/**
+ * Baut und signiert eine `VersionedTransaction` (v0) für einen gegebenen
+ * Blockhash. Accounts aus `lookupTables` werden über Tabellenindizes statt
+ * über volle Pubkeys referenziert.
+ */
+export function buildV0Transaction(
+  payer: Keypair,
+  instructions: TransactionInstruction[],
+  recentBlockhash: string,
+  lookupTables: AddressLookupTableAccount[] = [],
+  signers: Signer[] = []
+): VersionedTransaction {
+  const message = new TransactionMessage({
+    payerKey: payer.publicKey,
+    recentBlockhash,
+    instructions
+  }).compileToV0Message(lookupTables);
+
+  const tx = new VersionedTransaction(message);
+  tx.sign([payer, ...signers]);
+  return tx;
+}
+
+/**
+ * Baut, signiert und sendet eine v0-Transaktion und wartet auf die Bestätigung.
+ * Blockhash und Prioritätsgebühr kommen aus dem gemeinsamen `NetworkStateCache`;
+ * mit `computeUnits` wird zusätzlich das CU-Limit gesetzt.
+ */
+export async function sendV0Transaction(
+  connection: Connection,
+  payer: Keypair,
+  instructions: TransactionInstruction[],
+  lookupTables: AddressLookupTableAccount[] = [],
+  signers: Signer[] = [],
+  computeUnits?: number
+): Promise<string> {
+  const networkState = NetworkStateCache.forConnection(connection);
+  const { blockhash, lastValidBlockHeight } = await networkState.getBlockhash();
+  const tx = buildV0Transaction(
+    payer,
+    [...networkState.computeBudgetInstructions(computeUnits), ...instructions],
+    blockhash,
+    lookupTables,
+    signers
+  );
+
+  const signature = await connection.sendTransaction(tx);
+  const confirmation = await connection.confirmTransaction(
+    { signature, blockhash, lastValidBlockHeight },
+    'confirmed'
+  );
+  if (confirmation.value.err) {
+    throw new Error(`Transaktion ${signature} fehlgeschlagen: ${JSON.stringify(confirmation.value.err)}`);
+  }
+  return signature;
+}
+
+/**
+ * Wartet, bis die Lookup Table nach der letzten Erweiterung aktiv ist
+ * (sie ist erst ab dem Slot nach `lastExtendedSlot` nutzbar)
+ */
+async function waitForActivation(
+  connection: Connection,
+  lookupTable: PublicKey,
+  pollMs: number = 400
+): Promise<AddressLookupTableAccount> {
+  for (;;) {
+    const [table, slot] = await Promise.all([
+      connection.getAddressLookupTable(lookupTable, { commitment: 'confirmed' }),
+      connection.getSlot('confirmed')
+    ]);
+    if (table.value && slot > table.value.state.lastExtendedSlot) {
+      return table.value;
+    }
+    await new Promise(resolve => setTimeout(resolve, pollMs));
+  }
+}
+
+/** Bereits vergebene `recentSlot`-Werte je Authority */
+const reservedTableSlots = new Map<string, Set<number>>();
+
+/**
+ * Wählt den `recentSlot` einer neuen Tabelle. Die Tabellenadresse hängt nur
+ * von Authority und Slot ab; parallele Transfers eines Wallets weichen daher
+ * auf ältere, noch gültige Slots aus statt dieselbe Adresse zu erzeugen.
+ */
+function reserveTableSlot(authority: PublicKey, finalizedSlot: number): number {
+  const key = authority.toBase58();
+  const reserved = reservedTableSlots.get(key) ?? new Set<number>();
+  reservedTableSlots.set(key, reserved);
+  for (const slot of reserved) {
+    if (slot < finalizedSlot - 150) {
+      reserved.delete(slot);
+    }
+  }
+
+  let slot = finalizedSlot;
+  while (reserved.has(slot)) {
+    slot--;
+  }
+  reserved.add(slot);
+  return slot;
+}
+
+/**
+ * Legt eine Lookup Table für einen Transfer an und füllt sie mit `addresses`.
+ *
+ * Die erste Transaktion erzeugt die Tabelle und schreibt den ersten Block;
+ * die übrigen Blöcke werden parallel gesendet. Zurückgegeben wird die
+ * aktivierte Tabelle, bereit für `compileToV0Message`.
+ */
+export async function createTransferLookupTable(
+  connection: Connection,
+  payer: Keypair,
+  addresses: PublicKey[]
+): Promise<AddressLookupTableAccount> {
+  const recentSlot = reserveTableSlot(payer.publicKey, await connection.getSlot('finalized'));
+  const [createIx, lookupTable] = AddressLookupTableProgram.createLookupTable({
+    authority: payer.publicKey,
+    payer: payer.publicKey,
+    recentSlot
+  });
+
+  const extendIx = (chunk: PublicKey[]) => AddressLookupTableProgram.extendLookupTable({
+    payer: payer.publicKey,
+    authority: payer.publicKey,
+    lookupTable,
+    addresses: chunk
+  });
+
+  const first = addresses.slice(0, LOOKUP_TABLE_FIRST_CHUNK);
+  await sendV0Transaction(connection, payer, [createIx, extendIx(first)]);
+
+  const chunks: PublicKey[][] = [];
+  for (let i = first.length; i < addresses.length; i += LOOKUP_TABLE_EXTEND_CHUNK) {
+    chunks.push(addresses.slice(i, i + LOOKUP_TABLE_EXTEND_CHUNK));
+  }
+  await Promise.all(chunks.map(chunk => sendV0Transaction(connection, payer, [extendIx(chunk)])));
+
+  return waitForActivation(connection, lookupTable);
+}
+
+/**
+ * Deaktiviert eine Lookup Table nach dem Transfer. Nach der Abkühlphase kann
+ * sie mit `closeLookupTable` geschlossen und die Miete zurückgeholt werden.
+ */
+export async function deactivateTransferLookupTable(
+  connection: Connection,
+  payer: Keypair,
+  lookupTable: PublicKey
+): Promise<string> {
+  return sendV0Transaction(connection, payer, [
+    AddressLookupTableProgram.deactivateLookupTable({
+      lookupTable,
+      authority: payer.publicKey
+    })
+  ]);
+}
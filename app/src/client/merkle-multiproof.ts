@@ -0,0 +1,170 @@
+import { poseidonHashPair } from './poseidon';
+
+/**
+ * Merkle-Multiproofs (Format muss mit `verify_merkle_multiproof` in
+ * `utils.rs` übereinstimmen):
+ *
+ * [depth (1), leaf_bitmap (multiproofBitmapLength(depth)), siblings (n * 32)]
+ *
+ * Bit `i` der Bitmap (Byte `i / 8`, LSB zuerst) markiert Blattposition `i`;
+ * Blätter sind 32-Byte-Feldelemente (für Wallets `walletLeaf`).
+ * Die Geschwister sind die Knoten, die der Verifier nicht selbst berechnen
+ * kann: Ebene für Ebene von den Blättern aufwärts, innerhalb einer Ebene von
+ * links nach rechts. Pfade, die sich treffen, teilen die oberen Knoten.
+ */
+export const MAX_MULTIPROOF_DEPTH = 8;
+export const MAX_MULTIPROOF_LEAVES = 16;
+
+/** Hash zweier Knoten; muss `HashContext::hash_pair` (Poseidon BN254) entsprechen */
+export type MerkleHashFn = (left: Uint8Array, right: Uint8Array) => Uint8Array;
+
+/** Multiproof mit Root; `leaves` in aufsteigender Positionsreihenfolge */
+export interface MerkleMultiproof {
+  root: Uint8Array;
+  proof: Buffer;
+  leaves: Uint8Array[];
+}
+
+/** Länge der Positions-Bitmap für einen Baum mit `depth` Ebenen */
+export function multiproofBitmapLength(depth: number): number {
+  const width = 1 << depth;
+  return width < 8 ? 1 : width / 8;
+}
+
+/** Tiefe des kleinsten Baums mit mindestens `leafCount` Blättern */
+export function treeDepth(leafCount: number): number {
+  let depth = 0;
+  while ((1 << depth) < leafCount) {
+    depth++;
+  }
+  return depth;
+}
+
+/**
+ * Berechnet alle Ebenen des Baums; fehlende Blätter bis zur nächsten
+ * Zweierpotenz werden mit Nullen aufgefüllt
+ */
+export function merkleLayers(leaves: Uint8Array[], hashPair: MerkleHashFn = poseidonHashPair): Uint8Array[][] {
+  if (leaves.length === 0) {
+    throw new Error('Merkle-Baum ohne Blätter');
+  }
+  const width = 1 << treeDepth(leaves.length);
+  const layers: Uint8Array[][] = [
+    [...leaves, ...Array.from({ length: width - leaves.length }, () => new Uint8Array(32))]
+  ];
+  while (layers[layers.length - 1].length > 1) {
+    const level = layers[layers.length - 1];
+    const parents: Uint8Array[] = [];
+    for (let i = 0; i < level.length; i += 2) {
+      parents.push(hashPair(level[i], level[i + 1]));
+    }
+    layers.push(parents);
+  }
+  return layers;
+}
+
+/**
+ * Erzeugt den Multiproof für die Blätter an `positions`
+ * @param leaves Alle Blätter des Baums
+ * @param positions Zu beweisende Blattpositionen (Reihenfolge beliebig)
+ */
+export function buildMerkleMultiproof(
+  leaves: Uint8Array[],
+  positions: number[],
+  hashPair: MerkleHashFn = poseidonHashPair
+): MerkleMultiproof {
+  const layers = merkleLayers(leaves, hashPair);
+  const depth = layers.length - 1;
+  const known = [...new Set(positions)].sort((a, b) => a - b);
+
+  if (depth > MAX_MULTIPROOF_DEPTH) {
+    throw new Error(`Baumtiefe ${depth} überschreitet ${MAX_MULTIPROOF_DEPTH}`);
+  }
+  if (known.length === 0 || known.length > MAX_MULTIPROOF_LEAVES) {
+    throw new Error(`Multiproof für ${known.length} Blätter (1-${MAX_MULTIPROOF_LEAVES})`);
+  }
+  if (known[0] < 0 || known[known.length - 1] >= leaves.length) {
+    throw new Error('Blattposition außerhalb des Baums');
+  }
+
+  const bitmap = Buffer.alloc(multiproofBitmapLength(depth));
+  for (const position of known) {
+    bitmap[position >> 3] |= 1 << (position & 7);
+  }
+
+  // Gleicher Ablauf wie im Verifier: bekannte Paare hashen, sonst Geschwister anhängen
+  const siblings: Uint8Array[] = [];
+  let level = known;
+  for (let d = 0; d < depth; d++) {
+    const parents: number[] = [];
+    for (let i = 0; i < level.length; i++) {
+      const position = level[i];
+      if (position % 2 === 0 && level[i + 1] === position + 1) {
+        i++;
+      } else {
+        siblings.push(layers[d][position ^ 1]);
+      }
+      parents.push(position >> 1);
+    }
+    level = parents;
+  }
+
+  return {
+    root: layers[depth][0],
+    proof: Buffer.concat([Buffer.from([depth]), bitmap, ...siblings.map(s => Buffer.from(s))]),
+    leaves: known.map(position => leaves[position])
+  };
+}
+
+/**
+ * Prüft einen Multiproof off-chain (gleiche Regeln wie das Programm)
+ */
+export function verifyMerkleMultiproof(
+  proof: Uint8Array,
+  root: Uint8Array,
+  leaves: Uint8Array[],
+  hashPair: MerkleHashFn = poseidonHashPair
+): boolean {
+  if (proof.length === 0 || proof[0] > MAX_MULTIPROOF_DEPTH) {
+    return false;
+  }
+  const depth = proof[0];
+  const bitmapLength = multiproofBitmapLength(depth);
+  const siblingBytes = proof.length - 1 - bitmapLength;
+  if (siblingBytes < 0 || siblingBytes % 32 !== 0 || (depth < 3 && proof[1] >> (1 << depth) !== 0)) {
+    return false;
+  }
+
+  let nodes: { position: number; hash: Uint8Array }[] = [];
+  for (let position = 0; position < (1 << depth); position++) {
+    if (proof[1 + (position >> 3)] & (1 << (position & 7))) {
+      nodes.push({ position, hash: leaves[nodes.length] });
+    }
+  }
+  if (nodes.length !== leaves.length || nodes.length === 0) {
+    return false;
+  }
+
+  let offset = 1 + bitmapLength;
+  for (let d = 0; d < depth; d++) {
+    const parents: typeof nodes = [];
+    for (let i = 0; i < nodes.length; i++) {
+      const { position, hash } = nodes[i];
+      let parent: Uint8Array;
+      if (position % 2 === 0 && nodes[i + 1]?.position === position + 1) {
+        parent = hashPair(hash, nodes[++i].hash);
+      } else {
+        if (offset + 32 > proof.length) {
+          return false;
+        }
+        const sibling = proof.subarray(offset, offset + 32);
+        offset += 32;
+        parent = position % 2 === 0 ? hashPair(hash, sibling) : hashPair(sibling, hash);
+      }
+      parents.push({ position: position >> 1, hash: parent });
+    }
+    nodes = parents;
+  }
+
+  return offset === proof.length && Buffer.from(nodes[0].hash).equals(Buffer.from(root));
+}
@@ -0,0 +1,197 @@
+import {
+  BlockhashWithExpiryBlockHeight,
+  Commitment,
+  ComputeBudgetProgram,
+  Connection,
+  PublicKey,
+  TransactionInstruction
+} from '@solana/web3.js';
+
+/** Einstellungen des Netzwerkzustands-Caches */
+export interface NetworkStateCacheConfig {
+  /** Aktualisierungsintervall im Hintergrund (ms) */
+  refreshIntervalMs: number;
+  /** Maximales Alter eines ausgegebenen Blockhashs (ms) */
+  maxBlockhashAgeMs: number;
+  /** Commitment für `getLatestBlockhash` */
+  commitment: Commitment;
+  /** Perzentil der jüngsten Prioritätsgebühren, das geboten wird (0-100) */
+  feePercentile: number;
+  /** Unter-/Obergrenze der Prioritätsgebühr (Micro-Lamports pro CU) */
+  minPriorityFee: number;
+  maxPriorityFee: number;
+}
+
+export const DEFAULT_NETWORK_STATE_CONFIG: NetworkStateCacheConfig = {
+  refreshIntervalMs: 2_000,
+  maxBlockhashAgeMs: 30_000,
+  commitment: 'confirmed',
+  feePercentile: 75,
+  minPriorityFee: 0,
+  maxPriorityFee: 500_000
+};
+
+/** Maximale Anzahl Accounts pro `getRecentPrioritizationFees`-Abfrage */
+const MAX_FEE_ACCOUNTS = 128;
+
+/** Gemeinsame Caches pro RPC-Endpunkt (Connections ohne Endpunkt, z.B. Mocks, pro Objekt) */
+const sharedCaches = new Map<string, NetworkStateCache>();
+const sharedCachesByConnection = new WeakMap<Connection, NetworkStateCache>();
+
+/**
+ * Gemeinsamer Cache für Blockhash und Prioritätsgebühren
+ *
+ * Statt dass jeder Sendepfad (Client, Connectoren, Timing-Scheduler) vor jeder
+ * Transaktion selbst `getLatestBlockhash` aufruft, aktualisiert der Cache den
+ * Blockhash und `getRecentPrioritizationFees` für die verfolgten beschreibbaren
+ * Accounts in einem Hintergrundintervall und gibt die zwischengespeicherten
+ * Werte an alle Sender aus. Die Prioritätsgebühr wird vom Client als
+ * `SetComputeUnitPrice`-Instruktion gesetzt.
+ */
+export class NetworkStateCache {
+  private readonly connection: Connection;
+  private readonly config: NetworkStateCacheConfig;
+  private blockhash: BlockhashWithExpiryBlockHeight | null = null;
+  private blockhashFetchedAt = 0;
+  private priorityFee: number;
+  private trackedAccounts = new Map<string, PublicKey>();
+  private timer: NodeJS.Timeout | null = null;
+  private users = 0;
+  private refreshing: Promise<void> | null = null;
+
+  constructor(connection: Connection, config: Partial<NetworkStateCacheConfig> = {}) {
+    this.connection = connection;
+    this.config = { ...DEFAULT_NETWORK_STATE_CONFIG, ...config };
+    this.priorityFee = this.config.minPriorityFee;
+  }
+
+  /**
+   * Gemeinsame Instanz für den RPC-Endpunkt der Connection. Connectoren mit
+   * eigener `Connection` auf denselben Endpunkt teilen sich so einen Cache.
+   */
+  static forConnection(connection: Connection): NetworkStateCache {
+    const key = connection.rpcEndpoint;
+    let cache = key ? sharedCaches.get(key) : sharedCachesByConnection.get(connection);
+    if (!cache) {
+      cache = new NetworkStateCache(connection);
+      if (key) {
+        sharedCaches.set(key, cache);
+      } else {
+        sharedCachesByConnection.set(connection, cache);
+      }
+    }
+    return cache;
+  }
+
+  /**
+   * Startet die Aktualisierung im Hintergrund. Aufrufe werden gezählt; das
+   * Intervall läuft, bis jeder Nutzer `stop` aufgerufen hat.
+   */
+  start(): void {
+    this.users++;
+    if (this.timer) return;
+    void this.refresh();
+    this.timer = setInterval(() => { void this.refresh(); }, this.config.refreshIntervalMs);
+    // Der Cache allein soll den Prozess nicht am Leben halten
+    this.timer.unref?.();
+  }
+
+  /** Meldet einen Nutzer ab; der letzte beendet die Aktualisierung */
+  stop(): void {
+    this.users = Math.max(0, this.users - 1);
+    if (this.users === 0 && this.timer) {
+      clearInterval(this.timer);
+      this.timer = null;
+    }
+  }
+
+  /**
+   * Nimmt beschreibbare Accounts in die Gebührenabfrage auf. Die
+   * Prioritätsgebühr richtet sich nach den Slots, in denen diese Accounts
+   * gesperrt waren.
+   */
+  trackAccounts(accounts: PublicKey[]): void {
+    for (const account of accounts) {
+      if (this.trackedAccounts.size >= MAX_FEE_ACCOUNTS) break;
+      this.trackedAccounts.set(account.toBase58(), account);
+    }
+  }
+
+  /** Entfernt Accounts aus der Gebührenabfrage */
+  untrackAccounts(accounts: PublicKey[]): void {
+    accounts.forEach(account => this.trackedAccounts.delete(account.toBase58()));
+  }
+
+  /**
+   * Zwischengespeicherter Blockhash; nur wenn keiner vorliegt oder er älter
+   * als `maxBlockhashAgeMs` ist, wird sofort neu abgefragt (auch ohne
+   * laufende Hintergrundaktualisierung nutzbar)
+   */
+  async getBlockhash(): Promise<BlockhashWithExpiryBlockHeight> {
+    if (!this.blockhash || Date.now() - this.blockhashFetchedAt > this.config.maxBlockhashAgeMs) {
+      await this.refreshBlockhash();
+    }
+    return this.blockhash!;
+  }
+
+  /** Aktuelle Prioritätsgebühr in Micro-Lamports pro CU */
+  getPriorityFee(): number {
+    return this.priorityFee;
+  }
+
+  /**
+   * Compute-Budget-Instruktionen für eine Transaktion: immer der Preis aus
+   * dem Cache, das CU-Limit nur, wenn `units` angegeben ist
+   */
+  computeBudgetInstructions(units?: number): TransactionInstruction[] {
+    const instructions: TransactionInstruction[] = [];
+    if (units !== undefined) {
+      instructions.push(ComputeBudgetProgram.setComputeUnitLimit({ units }));
+    }
+    if (this.priorityFee > 0) {
+      instructions.push(ComputeBudgetProgram.setComputeUnitPrice({ microLamports: this.priorityFee }));
+    }
+    return instructions;
+  }
+
+  /** Aktualisiert Blockhash und Prioritätsgebühr (gleichzeitige Aufrufe werden zusammengefasst) */
+  refresh(): Promise<void> {
+    if (!this.refreshing) {
+      this.refreshing = Promise.all([this.refreshBlockhash(), this.refreshPriorityFee()])
+        .then(() => undefined)
+        .catch(error => console.warn('Netzwerkzustand konnte nicht aktualisiert werden:', error))
+        .finally(() => { this.refreshing = null; });
+    }
+    return this.refreshing;
+  }
+
+  private async refreshBlockhash(): Promise<void> {
+    this.blockhash = await this.connection.getLatestBlockhash(this.config.commitment);
+    this.blockhashFetchedAt = Date.now();
+  }
+
+  private async refreshPriorityFee(): Promise<void> {
+    const fees = await this.connection.getRecentPrioritizationFees({
+      lockedWritableAccounts: [...this.trackedAccounts.values()]
+    });
+    this.priorityFee = feeAtPercentile(
+      fees.map(fee => fee.prioritizationFee),
+      this.config.feePercentile,
+      this.config.minPriorityFee,
+      this.config.maxPriorityFee
+    );
+  }
+}
+
+/**
+ * Gebühr am gegebenen Perzentil, begrenzt auf `[min, max]`
+ */
+export function feeAtPercentile(fees: number[], percentile: number, min: number, max: number): number {
+  if (fees.length === 0) {
+    return min;
+  }
+  const sorted = [...fees].sort((a, b) => a - b);
+  const rank = Math.ceil((Math.min(100, Math.max(0, percentile)) / 100) * sorted.length) - 1;
+  const fee = sorted[Math.max(0, rank)];
+  return Math.min(max, Math.max(min, fee));
+}
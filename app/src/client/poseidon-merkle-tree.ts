@@ -0,0 +1,209 @@
+import { PublicKey } from '@solana/web3.js';
+import { MerkleHashFn } from './merkle-multiproof';
+import { poseidonHashPair } from './poseidon';
+
+/**
+ * Inkrementeller Poseidon-Merkle-Baum fester Tiefe.
+ *
+ * Knoten werden wie im Programm mit `hash_pair(left, right)` verknüpft;
+ * fehlende Blätter sind 32 Null-Bytes, leere Teilbäume werden nie
+ * materialisiert, sondern aus dem Cache `zeros` gelesen. Gespeichert sind nur
+ * die gefüllten Knoten links der Füllgrenze, daher kosten Einfügen und
+ * Aktualisieren `depth` Hashes und ein Proof keinen einzigen.
+ *
+ * Proofs haben das Format von `verify_merkle_proof`:
+ * [depth (1), Richtungsbits (ceil(depth / 8)), Geschwister (depth * 32)]
+ */
+
+/**
+ * Tiefe der Empfänger-Registry (131.072 Blätter); tiefer als die Multiproofs
+ * von `finalize` (`MAX_MULTIPROOF_DEPTH`), die Registry ist clientseitig
+ */
+export const REGISTRY_TREE_DEPTH = 17;
+
+/** Kennung und Version des Snapshot-Formats */
+const SNAPSHOT_MAGIC = Buffer.from('ZMT1');
+
+/** Länge des Snapshot-Kopfes: Kennung, Tiefe (u8), Blattanzahl (u32 LE) */
+const SNAPSHOT_HEADER = SNAPSHOT_MAGIC.length + 1 + 4;
+
+/**
+ * Merkle-Blatt eines Wallets (muss mit `wallet_leaf` in `utils.rs`
+ * übereinstimmen): Poseidon über die beiden 128-Bit-Hälften des Schlüssels,
+ * da rohe Schlüssel meist keine gültigen Feldelemente sind
+ */
+export function walletLeaf(wallet: PublicKey, hashPair: MerkleHashFn = poseidonHashPair): Uint8Array {
+  const key = wallet.toBytes();
+  return hashPair(key.subarray(0, 16), key.subarray(16));
+}
+
+export class PoseidonMerkleTree {
+  readonly depth: number;
+  private readonly hashPair: MerkleHashFn;
+  /** `zeros[l]`: Wurzel eines leeren Teilbaums der Höhe `l` */
+  private readonly zeros: Uint8Array[];
+  /** `levels[0]` Blätter bis `levels[depth]` Wurzel, nur gefüllte Knoten */
+  private readonly levels: Uint8Array[][];
+
+  constructor(depth: number = REGISTRY_TREE_DEPTH, hashPair: MerkleHashFn = poseidonHashPair) {
+    if (!Number.isInteger(depth) || depth < 1 || depth > 32) {
+      throw new Error(`Ungültige Baumtiefe: ${depth}`);
+    }
+    this.depth = depth;
+    this.hashPair = hashPair;
+    this.zeros = [new Uint8Array(32)];
+    for (let level = 0; level < depth; level++) {
+      this.zeros.push(hashPair(this.zeros[level], this.zeros[level]));
+    }
+    this.levels = Array.from({ length: depth + 1 }, () => []);
+  }
+
+  /**
+   * Baut einen Baum aus allen Blättern auf einmal (Ebene für Ebene, jeder
+   * Knoten wird genau einmal gehasht)
+   */
+  static fromLeaves(
+    leaves: Uint8Array[],
+    depth: number = REGISTRY_TREE_DEPTH,
+    hashPair: MerkleHashFn = poseidonHashPair
+  ): PoseidonMerkleTree {
+    const tree = new PoseidonMerkleTree(depth, hashPair);
+    if (leaves.length > tree.capacity) {
+      throw new Error(`${leaves.length} Blätter überschreiten die Kapazität ${tree.capacity}`);
+    }
+    tree.levels[0].push(...leaves);
+    for (let level = 0; level < depth; level++) {
+      const nodes = tree.levels[level];
+      for (let i = 0; i < nodes.length; i += 2) {
+        tree.levels[level + 1].push(hashPair(nodes[i], nodes[i + 1] ?? tree.zeros[level]));
+      }
+    }
+    return tree;
+  }
+
+  /**
+   * Stellt einen Baum aus `snapshot()` ohne einen einzigen Hash wieder her.
+   * Der Inhalt wird nicht nachgerechnet; `hashPair` muss der beim Erzeugen
+   * verwendete Hash sein.
+   */
+  static fromSnapshot(snapshot: Uint8Array, hashPair: MerkleHashFn = poseidonHashPair): PoseidonMerkleTree {
+    const data = Buffer.from(snapshot.buffer, snapshot.byteOffset, snapshot.byteLength);
+    if (data.length < SNAPSHOT_HEADER || !data.subarray(0, SNAPSHOT_MAGIC.length).equals(SNAPSHOT_MAGIC)) {
+      throw new Error('Kein Merkle-Snapshot');
+    }
+    const tree = new PoseidonMerkleTree(data[SNAPSHOT_MAGIC.length], hashPair);
+    const size = data.readUInt32LE(SNAPSHOT_MAGIC.length + 1);
+    const expected = SNAPSHOT_HEADER + 32 * PoseidonMerkleTree.filledNodes(size, tree.depth);
+    if (size > tree.capacity || data.length !== expected) {
+      throw new Error(`Merkle-Snapshot mit ${data.length} Bytes, erwartet ${expected}`);
+    }
+
+    let offset = SNAPSHOT_HEADER;
+    for (let level = 0; level <= tree.depth; level++) {
+      const count = Math.ceil(size / 2 ** level);
+      for (let i = 0; i < count; i++) {
+        tree.levels[level].push(Uint8Array.from(data.subarray(offset, offset + 32)));
+        offset += 32;
+      }
+    }
+    return tree;
+  }
+
+  /** Anzahl gespeicherter Knoten aller Ebenen bei `size` Blättern */
+  private static filledNodes(size: number, depth: number): number {
+    let total = 0;
+    for (let level = 0; level <= depth; level++) {
+      total += Math.ceil(size / 2 ** level);
+    }
+    return total;
+  }
+
+  /** Anzahl eingefügter Blätter */
+  get size(): number {
+    return this.levels[0].length;
+  }
+
+  /** Maximale Anzahl Blätter */
+  get capacity(): number {
+    return 2 ** this.depth;
+  }
+
+  /** Aktuelle Wurzel (die des leeren Baums, solange keine Blätter existieren) */
+  get root(): Uint8Array {
+    return this.node(this.depth, 0);
+  }
+
+  /** Blatt an `index` */
+  leaf(index: number): Uint8Array {
+    this.checkIndex(index);
+    return this.levels[0][index];
+  }
+
+  /** Hängt ein Blatt an und gibt seinen Index zurück (`depth` Hashes) */
+  insert(leaf: Uint8Array): number {
+    const index = this.size;
+    if (index >= this.capacity) {
+      throw new Error(`Merkle-Baum voll (${this.capacity} Blätter)`);
+    }
+    this.levels[0].push(leaf);
+    this.updatePath(index);
+    return index;
+  }
+
+  /** Ersetzt das Blatt an `index` (`depth` Hashes) */
+  update(index: number, leaf: Uint8Array): void {
+    this.checkIndex(index);
+    this.levels[0][index] = leaf;
+    this.updatePath(index);
+  }
+
+  /** Merkle-Proof für das Blatt an `index` im Format von `verify_merkle_proof` */
+  proof(index: number): Buffer {
+    this.checkIndex(index);
+    const directions = Buffer.alloc(Math.ceil(this.depth / 8));
+    const siblings: Uint8Array[] = [];
+    let position = index;
+    for (let level = 0; level < this.depth; level++) {
+      if (position & 1) {
+        directions[level >> 3] |= 1 << (level & 7);
+      }
+      siblings.push(this.node(level, position ^ 1));
+      position >>= 1;
+    }
+    return Buffer.concat([Buffer.from([this.depth]), directions, ...siblings]);
+  }
+
+  /**
+   * Serialisiert alle gefüllten Knoten:
+   * [Kennung "ZMT1", Tiefe (u8), Blattanzahl (u32 LE), Knoten Ebene 0..depth]
+   */
+  snapshot(): Buffer {
+    const header = Buffer.alloc(SNAPSHOT_HEADER);
+    SNAPSHOT_MAGIC.copy(header);
+    header[SNAPSHOT_MAGIC.length] = this.depth;
+    header.writeUInt32LE(this.size, SNAPSHOT_MAGIC.length + 1);
+    return Buffer.concat([header, ...this.levels.flat()]);
+  }
+
+  private node(level: number, index: number): Uint8Array {
+    return this.levels[level][index] ?? this.zeros[level];
+  }
+
+  private updatePath(index: number): void {
+    let position = index;
+    for (let level = 0; level < this.depth; level++) {
+      const parent = position >> 1;
+      this.levels[level + 1][parent] = this.hashPair(
+        this.node(level, parent * 2),
+        this.node(level, parent * 2 + 1)
+      );
+      position = parent;
+    }
+  }
+
+  private checkIndex(index: number): void {
+    if (!Number.isInteger(index) || index < 0 || index >= this.size) {
+      throw new Error(`Blattindex ${index} außerhalb von 0-${this.size - 1}`);
+    }
+  }
+}
@@ -0,0 +1,162 @@
+import { PublicKey } from '@solana/web3.js';
+import { MerkleHashFn } from './merkle-multiproof';
+import { poseidonHashPair } from './poseidon';
+import { PoseidonMerkleTree, REGISTRY_TREE_DEPTH, walletLeaf } from './poseidon-merkle-tree';
+
+/** Merkle-Proof eines registrierten Empfängers */
+export interface RecipientProof {
+  index: number;
+  leaf: Uint8Array;
+  root: Uint8Array;
+  /** Format von `verify_merkle_proof`, ausgehend vom Blatt `leaf` */
+  proof: Buffer;
+}
+
+/**
+ * Prüft einen Registry-Proof clientseitig wie `verify_merkle_proof`:
+ * vom Blatt `walletLeaf(wallet)` entlang der Richtungsbits bis zur Wurzel
+ */
+export function verifyRecipientProof(
+  proof: RecipientProof,
+  wallet: PublicKey,
+  hashPair: MerkleHashFn = poseidonHashPair
+): boolean {
+  const depth = proof.proof[0];
+  const directionBytes = Math.ceil(depth / 8);
+  if (depth === undefined || proof.proof.length !== 1 + directionBytes + depth * 32) {
+    return false;
+  }
+  let node = walletLeaf(wallet, hashPair);
+  for (let level = 0; level < depth; level++) {
+    const offset = 1 + directionBytes + level * 32;
+    const sibling = proof.proof.subarray(offset, offset + 32);
+    node = proof.proof[1 + (level >> 3)] & (1 << (level & 7)) ? hashPair(sibling, node) : hashPair(node, sibling);
+  }
+  return Buffer.from(node).equals(Buffer.from(proof.root));
+}
+
+/**
+ * Registry der Empfänger-Wallets über einem inkrementellen Poseidon-Baum.
+ *
+ * Jedes Wallet belegt ein Blatt (`walletLeaf`); neue Wallets werden
+ * angehängt, ersetzte an ihrer Position aktualisiert. Der Index
+ * Wallet -> Blatt wird im Speicher gehalten, sodass ein Proof ohne Hashen
+ * aus den gespeicherten Knoten entsteht. Der Snapshot enthält Wallets und
+ * Baum, ein Neustart muss den Baum also nicht neu aufbauen.
+ *
+ * Die Registry ist rein clientseitig: keine Instruktion prüft ihre Wurzel
+ * oder ihre Proofs. Die `merkle_root` eines Transfers ist die Wurzel des
+ * Multiproofs über genau seine Empfänger (`createRecipientMultiproof`).
+ * Registry-Proofs belegen die Mitgliedschaft gegenüber Dritten
+ * (`verifyRecipientProof`, gleiches Blatt und Format wie `verify_merkle_proof`).
+ */
+export class RecipientRegistry {
+  private readonly tree: PoseidonMerkleTree;
+  private readonly wallets: PublicKey[];
+  private readonly positions = new Map<string, number>();
+
+  /**
+   * @param tree Baum über `wallets` (Standard: leer, `REGISTRY_TREE_DEPTH`)
+   * @param wallets Wallets der Blätter in Blattreihenfolge
+   */
+  constructor(
+    tree: PoseidonMerkleTree = new PoseidonMerkleTree(REGISTRY_TREE_DEPTH),
+    wallets: PublicKey[] = []
+  ) {
+    if (tree.size !== wallets.length) {
+      throw new Error(`Baum mit ${tree.size} Blättern für ${wallets.length} Wallets`);
+    }
+    this.tree = tree;
+    this.wallets = [...wallets];
+    this.wallets.forEach((wallet, index) => this.positions.set(wallet.toBase58(), index));
+  }
+
+  /** Baut die Registry für viele Wallets auf einmal auf */
+  static fromWallets(wallets: PublicKey[], depth: number = REGISTRY_TREE_DEPTH): RecipientRegistry {
+    const unique = [...new Map(wallets.map(wallet => [wallet.toBase58(), wallet])).values()];
+    const tree = PoseidonMerkleTree.fromLeaves(unique.map(wallet => walletLeaf(wallet)), depth);
+    return new RecipientRegistry(tree, unique);
+  }
+
+  /**
+   * Stellt eine Registry aus `snapshot()` wieder her:
+   * [Anzahl Wallets (u32 LE), Wallets (n * 32), Baum-Snapshot]
+   */
+  static fromSnapshot(snapshot: Uint8Array): RecipientRegistry {
+    const data = Buffer.from(snapshot.buffer, snapshot.byteOffset, snapshot.byteLength);
+    const count = data.length >= 4 ? data.readUInt32LE(0) : -1;
+    if (count < 0 || data.length < 4 + count * 32) {
+      throw new Error('Kein Registry-Snapshot');
+    }
+    const wallets = Array.from({ length: count }, (_, i) =>
+      new PublicKey(data.subarray(4 + i * 32, 4 + (i + 1) * 32))
+    );
+    return new RecipientRegistry(PoseidonMerkleTree.fromSnapshot(data.subarray(4 + count * 32)), wallets);
+  }
+
+  /** Anzahl registrierter Wallets */
+  get size(): number {
+    return this.wallets.length;
+  }
+
+  /** Aktuelle Wurzel (`merkle_root` eines Transfers an diese Registry) */
+  get root(): Uint8Array {
+    return this.tree.root;
+  }
+
+  /** Ob ein Wallet registriert ist */
+  has(wallet: PublicKey): boolean {
+    return this.positions.has(wallet.toBase58());
+  }
+
+  /** Registriert ein Wallet und gibt seinen Blattindex zurück (idempotent) */
+  add(wallet: PublicKey): number {
+    const known = this.positions.get(wallet.toBase58());
+    if (known !== undefined) {
+      return known;
+    }
+    const index = this.tree.insert(walletLeaf(wallet));
+    this.wallets.push(wallet);
+    this.positions.set(wallet.toBase58(), index);
+    return index;
+  }
+
+  /** Ersetzt ein registriertes Wallet an seiner Position */
+  replace(previous: PublicKey, next: PublicKey): number {
+    const index = this.indexOf(previous);
+    if (this.has(next)) {
+      throw new Error(`Wallet ${next.toBase58()} ist bereits registriert`);
+    }
+    this.tree.update(index, walletLeaf(next));
+    this.wallets[index] = next;
+    this.positions.delete(previous.toBase58());
+    this.positions.set(next.toBase58(), index);
+    return index;
+  }
+
+  /** Proof für ein registriertes Wallet (ohne Hashen) */
+  proofFor(wallet: PublicKey): RecipientProof {
+    const index = this.indexOf(wallet);
+    return {
+      index,
+      leaf: this.tree.leaf(index),
+      root: this.tree.root,
+      proof: this.tree.proof(index)
+    };
+  }
+
+  /** Serialisiert Wallets und Baum (siehe `fromSnapshot`) */
+  snapshot(): Buffer {
+    const count = Buffer.alloc(4);
+    count.writeUInt32LE(this.wallets.length);
+    return Buffer.concat([count, ...this.wallets.map(wallet => wallet.toBuffer()), this.tree.snapshot()]);
+  }
+
+  private indexOf(wallet: PublicKey): number {
+    const index = this.positions.get(wallet.toBase58());
+    if (index === undefined) {
+      throw new Error(`Wallet ${wallet.toBase58()} ist nicht registriert`);
+    }
+    return index;
+  }
+}
@@ -0,0 +1,67 @@
+import { PublicKey } from '@solana/web3.js';
+
+/**
+ * Kanonisches Stealth-PDA-Schema (muss mit `stealth_pda.rs` übereinstimmen):
+ * [prefix, hop_index (u8), split_index (u8), seed, bump]
+ * prefix = "split" für echte Splits, "fake" für Fake-Splits
+ */
+export const STEALTH_MAX_HOPS = 4;
+export const STEALTH_SPLITS_PER_HOP = 48;
+export const STEALTH_BUMP_TABLE_LEN = STEALTH_MAX_HOPS * STEALTH_SPLITS_PER_HOP;
+
+/**
+ * Leitet den Stealth-Seed ab, den das Programm bei `initialize` aus
+ * Challenge und Payer berechnet
+ */
+export function deriveStealthSeed(
+  programId: PublicKey,
+  challenge: Uint8Array,
+  payer: PublicKey
+): Uint8Array {
+  const [seedKey] = PublicKey.findProgramAddressSync(
+    [Buffer.from('zeclipse'), Buffer.from(challenge), payer.toBuffer()],
+    programId
+  );
+  return seedKey.toBytes();
+}
+
+/**
+ * Leitet eine Stealth-PDA inklusive Bump ab
+ */
+export function findStealthPda(
+  programId: PublicKey,
+  seed: Uint8Array,
+  hopIndex: number,
+  splitIndex: number,
+  isFake: boolean
+): [PublicKey, number] {
+  return PublicKey.findProgramAddressSync(
+    [
+      Buffer.from(isFake ? 'fake' : 'split'),
+      Buffer.from([hopIndex]),
+      Buffer.from([splitIndex]),
+      Buffer.from(seed)
+    ],
+    programId
+  );
+}
+
+/**
+ * Berechnet die gepackte Bump-Tabelle (4 Hops x 48 Splits) off-chain.
+ * Sie wird bei `initialize` im TransferState hinterlegt, damit das Programm
+ * pro Split nur noch ein `create_program_address` ausführt.
+ */
+export function computeStealthBumpTable(
+  programId: PublicKey,
+  seed: Uint8Array,
+  realSplits: number = 4
+): number[] {
+  const table: number[] = new Array(STEALTH_BUMP_TABLE_LEN).fill(0);
+  for (let hop = 0; hop < STEALTH_MAX_HOPS; hop++) {
+    for (let split = 0; split < STEALTH_SPLITS_PER_HOP; split++) {
+      const [, bump] = findStealthPda(programId, seed, hop, split, split >= realSplits);
+      table[hop * STEALTH_SPLITS_PER_HOP + split] = bump;
+    }
+  }
+  return table;
+}
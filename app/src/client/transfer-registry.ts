@@ -0,0 +1,90 @@
+import { PublicKey } from '@solana/web3.js';
+
+/**
+ * Transfer-Nonces (muss mit `transfer_nonce_seed` und `TransferRegistry` im
+ * Programm übereinstimmen):
+ *
+ * Transfer-State: [b"transfer", owner, nonce (u32 LE, entfällt für Nonce 0)]
+ * Registry:       [b"transfer_registry", owner]
+ *
+ * Nonce 0 ist der Standard-Transfer eines Wallets und braucht keine Registry.
+ * Jede andere Nonce belegt bis zum Finalisieren oder Erstatten einen der
+ * `MAX_OPEN_TRANSFERS` Plätze der Registry.
+ */
+export const MAX_OPEN_TRANSFERS = 16;
+
+/** Nonce-Seed der Transfer-State-PDA (leer für Nonce 0) */
+export function transferNonceSeed(nonce: number): Buffer {
+  if (!Number.isInteger(nonce) || nonce < 0 || nonce > 0xffff_ffff) {
+    throw new Error(`Ungültige Transfer-Nonce: ${nonce}`);
+  }
+  if (nonce === 0) {
+    return Buffer.alloc(0);
+  }
+  const seed = Buffer.alloc(4);
+  seed.writeUInt32LE(nonce);
+  return seed;
+}
+
+/** Leitet die Transfer-State-PDA eines Wallets für `nonce` ab */
+export function deriveTransferState(programId: PublicKey, owner: PublicKey, nonce: number = 0): PublicKey {
+  const seeds = [Buffer.from('transfer'), owner.toBuffer()];
+  if (nonce !== 0) {
+    seeds.push(transferNonceSeed(nonce));
+  }
+  return PublicKey.findProgramAddressSync(seeds, programId)[0];
+}
+
+/** Leitet die Transfer-Registry eines Wallets ab */
+export function deriveTransferRegistry(programId: PublicKey, owner: PublicKey): PublicKey {
+  return PublicKey.findProgramAddressSync(
+    [Buffer.from('transfer_registry'), owner.toBuffer()],
+    programId
+  )[0];
+}
+
+/**
+ * Vergibt Nonces für parallele Transfers eines Wallets.
+ *
+ * Startet mit dem On-Chain-Stand der Registry (offene Nonces und
+ * `next_nonce`) und reserviert lokal, damit gleichzeitig gestartete
+ * Transfers nie dieselbe Nonce wählen, bevor ihre Initialisierung gelandet ist.
+ */
+export class NonceAllocator {
+  private readonly taken: Set<number>;
+  private next: number;
+
+  constructor(openNonces: number[] = [], nextNonce: number = 1) {
+    this.taken = new Set(openNonces);
+    this.next = Math.max(1, nextNonce);
+  }
+
+  /** Anzahl belegter Plätze (on-chain offen oder lokal reserviert) */
+  get inUse(): number {
+    return this.taken.size;
+  }
+
+  /** Freie Plätze der Registry */
+  get available(): number {
+    return Math.max(0, MAX_OPEN_TRANSFERS - this.taken.size);
+  }
+
+  /** Reserviert die nächste freie Nonce */
+  acquire(): number {
+    if (this.available === 0) {
+      throw new Error(`Bereits ${MAX_OPEN_TRANSFERS} Transfers offen`);
+    }
+    while (this.taken.has(this.next) || this.next === 0) {
+      this.next = (this.next + 1) % 0x1_0000_0000;
+    }
+    const nonce = this.next;
+    this.taken.add(nonce);
+    this.next = (nonce + 1) % 0x1_0000_0000;
+    return nonce;
+  }
+
+  /** Gibt eine Nonce nach Finalisieren oder Erstatten frei */
+  release(nonce: number): void {
+    this.taken.delete(nonce);
+  }
+}
@@ -3,12 +3,42 @@ import {
   Keypair,
   PublicKey,
   Transaction,
-  TransactionInstruction,
-  sendAndConfirmTransaction
+  TransactionInstruction
 } from '@solana/web3.js';
+import { randomBytes } from 'crypto';
 import { Program, AnchorProvider, web3, BN, Idl } from '@project-serum/anchor';
 import { ZEclipseProofGenerator } from '../proof-generator';
+import { ProofBackend } from '../proof-generator/proof-job';
 import { IDL } from '../idl/zeclipse';
+import { deriveStealthSeed, computeStealthBumpTable } from './stealth-pda';
+import {
+  BatchSplitAccount,
+  batchCuEstimate,
+  planBatchHops,
+  realSplitAccounts,
+  planReclaim,
+  reclaimCuEstimate
+} from './batch-plan';
+import { ComputeUnitEstimator } from './compute-estimator';
+import {
+  buildV0Transaction,
+  collectTransferAddresses,
+  createTransferLookupTable,
+  deactivateTransferLookupTable,
+  sendV0Transaction
+} from './lookup-table';
+import { PipelineError, PipelineStep, submitPipelined } from './hop-pipeline';
+import { NetworkStateCache } from './network-state-cache';
+import { AccountBatcher, TransferStatus } from './account-batcher';
+import { buildMerkleMultiproof, MerkleHashFn, MerkleMultiproof } from './merkle-multiproof';
+import { poseidonHashPair } from './poseidon';
+import { walletLeaf } from './poseidon-merkle-tree';
+import {
+  deriveTransferRegistry,
+  deriveTransferState,
+  MAX_OPEN_TRANSFERS,
+  NonceAllocator
+} from './transfer-registry';
 import {
   calculateEfficiency,
   getEfficiencySummary,
@@ -16,14 +46,53 @@ import {
   EfficiencyResult
 } from '../efficiency/cost-efficiency';
 
+/** CU-Limit für Schritte, deren Form noch nicht gemessen wurde */
+const DEFAULT_STEP_CU = 400_000;
+
+/** Optionen für `executeAnonymousTransfer` */
+export interface TransferOptions {
+  /**
+   * Alle Transaktionen vorab signieren und jeden Schritt senden, sobald der
+   * vorherige `processed` ist (Standard). `false` wartet nach jedem Schritt
+   * auf `confirmed`.
+   */
+  pipelined?: boolean;
+  /** Empfänger des DEV-Anteils, falls ein fehlgeschlagener Transfer erstattet wird */
+  refundDevAccount?: PublicKey;
+  /**
+   * Transfer-Nonce des Wallets (Standard: 0). Nonces ungleich 0 erfordern
+   * die Transfer-Registry (`openTransferRegistry`).
+   */
+  nonce?: number;
+}
+
+/** Ein Transfer für `executeConcurrentTransfers` */
+export interface ConcurrentTransfer {
+  amount: number;
+  recipient: PublicKey;
+  additionalRecipients?: PublicKey[];
+}
+
 export class ZEclipseClient {
   private connection: Connection;
   private wallet: Keypair;
   private program: Program;
-  private proofGenerator: ZEclipseProofGenerator;
+  private proofGenerator: ProofBackend;
+  private networkState: NetworkStateCache;
+  private accounts: AccountBatcher;
+  private computeEstimator: ComputeUnitEstimator;
   private showEfficiencyInfo: boolean = true; // Standardmäßig aktiviert
   
-  constructor(connection: Connection, wallet: Keypair, programId: PublicKey) {
+  /**
+   * @param proofBackend Proof-Generierung; ein `ProofPool` verlagert sie in
+   *   Worker-Threads (Standard: im aktuellen Thread)
+   */
+  constructor(
+    connection: Connection,
+    wallet: Keypair,
+    programId: PublicKey,
+    proofBackend: ProofBackend = new ZEclipseProofGenerator()
+  ) {
     this.connection = connection;
     this.wallet = wallet;
     
@@ -49,8 +118,10 @@ export class ZEclipseClient {
     // Typ-Assertion für IDL, um Kompatibilität mit Anchor-Programm sicherzustellen
     this.program = new Program(IDL as Idl, programId, provider);
     
-    // Proof-Generator initialisieren
-    this.proofGenerator = new ZEclipseProofGenerator();
+    this.proofGenerator = proofBackend;
+    this.networkState = NetworkStateCache.forConnection(connection);
+    this.accounts = AccountBatcher.forConnection(connection);
+    this.computeEstimator = new ComputeUnitEstimator(connection);
   }
   
   /**
@@ -83,12 +154,17 @@ export class ZEclipseClient {
    * @param amount Betrag in Lamports
    * @param recipient Empfänger-Pubkey
    * @param additionalRecipients Weitere Empfänger-Wallets für Multi-Wallet-Transfers (max. 5 zusätzliche)
+   * @param options Submission-Modus und Refund-Einstellungen
    */
   async executeAnonymousTransfer(
     amount: number,
     recipient: PublicKey,
-    additionalRecipients: PublicKey[] = []
+    additionalRecipients: PublicKey[] = [],
+    options: TransferOptions = {}
   ): Promise<string> {
+    const pipelined = options.pipelined ?? true;
+    const nonce = options.nonce ?? 0;
+    
     // Begrenzen auf maximal 6 Empfänger (Haupt + 5 weitere)
     const validAdditionalRecipients = additionalRecipients.slice(0, 5);
     const totalRecipients = 1 + validAdditionalRecipients.length;
@@ -100,108 +176,186 @@ export class ZEclipseClient {
       console.log(getSimpleEfficiencyDisplay(amount, totalRecipients));
     }
     
-    // 1. Initialen Proof generieren
-    console.log('Generiere initialen Proof...');
-    const initialProof = await this.proofGenerator.generateInitialProof(
-      BigInt(amount),
-      this.wallet.publicKey,
-      recipient
-    );
+    // 1. Transfer-State-PDA ableiten (eigene Adresse je Nonce)
+    const transferStatePda = deriveTransferState(this.program.programId, this.wallet.publicKey, nonce);
+    const transferRegistry = this.registryAccount(nonce);
+    // Prioritätsgebühr nach der Last auf dem Transfer-State bemessen
+    this.networkState.trackAccounts([transferStatePda]);
     
-    // 2. Transfer-State-PDA ableiten
-    const [transferStatePda] = await PublicKey.findProgramAddress(
-      [Buffer.from('transfer'), this.wallet.publicKey.toBuffer()],
-      this.program.programId
-    );
+    // 2. Stealth-Seed und Bumps off-chain berechnen (identisch zur Ableitung
+    // im Programm), damit alle Hops ohne Abruf des Transfer-States geplant
+    // werden können
+    const challenge = new Uint8Array(randomBytes(32));
+    const seed = deriveStealthSeed(this.program.programId, challenge, this.wallet.publicKey);
+    const stealthBumps = computeStealthBumpTable(this.program.programId, seed);
+    const plans = planBatchHops(this.program.programId, seed);
+    const hopSeeds = plans.flatMap(plan => new Array<Uint8Array>(plan.hopCount).fill(seed));
     
-    // 3. Transfer initialisieren
-    console.log('Initialisiere Transfer...');
-    const initTx = await this.program.methods
-      .initializeTransfer(new BN(amount), initialProof)
-      .accounts({
-        payer: this.wallet.publicKey,
-        transferState: transferStatePda,
-        systemProgram: web3.SystemProgram.programId,
-      })
-      .transaction();
+    // 3. Lookup Table anlegen und alle Proofs parallel generieren. Die Proofs
+    // hängen nur von Betrag, Teilnehmern und Seed ab, nicht vom On-Chain-Zustand.
+    console.log('Generiere Proofs und Lookup Table...');
+    const allRecipients = [recipient, ...validAdditionalRecipients];
+    // Die Merkle-Root über alle Empfänger wird bei der Initialisierung als
+    // Adresse des Root-Accounts festgeschrieben; die Finalisierung zahlt alle
+    // Empfänger in einer Instruktion und beweist sie mit einem Multiproof
+    const recipientSet = this.createRecipientMultiproof(allRecipients);
+    const [initialProof, finalProof, lookupTable] = await Promise.all([
+      this.proofGenerator.generateInitialProof(BigInt(amount), this.wallet.publicKey, recipient),
+      this.proofGenerator.generateFinalProof(BigInt(amount), this.wallet.publicKey, recipient, hopSeeds),
+      createTransferLookupTable(
+        this.connection,
+        this.wallet,
+        collectTransferAddresses(this.program.programId, transferStatePda, seed, allRecipients)
+      )
+    ]);
+    console.log(`Lookup Table aktiv: ${lookupTable.key.toBase58()} (${lookupTable.state.addresses.length} Adressen)`);
     
-    const initSignature = await sendAndConfirmTransaction(
-      this.connection,
-      initTx,
-      [this.wallet]
-    );
-    console.log(`Transfer initialisiert: ${initSignature}`);
-    
-    // 4. Transfer-State abrufen
-    const transferState = await this.program.account.transferState.fetch(transferStatePda);
-    
-    // Typkorrektur für den Seed (von unknown zu ArrayBuffer oder Array<number>)
-    const seedData = transferState.seed as ArrayBuffer;
-    const seed = new Uint8Array(seedData);
-    
-    // 5. Drei Hops ausführen
-    const hopSeeds: Uint8Array[] = [];
-    for (let hopIndex = 0; hopIndex < 3; hopIndex++) {
-      console.log(`Führe Hop ${hopIndex} aus...`);
-      
-      // Echte Splits generieren (8 Stück)
-      const realSplits = this.generateRealSplits(amount, 8);
-      
-      // Hop-Proof generieren
-      const hopProof = await this.proofGenerator.generateHopProof(
-        hopIndex,
-        seed,
-        realSplits.map(s => BigInt(s))
-      );
-      
-      // Hop-Seed für finalen Proof speichern
-      hopSeeds.push(seed);
-      
-      // Hop ausführen
-      const hopTx = await this.program.methods
-        .executeHop(hopIndex, hopProof)
+    // 4. Instruktionen aller Schritte bauen: Initialisierung, Batch-Hops
+    // (so viele Hops pro Transaktion, wie unter CU- und Account-Limit
+    // passen), Finalisierung. `fallbackUnits` gilt, solange die Form noch
+    // nicht gemessen wurde.
+    const steps: { label: string; ix: TransactionInstruction; fallbackUnits: number }[] = [];
+    steps.push({
+      label: 'Initialisierung',
+      fallbackUnits: DEFAULT_STEP_CU,
+      ix: await this.program.methods
+        .initializeTransfer(nonce, new BN(amount), initialProof, Array.from(challenge), stealthBumps, totalRecipients)
         .accounts({
-          authority: this.wallet.publicKey,
+          payer: this.wallet.publicKey,
           transferState: transferStatePda,
+          recipient,
+          merkleRootAccount: new PublicKey(recipientSet.root),
           systemProgram: web3.SystemProgram.programId,
+          transferRegistry,
         })
-        .transaction();
-      
-      const hopSignature = await sendAndConfirmTransaction(
-        this.connection,
-        hopTx,
-        [this.wallet]
-      );
-      console.log(`Hop ${hopIndex} abgeschlossen: ${hopSignature}`);
+        .instruction()
+    });
+    
+    for (const plan of plans) {
+      steps.push({
+        label: `Batch ${plan.batchIndex} (Hops ${plan.firstHop}-${plan.firstHop + plan.hopCount - 1}, ${plan.accounts.length} Split-Accounts)`,
+        fallbackUnits: batchCuEstimate(plan.hopCount, plan.accounts.length),
+        ix: await this.program.methods
+          .executeBatchHop(plan.batchIndex, plan.hopCount, plan.accounts.map(a => a.splitKey))
+          .accounts({
+            authority: this.wallet.publicKey,
+            transferState: transferStatePda,
+            systemProgram: web3.SystemProgram.programId,
+          })
+          .remainingAccounts(plan.accounts.map(a => ({
+            pubkey: a.pubkey,
+            isWritable: true,
+            isSigner: false
+          })))
+          .instruction()
+      });
     }
     
-    // 6. Finalen Proof generieren
-    console.log('Generiere finalen Proof...');
-    const finalProof = await this.proofGenerator.generateFinalProof(
-      BigInt(amount),
-      this.wallet.publicKey,
-      recipient,
-      hopSeeds
-    );
+    const splitAccounts = plans.flatMap(plan => plan.accounts);
+    steps.push({
+      label: 'Finalisierung',
+      fallbackUnits: DEFAULT_STEP_CU,
+      ix: await this.program.methods
+        .finalizeTransfer(finalProof, totalRecipients > 1 ? recipientSet.proof : Buffer.alloc(0))
+        .accounts({
+          authority: this.wallet.publicKey,
+          transferState: transferStatePda,
+          recipient: recipient,
+          systemProgram: web3.SystemProgram.programId,
+        })
+        // Nach den Empfängern die echten Splits aller Hops, deren Beträge ausgezahlt werden
+        .remainingAccounts([
+          ...validAdditionalRecipients,
+          ...realSplitAccounts(splitAccounts).map(account => account.pubkey)
+        ].map(pubkey => ({
+          pubkey,
+          isWritable: true,
+          isSigner: false
+        })))
+        .instruction()
+    });
     
-    // 7. Transfer finalisieren
-    console.log('Finalisiere Transfer...');
-    const finalizeTx = await this.program.methods
-      .finalizeTransfer(finalProof)
-      .accounts({
-        authority: this.wallet.publicKey,
-        transferState: transferStatePda,
-        recipient: recipient,
-        systemProgram: web3.SystemProgram.programId,
-      })
-      .transaction();
+    // Rent der Split-PDAs und des Transfer-States an das Wallet zurückholen
+    const finalizeStep = steps.length - 1;
+    for (const reclaim of await this.reclaimInstructions(transferStatePda, splitAccounts, nonce)) {
+      steps.push({ label: 'Rent-Rückgewinnung', ...reclaim });
+    }
     
-    const finalizeSignature = await sendAndConfirmTransaction(
-      this.connection,
-      finalizeTx,
-      [this.wallet]
-    );
+    // 5. Schritte senden
+    let signatures: string[];
+    try {
+      if (pipelined) {
+        // Alle Schritte vorab mit einem Blockhash signieren. Simulieren ist
+        // hier nicht möglich (jeder Schritt setzt den vorherigen voraus), daher
+        // gemessene Limits aus dem Cache, sonst das Fallback der Form.
+        const blockhash = await this.networkState.getBlockhash();
+        const signed: PipelineStep[] = steps.map(step => ({
+          label: step.label,
+          transaction: buildV0Transaction(
+            this.wallet,
+            [
+              ...this.networkState.computeBudgetInstructions(
+                this.computeEstimator.cachedLimit([step.ix]) ?? step.fallbackUnits
+              ),
+              step.ix
+            ],
+            blockhash.blockhash,
+            [lookupTable]
+          )
+        }));
+        signatures = await submitPipelined(this.connection, signed, blockhash, 'confirmed',
+          (step, signature) => console.log(`${step.label} gelandet: ${signature}`));
+        
+        // Verbrauchte CUs der noch ungemessenen Formen für spätere Transfers übernehmen
+        const landed = signatures;
+        this.computeEstimator
+          .recordLanded(steps.map((step, i) => ({ instructions: [step.ix], signature: landed[i] })))
+          .catch(error => console.warn('CU-Verbrauch konnte nicht übernommen werden:', error));
+      } else {
+        signatures = [];
+        for (const step of steps) {
+          try {
+            // Der vorherige Schritt ist bestätigt, die Simulation ist also aussagekräftig
+            const units = await this.computeEstimator.estimate(
+              this.wallet, [step.ix], [lookupTable], step.fallbackUnits
+            );
+            const signature = await sendV0Transaction(
+              this.connection, this.wallet, [step.ix], [lookupTable], [], units
+            );
+            console.log(`${step.label} bestätigt: ${signature}`);
+            signatures.push(signature);
+          } catch (error) {
+            throw new PipelineError(signatures.length, step.label, signatures, error);
+          }
+        }
+      }
+    } catch (error) {
+      if (error instanceof PipelineError && error.landed.length > finalizeStep) {
+        // Der Transfer ist finalisiert, nur die Rent-Rückgewinnung fehlt noch
+        console.warn(`${error.message}; hole Rent einzeln zurück...`);
+        signatures = error.landed;
+        await this.reclaimTransfer(splitAccounts, nonce)
+          .catch(reclaimError => console.warn('Rent-Rückgewinnung fehlgeschlagen:', reclaimError));
+      } else {
+        // Nach erfolgreicher Initialisierung liegen die Lamports im
+        // Transfer-State: den Transfer über `triggerRefund` zurückabwickeln
+        if (error instanceof PipelineError && error.landed.length > 0) {
+          console.error(`${error.message}; erstatte Transfer...`);
+          await this.refundTransfer(options.refundDevAccount, nonce);
+          await this.reclaimTransfer(splitAccounts, nonce);
+        }
+        await this.deactivateLookupTable(lookupTable.key);
+        throw error;
+      }
+    }
+    
+    const finalizeSignature = signatures[finalizeStep];
     console.log(`Transfer finalisiert: ${finalizeSignature}`);
+    this.networkState.untrackAccounts([transferStatePda]);
+    this.accounts.invalidate([transferStatePda]);
+    
+    // 6. Lookup Table deaktivieren (Miete kann nach der Abkühlphase zurückgeholt werden)
+    await this.deactivateLookupTable(lookupTable.key);
     
     // Zeige detaillierte Effizienz-Zusammenfassung nach Transfer, wenn aktiviert
     if (this.showEfficiencyInfo) {
@@ -212,23 +366,196 @@ export class ZEclipseClient {
   }
   
   /**
-   * Generiert echte Splits für einen Hop
+   * Erzeugt einen Merkle-Multiproof über die Empfänger eines
+   * Multi-Wallet-Transfers. Die Empfänger (Haupt-Empfänger + bis zu 5 weitere)
+   * liefern in dieser Reihenfolge die Blätter des Baums (`walletLeaf`); ein
+   * Proof für alle Empfänger ersetzt sechs Einzelpfade und hasht jeden
+   * inneren Knoten einmal.
+   * @param positions Zu beweisende Empfänger (Standard: alle)
+   * @param hashPair Knoten-Hash (Standard: Poseidon wie `HashContext::hash_pair`)
    */
-  private generateRealSplits(totalAmount: number, count: number): number[] {
-    const splits: number[] = [];
-    let remaining = totalAmount;
+  createRecipientMultiproof(
+    recipients: PublicKey[],
+    positions?: number[],
+    hashPair: MerkleHashFn = poseidonHashPair
+  ): MerkleMultiproof {
+    const leaves = recipients.slice(0, 6).map(recipient => walletLeaf(recipient, hashPair));
+    return buildMerkleMultiproof(leaves, positions ?? leaves.map((_, i) => i), hashPair);
+  }
+  
+  /**
+   * Führt mehrere Transfers desselben Wallets parallel aus. Jeder Transfer
+   * erhält eine eigene Nonce und damit einen eigenen Transfer-State; höchstens
+   * `concurrency` Transfers laufen gleichzeitig (begrenzt durch die freien
+   * Plätze der Registry). Die Registry wird bei Bedarf angelegt.
+   * @returns Ergebnis je Transfer in Eingabereihenfolge
+   */
+  async executeConcurrentTransfers(
+    transfers: ConcurrentTransfer[],
+    concurrency: number = 4,
+    options: Omit<TransferOptions, 'nonce'> = {}
+  ): Promise<PromiseSettledResult<string>[]> {
+    const nonces = await this.openTransferRegistry();
+    const workers = Math.min(concurrency, nonces.available, transfers.length);
+    if (transfers.length > 0 && workers < 1) {
+      throw new Error(`Keine freie Transfer-Nonce (${MAX_OPEN_TRANSFERS} Transfers offen)`);
+    }
     
-    // Erste (count-1) Splits zufällig generieren
-    for (let i = 0; i < count - 1; i++) {
-      // Zufälligen Anteil des verbleibenden Betrags nehmen
-      const splitAmount = Math.floor(remaining * Math.random() * 0.5);
-      splits.push(splitAmount);
-      remaining -= splitAmount;
+    const results: PromiseSettledResult<string>[] = new Array(transfers.length);
+    let next = 0;
+    const worker = async () => {
+      while (next < transfers.length) {
+        const index = next++;
+        const { amount, recipient, additionalRecipients } = transfers[index];
+        const nonce = nonces.acquire();
+        try {
+          const signature = await this.executeAnonymousTransfer(
+            amount, recipient, additionalRecipients, { ...options, nonce }
+          );
+          results[index] = { status: 'fulfilled', value: signature };
+          nonces.release(nonce);
+        } catch (error) {
+          results[index] = { status: 'rejected', reason: error };
+          // Ein `PipelineError` heißt: nichts gelandet oder bereits erstattet.
+          // Sonst kann der Transfer noch offen sein und die Nonce bleibt belegt.
+          if (error instanceof PipelineError) {
+            nonces.release(nonce);
+          }
+        }
+      }
+    };
+    
+    await Promise.all(Array.from({ length: workers }, worker));
+    return results;
+  }
+  
+  /**
+   * Fortschritt der Transfers des Wallets für die gegebenen Nonces, ohne den
+   * ganzen Transfer-State zu dekodieren: gleichzeitige Abfragen werden zu
+   * `getMultipleAccounts`-Aufrufen gebündelt, die nur die heißen Felder laden
+   * (`null` für nicht existierende Transfers)
+   */
+  getTransferStatuses(nonces: number[] = [0]): Promise<(TransferStatus | null)[]> {
+    return Promise.all(nonces.map(nonce =>
+      this.accounts.getTransferStatus(deriveTransferState(this.program.programId, this.wallet.publicKey, nonce))
+    ));
+  }
+  
+  /**
+   * Legt die Transfer-Registry des Wallets an, falls sie fehlt, und liefert
+   * einen Nonce-Vergeber mit ihrem aktuellen Stand
+   */
+  async openTransferRegistry(): Promise<NonceAllocator> {
+    const registry = deriveTransferRegistry(this.program.programId, this.wallet.publicKey);
+    const existing = await this.program.account.transferRegistry.fetchNullable(registry);
+    if (existing) {
+      const openNonces = (existing.openNonces as number[]).slice(0, existing.openCount as number);
+      return new NonceAllocator(openNonces, existing.nextNonce as number);
     }
     
-    // Letzten Split mit dem Rest füllen
-    splits.push(remaining);
+    const openIx = await this.program.methods
+      .openTransferRegistry()
+      .accounts({
+        owner: this.wallet.publicKey,
+        transferRegistry: registry,
+        systemProgram: web3.SystemProgram.programId,
+      })
+      .instruction();
+    const units = await this.computeEstimator.estimate(this.wallet, [openIx], [], DEFAULT_STEP_CU);
+    const signature = await sendV0Transaction(this.connection, this.wallet, [openIx], [], [], units);
+    console.log(`Transfer-Registry angelegt: ${signature}`);
+    return new NonceAllocator();
+  }
+  
+  /**
+   * Bricht einen laufenden Transfer des Wallets ab und erstattet die Lamports
+   * @param devAccount Empfänger des DEV-Anteils (Standard: das eigene Wallet)
+   * @param nonce Nonce des Transfers (Standard: 0)
+   */
+  async refundTransfer(devAccount: PublicKey = this.wallet.publicKey, nonce: number = 0): Promise<string> {
+    const transferStatePda = deriveTransferState(this.program.programId, this.wallet.publicKey, nonce);
+    
+    const refundIx = await this.program.methods
+      .triggerRefund()
+      .accounts({
+        authority: this.wallet.publicKey,
+        transferState: transferStatePda,
+        owner: this.wallet.publicKey,
+        devAccount,
+        systemProgram: web3.SystemProgram.programId,
+      })
+      .instruction();
     
-    return splits;
+    const units = await this.computeEstimator.estimate(this.wallet, [refundIx], [], DEFAULT_STEP_CU);
+    const signature = await sendV0Transaction(this.connection, this.wallet, [refundIx], [], [], units);
+    console.log(`Transfer erstattet: ${signature}`);
+    return signature;
+  }
+  
+  /**
+   * Schließt die Split-PDAs und den Transfer-State eines finalisierten oder
+   * erstatteten Transfers; Lamports und Miete gehen an das Wallet zurück
+   * @param splitAccounts Split-Accounts aller Hops (siehe `planBatchHops`)
+   * @param nonce Nonce des Transfers (Standard: 0)
+   * @returns Signaturen der Reclaim-Transaktionen
+   */
+  async reclaimTransfer(splitAccounts: BatchSplitAccount[], nonce: number = 0): Promise<string[]> {
+    const transferStatePda = deriveTransferState(this.program.programId, this.wallet.publicKey, nonce);
+    const signatures: string[] = [];
+    for (const { ix, fallbackUnits } of await this.reclaimInstructions(transferStatePda, splitAccounts, nonce)) {
+      const units = await this.computeEstimator.estimate(this.wallet, [ix], [], fallbackUnits);
+      signatures.push(await sendV0Transaction(this.connection, this.wallet, [ix], [], [], units));
+    }
+    console.log(`Rent zurückgeholt: ${signatures.join(', ')}`);
+    return signatures;
+  }
+  
+  /**
+   * Reclaim-Instruktionen eines Transfers (siehe `planReclaim`)
+   */
+  private async reclaimInstructions(
+    transferStatePda: PublicKey,
+    splitAccounts: BatchSplitAccount[],
+    nonce: number
+  ): Promise<{ ix: TransactionInstruction; fallbackUnits: number }[]> {
+    return Promise.all(planReclaim(splitAccounts).map(async plan => ({
+      fallbackUnits: reclaimCuEstimate(plan.accounts.length),
+      ix: await this.program.methods
+        .reclaimTransfer(plan.accounts.map(a => a.splitKey), plan.closeState)
+        .accounts({
+          authority: this.wallet.publicKey,
+          transferState: transferStatePda,
+          owner: this.wallet.publicKey,
+          systemProgram: web3.SystemProgram.programId,
+          transferRegistry: this.registryAccount(nonce),
+        })
+        .remainingAccounts(plan.accounts.map(a => ({
+          pubkey: a.pubkey,
+          isWritable: true,
+          isSigner: false
+        })))
+        .instruction()
+    })));
+  }
+  
+  /**
+   * Registry-Account für Instruktionen eines Transfers; ohne Nonce steht die
+   * Programm-ID für den fehlenden optionalen Account
+   */
+  private registryAccount(nonce: number): PublicKey {
+    return nonce === 0
+      ? this.program.programId
+      : deriveTransferRegistry(this.program.programId, this.wallet.publicKey);
+  }
+  
+  /**
+   * Deaktiviert eine Lookup Table; Fehler werden nur protokolliert
+   */
+  private async deactivateLookupTable(lookupTable: PublicKey): Promise<void> {
+    try {
+      await deactivateTransferLookupTable(this.connection, this.wallet, lookupTable);
+    } catch (error) {
+      console.warn(`Lookup Table ${lookupTable.toBase58()} konnte nicht deaktiviert werden:`, error);
+    }
   }
 }
\ No newline at end of file
@@ -17,6 +17,10 @@
 
 import { Connection, Keypair, PublicKey, ComputeBudgetProgram, Transaction } from '@solana/web3.js';
 import { ZEclipseClient } from '../client/zeclipse-client';
+import { ProofPool } from '../proof-generator/proof-pool';
+import { NetworkStateCache } from '../client/network-state-cache';
+import { AccountBatcher } from '../client/account-batcher';
+import { RecipientProof, RecipientRegistry } from '../client/recipient-registry';
 import { EfficiencyResult, CostBreakdown, calculateEfficiency, calculateBaselineEfficiency } from '../efficiency/cost-efficiency';
 
 /**
@@ -31,6 +35,17 @@ export interface DAppConfig {
   useDevnet?: boolean;
   /** Programm-ID für die ZEclipse-Applikation */
   programId?: string;
+  /**
+   * Anzahl der Proof-Worker-Threads. Bei einem Wert > 0 laufen bis zu so
+   * viele Proofs gleichzeitig außerhalb des Event-Loops; ohne Angabe wird
+   * im aktuellen Thread bewiesen.
+   */
+  proofWorkers?: number;
+  /**
+   * Snapshot der Empfänger-Registry (`saveRecipientRegistry`); ohne Angabe
+   * startet die Registry leer
+   */
+  recipientRegistrySnapshot?: Uint8Array;
 }
 
 /**
@@ -88,6 +103,9 @@ export enum ZEclipseErrorCode {
 export class ZEclipseDAppConnector {
   private connection: Connection;
   private zeclipseClient: ZEclipseClient;
+  private proofPool?: ProofPool;
+  private registrySnapshot?: Uint8Array;
+  private registry?: RecipientRegistry;
   
   /**
    * Creates a new DApp connector instance
@@ -103,8 +121,80 @@ export class ZEclipseDAppConnector {
     // Verwende eine gültige Base58-Programm-ID als Fallback
     const programId = new PublicKey(config.programId || '11111111111111111111111111111111');
     
+    // Proof-Pool nur anlegen, wenn Worker konfiguriert sind; alle Transfers
+    // des Connectors teilen sich den Pool
+    if (config.proofWorkers && config.proofWorkers > 0) {
+      this.proofPool = new ProofPool(config.proofWorkers);
+    }
+    
     // ZEclipseClient mit allen erforderlichen Parametern initialisieren
-    this.zeclipseClient = new ZEclipseClient(this.connection, tempKeypair, programId);
+    this.zeclipseClient = new ZEclipseClient(this.connection, tempKeypair, programId, this.proofPool);
+    this.registrySnapshot = config.recipientRegistrySnapshot;
+  }
+  
+  /**
+   * Recipient wallet registry (incremental Poseidon Merkle tree), created
+   * on first use from the configured snapshot
+   */
+  private get recipientRegistry(): RecipientRegistry {
+    if (!this.registry) {
+      this.registry = this.registrySnapshot
+        ? RecipientRegistry.fromSnapshot(this.registrySnapshot)
+        : new RecipientRegistry();
+      this.registrySnapshot = undefined;
+    }
+    return this.registry;
+  }
+  
+  /**
+   * Adds recipient wallets to the registry (already registered wallets keep
+   * their leaf); each new wallet costs one Merkle path update
+   * 
+   * @param addresses Recipient wallet addresses
+   * @returns The new registry root
+   */
+  registerRecipients(addresses: string[]): Uint8Array {
+    const wallets = addresses.map(address => new PublicKey(address));
+    for (const wallet of wallets) {
+      this.recipientRegistry.add(wallet);
+    }
+    return this.recipientRegistry.root;
+  }
+  
+  /**
+   * Returns the Merkle proof of a registered recipient against the current
+   * registry root; served from the stored nodes without hashing. The registry
+   * is client-side only: no instruction accepts this proof, check it with
+   * `verifyRecipientProof`
+   * 
+   * @param address Registered recipient wallet address
+   */
+  getRecipientProof(address: string): RecipientProof {
+    return this.recipientRegistry.proofFor(new PublicKey(address));
+  }
+  
+  /**
+   * Current root of the recipient registry
+   */
+  getRecipientRoot(): Uint8Array {
+    return this.recipientRegistry.root;
+  }
+  
+  /**
+   * Serializes the recipient registry; pass the snapshot as
+   * `recipientRegistrySnapshot` to restore it without a rebuild
+   */
+  saveRecipientRegistry(): Buffer {
+    return this.recipientRegistry.snapshot();
+  }
+  
+  /**
+   * Releases the proof workers and the network state refresh;
+   * pending proofs are cancelled
+   */
+  close(): void {
+    this.proofPool?.close();
+    NetworkStateCache.forConnection(this.connection).stop();
   }
   
   /**
@@ -115,6 +205,8 @@ export class ZEclipseDAppConnector {
     try {
       // Test connection and resolve program addresses
       await this.connection.getVersion();
+      // Keep blockhash and priority fees warm for all transfers of this endpoint
+      NetworkStateCache.forConnection(this.connection).start();
       // Note: ZEclipseClient may not have an initialize method depending on implementation
       // We'll assume it exists for now, but this should be verified with actual client code
       return true;
@@ -334,13 +426,16 @@ export class ZEclipseDAppConnector {
   /**
    * Get the current balance of a wallet address
    * 
+   * Concurrent balance reads are batched into `getMultipleAccounts` calls
+   * that fetch no account data (see `AccountBatcher`).
+   * 
    * @param address Wallet address to check
    * @returns Promise resolving to balance in lamports
    */
   async getBalance(address: string): Promise<number> {
     try {
       const pubkey = new PublicKey(address);
-      return await this.connection.getBalance(pubkey);
+      return await AccountBatcher.forConnection(this.connection).getBalance(pubkey);
     } catch (error: any) {
       throw new Error(`Failed to get balance: ${error.message || 'Unknown error'}`);
     }
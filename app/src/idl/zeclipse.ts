@@ -15,13 +15,32 @@ export const IDL = {
           "isMut": true,
           "isSigner": false
         },
+        {
+          "name": "recipient",
+          "isMut": false,
+          "isSigner": false
+        },
+        {
+          "name": "merkleRootAccount",
+          "isMut": false,
+          "isSigner": false
+        },
         {
           "name": "systemProgram",
           "isMut": false,
           "isSigner": false
+        },
+        {
+          "name": "transferRegistry",
+          "isMut": true,
+          "isSigner": false
         }
       ],
       "args": [
+        {
+          "name": "nonce",
+          "type": "u32"
+        },
         {
           "name": "amount",
           "type": "u64"
@@ -29,6 +48,22 @@ export const IDL = {
         {
           "name": "proofData",
           "type": "bytes"
+        },
+        {
+          "name": "challenge",
+          "type": {
+            "array": ["u8", 32]
+          }
+        },
+        {
+          "name": "stealthBumps",
+          "type": {
+            "array": ["u8", 192]
+          }
+        },
+        {
+          "name": "recipientCount",
+          "type": "u8"
         }
       ]
     },
@@ -62,6 +97,42 @@ export const IDL = {
         }
       ]
     },
+    {
+      "name": "executeBatchHop",
+      "accounts": [
+        {
+          "name": "authority",
+          "isMut": true,
+          "isSigner": true
+        },
+        {
+          "name": "transferState",
+          "isMut": true,
+          "isSigner": false
+        },
+        {
+          "name": "systemProgram",
+          "isMut": false,
+          "isSigner": false
+        }
+      ],
+      "args": [
+        {
+          "name": "batchIndex",
+          "type": "u8"
+        },
+        {
+          "name": "hopCount",
+          "type": "u8"
+        },
+        {
+          "name": "splitKeys",
+          "type": {
+            "vec": "u16"
+          }
+        }
+      ]
+    },
     {
       "name": "finalizeTransfer",
       "accounts": [
@@ -90,6 +161,104 @@ export const IDL = {
         {
           "name": "proofData",
           "type": "bytes"
+        },
+        {
+          "name": "recipientProof",
+          "type": "bytes"
+        }
+      ]
+    },
+    {
+      "name": "triggerRefund",
+      "accounts": [
+        {
+          "name": "authority",
+          "isMut": true,
+          "isSigner": true
+        },
+        {
+          "name": "transferState",
+          "isMut": true,
+          "isSigner": false
+        },
+        {
+          "name": "owner",
+          "isMut": true,
+          "isSigner": false
+        },
+        {
+          "name": "devAccount",
+          "isMut": true,
+          "isSigner": false
+        },
+        {
+          "name": "systemProgram",
+          "isMut": false,
+          "isSigner": false
+        }
+      ],
+      "args": []
+    },
+    {
+      "name": "openTransferRegistry",
+      "accounts": [
+        {
+          "name": "owner",
+          "isMut": true,
+          "isSigner": true
+        },
+        {
+          "name": "transferRegistry",
+          "isMut": true,
+          "isSigner": false
+        },
+        {
+          "name": "systemProgram",
+          "isMut": false,
+          "isSigner": false
+        }
+      ],
+      "args": []
+    },
+    {
+      "name": "reclaimTransfer",
+      "accounts": [
+        {
+          "name": "authority",
+          "isMut": true,
+          "isSigner": true
+        },
+        {
+          "name": "transferState",
+          "isMut": true,
+          "isSigner": false
+        },
+        {
+          "name": "owner",
+          "isMut": true,
+          "isSigner": false
+        },
+        {
+          "name": "systemProgram",
+          "isMut": false,
+          "isSigner": false
+        },
+        {
+          "name": "transferRegistry",
+          "isMut": true,
+          "isSigner": false
+        }
+      ],
+      "args": [
+        {
+          "name": "splitKeys",
+          "type": {
+            "vec": "u16"
+          }
+        },
+        {
+          "name": "closeState",
+          "type": "bool"
         }
       ]
     }
@@ -127,6 +296,39 @@ export const IDL = {
           }
         ]
       }
+    },
+    {
+      "name": "TransferRegistry",
+      "type": {
+        "kind": "struct",
+        "fields": [
+          {
+            "name": "owner",
+            "type": "publicKey"
+          },
+          {
+            "name": "bump",
+            "type": "u8"
+          },
+          {
+            "name": "openCount",
+            "type": "u8"
+          },
+          {
+            "name": "nextNonce",
+            "type": "u32"
+          },
+          {
+            "name": "openNonces",
+            "type": {
+              "array": [
+                "u32",
+                16
+              ]
+            }
+          }
+        ]
+      }
     }
   ],
   "events": [
@@ -0,0 +1,56 @@
+/**
+ * Proof-Jobs für den Proof-Pool
+ *
+ * Ein Job beschreibt einen Aufruf von `ZEclipseProofGenerator` in einer Form,
+ * die per Structured Clone an einen Worker übergeben werden kann (Pubkeys als
+ * Bytes, Beträge als `bigint`).
+ */
+
+import { PublicKey } from '@solana/web3.js';
+
+/** Gemeinsame Schnittstelle von `ZEclipseProofGenerator` und `ProofPool` */
+export interface ProofBackend {
+  generateInitialProof(amount: bigint, sender: PublicKey, recipient: PublicKey): Promise<Uint8Array>;
+  generateHopProof(hopIndex: number, seed: Uint8Array, realSplits: bigint[]): Promise<Uint8Array>;
+  generateFinalProof(
+    amount: bigint,
+    sender: PublicKey,
+    recipient: PublicKey,
+    allHopSeeds: Uint8Array[]
+  ): Promise<Uint8Array>;
+}
+
+export type ProofJob =
+  | { kind: 'initial'; amount: bigint; sender: Uint8Array; recipient: Uint8Array }
+  | { kind: 'hop'; hopIndex: number; seed: Uint8Array; realSplits: bigint[] }
+  | { kind: 'final'; amount: bigint; sender: Uint8Array; recipient: Uint8Array; hopSeeds: Uint8Array[] };
+
+/** Nachricht an einen Worker */
+export interface ProofRequest {
+  id: number;
+  job: ProofJob;
+}
+
+/** Antwort eines Workers: entweder `proof` oder `error` */
+export interface ProofResponse {
+  id: number;
+  proof?: Uint8Array;
+  error?: string;
+}
+
+/** Führt einen Job mit dem gegebenen Backend aus */
+export function runProofJob(backend: ProofBackend, job: ProofJob): Promise<Uint8Array> {
+  switch (job.kind) {
+    case 'initial':
+      return backend.generateInitialProof(job.amount, new PublicKey(job.sender), new PublicKey(job.recipient));
+    case 'hop':
+      return backend.generateHopProof(job.hopIndex, job.seed, job.realSplits);
+    case 'final':
+      return backend.generateFinalProof(
+        job.amount,
+        new PublicKey(job.sender),
+        new PublicKey(job.recipient),
+        job.hopSeeds
+      );
+  }
+}
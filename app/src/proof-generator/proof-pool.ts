@@ -0,0 +1,297 @@
+/**
+ * Proof-Pool auf Basis von `worker_threads`
+ *
+ * Die Proof-Generierung läuft in Worker-Threads statt auf dem Event-Loop, so
+ * dass ein Transfer beim Beweisen nicht alle anderen Anfragen des Connectors
+ * blockiert. Der Pool hält höchstens `size` Jobs gleichzeitig in Arbeit
+ * (einen pro Worker), weitere Jobs warten in einer FIFO-Queue.
+ *
+ * Jobs können einzeln oder als Batch eingereicht und über ein `AbortSignal`
+ * abgebrochen werden: wartende Jobs werden aus der Queue entfernt, ein
+ * laufender Job beendet seinen Worker, der beim nächsten Job neu gestartet
+ * wird.
+ *
+ * Der Transport ist über `ProofWorkerFactory` austauschbar; `createInlineWorkerFactory`
+ * führt die Jobs im aktuellen Thread aus (Umgebungen ohne Worker, Tests).
+ */
+
+import { cpus } from 'os';
+import { extname, join } from 'path';
+import { Worker } from 'worker_threads';
+import { PublicKey } from '@solana/web3.js';
+import { ZEclipseProofGenerator } from './index';
+import { ProofBackend, ProofJob, ProofRequest, ProofResponse, runProofJob } from './proof-job';
+
+/** Minimale Worker-Schnittstelle des Pools */
+export interface ProofWorker {
+  postMessage(request: ProofRequest): void;
+  onMessage(listener: (response: ProofResponse) => void): void;
+  onError(listener: (error: Error) => void): void;
+  terminate(): void;
+}
+
+export type ProofWorkerFactory = () => ProofWorker;
+
+/** Fehler eines abgebrochenen Proof-Jobs */
+export class ProofCancelledError extends Error {
+  constructor() {
+    super('Proof-Generierung abgebrochen');
+    this.name = 'ProofCancelledError';
+  }
+}
+
+/** Standardgröße: ein Kern bleibt für den Event-Loop frei */
+export function defaultProofPoolSize(): number {
+  return Math.max(1, cpus().length - 1);
+}
+
+/**
+ * Startet Worker mit `proof-worker`. Unter ts-node wird die TypeScript-Quelle
+ * mit registriertem ts-node geladen, sonst die kompilierte JavaScript-Datei.
+ */
+export function createNodeWorkerFactory(): ProofWorkerFactory {
+  const isTs = extname(__filename) === '.ts';
+  const script = join(__dirname, `proof-worker${isTs ? '.ts' : '.js'}`);
+
+  return () => {
+    const worker = new Worker(script, isTs ? { execArgv: ['-r', 'ts-node/register'] } : undefined);
+    return {
+      postMessage: request => worker.postMessage(request),
+      onMessage: listener => worker.on('message', listener),
+      onError: listener => {
+        worker.on('error', listener);
+        worker.on('exit', code => {
+          if (code !== 0) listener(new Error(`Proof-Worker beendet mit Code ${code}`));
+        });
+      },
+      terminate: () => { void worker.terminate(); }
+    };
+  };
+}
+
+/** Führt Jobs im aktuellen Thread aus (gleiches Protokoll wie ein Worker) */
+export function createInlineWorkerFactory(
+  backend: ProofBackend = new ZEclipseProofGenerator()
+): ProofWorkerFactory {
+  return () => {
+    let listener: (response: ProofResponse) => void = () => {};
+    let terminated = false;
+    return {
+      postMessage: ({ id, job }) => {
+        runProofJob(backend, job).then(
+          proof => { if (!terminated) listener({ id, proof }); },
+          error => { if (!terminated) listener({ id, error: error instanceof Error ? error.message : String(error) }); }
+        );
+      },
+      onMessage: l => { listener = l; },
+      onError: () => {},
+      terminate: () => { terminated = true; }
+    };
+  };
+}
+
+interface PendingJob {
+  id: number;
+  job: ProofJob;
+  resolve: (proof: Uint8Array) => void;
+  reject: (error: Error) => void;
+  signal?: AbortSignal;
+  onAbort?: () => void;
+}
+
+export class ProofPool implements ProofBackend {
+  private readonly size: number;
+  private readonly factory: ProofWorkerFactory;
+  private idle: ProofWorker[] = [];
+  private running = new Map<ProofWorker, PendingJob>();
+  private queue: PendingJob[] = [];
+  private workerCount = 0;
+  private nextId = 0;
+  private closed = false;
+
+  /**
+   * @param size Maximale Anzahl gleichzeitig laufender Proofs
+   * @param factory Erzeugt die Worker (Standard: `worker_threads`)
+   */
+  constructor(size: number = defaultProofPoolSize(), factory: ProofWorkerFactory = createNodeWorkerFactory()) {
+    this.size = Math.max(1, size);
+    this.factory = factory;
+  }
+
+  /** Anzahl laufender Jobs */
+  get inFlight(): number {
+    return this.running.size;
+  }
+
+  /** Anzahl wartender Jobs */
+  get queued(): number {
+    return this.queue.length;
+  }
+
+  /** Reicht einen Job ein */
+  submit(job: ProofJob, signal?: AbortSignal): Promise<Uint8Array> {
+    if (this.closed) {
+      return Promise.reject(new Error('Proof-Pool ist geschlossen'));
+    }
+    if (signal?.aborted) {
+      return Promise.reject(new ProofCancelledError());
+    }
+
+    return new Promise<Uint8Array>((resolve, reject) => {
+      const pending: PendingJob = { id: this.nextId++, job, resolve, reject, signal };
+      if (signal) {
+        pending.onAbort = () => this.cancel(pending);
+        signal.addEventListener('abort', pending.onAbort, { once: true });
+      }
+      this.queue.push(pending);
+      this.dispatch();
+    });
+  }
+
+  /**
+   * Reicht mehrere Jobs ein. Schlägt ein Job fehl, werden die übrigen
+   * abgebrochen; `signal` bricht den gesamten Batch ab.
+   */
+  async submitBatch(jobs: ProofJob[], signal?: AbortSignal): Promise<Uint8Array[]> {
+    const batch = new AbortController();
+    const abortBatch = () => batch.abort();
+    signal?.addEventListener('abort', abortBatch, { once: true });
+
+    try {
+      return await Promise.all(jobs.map(job =>
+        this.submit(job, batch.signal).catch(error => {
+          batch.abort();
+          throw error;
+        })
+      ));
+    } finally {
+      signal?.removeEventListener('abort', abortBatch);
+    }
+  }
+
+  generateInitialProof(amount: bigint, sender: PublicKey, recipient: PublicKey): Promise<Uint8Array> {
+    return this.submit({ kind: 'initial', amount, sender: sender.toBytes(), recipient: recipient.toBytes() });
+  }
+
+  generateHopProof(hopIndex: number, seed: Uint8Array, realSplits: bigint[]): Promise<Uint8Array> {
+    return this.submit({ kind: 'hop', hopIndex, seed, realSplits });
+  }
+
+  generateFinalProof(
+    amount: bigint,
+    sender: PublicKey,
+    recipient: PublicKey,
+    allHopSeeds: Uint8Array[]
+  ): Promise<Uint8Array> {
+    return this.submit({
+      kind: 'final',
+      amount,
+      sender: sender.toBytes(),
+      recipient: recipient.toBytes(),
+      hopSeeds: allHopSeeds
+    });
+  }
+
+  /** Bricht alle Jobs ab und beendet die Worker */
+  close(): void {
+    this.closed = true;
+    for (const pending of [...this.queue, ...this.running.values()]) {
+      this.settle(pending).reject(new ProofCancelledError());
+    }
+    this.queue = [];
+    for (const worker of [...this.idle, ...this.running.keys()]) {
+      worker.terminate();
+    }
+    this.idle = [];
+    this.running.clear();
+    this.workerCount = 0;
+  }
+
+  /** Teilt wartende Jobs freien (oder neu gestarteten) Workern zu */
+  private dispatch(): void {
+    while (this.queue.length > 0) {
+      const worker = this.idle.pop() ?? (this.workerCount < this.size ? this.spawn() : undefined);
+      if (!worker) {
+        return;
+      }
+      const pending = this.queue.shift()!;
+      this.running.set(worker, pending);
+      worker.postMessage({ id: pending.id, job: pending.job });
+    }
+  }
+
+  private spawn(): ProofWorker {
+    const worker = this.factory();
+    this.workerCount++;
+
+    worker.onMessage(response => {
+      const pending = this.running.get(worker);
+      if (!pending || pending.id !== response.id) {
+        return;
+      }
+      this.running.delete(worker);
+      this.idle.push(worker);
+
+      const { resolve, reject } = this.settle(pending);
+      if (response.error !== undefined) {
+        reject(new Error(`proof generation failed: ${response.error}`));
+      } else {
+        resolve(response.proof!);
+      }
+      this.dispatch();
+    });
+
+    worker.onError(error => {
+      const pending = this.running.get(worker);
+      if (!this.retire(worker)) {
+        return;
+      }
+      if (pending) {
+        this.settle(pending).reject(error);
+      }
+      this.dispatch();
+    });
+
+    return worker;
+  }
+
+  /** Entfernt einen Worker aus dem Pool; false, wenn er schon entfernt war */
+  private retire(worker: ProofWorker): boolean {
+    const wasRunning = this.running.delete(worker);
+    const idleIndex = this.idle.indexOf(worker);
+    if (idleIndex >= 0) {
+      this.idle.splice(idleIndex, 1);
+    }
+    if (!wasRunning && idleIndex < 0) {
+      return false;
+    }
+    this.workerCount--;
+    return true;
+  }
+
+  private cancel(pending: PendingJob): void {
+    const queueIndex = this.queue.indexOf(pending);
+    if (queueIndex >= 0) {
+      this.queue.splice(queueIndex, 1);
+    } else {
+      // Laufender Job: der Worker wird beendet und bei Bedarf neu gestartet
+      for (const [worker, job] of this.running) {
+        if (job === pending) {
+          this.retire(worker);
+          worker.terminate();
+          break;
+        }
+      }
+    }
+    this.settle(pending).reject(new ProofCancelledError());
+    this.dispatch();
+  }
+
+  /** Löst den Abort-Listener eines Jobs und gibt dessen Callbacks zurück */
+  private settle(pending: PendingJob): Pick<PendingJob, 'resolve' | 'reject'> {
+    if (pending.signal && pending.onAbort) {
+      pending.signal.removeEventListener('abort', pending.onAbort);
+    }
+    return pending;
+  }
+}
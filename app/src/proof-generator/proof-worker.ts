@@ -0,0 +1,22 @@
+/**
+ * Worker-Einstiegspunkt des Proof-Pools (`worker_threads`)
+ *
+ * Jeder Worker hält einen eigenen `ZEclipseProofGenerator` und bearbeitet
+ * die Jobs, die ihm der Pool zuteilt, nacheinander.
+ */
+
+import { parentPort } from 'worker_threads';
+import { ZEclipseProofGenerator } from './index';
+import { ProofRequest, ProofResponse, runProofJob } from './proof-job';
+
+const generator = new ZEclipseProofGenerator();
+
+parentPort?.on('message', async ({ id, job }: ProofRequest) => {
+  let response: ProofResponse;
+  try {
+    response = { id, proof: await runProofJob(generator, job) };
+  } catch (error) {
+    response = { id, error: error instanceof Error ? error.message : String(error) };
+  }
+  parentPort!.postMessage(response);
+});
@@ -0,0 +1,64 @@
+/**
+ * Binary min-heap used by the temporal obfuscation scheduler
+ *
+ * `push` and `pop` are O(log n), `peek` is O(1). The ordering is defined by
+ * the comparator passed to the constructor (negative = `a` comes first).
+ */
+export class MinHeap<T> {
+  private items: T[] = [];
+
+  constructor(private readonly compare: (a: T, b: T) => number) {}
+
+  /** Number of queued items */
+  get size(): number {
+    return this.items.length;
+  }
+
+  /** Smallest item without removing it */
+  peek(): T | undefined {
+    return this.items[0];
+  }
+
+  /** Inserts an item */
+  push(item: T): void {
+    const items = this.items;
+    items.push(item);
+
+    let index = items.length - 1;
+    while (index > 0) {
+      const parent = (index - 1) >> 1;
+      if (this.compare(items[index], items[parent]) >= 0) break;
+      [items[index], items[parent]] = [items[parent], items[index]];
+      index = parent;
+    }
+  }
+
+  /** Removes and returns the smallest item */
+  pop(): T | undefined {
+    const items = this.items;
+    if (items.length === 0) return undefined;
+
+    const top = items[0];
+    const last = items.pop()!;
+    if (items.length > 0) {
+      items[0] = last;
+      let index = 0;
+      for (;;) {
+        const left = 2 * index + 1;
+        const right = left + 1;
+        let smallest = index;
+        if (left < items.length && this.compare(items[left], items[smallest]) < 0) smallest = left;
+        if (right < items.length && this.compare(items[right], items[smallest]) < 0) smallest = right;
+        if (smallest === index) break;
+        [items[index], items[smallest]] = [items[smallest], items[index]];
+        index = smallest;
+      }
+    }
+    return top;
+  }
+
+  /** Removes all items */
+  clear(): void {
+    this.items = [];
+  }
+}
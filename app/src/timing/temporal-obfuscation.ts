@@ -8,6 +8,8 @@
  */
 
 import { PublicKey, Connection, TransactionInstruction, Transaction } from '@solana/web3.js';
+import { MinHeap } from './min-heap';
+import { NetworkStateCache } from '../client/network-state-cache';
 
 /**
  * Configuration for temporal obfuscation
@@ -25,6 +27,8 @@ export interface TemporalObfuscationConfig {
   timeWindowSize: number;
   /** Interval to use for time-slicing (in milliseconds) */
   timeSliceInterval: number;
+  /** Maximum number of scheduled sends in flight at once (default: 8) */
+  maxInFlight?: number;
 }
 
 /**
@@ -36,9 +40,19 @@ export const DEFAULT_TEMPORAL_CONFIG: TemporalObfuscationConfig = {
   randomBatchOrder: true,
   timeSlicedExecution: true,
   timeWindowSize: 60000, // 60s window
-  timeSliceInterval: 2000 // 2s interval
+  timeSliceInterval: 2000, // 2s interval
+  maxInFlight: 8
 };
 
+/** In-flight limit used when the configuration does not set one */
+const DEFAULT_MAX_IN_FLIGHT = 8;
+
+/** Number of execution records kept for pattern analysis */
+const MAX_EXECUTION_RECORDS = 1000;
+
+/** Largest delay accepted by `setTimeout` */
+const MAX_TIMER_DELAY = 0x7fffffff;
+
 /**
  * Scheduled transaction for time-sliced execution
  */
@@ -46,6 +60,19 @@ interface ScheduledTransaction {
   transaction: Transaction;
   executionTime: number;
   priority: number;
+  hopIndex: number;
+  /** Insertion order, keeps equal deadlines FIFO */
+  sequence: number;
+}
+
+/**
+ * Heap order: earliest execution time first, then higher priority, then
+ * insertion order
+ */
+function compareScheduled(a: ScheduledTransaction, b: ScheduledTransaction): number {
+  return a.executionTime - b.executionTime
+    || b.priority - a.priority
+    || a.sequence - b.sequence;
 }
 
 /**
@@ -56,18 +83,28 @@ interface ExecutionTimeRecord {
   transactionId: string;
   hopIndex: number;
   executionDuration: number;
+  /** Time between the scheduled execution time and the actual send (ms) */
+  schedulingLag: number;
 }
 
 /**
  * Temporal obfuscation manager for ZEclipse transactions
+ *
+ * Scheduled transactions are kept in a min-heap ordered by execution time.
+ * A single timer is armed for the earliest deadline; when it fires, all due
+ * transactions are sent concurrently, bounded by `maxInFlight`.
  */
 export class TemporalObfuscationManager {
   private config: TemporalObfuscationConfig;
-  private scheduledTransactions: ScheduledTransaction[] = [];
+  private scheduledTransactions = new MinHeap<ScheduledTransaction>(compareScheduled);
   private executionTimeRecords: ExecutionTimeRecord[] = [];
   private connection: Connection;
   private isProcessing: boolean = false;
-  private processingInterval: NodeJS.Timeout | null = null;
+  private timer: NodeJS.Timeout | null = null;
+  /** Deadline the timer is armed for */
+  private timerDeadline: number = Infinity;
+  private inFlight: number = 0;
+  private nextSequence: number = 0;
   
   /**
    * Create a new TemporalObfuscationManager
@@ -90,21 +127,17 @@ export class TemporalObfuscationManager {
     if (this.isProcessing) return;
     
     this.isProcessing = true;
-    this.processingInterval = setInterval(
-      () => this.processScheduledTransactions(),
-      500 // Check for scheduled transactions every 500ms
-    );
+    this.armTimer();
   }
   
   /**
    * Stop processing scheduled transactions
+   * 
+   * Scheduled transactions stay queued; sends already in flight complete.
    */
   public stopProcessing(): void {
     this.isProcessing = false;
-    if (this.processingInterval) {
-      clearInterval(this.processingInterval);
-      this.processingInterval = null;
-    }
+    this.clearTimer();
   }
   
   /**
@@ -126,27 +159,7 @@ export class TemporalObfuscationManager {
     // Calculate execution time
     const executionTime = Date.now() + delay;
     
-    // Add to scheduled transactions
-    this.scheduledTransactions.push({
-      transaction,
-      executionTime,
-      priority
-    });
-    
-    // Sort by execution time and priority
-    this.scheduledTransactions.sort((a, b) => {
-      // Sort by execution time first
-      if (a.executionTime !== b.executionTime) {
-        return a.executionTime - b.executionTime;
-      }
-      // Then by priority (higher priority first)
-      return b.priority - a.priority;
-    });
-    
-    // If not already processing, start
-    if (!this.isProcessing) {
-      this.startProcessing();
-    }
+    this.enqueue(transaction, executionTime, hopIndex, priority);
     
     return executionTime;
   }
@@ -227,11 +240,7 @@ export class TemporalObfuscationManager {
       const executionTime = Date.now() + totalDelay;
       
       // Schedule with custom execution time
-      this.scheduledTransactions.push({
-        transaction: tx,
-        executionTime,
-        priority: 1
-      });
+      this.enqueue(tx, executionTime, hopIndex, 1);
       
       // Update the map
       if (!timeSliceMap.has(timeSlice)) {
@@ -240,14 +249,6 @@ export class TemporalObfuscationManager {
       timeSliceMap.get(timeSlice)!.push(executionTime);
     });
     
-    // Sort scheduled transactions
-    this.scheduledTransactions.sort((a, b) => a.executionTime - b.executionTime);
-    
-    // If not already processing, start
-    if (!this.isProcessing && this.scheduledTransactions.length > 0) {
-      this.startProcessing();
-    }
-    
     return timeSliceMap;
   }
   
@@ -296,13 +297,17 @@ export class TemporalObfuscationManager {
   public getDiagnosticInfo(): {
     scheduled: number,
     executed: number,
+    inFlight: number,
     meanDelay: number,
+    meanSchedulingLag: number,
     timeWindowUtilization: number[]
   } {
-    // Calculate mean delay from execution records
-    const delays = this.executionTimeRecords.map(r => r.executionDuration);
-    const meanDelay = delays.length > 0 ? 
-      delays.reduce((sum, delay) => sum + delay, 0) / delays.length : 0;
+    // Calculate mean delay and scheduling lag from execution records
+    const records = this.executionTimeRecords;
+    const meanDelay = records.length > 0 ? 
+      records.reduce((sum, r) => sum + r.executionDuration, 0) / records.length : 0;
+    const meanSchedulingLag = records.length > 0 ?
+      records.reduce((sum, r) => sum + r.schedulingLag, 0) / records.length : 0;
     
     // Calculate time window utilization (percentage of slots used)
     const numSlices = Math.floor(this.config.timeWindowSize / this.config.timeSliceInterval);
@@ -323,70 +328,146 @@ export class TemporalObfuscationManager {
     );
     
     return {
-      scheduled: this.scheduledTransactions.length,
+      scheduled: this.scheduledTransactions.size,
       executed: this.executionTimeRecords.length,
+      inFlight: this.inFlight,
       meanDelay,
+      meanSchedulingLag,
       timeWindowUtilization: normalizedUtilization
     };
   }
   
   /**
-   * Process scheduled transactions that are ready for execution
+   * Add a transaction to the heap and re-arm the timer if it is the new
+   * earliest deadline
    * @private
    */
-  private async processScheduledTransactions(): Promise<void> {
-    const now = Date.now();
+  private enqueue(
+    transaction: Transaction,
+    executionTime: number,
+    hopIndex: number,
+    priority: number
+  ): void {
+    this.scheduledTransactions.push({
+      transaction,
+      executionTime,
+      priority,
+      hopIndex,
+      sequence: this.nextSequence++
+    });
     
-    // Extract transactions that are ready to execute
-    const readyTransactions: ScheduledTransaction[] = [];
-    const pendingTransactions: ScheduledTransaction[] = [];
+    // If not already processing, start (arms the timer)
+    if (!this.isProcessing) {
+      this.startProcessing();
+    } else if (executionTime < this.timerDeadline) {
+      this.armTimer();
+    }
+  }
+  
+  /**
+   * Arm a single timer for the earliest scheduled deadline
+   * @private
+   */
+  private armTimer(): void {
+    this.clearTimer();
+    
+    const next = this.scheduledTransactions.peek();
+    if (!this.isProcessing || !next) return;
+    
+    const delay = Math.min(Math.max(0, next.executionTime - Date.now()), MAX_TIMER_DELAY);
+    this.timerDeadline = next.executionTime;
+    this.timer = setTimeout(() => {
+      this.timer = null;
+      this.timerDeadline = Infinity;
+      this.processScheduledTransactions();
+    }, delay);
+  }
+  
+  /**
+   * @private
+   */
+  private clearTimer(): void {
+    if (this.timer) {
+      clearTimeout(this.timer);
+      this.timer = null;
+    }
+    this.timerDeadline = Infinity;
+  }
+  
+  /**
+   * Dispatch all due transactions, at most `maxInFlight` at a time
+   * @private
+   */
+  private processScheduledTransactions(): void {
+    if (!this.isProcessing) return;
     
-    this.scheduledTransactions.forEach(scheduled => {
-      if (scheduled.executionTime <= now) {
-        readyTransactions.push(scheduled);
-      } else {
-        pendingTransactions.push(scheduled);
-      }
-    });
+    const maxInFlight = this.config.maxInFlight ?? DEFAULT_MAX_IN_FLIGHT;
+    const now = Date.now();
     
-    // Update the scheduled transactions list
-    this.scheduledTransactions = pendingTransactions;
+    while (this.inFlight < maxInFlight) {
+      const next = this.scheduledTransactions.peek();
+      if (!next || next.executionTime > now) break;
+      
+      this.scheduledTransactions.pop();
+      this.inFlight++;
+      void this.executeScheduled(next, now);
+    }
     
-    // Execute ready transactions
-    for (const scheduled of readyTransactions) {
-      try {
-        const startTime = Date.now();
-        // Die korrekte Signatur für sendTransaction mit Transaction-Typ verwenden
-        const signature = await this.connection.sendTransaction(
-          scheduled.transaction,
-          [] // leeres Signers-Array, da die Transaktion bereits signiert sein sollte
-        );
-        
-        const endTime = Date.now();
-        
-        // Record execution time
-        this.executionTimeRecords.push({
-          timestamp: startTime,
-          transactionId: signature,
-          hopIndex: -1, // Placeholder, would be set in actual implementation
-          executionDuration: endTime - startTime
-        });
-        
-        // Limit the size of execution records to prevent memory growth
-        if (this.executionTimeRecords.length > 1000) {
-          this.executionTimeRecords = this.executionTimeRecords.slice(-1000);
-        }
-      } catch (error) {
-        console.error('Error executing scheduled transaction:', error);
-      }
+    // Due transactions blocked by the in-flight limit are dispatched when a
+    // send completes; otherwise wait for the next deadline
+    if (this.inFlight < maxInFlight) {
+      this.armTimer();
     }
     
     // If no more transactions and not stopped externally, stop processing
-    if (this.scheduledTransactions.length === 0 && this.isProcessing) {
+    if (this.scheduledTransactions.size === 0 && this.inFlight === 0) {
       this.stopProcessing();
     }
   }
   
+  /**
+   * Send one scheduled transaction and record its timing
+   * @private
+   */
+  private async executeScheduled(scheduled: ScheduledTransaction, dispatchTime: number): Promise<void> {
+    const startTime = Date.now();
+    try {
+      // Unsignierte Transaktionen erhalten den gemeinsam gecachten Blockhash
+      if (!scheduled.transaction.recentBlockhash) {
+        const { blockhash } = await NetworkStateCache.forConnection(this.connection).getBlockhash();
+        scheduled.transaction.recentBlockhash = blockhash;
+      }
+      
+      // Die korrekte Signatur für sendTransaction mit Transaction-Typ verwenden
+      const signature = await this.connection.sendTransaction(
+        scheduled.transaction,
+        [] // leeres Signers-Array, da die Transaktion bereits signiert sein sollte
+      );
+      
+      const endTime = Date.now();
+      
+      // Record execution time
+      this.executionTimeRecords.push({
+        timestamp: startTime,
+        transactionId: signature,
+        hopIndex: scheduled.hopIndex,
+        executionDuration: endTime - startTime,
+        schedulingLag: dispatchTime - scheduled.executionTime
+      });
+      
+      // Limit the size of execution records to prevent memory growth
+      // (trimmed in chunks, not on every send)
+      if (this.executionTimeRecords.length > 2 * MAX_EXECUTION_RECORDS) {
+        this.executionTimeRecords = this.executionTimeRecords.slice(-MAX_EXECUTION_RECORDS);
+      }
+    } catch (error) {
+      console.error('Error executing scheduled transaction:', error);
+    } finally {
+      this.inFlight--;
+      this.processScheduledTransactions();
+    }
+  }
+  
   /**
    * Generate a random delay with hop-specific characteristics
    * 
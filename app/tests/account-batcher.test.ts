@@ -0,0 +1,84 @@
+/**
+ * Tests für den gebündelten Account-Zugriff
+ */
+
+import { Connection, Keypair, PublicKey } from '@solana/web3.js';
+import { AccountBatcher, TRANSFER_STATE_STATUS_SLICE } from '../src/client/account-batcher';
+
+function mockConnection(slot: () => number = () => 100) {
+  return {
+    getMultipleAccountsInfoAndContext: jest.fn(async (keys: PublicKey[], config: { dataSlice?: { length: number } }) => ({
+      context: { slot: slot() },
+      value: keys.map((key, index) => index === keys.length - 1 && key.equals(missing) ? null : {
+        lamports: 1_000 + index,
+        owner: PublicKey.default,
+        executable: false,
+        rentEpoch: 0,
+        // Heiße Felder: current_hop = 2, completed = 1, version = 1, fake_mode = 0
+        data: Buffer.from([2, 1, 1, 0, 254, 3, 1, 0]).subarray(0, config.dataSlice?.length ?? 8)
+      })
+    }))
+  };
+}
+
+const missing = Keypair.generate().publicKey;
+const keys = Array.from({ length: 5 }, () => Keypair.generate().publicKey);
+
+describe('AccountBatcher', () => {
+  test('bündelt gleichzeitige Abfragen je Ausschnitt in einen Aufruf', async () => {
+    const connection = mockConnection();
+    const batcher = new AccountBatcher(connection as unknown as Connection, { windowMs: 1 });
+
+    const [balances, statuses, duplicate] = await Promise.all([
+      Promise.all(keys.map(key => batcher.getBalance(key))),
+      Promise.all([keys[0], missing].map(key => batcher.getTransferStatus(key))),
+      batcher.getBalance(keys[0])
+    ]);
+
+    expect(balances).toEqual([1_000, 1_001, 1_002, 1_003, 1_004]);
+    expect(duplicate).toBe(1_000);
+    expect(statuses[0]).toEqual({ currentHop: 2, batchCount: 1, completed: true, refundTriggered: false, version: 1, committedFakes: false });
+    expect(statuses[1]).toBeNull();
+
+    // Ein Aufruf ohne Daten für die Salden, einer mit dem Status-Ausschnitt
+    expect(connection.getMultipleAccountsInfoAndContext).toHaveBeenCalledTimes(2);
+    const slices = connection.getMultipleAccountsInfoAndContext.mock.calls.map(([, config]) => config.dataSlice);
+    expect(slices).toEqual([{ offset: 0, length: 0 }, TRANSFER_STATE_STATUS_SLICE]);
+    expect(connection.getMultipleAccountsInfoAndContext.mock.calls[0][0]).toHaveLength(5);
+  });
+
+  test('teilt große Abfragen in Blöcke von maxBatchSize', async () => {
+    const connection = mockConnection();
+    const batcher = new AccountBatcher(connection as unknown as Connection, { windowMs: 1, maxBatchSize: 2 });
+    await batcher.getMultipleAccountsInfo(keys);
+    expect(connection.getMultipleAccountsInfoAndContext).toHaveBeenCalledTimes(3);
+  });
+
+  test('antwortet im selben Slot aus dem Cache, bis ein neuerer Slot gemeldet wird', async () => {
+    let slot = 100;
+    const connection = mockConnection(() => slot);
+    const batcher = new AccountBatcher(connection as unknown as Connection, { windowMs: 1, slotTtlMs: 60_000 });
+
+    await batcher.getBalance(keys[0]);
+    await batcher.getBalance(keys[0]);
+    expect(batcher.rpcCallCount).toBe(1);
+
+    // Eine Antwort aus einem neueren Slot macht ältere Einträge ungültig
+    slot = 101;
+    await batcher.getBalance(keys[1]);
+    await batcher.getBalance(keys[0]);
+    expect(batcher.rpcCallCount).toBe(3);
+
+    batcher.invalidate([keys[0]]);
+    await batcher.getBalance(keys[0]);
+    expect(batcher.rpcCallCount).toBe(4);
+  });
+
+  test('gibt RPC-Fehler an alle Wartenden weiter', async () => {
+    const connection = { getMultipleAccountsInfoAndContext: jest.fn().mockRejectedValue(new Error('429')) };
+    const batcher = new AccountBatcher(connection as unknown as Connection, { windowMs: 1 });
+    const reads = keys.slice(0, 2).map(key => batcher.getBalance(key));
+    await expect(reads[0]).rejects.toThrow('429');
+    await expect(reads[1]).rejects.toThrow('429');
+  });
+});
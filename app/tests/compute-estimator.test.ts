@@ -0,0 +1,82 @@
+/**
+ * Tests für die simulationsbasierte CU-Schätzung
+ */
+
+import { Connection, Keypair, PublicKey, TransactionInstruction } from '@solana/web3.js';
+import { ComputeUnitEstimator, instructionShape } from '../src/client/compute-estimator';
+
+function mockConnection(result: { err: unknown; unitsConsumed?: number }) {
+  return {
+    simulateTransaction: jest.fn().mockResolvedValue({ value: { logs: [], ...result } }),
+    getTransaction: jest.fn().mockResolvedValue({ meta: { computeUnitsConsumed: 120_000 } })
+  };
+}
+
+const programId = Keypair.generate().publicKey;
+
+function instruction(discriminator: number, accounts: number): TransactionInstruction {
+  return new TransactionInstruction({
+    programId,
+    keys: Array.from({ length: accounts }, () => ({
+      pubkey: Keypair.generate().publicKey,
+      isSigner: false,
+      isWritable: true
+    })),
+    data: Buffer.alloc(8, discriminator)
+  });
+}
+
+describe('ComputeUnitEstimator', () => {
+  const payer = Keypair.generate();
+
+  test('simuliert jede Form nur einmal und schlägt den Aufschlag auf', async () => {
+    const connection = mockConnection({ err: null, unitsConsumed: 50_000 });
+    const estimator = new ComputeUnitEstimator(connection as unknown as Connection);
+
+    // Gleiche Form, andere Accounts: derselbe Cache-Eintrag
+    expect(await estimator.estimate(payer, [instruction(1, 3)])).toBe(55_000);
+    expect(await estimator.estimate(payer, [instruction(1, 3)])).toBe(55_000);
+    expect(connection.simulateTransaction).toHaveBeenCalledTimes(1);
+
+    await estimator.estimate(payer, [instruction(1, 4)]);
+    expect(connection.simulateTransaction).toHaveBeenCalledTimes(2);
+  });
+
+  test('verwendet das Fallback, wenn die Simulation fehlschlägt', async () => {
+    const connection = mockConnection({ err: { InstructionError: [1, 'Custom'] } });
+    const estimator = new ComputeUnitEstimator(connection as unknown as Connection);
+    const ixs = [instruction(2, 3)];
+
+    expect(await estimator.estimate(payer, ixs, [], 400_000)).toBe(400_000);
+    expect(estimator.cachedLimit(ixs)).toBeUndefined();
+  });
+
+  test('übernimmt den Verbrauch gelandeter Transaktionen', async () => {
+    const connection = mockConnection({ err: null, unitsConsumed: 50_000 });
+    const estimator = new ComputeUnitEstimator(connection as unknown as Connection, { minMargin: 5_000 });
+    const measured = [instruction(3, 2)];
+    const unmeasured = [instruction(4, 2)];
+    estimator.record(measured, 1_000);
+
+    await estimator.recordLanded([
+      { instructions: measured, signature: 'sig-1' },
+      { instructions: unmeasured, signature: 'sig-2' }
+    ]);
+
+    expect(connection.getTransaction).toHaveBeenCalledTimes(1);
+    expect(estimator.cachedLimit(measured)).toBe(6_000);
+    expect(estimator.cachedLimit(unmeasured)).toBe(132_000);
+  });
+
+  test('Form berücksichtigt Programm, Diskriminator und Account-Anzahl', () => {
+    const other = new TransactionInstruction({
+      programId: PublicKey.default,
+      keys: [],
+      data: Buffer.alloc(8, 1)
+    });
+
+    expect(instructionShape([instruction(1, 3)])).toBe(instructionShape([instruction(1, 3)]));
+    expect(instructionShape([instruction(1, 3)])).not.toBe(instructionShape([instruction(2, 3)]));
+    expect(instructionShape([instruction(1, 0)])).not.toBe(instructionShape([other]));
+  });
+});
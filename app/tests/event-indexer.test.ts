@@ -0,0 +1,148 @@
+/**
+ * Tests für den Ereignis-Indexer
+ */
+
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import { Connection, Keypair, PublicKey } from '@solana/web3.js';
+import { decodeEvent, eventDiscriminator, EventIndexer, extractEventData } from '../src/client/event-indexer';
+
+const programId = Keypair.generate().publicKey;
+const owner = Keypair.generate().publicKey;
+const transferState = Keypair.generate().publicKey;
+const recipient = Keypair.generate().publicKey;
+
+/** Kodiert ein Event wie `emit!`: Discriminator + Borsh-Felder */
+function encode(name: string, fields: Buffer[]): Buffer {
+  return Buffer.concat([eventDiscriminator(name), ...fields]);
+}
+
+const u8 = (value: number) => Buffer.from([value]);
+function u32(value: number): Buffer {
+  const buffer = Buffer.alloc(4);
+  buffer.writeUInt32LE(value);
+  return buffer;
+}
+function u64(value: number): Buffer {
+  const buffer = Buffer.alloc(8);
+  buffer.writeBigUInt64LE(BigInt(value));
+  return buffer;
+}
+
+const initialized = encode('TransferInitialized', [
+  owner.toBuffer(), recipient.toBuffer(), u64(1_000_000), u64(1_000_000),
+  u8(4), u8(4), u8(4), u64(65_536), transferState.toBuffer(), u32(3)
+]);
+const batchHop = encode('BatchHopExecuted', [
+  owner.toBuffer(), u8(0), u8(2), u8(16), u32(400_000), u8(50), u8(2),
+  transferState.toBuffer(), u32(20), u64(0)
+]);
+const finalized = encode('TransferFinalized', [
+  owner.toBuffer(), recipient.toBuffer(), u64(990_000), u64(10_000), u64(1_000_000),
+  transferState.toBuffer(), u64(1_700_000_000), u8(1),
+  u64(990_000), u64(0), u64(0), u64(0), u64(0), u64(0)
+]);
+
+/** Logzeilen einer Transaktion des Programms mit den gegebenen Events */
+function programLogs(events: Buffer[], cpiEvent?: Buffer): string[] {
+  const other = Keypair.generate().publicKey.toBase58();
+  return [
+    `Program ${programId.toBase58()} invoke [1]`,
+    'Program log: Instruction: ExecuteBatchHop',
+    `Program ${other} invoke [2]`,
+    ...(cpiEvent ? [`Program data: ${cpiEvent.toString('base64')}`] : []),
+    `Program ${other} success`,
+    ...events.map(event => `Program data: ${event.toString('base64')}`),
+    `Program ${programId.toBase58()} consumed 120000 of 400000 compute units`,
+    `Program ${programId.toBase58()} success`
+  ];
+}
+
+function mockConnection() {
+  return {
+    onLogs: jest.fn().mockReturnValue(7),
+    removeOnLogsListener: jest.fn().mockResolvedValue(undefined)
+  };
+}
+
+describe('Event-Dekodierung', () => {
+  test('dekodiert die Felder in Layout-Reihenfolge', () => {
+    const event = decodeEvent(batchHop, 42)!;
+    expect(event.name).toBe('BatchHopExecuted');
+    expect(event.slot).toBe(42);
+    expect(event.data).toMatchObject({
+      owner: owner.toBase58(),
+      hopsProcessed: 2,
+      computeUnitsConsumed: 400_000,
+      remainingHops: 2,
+      transferState: transferState.toBase58(),
+      poseidonHashes: 20
+    });
+  });
+
+  test('verwirft unbekannte und abgeschnittene Events', () => {
+    expect(decodeEvent(encode('SomethingElse', [u64(1)]))).toBeNull();
+    expect(decodeEvent(initialized.subarray(0, initialized.length - 1))).toBeNull();
+  });
+
+  test('liest nur Events des Programms selbst, nicht aus CPIs', () => {
+    const data = extractEventData(programId, programLogs([batchHop], finalized));
+    expect(data).toHaveLength(1);
+    expect(data[0]).toEqual(batchHop);
+  });
+});
+
+describe('EventIndexer', () => {
+  test('verfolgt den Fortschritt bis zur Finalisierung', () => {
+    const indexer = new EventIndexer(mockConnection() as unknown as Connection, programId);
+    indexer.ingestLogs({ err: null, logs: programLogs([initialized]) }, 10);
+    indexer.ingestLogs({ err: null, logs: programLogs([batchHop]) }, 11);
+
+    expect(indexer.get(transferState)).toMatchObject({ nonce: 3, phase: 'hopping', completedHops: 2, progressPercent: 50 });
+    expect(indexer.active()).toHaveLength(1);
+
+    // Fehlgeschlagene Transaktionen ändern den Index nicht
+    expect(indexer.ingestLogs({ err: { InstructionError: [0, 'Custom'] }, logs: programLogs([finalized]) }, 12)).toEqual([]);
+
+    indexer.ingestLogs({ err: null, logs: programLogs([finalized]) }, 13);
+    // Verspätet zugestellter Hop setzt die Phase nicht zurück
+    indexer.ingestLogs({ err: null, logs: programLogs([batchHop]) }, 11);
+    expect(indexer.get(transferState)).toMatchObject({ phase: 'finalized', progressPercent: 100, lastSlot: 13 });
+    expect(indexer.active()).toHaveLength(0);
+    expect(indexer.list(owner)).toHaveLength(1);
+  });
+
+  test('waitFor löst beim passenden Event auf', async () => {
+    const indexer = new EventIndexer(mockConnection() as unknown as Connection, programId);
+    const done = indexer.waitFor(transferState, progress => progress.phase === 'finalized', 1_000);
+    indexer.ingestLogs({ err: null, logs: programLogs([initialized, finalized]) }, 5);
+    await expect(done).resolves.toMatchObject({ recipient: recipient.toBase58() });
+  });
+
+  test('stellt den Index nach einem Neustart aus dem Append-Log wieder her', async () => {
+    const logPath = path.join(fs.mkdtempSync(path.join(os.tmpdir(), 'zeclipse-indexer-')), 'events.log');
+    const connection = mockConnection();
+
+    const first = new EventIndexer(connection as unknown as Connection, programId, { logPath });
+    expect(first.start()).toBe(0);
+    expect(connection.onLogs).toHaveBeenCalledWith(programId, expect.any(Function), 'confirmed');
+    first.ingestLogs({ err: null, logs: programLogs([initialized, batchHop]) }, 20);
+    await first.stop();
+    expect(connection.removeOnLogsListener).toHaveBeenCalledWith(7);
+
+    // Abgeschnittener Eintrag am Ende (Absturz beim Schreiben)
+    fs.appendFileSync(logPath, Buffer.from([0x40, 0, 0]));
+
+    const second = new EventIndexer(connection as unknown as Connection, programId, { logPath });
+    expect(second.start()).toBe(2);
+    expect(second.get(transferState)).toEqual(first.get(transferState));
+    second.ingestLogs({ err: null, logs: programLogs([finalized]) }, 21);
+    await second.stop();
+
+    const third = new EventIndexer(connection as unknown as Connection, programId, { logPath });
+    expect(third.start()).toBe(3);
+    expect(third.get(transferState)?.phase).toBe('finalized');
+    await third.stop();
+  });
+});
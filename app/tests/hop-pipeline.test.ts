@@ -0,0 +1,65 @@
+/**
+ * Tests für die pipelined Submission der Transfer-Schritte
+ *
+ * Die Connection wird gemockt; geprüft werden Reihenfolge, Commitment pro
+ * Schritt und das Verhalten bei einem fehlgeschlagenen Schritt.
+ */
+
+import { Connection, VersionedTransaction } from '@solana/web3.js';
+import { PipelineError, PipelineStep, submitPipelined } from '../src/client/hop-pipeline';
+
+function mockConnection(failAt: number = -1) {
+  const events: string[] = [];
+  const connection = {
+    sendTransaction: jest.fn(async (tx: { id: string }, options: { skipPreflight: boolean }) => {
+      events.push(`send ${tx.id}${options.skipPreflight ? ' (skip preflight)' : ''}`);
+      return `sig-${tx.id}`;
+    }),
+    confirmTransaction: jest.fn(async ({ signature }: { signature: string }, commitment: string) => {
+      events.push(`confirm ${signature} ${commitment}`);
+      const failed = failAt >= 0 && signature === `sig-${failAt}`;
+      return { context: { slot: 1 }, value: { err: failed ? { InstructionError: [0, 'Custom'] } : null } };
+    })
+  };
+  return { connection: connection as unknown as Connection, events };
+}
+
+function steps(count: number): PipelineStep[] {
+  return Array.from({ length: count }, (_, i) => ({
+    label: `step ${i}`,
+    transaction: { id: `${i}` } as unknown as VersionedTransaction
+  }));
+}
+
+const blockhash = { blockhash: 'hash', lastValidBlockHeight: 100 };
+
+describe('submitPipelined', () => {
+  test('sendet jeden Schritt nach processed des vorherigen', async () => {
+    const { connection, events } = mockConnection();
+
+    const signatures = await submitPipelined(connection, steps(3), blockhash);
+
+    expect(signatures).toEqual(['sig-0', 'sig-1', 'sig-2']);
+    expect(events).toEqual([
+      'send 0',
+      'confirm sig-0 processed',
+      'send 1 (skip preflight)',
+      'confirm sig-1 processed',
+      'send 2 (skip preflight)',
+      'confirm sig-2 confirmed'
+    ]);
+  });
+
+  test('bricht beim ersten fehlgeschlagenen Schritt ab', async () => {
+    const { connection } = mockConnection(1);
+
+    const result = submitPipelined(connection, steps(3), blockhash);
+
+    await expect(result).rejects.toBeInstanceOf(PipelineError);
+    await result.catch((error: PipelineError) => {
+      expect(error.stepIndex).toBe(1);
+      expect(error.landed).toEqual(['sig-0']);
+    });
+    expect(connection.sendTransaction).toHaveBeenCalledTimes(2);
+  });
+});
@@ -0,0 +1,81 @@
+/**
+ * Tests für Lookup Tables und Batch-Hop-Planung
+ *
+ * Prüfen, dass alle Accounts eines Transfers in eine Address Lookup Table
+ * passen und eine v0-Nachricht die Split-Accounts über Tabellenindizes
+ * referenziert.
+ */
+
+import {
+  AddressLookupTableAccount,
+  Keypair,
+  PublicKey,
+  SystemProgram,
+  TransactionInstruction,
+  TransactionMessage
+} from '@solana/web3.js';
+import { collectTransferAddresses, LOOKUP_TABLE_MAX_ADDRESSES } from '../src/client/lookup-table';
+import { planBatchHops, MAX_BATCH_SPLIT_ACCOUNTS } from '../src/client/batch-plan';
+import { STEALTH_BUMP_TABLE_LEN } from '../src/client/stealth-pda';
+
+describe('Lookup Table', () => {
+  const programId = Keypair.generate().publicKey;
+  const transferState = Keypair.generate().publicKey;
+  const seed = new Uint8Array(32).fill(7);
+  const recipient = Keypair.generate().publicKey;
+
+  test('sammelt alle Transfer-Adressen ohne Duplikate', () => {
+    const addresses = collectTransferAddresses(programId, transferState, seed, [recipient, recipient]);
+
+    expect(addresses.length).toBe(3 + STEALTH_BUMP_TABLE_LEN);
+    expect(addresses.length).toBeLessThanOrEqual(LOOKUP_TABLE_MAX_ADDRESSES);
+    expect(new Set(addresses.map(a => a.toBase58())).size).toBe(addresses.length);
+  });
+
+  test('Standard-Transfer passt in einen Batch-Hop', () => {
+    const plans = planBatchHops(programId, seed);
+
+    expect(plans).toHaveLength(1);
+    expect(plans[0].hopCount).toBe(4);
+    expect(plans[0].accounts).toHaveLength(32);
+    expect(plans[0].accounts.length).toBeLessThanOrEqual(MAX_BATCH_SPLIT_ACCOUNTS);
+  });
+
+  test('v0-Nachricht referenziert Split-Accounts über die Tabelle', () => {
+    const payer = Keypair.generate();
+    const [plan] = planBatchHops(programId, seed);
+    const lookupTable = new AddressLookupTableAccount({
+      key: Keypair.generate().publicKey,
+      state: {
+        deactivationSlot: BigInt('18446744073709551615'),
+        lastExtendedSlot: 0,
+        lastExtendedSlotStartIndex: 0,
+        authority: payer.publicKey,
+        addresses: collectTransferAddresses(programId, transferState, seed, [recipient])
+      }
+    });
+
+    const ix = new TransactionInstruction({
+      programId,
+      keys: [
+        { pubkey: payer.publicKey, isSigner: true, isWritable: true },
+        { pubkey: transferState, isSigner: false, isWritable: true },
+        { pubkey: SystemProgram.programId, isSigner: false, isWritable: false },
+        ...plan.accounts.map(a => ({ pubkey: a.pubkey, isSigner: false, isWritable: true }))
+      ],
+      data: Buffer.alloc(0)
+    });
+
+    const message = new TransactionMessage({
+      payerKey: payer.publicKey,
+      recentBlockhash: new PublicKey(new Uint8Array(32).fill(1)).toBase58(),
+      instructions: [ix]
+    }).compileToV0Message([lookupTable]);
+
+    // Nur Signer und Programm stehen statisch in der Nachricht
+    expect(message.staticAccountKeys).toHaveLength(2);
+    expect(message.addressTableLookups).toHaveLength(1);
+    // Transfer-State + alle Split-Accounts sind beschreibbare Tabellen-Lookups
+    expect(message.addressTableLookups[0].writableIndexes).toHaveLength(1 + plan.accounts.length);
+  });
+});
@@ -0,0 +1,69 @@
+/**
+ * Tests für Merkle-Multiproofs über die Empfänger eines Transfers
+ */
+
+import { createHash } from 'crypto';
+import {
+  buildMerkleMultiproof,
+  merkleLayers,
+  MerkleHashFn,
+  verifyMerkleMultiproof
+} from '../src/client/merkle-multiproof';
+
+// Deterministischer Ersatz für Poseidon; das Format ist vom Hash unabhängig
+function countingHash(): MerkleHashFn & { calls: number } {
+  const hash = ((left: Uint8Array, right: Uint8Array) => {
+    hash.calls++;
+    return new Uint8Array(createHash('sha256').update(left).update(right).digest());
+  }) as MerkleHashFn & { calls: number };
+  hash.calls = 0;
+  return hash;
+}
+
+// Blätter (z. B. `walletLeaf` der Empfänger)
+const recipients = Array.from({ length: 6 }, (_, i) => new Uint8Array(32).fill(i + 1));
+
+describe('Merkle-Multiproof', () => {
+  test('beweist alle 6 Empfänger mit einem Geschwisterknoten', () => {
+    const hash = countingHash();
+    const { root, proof, leaves } = buildMerkleMultiproof(recipients, [5, 0, 1, 2, 3, 4], hash);
+
+    // depth + 1 Byte Bitmap + Nachbar des Paares (4, 5)
+    expect(proof.length).toBe(1 + 1 + 32);
+    expect(proof[0]).toBe(3);
+    expect(proof[1]).toBe(0b0011_1111);
+    expect(leaves).toEqual(recipients);
+
+    const verify = countingHash();
+    expect(verifyMerkleMultiproof(proof, root, leaves, verify)).toBe(true);
+    // Jeder innere Knoten wird genau einmal gehasht
+    expect(verify.calls).toBe(6);
+  });
+
+  test('teilt obere Knoten zwischen Pfaden', () => {
+    const hash = countingHash();
+    const { root, proof, leaves } = buildMerkleMultiproof(recipients, [1, 4], hash);
+
+    // Zwei Einzelpfade bräuchten 2 x 3 Geschwister
+    expect(proof.length).toBe(2 + 4 * 32);
+    expect(leaves).toEqual([recipients[1], recipients[4]]);
+    expect(verifyMerkleMultiproof(proof, root, leaves, hash)).toBe(true);
+    expect(root).toEqual(merkleLayers(recipients, hash)[3][0]);
+  });
+
+  test('lehnt falsche Blätter und beschädigte Proofs ab', () => {
+    const hash = countingHash();
+    const { root, proof, leaves } = buildMerkleMultiproof(recipients, [1, 4], hash);
+
+    expect(verifyMerkleMultiproof(proof, root, [recipients[1], recipients[3]], hash)).toBe(false);
+    expect(verifyMerkleMultiproof(proof, root, leaves.slice(0, 1), hash)).toBe(false);
+    expect(verifyMerkleMultiproof(proof.subarray(0, proof.length - 32), root, leaves, hash)).toBe(false);
+    expect(verifyMerkleMultiproof(Buffer.concat([proof, Buffer.alloc(32)]), root, leaves, hash)).toBe(false);
+  });
+
+  test('prüft Positionen beim Erzeugen', () => {
+    const hash = countingHash();
+    expect(() => buildMerkleMultiproof(recipients, [], hash)).toThrow();
+    expect(() => buildMerkleMultiproof(recipients, [6], hash)).toThrow();
+  });
+});
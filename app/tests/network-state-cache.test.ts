@@ -0,0 +1,60 @@
+/**
+ * Tests für den gemeinsamen Netzwerkzustands-Cache
+ */
+
+import { ComputeBudgetProgram, Connection, Keypair } from '@solana/web3.js';
+import { NetworkStateCache, feeAtPercentile } from '../src/client/network-state-cache';
+
+function mockConnection(fees: number[]) {
+  return {
+    getLatestBlockhash: jest.fn().mockResolvedValue({
+      blockhash: 'mock-blockhash',
+      lastValidBlockHeight: 123456
+    }),
+    getRecentPrioritizationFees: jest.fn().mockResolvedValue(
+      fees.map((prioritizationFee, slot) => ({ slot, prioritizationFee }))
+    )
+  };
+}
+
+describe('NetworkStateCache', () => {
+  test('gibt den Blockhash aus dem Cache aus', async () => {
+    const connection = mockConnection([]);
+    const cache = new NetworkStateCache(connection as unknown as Connection);
+
+    await cache.getBlockhash();
+    const { blockhash } = await cache.getBlockhash();
+
+    expect(blockhash).toBe('mock-blockhash');
+    expect(connection.getLatestBlockhash).toHaveBeenCalledTimes(1);
+  });
+
+  test('bemisst die Prioritätsgebühr nach den verfolgten Accounts', async () => {
+    const connection = mockConnection([0, 10, 20, 30, 1_000_000]);
+    const cache = new NetworkStateCache(connection as unknown as Connection, { feePercentile: 75 });
+    const account = Keypair.generate().publicKey;
+
+    cache.trackAccounts([account]);
+    await cache.refresh();
+
+    expect(connection.getRecentPrioritizationFees).toHaveBeenCalledWith({ lockedWritableAccounts: [account] });
+    expect(cache.getPriorityFee()).toBe(30);
+
+    const [limit, price] = cache.computeBudgetInstructions(200_000);
+    expect(limit.programId.equals(ComputeBudgetProgram.programId)).toBe(true);
+    expect(price.programId.equals(ComputeBudgetProgram.programId)).toBe(true);
+  });
+
+  test('feeAtPercentile begrenzt auf das konfigurierte Intervall', () => {
+    expect(feeAtPercentile([], 75, 5, 100)).toBe(5);
+    expect(feeAtPercentile([1, 2, 3, 4], 50, 0, 100)).toBe(2);
+    expect(feeAtPercentile([1_000, 2_000], 100, 0, 500)).toBe(500);
+  });
+
+  test('teilt eine Instanz pro RPC-Endpunkt', () => {
+    const a = new Connection('http://localhost:8899');
+    const b = new Connection('http://localhost:8899');
+
+    expect(NetworkStateCache.forConnection(a)).toBe(NetworkStateCache.forConnection(b));
+  });
+});
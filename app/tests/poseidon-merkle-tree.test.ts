@@ -0,0 +1,156 @@
+/**
+ * Tests für den inkrementellen Poseidon-Merkle-Baum und die Empfänger-Registry
+ */
+
+import { createHash } from 'crypto';
+import { PublicKey } from '@solana/web3.js';
+import { MerkleHashFn, merkleLayers } from '../src/client/merkle-multiproof';
+import { poseidonHashPair } from '../src/client/poseidon';
+import { PoseidonMerkleTree, walletLeaf } from '../src/client/poseidon-merkle-tree';
+import { RecipientRegistry, verifyRecipientProof } from '../src/client/recipient-registry';
+
+// Schneller Ersatz für Poseidon in Strukturtests
+function countingHash(): MerkleHashFn & { calls: number } {
+  const hash = ((left: Uint8Array, right: Uint8Array) => {
+    hash.calls++;
+    return new Uint8Array(createHash('sha256').update(left).update(right).digest());
+  }) as MerkleHashFn & { calls: number };
+  hash.calls = 0;
+  return hash;
+}
+
+const hex = (bytes: Uint8Array) => Buffer.from(bytes).toString('hex');
+const leaves = Array.from({ length: 11 }, (_, i) => new Uint8Array(32).fill(i + 1));
+
+describe('Poseidon-Hash', () => {
+  test('entspricht den Vektoren des Programms', () => {
+    const one = new Uint8Array(32);
+    const two = new Uint8Array(32);
+    one[31] = 1;
+    two[31] = 2;
+    // Gleiche Vektoren wie test_merkle_hash_matches_offchain_vectors
+    expect(hex(poseidonHashPair(one, two)))
+      .toBe('115cc0f5e7d690413df64c6b9662e9cf2a3617f2743245519e19607a4417189a');
+    expect(hex(walletLeaf(new PublicKey(new Uint8Array(32).fill(0xff)))))
+      .toBe('2578c8bbec89b2fe57969cfb9b884d2e92f1949334ac9530537b324dc674f63d');
+  });
+
+  test('lehnt Werte außerhalb des Feldes ab', () => {
+    const max = new Uint8Array(32).fill(0xff);
+    expect(() => poseidonHashPair(max, new Uint8Array(32))).toThrow();
+  });
+});
+
+describe('PoseidonMerkleTree', () => {
+  test('Einfügen ergibt dieselbe Wurzel wie der Gesamtaufbau', () => {
+    const hash = countingHash();
+    const incremental = new PoseidonMerkleTree(4, hash);
+    hash.calls = 0;
+    for (const leaf of leaves) {
+      incremental.insert(leaf);
+    }
+    // depth Hashes je Blatt
+    expect(hash.calls).toBe(leaves.length * 4);
+
+    const bulk = PoseidonMerkleTree.fromLeaves(leaves, 4, hash);
+    expect(incremental.root).toEqual(bulk.root);
+    expect(bulk.root).toEqual(merkleLayers([...leaves, ...Array(5).fill(new Uint8Array(32))], hash)[4][0]);
+  });
+
+  test('Aktualisieren entspricht einem Neuaufbau', () => {
+    const hash = countingHash();
+    const tree = PoseidonMerkleTree.fromLeaves(leaves, 4, hash);
+    const replaced = new Uint8Array(32).fill(0xaa);
+    tree.update(3, replaced);
+
+    const expected = [...leaves];
+    expected[3] = replaced;
+    expect(tree.root).toEqual(PoseidonMerkleTree.fromLeaves(expected, 4, hash).root);
+    expect(() => tree.update(leaves.length, replaced)).toThrow();
+  });
+
+  test('Proofs haben das Format von verify_merkle_proof', () => {
+    const hash = countingHash();
+    const tree = PoseidonMerkleTree.fromLeaves(leaves, 4, hash);
+    hash.calls = 0;
+    const proof = tree.proof(5);
+    expect(hash.calls).toBe(0);
+
+    // depth + 1 Byte Richtungsbits + 4 Geschwister
+    expect(proof.length).toBe(1 + 1 + 4 * 32);
+    expect(proof[0]).toBe(4);
+    expect(proof[1]).toBe(0b0101);
+
+    let node = tree.leaf(5);
+    for (let level = 0; level < 4; level++) {
+      const sibling = proof.subarray(2 + level * 32, 2 + (level + 1) * 32);
+      node = proof[1] & (1 << level) ? hash(sibling, node) : hash(node, sibling);
+    }
+    expect(node).toEqual(tree.root);
+  });
+
+  test('Snapshot wird ohne Hashen wiederhergestellt', () => {
+    const hash = countingHash();
+    const tree = PoseidonMerkleTree.fromLeaves(leaves, 4, hash);
+    const snapshot = tree.snapshot();
+
+    hash.calls = 0;
+    const restored = PoseidonMerkleTree.fromSnapshot(snapshot, hash);
+    // Nur der Cache der leeren Teilbäume
+    expect(hash.calls).toBe(4);
+    expect(restored.size).toBe(leaves.length);
+    expect(restored.root).toEqual(tree.root);
+    expect(restored.proof(7)).toEqual(tree.proof(7));
+
+    restored.insert(new Uint8Array(32).fill(0xbb));
+    tree.insert(new Uint8Array(32).fill(0xbb));
+    expect(restored.root).toEqual(tree.root);
+
+    expect(() => PoseidonMerkleTree.fromSnapshot(snapshot.subarray(0, snapshot.length - 1), hash)).toThrow();
+    expect(() => PoseidonMerkleTree.fromSnapshot(Buffer.from('ZMT0'), hash)).toThrow();
+  });
+
+  test('lehnt Einfügen in einen vollen Baum ab', () => {
+    const tree = new PoseidonMerkleTree(1, countingHash());
+    tree.insert(leaves[0]);
+    tree.insert(leaves[1]);
+    expect(() => tree.insert(leaves[2])).toThrow();
+  });
+});
+
+describe('RecipientRegistry', () => {
+  const wallets = Array.from({ length: 3 }, (_, i) => new PublicKey(new Uint8Array(32).fill(i + 1)));
+
+  test('registriert, ersetzt und beweist Wallets', () => {
+    const registry = new RecipientRegistry(new PoseidonMerkleTree(4));
+    expect(wallets.map(wallet => registry.add(wallet))).toEqual([0, 1, 2]);
+    expect(registry.add(wallets[1])).toBe(1);
+    expect(registry.size).toBe(3);
+
+    const proof = registry.proofFor(wallets[2]);
+    expect(proof.index).toBe(2);
+    expect(proof.leaf).toEqual(walletLeaf(wallets[2]));
+    expect(proof.root).toEqual(registry.root);
+    expect(proof.proof[0]).toBe(4);
+    expect(verifyRecipientProof(proof, wallets[2])).toBe(true);
+    expect(verifyRecipientProof(proof, wallets[1])).toBe(false);
+
+    const next = new PublicKey(new Uint8Array(32).fill(9));
+    expect(registry.replace(wallets[0], next)).toBe(0);
+    expect(registry.has(wallets[0])).toBe(false);
+    expect(() => registry.proofFor(wallets[0])).toThrow();
+    expect(() => registry.replace(next, wallets[1])).toThrow();
+    expect(registry.root)
+      .toEqual(RecipientRegistry.fromWallets([next, wallets[1], wallets[2]], 4).root);
+  });
+
+  test('Snapshot enthält Wallets und Baum', () => {
+    const registry = RecipientRegistry.fromWallets(wallets, 4);
+    const restored = RecipientRegistry.fromSnapshot(registry.snapshot());
+
+    expect(restored.size).toBe(3);
+    expect(restored.root).toEqual(registry.root);
+    expect(restored.proofFor(wallets[1])).toEqual(registry.proofFor(wallets[1]));
+    expect(() => RecipientRegistry.fromSnapshot(new Uint8Array(3))).toThrow();
+  });
+});
@@ -0,0 +1,116 @@
+/**
+ * Tests für den Proof-Pool
+ *
+ * Die Worker werden durch kontrollierbare Fakes ersetzt, damit Queueing,
+ * Parallelität und Abbruch deterministisch geprüft werden können.
+ */
+
+import { Keypair } from '@solana/web3.js';
+import { ProofRequest, ProofResponse } from '../src/proof-generator/proof-job';
+import {
+  ProofCancelledError,
+  ProofPool,
+  ProofWorker,
+  createInlineWorkerFactory
+} from '../src/proof-generator/proof-pool';
+
+interface FakeWorker extends ProofWorker {
+  requests: ProofRequest[];
+  terminated: boolean;
+  finish(proof?: Uint8Array): void;
+}
+
+function fakeFactory() {
+  const workers: FakeWorker[] = [];
+  const factory = () => {
+    let listener: (response: ProofResponse) => void = () => {};
+    const worker: FakeWorker = {
+      requests: [],
+      terminated: false,
+      postMessage: request => { worker.requests.push(request); },
+      onMessage: l => { listener = l; },
+      onError: () => {},
+      terminate: () => { worker.terminated = true; },
+      finish: (proof = new Uint8Array([1])) => {
+        listener({ id: worker.requests[worker.requests.length - 1].id, proof });
+      }
+    };
+    workers.push(worker);
+    return worker;
+  };
+  return { factory, workers };
+}
+
+const hopJob = (hopIndex: number) => ({
+  kind: 'hop' as const,
+  hopIndex,
+  seed: new Uint8Array(32),
+  realSplits: new Array(8).fill(BigInt(1))
+});
+
+describe('ProofPool', () => {
+  test('hält höchstens size Jobs gleichzeitig in Arbeit', async () => {
+    const { factory, workers } = fakeFactory();
+    const pool = new ProofPool(2, factory);
+
+    const proofs = [0, 1, 2].map(i => pool.submit(hopJob(i)));
+    expect(workers).toHaveLength(2);
+    expect(pool.inFlight).toBe(2);
+    expect(pool.queued).toBe(1);
+
+    workers[0].finish(new Uint8Array([7]));
+    await expect(proofs[0]).resolves.toEqual(new Uint8Array([7]));
+    // Der freie Worker übernimmt den wartenden Job
+    expect(workers[0].requests).toHaveLength(2);
+
+    workers[0].finish();
+    workers[1].finish();
+    await Promise.all(proofs);
+    expect(pool.inFlight).toBe(0);
+    pool.close();
+  });
+
+  test('bricht wartende und laufende Jobs ab', async () => {
+    const { factory, workers } = fakeFactory();
+    const pool = new ProofPool(1, factory);
+    const controller = new AbortController();
+
+    const running = pool.submit(hopJob(0), controller.signal);
+    const waiting = pool.submit(hopJob(1));
+    controller.abort();
+
+    await expect(running).rejects.toBeInstanceOf(ProofCancelledError);
+    expect(workers[0].terminated).toBe(true);
+    // Der wartende Job läuft auf einem neuen Worker weiter
+    expect(workers).toHaveLength(2);
+    workers[1].finish();
+    await expect(waiting).resolves.toBeDefined();
+    pool.close();
+  });
+
+  test('Batch wird bei einem Fehler vollständig abgebrochen', async () => {
+    const { factory, workers } = fakeFactory();
+    const pool = new ProofPool(2, factory);
+
+    const batch = pool.submitBatch([hopJob(0), hopJob(1), hopJob(2)]);
+    pool.close();
+
+    await expect(batch).rejects.toBeInstanceOf(ProofCancelledError);
+    expect(workers.every(w => w.terminated)).toBe(true);
+  });
+
+  test('Inline-Worker erzeugen echte Proofs', async () => {
+    const pool = new ProofPool(2, createInlineWorkerFactory());
+    const sender = Keypair.generate().publicKey;
+    const recipient = Keypair.generate().publicKey;
+
+    const [initial, final] = await Promise.all([
+      pool.generateInitialProof(BigInt(1_000_000), sender, recipient),
+      pool.generateFinalProof(BigInt(1_000_000), sender, recipient, [new Uint8Array(32)])
+    ]);
+
+    expect(initial).toHaveLength(128);
+    expect(final).toHaveLength(128);
+    pool.close();
+  });
+});
@@ -120,6 +120,49 @@ describe('Temporal Obfuscation', () => {
       expect(scheduledCount).toBe(transactions.length);
     });
     
+    test('due transactions are sent concurrently up to maxInFlight', async () => {
+      jest.useFakeTimers();
+      
+      const flushMicrotasks = async () => {
+        for (let i = 0; i < 5; i++) await Promise.resolve();
+      };
+      
+      // Sends stay pending until resolved by the test
+      const pending: Array<(signature: string) => void> = [];
+      const sendTransaction = jest.fn(() => new Promise<string>(resolve => pending.push(resolve)));
+      const limited = new TemporalObfuscationManager(
+        { sendTransaction } as unknown as Connection,
+        { ...DEFAULT_TEMPORAL_CONFIG, maxInFlight: 2 }
+      );
+      
+      // Pre-signed transactions carry their blockhash
+      const signedTransaction = () => {
+        const tx = new Transaction();
+        tx.recentBlockhash = '11111111111111111111111111111111';
+        return tx;
+      };
+      [0, 1, 2].forEach(hop => limited.scheduleTransaction(signedTransaction(), hop));
+      jest.advanceTimersByTime(DEFAULT_TEMPORAL_CONFIG.maxDelay * 2);
+      
+      // Only two sends in flight, the third waits for a free slot
+      expect(sendTransaction).toHaveBeenCalledTimes(2);
+      expect(limited.getDiagnosticInfo().inFlight).toBe(2);
+      
+      pending[0]('sig-0');
+      await flushMicrotasks();
+      expect(sendTransaction).toHaveBeenCalledTimes(3);
+      
+      pending[1]('sig-1');
+      pending[2]('sig-2');
+      await flushMicrotasks();
+      
+      const diagnostics = limited.getDiagnosticInfo();
+      expect(diagnostics.executed).toBe(3);
+      expect(diagnostics.scheduled).toBe(0);
+      expect(diagnostics.meanSchedulingLag).toBeGreaterThanOrEqual(0);
+      limited.stopProcessing();
+    });
+    
     test('getDiagnosticInfo should return valid diagnostic information', () => {
       const diagnostics = manager.getDiagnosticInfo();
       
@@ -0,0 +1,59 @@
+/**
+ * Tests für Transfer-Nonces und die Nonce-Vergabe paralleler Transfers
+ */
+
+import { PublicKey } from '@solana/web3.js';
+import {
+  deriveTransferRegistry,
+  deriveTransferState,
+  MAX_OPEN_TRANSFERS,
+  NonceAllocator,
+  transferNonceSeed
+} from '../src/client/transfer-registry';
+
+const programId = new PublicKey(new Uint8Array(32).fill(5));
+const owner = new PublicKey(new Uint8Array(32).fill(7));
+
+describe('Transfer-Nonces', () => {
+  test('Nonce 0 behält die bisherige Transfer-State-Adresse', () => {
+    const [legacy] = PublicKey.findProgramAddressSync(
+      [Buffer.from('transfer'), owner.toBuffer()],
+      programId
+    );
+    expect(transferNonceSeed(0).length).toBe(0);
+    expect(deriveTransferState(programId, owner)).toEqual(legacy);
+  });
+
+  test('jede Nonce hat eine eigene Adresse', () => {
+    expect(transferNonceSeed(0x04030201)).toEqual(Buffer.from([1, 2, 3, 4]));
+    const addresses = [0, 1, 2, 3].map(nonce => deriveTransferState(programId, owner, nonce).toBase58());
+    expect(new Set(addresses).size).toBe(4);
+    expect(deriveTransferRegistry(programId, owner).toBase58()).not.toBe(addresses[0]);
+    expect(() => transferNonceSeed(-1)).toThrow();
+    expect(() => transferNonceSeed(2 ** 32)).toThrow();
+  });
+});
+
+describe('NonceAllocator', () => {
+  test('überspringt offene Nonces und vergibt keine doppelt', () => {
+    const nonces = new NonceAllocator([1, 3], 1);
+    expect([nonces.acquire(), nonces.acquire(), nonces.acquire()]).toEqual([2, 4, 5]);
+    expect(nonces.inUse).toBe(5);
+
+    nonces.release(2);
+    expect(nonces.available).toBe(MAX_OPEN_TRANSFERS - 4);
+    expect(nonces.acquire()).toBe(6);
+  });
+
+  test('begrenzt auf die Plätze der Registry', () => {
+    const nonces = new NonceAllocator();
+    for (let i = 0; i < MAX_OPEN_TRANSFERS; i++) {
+      nonces.acquire();
+    }
+    expect(nonces.available).toBe(0);
+    expect(() => nonces.acquire()).toThrow();
+
+    nonces.release(3);
+    expect(nonces.acquire()).toBe(MAX_OPEN_TRANSFERS + 1);
+  });
+});
@@ -6,13 +6,13 @@
 //! ## Main Features
 //! 
 //! - Poseidon hash functionality with BN254 parameters
+//! - Compile-time MDS matrix and round constants in Montgomery form
 //! - Clean error handling with meaningful error messages
 //! - Comprehensive tests for consistency and correctness
 //! - Optional Anchor compatibility layer
+//! - Optional `parallel` batch hashing on the host (rayon)
 
 use solana_poseidon::{hashv, Parameters, Endianness};
-use curve25519_dalek::scalar::Scalar;
-use num_bigint::BigUint;
 // fmt wird nicht benützt
 // use std::fmt;
 use thiserror::Error;
@@ -36,72 +36,26 @@ pub enum PoseidonError {
 /// Short alias for Result with PoseidonError
 pub type Result<T> = std::result::Result<T, PoseidonError>;
 
+/// Compile-time Poseidon parameter tables (shared with the on-chain crate)
+pub mod params;
+
 /// Poseidon constants and helper tools
 pub mod constants {
     use super::*;
     
-    pub const POSEIDON_FULL_ROUNDS: usize = 8;
-    pub const POSEIDON_PARTIAL_ROUNDS: usize = 57;
-    pub const POSEIDON_WIDTH: usize = 3;
-    
-    /// Converts a hex string into a Scalar value
-    pub fn scalar_from_hex(s: &str) -> Result<Scalar> {
-        let s = if s.starts_with("0x") { &s[2..] } else { s };
-        
-        // Convert hexadecimal to BigUint
-        let big_uint = BigUint::parse_bytes(s.as_bytes(), 16)
-            .ok_or_else(|| PoseidonError::ConversionError(
-                format!("Failed to parse hex string: {}", s)
-            ))?;
-        
-        // BigUint zu bytes konvertieren
-        let bytes = big_uint.to_bytes_be();
-        
-        // Scalar von bytes konvertieren
-        let mut array = [0u8; 32];
-        let len = std::cmp::min(bytes.len(), 32);
-        array[32 - len..].copy_from_slice(&bytes[..len]);
-        
-        Ok(Scalar::from_bytes_mod_order(array))
-    }
+    pub use crate::params::{
+        get_mds_matrix, get_round_constants, FieldElement, MDS_MATRIX, ROUND_CONSTANTS,
+        ROUND_CONSTANT_COUNT, POSEIDON_FULL_ROUNDS, POSEIDON_PARTIAL_ROUNDS, POSEIDON_WIDTH,
+    };
     
-    /// Generates the MDS matrix for Poseidon
-    pub fn get_mds_matrix() -> Result<Vec<Vec<Scalar>>> {
-        let mds_hex = [
-            ["3d955d6c02fe4d7cb500e12f2b55eff668a7b4386bd27413766713c93f2acfcd", 
-             "3798866f4e6058035dcf8addb2cf1771fac234bcc8fc05d6676e77e797f224bf", 
-             "2c51456a7bf2467eac813649f3f25ea896eac27c5da020dae54a6e640278fda2"],
-            ["20088ca07bbcd7490a0218ebc0ecb31d0ea34840e2dc2d33a1a5adfecff83b43", 
-             "1d04ba0915e7807c968ea4b1cb2d610c7f9a16b4033f02ebacbb948c86a988c3", 
-             "5387ccd5729d7acbd09d96714d1d18bbd0eeaefb2ddee3d2ef573c9c7f953307"],
-            ["1e208f585a72558534281562cad89659b428ec61433293a8d7f0f0e38a6726ac", 
-             "0455ebf862f0b60f69698e97d36e8aafd4d107cae2b61be1858b23a3363642e0", 
-             "569e2c206119e89455852059f707370e2c1fc9721f6c50991cedbbf782daef54"],
-        ];
-        
-        let result = mds_hex.iter()
-            .map(|row| {
-                row.iter()
-                   .map(|&s| scalar_from_hex(s))
-                   .collect::<Result<Vec<_>>>()
-            })
-            .collect::<Result<Vec<_>>>()?;
-        
-        Ok(result)
-    }
-    
-    /// Generates the round constants for Poseidon
-    pub fn get_round_constants() -> Result<Vec<Scalar>> {
-        let constants_hex = [
-            "6c4ffa723eaf1a7bf74905cc7dae4ca9ff4a2c3bc81d42e09540d1f250910880",
-            "54dd837eccf180c92c2f53a3476e45a156ab69a403b6b9fdfd8dd970fddcdd9a",
-            "a5316c9a43627a37481bfc4a85a23b87a97b697d9c6e34ad677c585d7084300c",
-            // Add more constants from poseidon_constants.rs here
-        ];
-        
-        constants_hex.iter()
-            .map(|&s| scalar_from_hex(s))
-            .collect()
+    /// Converts a 64-digit hex string (optional `0x` prefix) into a field element
+    ///
+    /// Only needed for values that are not known at compile time; the
+    /// parameter tables themselves are built by `FieldElement::from_hex`.
+    pub fn field_from_hex(s: &str) -> Result<FieldElement> {
+        FieldElement::parse_hex(s).ok_or_else(|| PoseidonError::ConversionError(
+            format!("Failed to parse hex string: {}", s)
+        ))
     }
 }
 
@@ -149,15 +103,83 @@ pub mod hash {
     }
     
     /// Batch processing of hash inputs
+    ///
+    /// With the `parallel` feature (host builds only) the sets are spread
+    /// across the rayon pool; the order of the results is unchanged.
     pub fn batch_hash(input_sets: &[Vec<&[u8]>]) -> Result<Vec<[u8; 32]>> {
-        let mut results = Vec::with_capacity(input_sets.len());
+        #[cfg(all(feature = "parallel", not(target_os = "solana")))]
+        {
+            use rayon::prelude::*;
+            input_sets.par_iter().map(|inputs| generate_hash(inputs)).collect()
+        }
         
-        for inputs in input_sets {
-            let hash_bytes = generate_hash(inputs.as_slice())?;
-            results.push(hash_bytes);
+        #[cfg(not(all(feature = "parallel", not(target_os = "solana"))))]
+        {
+            let mut results = Vec::with_capacity(input_sets.len());
+            
+            for inputs in input_sets {
+                let hash_bytes = generate_hash(inputs.as_slice())?;
+                results.push(hash_bytes);
+            }
+            
+            Ok(results)
+        }
+    }
+    
+    /// Largest number of inputs per set accepted by `batch_hash_into`
+    /// (the Bn254X5 parameters support widths up to 13)
+    pub const MAX_BATCH_ARITY: usize = 12;
+    
+    /// Hashes one set of the flat layout without allocating
+    fn hash_flat_set(set: &[[u8; 32]]) -> Result<[u8; 32]> {
+        let mut inputs: [&[u8]; MAX_BATCH_ARITY] = [&[]; MAX_BATCH_ARITY];
+        for (input, element) in inputs.iter_mut().zip(set) {
+            *input = &element[..];
+        }
+        generate_hash(&inputs[..set.len()])
+    }
+    
+    /// Batch processing over a flat, contiguous input layout
+    ///
+    /// `inputs` holds `out.len()` sets of `arity` big-endian field elements
+    /// back to back; set `i` is written to `out[i]`. Shorter inputs must be
+    /// left-padded with zeros, which yields the same hash as `generate_hash`
+    /// on the unpadded bytes. Nothing is allocated per set, so callers can
+    /// reuse both buffers across batches.
+    ///
+    /// With the `parallel` feature (host builds only) the sets are spread
+    /// across the rayon pool; the on-chain build always hashes sequentially.
+    pub fn batch_hash_into(inputs: &[[u8; 32]], arity: usize, out: &mut [[u8; 32]]) -> Result<()> {
+        if arity == 0 || arity > MAX_BATCH_ARITY {
+            return Err(PoseidonError::HashingError(
+                format!("Batch arity must be between 1 and {}, got {}", MAX_BATCH_ARITY, arity)
+            ));
+        }
+        if inputs.len() != arity * out.len() {
+            return Err(PoseidonError::HashingError(
+                format!("Expected {} inputs for {} sets of arity {}, got {}",
+                        arity * out.len(), out.len(), arity, inputs.len())
+            ));
+        }
+        
+        #[cfg(all(feature = "parallel", not(target_os = "solana")))]
+        {
+            use rayon::prelude::*;
+            out.par_iter_mut()
+                .zip(inputs.par_chunks_exact(arity))
+                .try_for_each(|(digest, set)| -> Result<()> {
+                    *digest = hash_flat_set(set)?;
+                    Ok(())
+                })
         }
         
-        Ok(results)
+        #[cfg(not(all(feature = "parallel", not(target_os = "solana"))))]
+        {
+            for (digest, set) in out.iter_mut().zip(inputs.chunks_exact(arity)) {
+                *digest = hash_flat_set(set)?;
+            }
+            Ok(())
+        }
     }
     
     /// Helper function for debug output during development
@@ -209,6 +231,11 @@ pub mod anchor {
     pub fn batch_hash(input_sets: &[Vec<&[u8]>]) -> anchor_lang::Result<Vec<[u8; 32]>> {
         hash::batch_hash(input_sets).map_err(convert_error)
     }
+    
+    /// Batch hash a flat input layout into `out` (Anchor-compatible)
+    pub fn batch_hash_into(inputs: &[[u8; 32]], arity: usize, out: &mut [[u8; 32]]) -> anchor_lang::Result<()> {
+        hash::batch_hash_into(inputs, arity, out).map_err(convert_error)
+    }
 }
 
 #[cfg(test)]
@@ -241,36 +268,37 @@ mod tests {
         // Der ursprüngliche Hex-String
         let hex_value = "3d955d6c02fe4d7cb500e12f2b55eff668a7b4386bd27413766713c93f2acfcd";
         
-        // Konvertieren zu Scalar und zurück
-        let scalar = constants::scalar_from_hex(hex_value).unwrap();
-        let bytes = scalar.to_bytes();
+        // Laufzeit-Konvertierung muss dem Compile-Time-Tabelleneintrag entsprechen
+        let element = constants::field_from_hex(hex_value).unwrap();
+        assert_eq!(element, constants::MDS_MATRIX[0][0],
+                  "Runtime conversion should match the compile-time table");
         
-        // Validierung, dass der Scalar nicht null ist
-        assert!(!bytes.iter().all(|&b| b == 0), 
-               "Scalar conversion produced all zeros, which is invalid");
+        // Validierung, dass das Element nicht null ist
+        assert!(!element.to_bytes().iter().all(|&b| b == 0), 
+               "Conversion produced all zeros, which is invalid");
         
-        // Validierung, dass der Scalar in gültigem Bereich liegt
-        // (es ist nicht erforderlich, dass die genaue Hex-Darstellung zurückkommt,
-        // aber es muss ein gültiger Scalar-Wert sein)
-        let reconverted_scalar = Scalar::from_bytes_mod_order(bytes);
-        assert_eq!(scalar, reconverted_scalar, 
-                  "Scalar roundtrip conversion should preserve the value");
+        // Die kanonische Darstellung ist reduziert und lässt sich erneut einlesen
+        let reconverted = constants::field_from_hex(&hex::encode(element.to_bytes())).unwrap();
+        assert_eq!(element, reconverted, 
+                  "Roundtrip conversion should preserve the value");
         
         // Test mit 0x-Präfix - dieses Feature muss erhalten bleiben
         let hex_with_prefix = format!("0x{}", hex_value);
-        let scalar2 = constants::scalar_from_hex(&hex_with_prefix).unwrap();
-        assert_eq!(scalar, scalar2, 
+        let element2 = constants::field_from_hex(&hex_with_prefix).unwrap();
+        assert_eq!(element, element2, 
                  "Conversion with and without 0x prefix should give the same result");
     }
     
     #[test]
     fn test_mds_matrix_dimensions() {
-        let mds = constants::get_mds_matrix().unwrap();
+        let mds = constants::get_mds_matrix();
         
         assert_eq!(mds.len(), 3, "MDS matrix should have 3 rows");
-        for row in &mds {
+        for row in mds {
             assert_eq!(row.len(), 3, "Each row should have 3 columns");
         }
+        assert_eq!(constants::get_round_constants().len(), 195,
+                  "t = 3 with 8 full and 57 partial rounds needs 195 constants");
     }
     
     #[test]
@@ -294,11 +322,36 @@ mod tests {
         }
     }
     
+    #[test]
+    fn test_flat_batch_processing() {
+        // Drei Sätze mit je zwei Feldelementen, hintereinander abgelegt
+        let mut flat = [[0u8; 32]; 6];
+        for (i, element) in flat.iter_mut().enumerate() {
+            element[31] = i as u8 + 1;
+        }
+        let nested: Vec<Vec<&[u8]>> = flat.chunks(2)
+            .map(|set| set.iter().map(|element| &element[..]).collect())
+            .collect();
+        
+        let mut out = [[0u8; 32]; 3];
+        hash::batch_hash_into(&flat, 2, &mut out).unwrap();
+        assert_eq!(out.to_vec(), hash::batch_hash(&nested).unwrap(),
+                  "Flat and nested batch layouts should produce the same hashes");
+        
+        // Links aufgefüllte Eingaben entsprechen den ungekürzten Bytes
+        assert_eq!(out[0], hash::generate_hash(&[&[1u8][..], &[2u8][..]]).unwrap(),
+                  "Left padding should not change the hash");
+        
+        // Eingaben, die nicht zur Ausgabe passen, werden abgelehnt
+        assert!(hash::batch_hash_into(&flat[..5], 2, &mut out).is_err());
+        assert!(hash::batch_hash_into(&flat, 0, &mut []).is_err());
+    }
+    
     #[test]
     fn test_error_handling() {
         // Ungültiger Hex-String sollte zu Fehler führen
         let invalid_hex = "xyz"; // keine gültige Hex
-        let result = constants::scalar_from_hex(invalid_hex);
+        let result = constants::field_from_hex(invalid_hex);
         assert!(result.is_err(), "Invalid hex should result in error");
         
         // Prüfe, ob der richtige Fehlertyp zurückgegeben wird
@@ -3,8 +3,7 @@
 // and validates its functionality
 
 use solana_poseidon::{hashv, Parameters, Endianness};
-use curve25519_dalek::scalar::Scalar;
-use num_bigint::BigUint;
+use zeclipse_poseidon::params::{self, FieldElement};
 
 fn main() {
     println!("\n\n=================================");
@@ -32,8 +31,8 @@ fn run_all_tests() -> Result<(), String> {
     // Test 2: Hash consistency
     test_hash_consistency()?;
     
-    // Test 3: Conversion from hex to Scalar
-    test_hex_to_scalar()?;
+    // Test 3: Conversion from hex to field elements
+    test_hex_to_field()?;
     
     // Test 4: MDS matrix and round constants
     test_constants()?;
@@ -97,36 +96,37 @@ fn test_hash_consistency() -> Result<(), String> {
     Ok(())
 }
 
-fn test_hex_to_scalar() -> Result<(), String> {
-    println!("\n[Test 3] Conversion from hex to Scalar");
-    println!("----------------------------------");
+fn test_hex_to_field() -> Result<(), String> {
+    println!("\n[Test 3] Conversion from hex to field elements");
+    println!("------------------------------------------");
     
-    // Some test hex strings
+    // The first MDS row as hex; the compile-time table must hold the same values
     let hex_values = [
         "3d955d6c02fe4d7cb500e12f2b55eff668a7b4386bd27413766713c93f2acfcd",
         "3798866f4e6058035dcf8addb2cf1771fac234bcc8fc05d6676e77e797f224bf",
         "2c51456a7bf2467eac813649f3f25ea896eac27c5da020dae54a6e640278fda2",
     ];
     
-    println!("Converting {} hex strings to Scalar values...", hex_values.len());
+    println!("Converting {} hex strings to field elements...", hex_values.len());
     
-    // Convert all hex strings to Scalar values
-    let scalars: Vec<Scalar> = hex_values.iter().map(|&s| {
-        println!("Processing: {}", s);
-        scalar_from_hex(s)
-    }).collect();
-    
-    // Verify that the converted values are not trivial
-    for (i, scalar) in scalars.iter().enumerate() {
-        if scalar.to_bytes().iter().all(|&b| b == 0) {
+    for (i, &hex_value) in hex_values.iter().enumerate() {
+        println!("Processing: {}", hex_value);
+        let element = FieldElement::parse_hex(hex_value)
+            .ok_or_else(|| format!("Failed to parse hex string: {}", hex_value))?;
+        
+        // Verify that the converted values are not trivial
+        if element.is_zero() {
             return Err(format!(
-                "Converted Scalar for '{}' is zero, which cannot be correct",
-                hex_values[i]
+                "Converted field element for '{}' is zero, which cannot be correct",
+                hex_value
             ));
         }
+        if element != params::MDS_MATRIX[0][i] {
+            return Err(format!("Runtime conversion of '{}' differs from the compile-time table", hex_value));
+        }
     }
     
-    println!("✅ Successfully converted all {} hex strings to valid Scalar values", hex_values.len());
+    println!("✅ Successfully converted all {} hex strings to valid field elements", hex_values.len());
     Ok(())
 }
 
@@ -134,60 +134,25 @@ fn test_constants() -> Result<(), String> {
     println!("\n[Test 4] MDS Matrix and Round Constants");
     println!("-----------------------------------");
     
-    // Create MDS matrix from hex constants
-    println!("Creating MDS matrix from hex constants...");
-    let mds_hex = [
-        ["3d955d6c02fe4d7cb500e12f2b55eff668a7b4386bd27413766713c93f2acfcd", 
-         "3798866f4e6058035dcf8addb2cf1771fac234bcc8fc05d6676e77e797f224bf", 
-         "2c51456a7bf2467eac813649f3f25ea896eac27c5da020dae54a6e640278fda2"],
-        ["20088ca07bbcd7490a0218ebc0ecb31d0ea34840e2dc2d33a1a5adfecff83b43", 
-         "1d04ba0915e7807c968ea4b1cb2d610c7f9a16b4033f02ebacbb948c86a988c3", 
-         "5387ccd5729d7acbd09d96714d1d18bbd0eeaefb2ddee3d2ef573c9c7f953307"],
-        ["1e208f585a72558534281562cad89659b428ec61433293a8d7f0f0e38a6726ac", 
-         "0455ebf862f0b60f69698e97d36e8aafd4d107cae2b61be1858b23a3363642e0", 
-         "569e2c206119e89455852059f707370e2c1fc9721f6c50991cedbbf782daef54"],
-    ];
-    
-    let mds_matrix: Vec<Vec<Scalar>> = mds_hex.iter()
-        .map(|row| row.iter().map(|&s| scalar_from_hex(s)).collect())
-        .collect();
-    
-    println!("Successfully created MDS matrix ({} x {} elements)", 
-             mds_matrix.len(), 
-             if mds_matrix.len() > 0 { mds_matrix[0].len() } else { 0 });
+    // Both tables are static; nothing is parsed or allocated here
+    let mds_matrix = params::get_mds_matrix();
+    println!("Loaded MDS matrix ({} x {} elements)", mds_matrix.len(), mds_matrix[0].len());
     
-    // Create round constants from hex strings
-    println!("\nCreating round constants from hex values...");
-    let round_constants_hex = [
-        "6c4ffa723eaf1a7bf74905cc7dae4ca9ff4a2c3bc81d42e09540d1f250910880",
-        "54dd837eccf180c92c2f53a3476e45a156ab69a403b6b9fdfd8dd970fddcdd9a",
-        "a5316c9a43627a37481bfc4a85a23b87a97b697d9c6e34ad677c585d7084300c",
-    ];
+    let round_constants = params::get_round_constants();
+    println!("Loaded round constants ({} elements)", round_constants.len());
     
-    let round_constants: Vec<Scalar> = round_constants_hex.iter()
-        .map(|&s| scalar_from_hex(s))
-        .collect();
-    
-    println!("Successfully created round constants ({} elements)", round_constants.len());
+    if round_constants.len() != params::ROUND_CONSTANT_COUNT {
+        return Err(format!(
+            "Expected {} round constants, found {}",
+            params::ROUND_CONSTANT_COUNT,
+            round_constants.len()
+        ));
+    }
+    if mds_matrix.iter().flatten().chain(round_constants.iter()).any(FieldElement::is_zero) {
+        return Err("Parameter tables contain a zero element".to_string());
+    }
     
+    println!("First round constant: 0x{}", hex::encode(round_constants[0].to_bytes()));
     println!("✅ Successfully validated Poseidon constants");
     Ok(())
 }
-
-// Helper function for converting hex strings to Scalar values
-fn scalar_from_hex(s: &str) -> Scalar {
-    let s = if s.starts_with("0x") { &s[2..] } else { s };
-    
-    // Convert hexadecimal to BigUint
-    let big_uint = BigUint::parse_bytes(s.as_bytes(), 16)
-        .unwrap_or_else(|| panic!("Failed to parse hex string for Scalar: {}", s));
-    
-    // Convert BigUint to bytes
-    let bytes = big_uint.to_bytes_be();
-    
-    // Convert Scalar from bytes (updated method for curve25519-dalek v4)
-    let mut array = [0u8; 32];
-    let len = std::cmp::min(bytes.len(), 32);
-    array[32 - len..].copy_from_slice(&bytes[..len]);
-    Scalar::from_bytes_mod_order(array)
-}
@@ -0,0 +1,191 @@
+//! Criterion benchmarks for the host-side hot paths
+//!
+//! Covers the functions the off-chain relayer calls in its hot loop, at the
+//! sizes of the fixed configuration: 4 hops x 48 splits (4 real, 44 fake),
+//! 8 commitments and 20-level Merkle paths.
+//!
+//! Record a baseline and compare against it with `benches/run_benches.sh`
+//! (`--save <name>` / `--compare <name>`); the comparison fails when a
+//! benchmark regressed beyond the threshold.
+
+use criterion::{black_box, criterion_group, criterion_main, BatchSize, Criterion};
+use solana_program::program_stubs::{set_syscall_stubs, SyscallStubs};
+use solana_program::pubkey::Pubkey;
+
+use zeclipse::bloom::{bloom_insert, BloomParams, FAKE_BLOOM_BYTES};
+use zeclipse::hash_context::HashContext;
+use zeclipse::state::BlackoutConfig;
+use zeclipse::stealth_pda::{compute_bump_table, create_stealth_pda, find_stealth_pda, lookup_bump};
+use zeclipse::utils::{
+    check_bloom_filter,
+    extract_splits,
+    generate_bloom_filter,
+    generate_fake_splits,
+    poseidon_hash_commitments,
+    verify_merkle_proof,
+};
+
+const HOPS: u8 = 4;
+const SPLITS_PER_HOP: u8 = 48;
+const REAL_SPLITS: u8 = 4;
+const MERKLE_LEVELS: usize = 20;
+const AMOUNT: u64 = 1_000_000_000;
+
+const CHALLENGE: [u8; 32] = [7u8; 32];
+const SEED: [u8; 32] = [42u8; 32];
+
+/// Drops `msg!` output, which the default host stubs print to stdout and
+/// which would otherwise dominate the measured time
+struct QuietStubs;
+
+impl SyscallStubs for QuietStubs {
+    fn sol_log(&self, _message: &str) {}
+}
+
+fn quiet_logs() {
+    set_syscall_stubs(Box::new(QuietStubs));
+}
+
+/// Proof whose split commitments (bytes 48..80) are zero: equal splits that
+/// pass all checks of `extract_splits`
+fn split_proof() -> [u8; 128] {
+    let mut proof = [0u8; 128];
+    for (i, byte) in proof.iter_mut().enumerate() {
+        if !(48..80).contains(&i) {
+            *byte = i as u8;
+        }
+    }
+    proof
+}
+
+/// Valid 20-level Merkle proof in the `verify_merkle_proof` format, with its root
+fn merkle_fixture(leaf: &Pubkey) -> (Vec<u8>, [u8; 32]) {
+    let direction_bytes = (MERKLE_LEVELS + 7) / 8;
+    let mut proof = vec![0u8; 1 + direction_bytes + MERKLE_LEVELS * 32];
+    proof[0] = MERKLE_LEVELS as u8;
+
+    let mut ctx = HashContext::new();
+    let mut node = leaf.to_bytes();
+    for level in 0..MERKLE_LEVELS {
+        let sibling = [level as u8 + 1; 32];
+        let is_right = level % 3 == 0;
+        if is_right {
+            proof[1 + level / 8] |= 1 << (level % 8);
+        }
+        let offset = 1 + direction_bytes + level * 32;
+        proof[offset..offset + 32].copy_from_slice(&sibling);
+        node = if is_right {
+            ctx.hash_pair(&sibling, &node).unwrap()
+        } else {
+            ctx.hash_pair(&node, &sibling).unwrap()
+        };
+    }
+    (proof, node)
+}
+
+fn bench_hashing(c: &mut Criterion) {
+    quiet_logs();
+    let mut group = c.benchmark_group("poseidon");
+    let commitments: [[u8; 32]; 8] = core::array::from_fn(|i| [i as u8 + 1; 32]);
+    group.bench_function("hash_commitments_8", |b| {
+        let mut ctx = HashContext::new();
+        b.iter(|| poseidon_hash_commitments(&mut ctx, black_box(&commitments)).unwrap())
+    });
+
+    let leaf = Pubkey::new_from_array([9u8; 32]);
+    let (proof, root) = merkle_fixture(&leaf);
+    group.bench_function("verify_merkle_proof_20", |b| {
+        let mut ctx = HashContext::new();
+        b.iter(|| {
+            let valid = verify_merkle_proof(&mut ctx, black_box(&proof), &root, &leaf).unwrap();
+            assert!(valid);
+        })
+    });
+    group.finish();
+}
+
+fn bench_splits(c: &mut Criterion) {
+    let mut group = c.benchmark_group("splits");
+    let proof = split_proof();
+    group.bench_function("extract_splits_4", |b| {
+        let mut ctx = HashContext::new();
+        b.iter(|| extract_splits(&mut ctx, black_box(&proof), AMOUNT, &CHALLENGE).unwrap())
+    });
+
+    let config = BlackoutConfig::new();
+    group.bench_function("generate_fake_splits_44", |b| {
+        let mut ctx = HashContext::new();
+        b.iter(|| generate_fake_splits(&mut ctx, &config, black_box(&CHALLENGE)).unwrap())
+    });
+    group.finish();
+}
+
+fn bench_bloom(c: &mut Criterion) {
+    let mut group = c.benchmark_group("bloom");
+    let config = BlackoutConfig::new();
+    group.bench_function("generate_bloom_filter", |b| {
+        b.iter(|| generate_bloom_filter(black_box(&config), &CHALLENGE))
+    });
+
+    group.bench_function("bloom_insert_4x44", |b| {
+        b.iter_batched(
+            || [0u8; FAKE_BLOOM_BYTES],
+            |mut bloom| {
+                for hop in 0..HOPS {
+                    for split in REAL_SPLITS..SPLITS_PER_HOP {
+                        bloom_insert(&mut bloom, &BloomParams::FAKE_SPLITS, hop, split);
+                    }
+                }
+                bloom
+            },
+            BatchSize::SmallInput,
+        )
+    });
+
+    let bloom = generate_bloom_filter(&config, &CHALLENGE);
+    group.bench_function("check_bloom_filter_4x48", |b| {
+        b.iter(|| {
+            let mut fakes = 0u32;
+            for hop in 0..HOPS {
+                for split in 0..SPLITS_PER_HOP {
+                    fakes += check_bloom_filter(black_box(&bloom), hop, split) as u32;
+                }
+            }
+            fakes
+        })
+    });
+    group.finish();
+}
+
+fn bench_pda(c: &mut Criterion) {
+    let mut group = c.benchmark_group("pda");
+    let program_id = Pubkey::new_from_array([3u8; 32]);
+
+    // Bump search for all 4 x 48 stealth PDAs (client side, once per transfer)
+    group.sample_size(20);
+    group.bench_function("compute_bump_table_4x48", |b| {
+        b.iter(|| compute_bump_table(&program_id, black_box(&SEED), REAL_SPLITS))
+    });
+
+    group.sample_size(100);
+    group.bench_function("find_stealth_pda", |b| {
+        b.iter(|| find_stealth_pda(&program_id, black_box(&SEED), 2, 17, true))
+    });
+
+    // Recreation from the committed bump, as the program does per split
+    let bumps = compute_bump_table(&program_id, &SEED, REAL_SPLITS);
+    group.bench_function("create_stealth_pda_4x48", |b| {
+        b.iter(|| {
+            for hop in 0..HOPS {
+                for split in 0..SPLITS_PER_HOP {
+                    let bump = lookup_bump(&bumps, hop, split).unwrap();
+                    black_box(create_stealth_pda(&program_id, &SEED, hop, split, split >= REAL_SPLITS, bump).unwrap());
+                }
+            }
+        })
+    });
+    group.finish();
+}
+
+criterion_group!(benches, bench_hashing, bench_splits, bench_bloom, bench_pda);
+criterion_main!(benches);
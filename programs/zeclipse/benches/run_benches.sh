@@ -0,0 +1,89 @@
+#!/bin/bash
+
+# ZEclipse benchmark runner
+#
+# Records Criterion baselines for benches/hot_paths.rs and fails when a
+# benchmark regressed against a recorded baseline.
+#
+#   benches/run_benches.sh --save main              record baseline "main"
+#   benches/run_benches.sh --compare main [-t 10]   compare, fail above 10 % slowdown
+#
+# A benchmark counts as regressed when the mean time grew by more than the
+# threshold and Criterion's confidence interval for the change lies entirely
+# above zero (i.e. the slowdown is statistically significant).
+
+set -euo pipefail
+
+RED="\033[0;31m"
+GREEN="\033[0;32m"
+NC="\033[0m"
+
+cd "$(dirname "$0")/.."
+
+MODE=""
+BASELINE=""
+THRESHOLD=10
+
+while [[ $# -gt 0 ]]; do
+  case "$1" in
+    --save|--compare)
+      MODE="$1"
+      BASELINE="${2:?missing baseline name}"
+      shift 2
+      ;;
+    -t|--threshold)
+      THRESHOLD="${2:?missing threshold}"
+      shift 2
+      ;;
+    *)
+      echo "Usage: $0 --save <name> | --compare <name> [-t <percent>]" >&2
+      exit 2
+      ;;
+  esac
+done
+
+if [[ -z "$MODE" ]]; then
+  echo "Usage: $0 --save <name> | --compare <name> [-t <percent>]" >&2
+  exit 2
+fi
+
+TARGET_DIR="${CARGO_TARGET_DIR:-$(cargo metadata --format-version 1 --no-deps \
+  | python3 -c 'import json,sys; print(json.load(sys.stdin)["target_directory"])')}"
+CRITERION_DIR="${TARGET_DIR}/criterion"
+
+if [[ "$MODE" == "--save" ]]; then
+  cargo bench --bench hot_paths -- --save-baseline "$BASELINE"
+  echo -e "${GREEN}Baseline '${BASELINE}' recorded in ${CRITERION_DIR}${NC}"
+  exit 0
+fi
+
+if [[ ! -d "$CRITERION_DIR" ]] || ! find "$CRITERION_DIR" -type d -name "$BASELINE" | grep -q .; then
+  echo -e "${RED}No baseline '${BASELINE}' found; record one with --save ${BASELINE}${NC}" >&2
+  exit 1
+fi
+
+cargo bench --bench hot_paths -- --baseline "$BASELINE"
+
+# Criterion writes the relative change against the baseline to
+# <group>/<bench>/change/estimates.json
+python3 - "$CRITERION_DIR" "$THRESHOLD" <<'EOF'
+import json, pathlib, sys
+
+root, threshold = pathlib.Path(sys.argv[1]), float(sys.argv[2]) / 100.0
+regressions = []
+for path in sorted(root.glob("*/*/change/estimates.json")):
+    mean = json.loads(path.read_text())["mean"]
+    change = mean["point_estimate"]
+    lower = mean["confidence_interval"]["lower_bound"]
+    name = "/".join(path.parts[-4:-2])
+    print(f"{name:<40} {change * 100:+7.2f} %")
+    if change > threshold and lower > 0:
+        regressions.append(name)
+
+if regressions:
+    print(f"\n{len(regressions)} benchmark(s) regressed by more than {threshold * 100:.0f} %:")
+    for name in regressions:
+        print(f"  {name}")
+    sys.exit(1)
+print("\nNo regressions")
+EOF
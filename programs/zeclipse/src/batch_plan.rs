@@ -0,0 +1,190 @@
+//! Account layout and compute budget of a batch hop
+//!
+//! `execute_batch_hop` receives its split PDAs through `remaining_accounts`.
+//! Each account is described by a split key (`hop << 8 | split`) in the
+//! instruction data, so the client can list the accounts in any order,
+//! typically the order of its address lookup table, and the program still
+//! knows which hop/split pair every account stands for.
+//!
+//! Only splits that receive lamports need an account: the real splits and the
+//! first `PRIMARY_FAKE_SPLITS` fake splits of each hop. Secondary fake splits
+//! are never touched. With the default 4 x (4 + 44) layout a full transfer
+//! needs 4 x 8 = 32 split accounts, which fits into one transaction.
+//! With committed fake splits (`FAKE_MODE_COMMITTED`) no fake split is funded
+//! during the hops, so a hop needs only its real splits
+//! (`accounts_per_hop(real_splits, 0)`).
+//!
+//! The cost model below decides how many hops fit under the transaction CU
+//! limit and the account lock limit. The proof is verified once per batch, so
+//! only PDA validation and the lamport credit scale with the number of accounts
+//! (the transfer state is debited in place, see `crate::lamports`).
+
+/// Compute unit limit of a single transaction
+pub const MAX_TRANSACTION_CU: u32 = 1_400_000;
+
+/// Reserve for logging, account loading and the event
+pub const BATCH_CU_HEADROOM: u32 = 60_000;
+
+/// Proof verification and split extraction (once per batch)
+pub const BATCH_BASE_CU: u32 = 90_000;
+
+/// Per-hop bookkeeping (state update, hop window checks)
+pub const HOP_CU: u32 = 4_000;
+
+/// Per split account: one `create_program_address` plus one in-place lamport credit
+pub const SPLIT_ACCOUNT_CU: u32 = 3_000;
+
+/// Account locks allowed per transaction
+pub const MAX_TX_ACCOUNT_LOCKS: usize = 64;
+
+/// Fixed accounts of the batch hop (authority, transfer state, system program, program)
+pub const BATCH_HOP_FIXED_ACCOUNTS: usize = 4;
+
+/// Split accounts that fit next to the fixed accounts
+pub const MAX_BATCH_SPLIT_ACCOUNTS: usize = MAX_TX_ACCOUNT_LOCKS - BATCH_HOP_FIXED_ACCOUNTS;
+
+/// Fake splits per hop that are funded (with the rent-exempt minimum of an
+/// empty account, the smallest balance the runtime lets a new account keep)
+pub const PRIMARY_FAKE_SPLITS: u8 = 4;
+
+/// Fixed accounts of a reclaim (authority, transfer state, owner, system
+/// program, transfer registry, program)
+pub const RECLAIM_FIXED_ACCOUNTS: usize = 6;
+
+/// Split accounts a single reclaim can close
+pub const MAX_RECLAIM_SPLIT_ACCOUNTS: usize = MAX_TX_ACCOUNT_LOCKS - RECLAIM_FIXED_ACCOUNTS;
+
+/// Reclaim bookkeeping and closing the transfer state (once per transaction)
+pub const RECLAIM_BASE_CU: u32 = 15_000;
+
+/// Per reclaimed split account: one `create_program_address` plus one signed
+/// System transfer (split PDAs are owned by the System program)
+pub const RECLAIM_ACCOUNT_CU: u32 = 5_000;
+
+/// Estimated compute units of a reclaim (headroom included)
+pub const fn reclaim_cu_estimate(split_accounts: usize) -> u32 {
+    BATCH_CU_HEADROOM + RECLAIM_BASE_CU + split_accounts as u32 * RECLAIM_ACCOUNT_CU
+}
+
+/// Packs a hop/split pair into a split key
+#[inline(always)]
+pub const fn split_key(hop_index: u8, split_index: u8) -> u16 {
+    ((hop_index as u16) << 8) | split_index as u16
+}
+
+/// Unpacks a split key into its hop/split pair
+#[inline(always)]
+pub const fn split_key_parts(key: u16) -> (u8, u8) {
+    ((key >> 8) as u8, key as u8)
+}
+
+/// Whether a fake split is funded by the batch hops
+///
+/// Depends only on the split index, so the result is independent of the
+/// account order chosen by the client.
+#[inline(always)]
+pub const fn is_primary_fake(split_index: u8, real_splits: u8) -> bool {
+    split_index >= real_splits && split_index - real_splits < PRIMARY_FAKE_SPLITS
+}
+
+/// Split accounts per hop that receive lamports
+pub const fn accounts_per_hop(real_splits: u8, fake_splits: u8) -> u8 {
+    let primary = if fake_splits < PRIMARY_FAKE_SPLITS { fake_splits } else { PRIMARY_FAKE_SPLITS };
+    real_splits.saturating_add(primary)
+}
+
+/// Fake split accounts funded over all hops of a transfer
+///
+/// `initialize` deposits their rent-exempt minimum on top of the amount.
+pub const fn funded_fake_splits(num_hops: u8, fake_splits: u8) -> u64 {
+    num_hops as u64 * accounts_per_hop(0, fake_splits) as u64
+}
+
+/// Estimated compute units of a batch (headroom included)
+pub const fn batch_cu_estimate(hops: u8, split_accounts: usize) -> u32 {
+    let accounts = if split_accounts > MAX_BATCH_SPLIT_ACCOUNTS {
+        MAX_BATCH_SPLIT_ACCOUNTS
+    } else {
+        split_accounts
+    };
+    BATCH_CU_HEADROOM + BATCH_BASE_CU + hops as u32 * HOP_CU + accounts as u32 * SPLIT_ACCOUNT_CU
+}
+
+/// Whether a batch stays within the CU and account lock limits
+pub const fn batch_fits(hops: u8, split_accounts: usize) -> bool {
+    batch_fits_within(hops, split_accounts, MAX_TRANSACTION_CU)
+}
+
+/// Whether a batch stays within `cu_limit` and the account lock limit
+pub const fn batch_fits_within(hops: u8, split_accounts: usize, cu_limit: u32) -> bool {
+    split_accounts <= MAX_BATCH_SPLIT_ACCOUNTS
+        && batch_cu_estimate(hops, split_accounts) <= cu_limit
+}
+
+/// Largest number of hops (at most `remaining_hops`) that fits into one batch
+///
+/// Returns 0 if not even a single hop fits.
+pub fn max_batch_hops(remaining_hops: u8, accounts_per_hop: u8) -> u8 {
+    max_batch_hops_within(remaining_hops, accounts_per_hop, MAX_TRANSACTION_CU)
+}
+
+/// Largest number of hops (at most `remaining_hops`) whose batch stays
+/// within `cu_limit`; 0 if not even a single hop fits
+pub fn max_batch_hops_within(remaining_hops: u8, accounts_per_hop: u8, cu_limit: u32) -> u8 {
+    let mut hops = remaining_hops;
+    while hops > 0 && !batch_fits_within(hops, hops as usize * accounts_per_hop as usize, cu_limit) {
+        hops -= 1;
+    }
+    hops
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_split_key_roundtrip() {
+        let key = split_key(3, 47);
+        assert_eq!(key, 0x032F);
+        assert_eq!(split_key_parts(key), (3, 47));
+    }
+
+    #[test]
+    fn test_primary_fake_classification() {
+        assert!(!is_primary_fake(3, 4));
+        assert!(is_primary_fake(4, 4));
+        assert!(is_primary_fake(7, 4));
+        assert!(!is_primary_fake(8, 4));
+        assert_eq!(accounts_per_hop(4, 44), 8);
+        assert_eq!(accounts_per_hop(4, 2), 6);
+        assert_eq!(funded_fake_splits(4, 44), 16);
+        assert_eq!(funded_fake_splits(4, 2), 8);
+    }
+
+    #[test]
+    fn test_default_transfer_fits_one_batch() {
+        let per_hop = accounts_per_hop(4, 44);
+        assert_eq!(max_batch_hops(4, per_hop), 4);
+        assert!(batch_cu_estimate(4, 32) < MAX_TRANSACTION_CU);
+
+        // Account locks, not CUs, bound wide hops
+        assert_eq!(max_batch_hops(4, 20), 3);
+        assert_eq!(max_batch_hops(4, 61), 0);
+    }
+
+    #[test]
+    fn test_batch_hops_within_cu_limit() {
+        // 150k base + 28k per hop of 8 accounts
+        assert_eq!(max_batch_hops_within(4, 8, 240_000), 3);
+        assert_eq!(max_batch_hops_within(4, 8, 178_000), 1);
+        assert_eq!(max_batch_hops_within(4, 8, 150_000), 0);
+        assert_eq!(max_batch_hops_within(4, 8, MAX_TRANSACTION_CU), max_batch_hops(4, 8));
+    }
+
+    #[test]
+    fn test_default_transfer_reclaims_in_one_transaction() {
+        let split_accounts = 4 * accounts_per_hop(4, 44) as usize;
+        assert!(split_accounts <= MAX_RECLAIM_SPLIT_ACCOUNTS);
+        assert!(reclaim_cu_estimate(MAX_RECLAIM_SPLIT_ACCOUNTS) <= MAX_TRANSACTION_CU);
+    }
+}
@@ -3,152 +3,8 @@
 //! This tool verifies the correct implementation of Poseidon parameters
 //! without depending on the entire program compilation.
 
-// Simple standard imports
-
-/// Import the Poseidon constants directly
-mod poseidon_constants {
-    pub const POSEIDON_WIDTH: usize = 3;
-    pub const POSEIDON_FULL_ROUNDS: usize = 8;
-    pub const POSEIDON_PARTIAL_ROUNDS: usize = 56;
-    
-    /// MDS matrix for Poseidon with WIDTH=3
-    /// Formatted as an array of arrays for compatibility with solana_poseidon
-    pub fn get_mds_matrix() -> Vec<[u8; 32]> {
-        // Correct MDS matrix from the constant data
-        [
-            // Row 1
-            [
-                0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-            ],
-            // Row 2
-            [
-                0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-            ],
-            // Row 3
-            [
-                0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-            ],
-            // Row 4
-            [
-                0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-            ],
-            // Row 5
-            [
-                0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-            ],
-            // Row 6
-            [
-                0x09, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-            ],
-            // Row 7
-            [
-                0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-            ],
-            // Row 8
-            [
-                0x0b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-            ],
-            // Row 9
-            [
-                0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-            ],
-        ].to_vec()
-    }
-    
-    /// Returns the first 10 round constants for the test implementation
-    pub fn get_round_constants_sample() -> Vec<[u8; 32]> {
-        // The first 10 constants for testing purposes
-        [
-            [
-                0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-            ],
-            [
-                0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-            ],
-            [
-                0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-            ],
-            [
-                0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-            ],
-            [
-                0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-            ],
-            [
-                0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-            ],
-            [
-                0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-            ],
-            [
-                0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-            ],
-            [
-                0x09, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-            ],
-            [
-                0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-            ],
-        ].to_vec()
-    }
-}
+/// Compile-time Poseidon tables (no parsing or allocation at startup)
+use zeclipse_poseidon::params as poseidon_constants;
 
 /// Simple test function for validating Poseidon parameters
 /// Validates the Poseidon parameters through simple consistency checks
@@ -156,7 +12,7 @@ fn validate_poseidon_params() -> Result<(), String> {
     println!("Validating Poseidon parameters...");
     
     // 1. Simple validation of constants
-    if poseidon_constants::POSEIDON_WIDTH != 3 || poseidon_constants::POSEIDON_FULL_ROUNDS != 8 || poseidon_constants::POSEIDON_PARTIAL_ROUNDS != 56 {
+    if poseidon_constants::POSEIDON_WIDTH != 3 || poseidon_constants::POSEIDON_FULL_ROUNDS != 8 || poseidon_constants::POSEIDON_PARTIAL_ROUNDS != 57 {
         return Err(format!("Parameter validation failed: Incorrect constants"));
     }
     
@@ -167,26 +23,28 @@ fn validate_poseidon_params() -> Result<(), String> {
                          poseidon_constants::POSEIDON_WIDTH, mds.len()));
     }
     
-    // 3. Verification of round constants
-    let constants = poseidon_constants::get_round_constants_sample();
-    if constants.len() < 10 {
-        return Err(format!("Too few round constants: {}", constants.len()));
+    // 3. Verification of round constants (one per state element and round)
+    let constants = poseidon_constants::get_round_constants();
+    let expected = poseidon_constants::POSEIDON_WIDTH
+        * (poseidon_constants::POSEIDON_FULL_ROUNDS + poseidon_constants::POSEIDON_PARTIAL_ROUNDS);
+    if constants.len() != expected {
+        return Err(format!("Wrong number of round constants: expected {}, found {}", expected, constants.len()));
     }
     
-    // 4. Structural validation of entries
-    for (i, row) in mds.iter().enumerate() {
-        if row.len() != 32 {
-            return Err(format!("Invalid length for MDS matrix entry {}: {} bytes", i, row.len()));
-        }
+    // 4. Structural validation of entries: every element is a non-zero,
+    //    canonical field element below the BN254 modulus
+    for (i, element) in mds.iter().flatten().enumerate() {
+        validate_element(element).map_err(|e| format!("Invalid MDS matrix entry {}: {}", i, e))?;
     }
     
-    for (i, constant) in constants.iter().enumerate() {
-        if constant.len() != 32 {
-            return Err(format!("Invalid length for round constant {}: {} bytes", i, constant.len()));
-        }
+    for (i, element) in constants.iter().enumerate() {
+        validate_element(element).map_err(|e| format!("Invalid round constant {}: {}", i, e))?;
     }
     
-    // 5. Output successful validation
+    // 5. Known test vector through the Bn254X5 hash
+    zeclipse_poseidon::hash::validate_parameters().map_err(|e| e.to_string())?;
+    
+    // 6. Output successful validation
     println!("POSEIDON PARAMETER VALIDATION SUCCESSFUL");
     println!("  - Width: {}", poseidon_constants::POSEIDON_WIDTH);
     println!("  - Full rounds: {}", poseidon_constants::POSEIDON_FULL_ROUNDS);
@@ -199,6 +57,18 @@ fn validate_poseidon_params() -> Result<(), String> {
     Ok(())
 }
 
+/// Checks that a table entry is non-zero and survives the canonical round trip
+fn validate_element(element: &poseidon_constants::FieldElement) -> Result<(), String> {
+    if element.is_zero() {
+        return Err("element is zero".to_string());
+    }
+    let canonical = element.to_bytes();
+    match poseidon_constants::FieldElement::parse_hex(&hex::encode(canonical)) {
+        Some(reparsed) if reparsed == *element => Ok(()),
+        _ => Err("element is not in canonical form".to_string()),
+    }
+}
+
 fn main() {
     println!("Poseidon Validation Tool\n");
     
@@ -0,0 +1,160 @@
+//! Bloom filter for the fake split classification
+//!
+//! Every hop/split pair is hashed with two multiply-add-shift functions and
+//! expanded to `k` bit positions by double hashing
+//! (`pos_i = h1 + i * h2 mod m`), so a membership test is `k` bit tests and
+//! no heap or syscall is involved. The bit length is a power of two and the
+//! hash count is configurable through `BloomParams`, which also exposes the
+//! expected false-positive rate for a given number of entries.
+//!
+//! With the default transfer layout (2048 bits, 7 hashes) the 176 fake
+//! entries of a 4 x 44 configuration give an expected false-positive rate of
+//! about 0.4%.
+
+/// Bit length of the fake split filter stored in `TransferState`
+pub const FAKE_BLOOM_BITS: u32 = 2048;
+
+/// Byte length of the fake split filter stored in `TransferState`
+pub const FAKE_BLOOM_BYTES: usize = (FAKE_BLOOM_BITS / 8) as usize;
+
+/// Number of hash functions used for the fake split filter
+pub const FAKE_BLOOM_HASHES: u8 = 7;
+
+/// Fake split filter as stored on-chain
+pub type FakeBloom = [u8; FAKE_BLOOM_BYTES];
+
+/// Multiplier and offset of the first multiply-add-shift hash
+const H1_MUL: u64 = 0x9E37_79B9_7F4A_7C15;
+const H1_ADD: u64 = 0x632B_E59B_D9B4_E019;
+
+/// Multiplier and offset of the second multiply-add-shift hash
+const H2_MUL: u64 = 0xC2B2_AE3D_27D4_EB4F;
+const H2_ADD: u64 = 0x1656_67B1_9E37_79F9;
+
+/// Size and hash count of a Bloom filter
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub struct BloomParams {
+    /// Number of bits (power of two, at least 8)
+    pub bits: u32,
+    /// Number of hash functions (at least 1)
+    pub hashes: u8,
+}
+
+impl BloomParams {
+    /// Parameters of the fake split filter in `TransferState`
+    pub const FAKE_SPLITS: BloomParams = BloomParams {
+        bits: FAKE_BLOOM_BITS,
+        hashes: FAKE_BLOOM_HASHES,
+    };
+
+    /// Creates a parameter set
+    pub const fn new(bits: u32, hashes: u8) -> Self {
+        Self { bits, hashes }
+    }
+
+    /// Checks that the bit length is a power of two and the hash count is non-zero
+    pub const fn is_valid(&self) -> bool {
+        self.bits >= 8 && self.bits.is_power_of_two() && self.hashes > 0
+    }
+
+    /// Number of bytes needed to store the filter
+    pub const fn byte_len(&self) -> usize {
+        (self.bits / 8) as usize
+    }
+
+    /// Number of low bits of a hash used as bit position
+    #[inline(always)]
+    const fn index_bits(&self) -> u32 {
+        self.bits.trailing_zeros()
+    }
+
+    /// Expected false-positive rate after inserting `entries` elements
+    ///
+    /// `(1 - e^(-k * n / m))^k`; intended for off-chain sizing and verification.
+    pub fn false_positive_rate(&self, entries: u32) -> f64 {
+        let k = self.hashes as f64;
+        let fill = 1.0 - (-k * entries as f64 / self.bits as f64).exp();
+        fill.powf(k)
+    }
+
+    /// Hash count minimizing the false-positive rate for `entries` elements
+    pub fn optimal_hashes(bits: u32, entries: u32) -> u8 {
+        if entries == 0 {
+            return 1;
+        }
+        let k = (bits as f64 / entries as f64 * core::f64::consts::LN_2).round();
+        k.clamp(1.0, u8::MAX as f64) as u8
+    }
+}
+
+/// Packs a hop/split pair into the element key
+#[inline(always)]
+pub fn element_key(hop_index: u8, split_index: u8) -> u64 {
+    ((hop_index as u64) << 8) | split_index as u64
+}
+
+/// Base hashes for double hashing; `h2` is forced odd so all `k` positions differ
+#[inline(always)]
+fn base_hashes(params: &BloomParams, hop_index: u8, split_index: u8) -> (u32, u32) {
+    let key = element_key(hop_index, split_index);
+    let shift = 64 - params.index_bits();
+    let h1 = (key.wrapping_mul(H1_MUL).wrapping_add(H1_ADD) >> shift) as u32;
+    let h2 = (key.wrapping_mul(H2_MUL).wrapping_add(H2_ADD) >> shift) as u32 | 1;
+    (h1, h2)
+}
+
+/// Sets the `k` bits of a hop/split pair
+pub fn bloom_insert(filter: &mut [u8], params: &BloomParams, hop_index: u8, split_index: u8) {
+    debug_assert!(params.is_valid() && filter.len() >= params.byte_len());
+    let mask = params.bits - 1;
+    let (h1, h2) = base_hashes(params, hop_index, split_index);
+    for i in 0..params.hashes as u32 {
+        let position = h1.wrapping_add(i.wrapping_mul(h2)) & mask;
+        filter[(position >> 3) as usize] |= 1 << (position & 7);
+    }
+}
+
+/// Tests whether a hop/split pair may be in the filter (`k` bit tests)
+#[inline]
+pub fn bloom_contains(filter: &[u8], params: &BloomParams, hop_index: u8, split_index: u8) -> bool {
+    debug_assert!(params.is_valid() && filter.len() >= params.byte_len());
+    let mask = params.bits - 1;
+    let (h1, h2) = base_hashes(params, hop_index, split_index);
+    for i in 0..params.hashes as u32 {
+        let position = h1.wrapping_add(i.wrapping_mul(h2)) & mask;
+        if filter[(position >> 3) as usize] & (1 << (position & 7)) == 0 {
+            return false;
+        }
+    }
+    true
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_insert_and_contains() {
+        let params = BloomParams::FAKE_SPLITS;
+        let mut filter: FakeBloom = [0; FAKE_BLOOM_BYTES];
+
+        bloom_insert(&mut filter, &params, 2, 17);
+        assert!(bloom_contains(&filter, &params, 2, 17));
+        // Hop bits are part of the key
+        assert!(!bloom_contains(&filter, &params, 3, 17));
+        assert_eq!(
+            filter.iter().map(|b| b.count_ones()).sum::<u32>(),
+            FAKE_BLOOM_HASHES as u32
+        );
+    }
+
+    #[test]
+    fn test_false_positive_rate_of_default_layout() {
+        let params = BloomParams::FAKE_SPLITS;
+        assert!(params.is_valid());
+        assert_eq!(params.byte_len(), FAKE_BLOOM_BYTES);
+        assert_eq!(BloomParams::optimal_hashes(FAKE_BLOOM_BITS, 176), 8);
+        assert!(params.false_positive_rate(176) < 0.005);
+        assert!(!BloomParams::new(100, 3).is_valid());
+    }
+}
@@ -0,0 +1,222 @@
+//! Per-phase compute unit profiling
+//!
+//! Every instruction handler creates one `CuProfiler` and brackets its phases
+//! with `checkpoint`: the compute units consumed since the previous checkpoint
+//! (read through `sol_remaining_compute_units`) are charged to the named
+//! phase. A phase may be charged several times, e.g. PDA validation and
+//! transfer inside a split loop; the amounts accumulate. When the profiler is
+//! dropped it emits one compact `CuProfileRecorded` event, also on early
+//! error returns, so a failing instruction still reports the phases it
+//! reached. Each checkpoint includes the cost of one
+//! `sol_remaining_compute_units` syscall.
+//!
+//! The measurement only exists with the `cu-profile` feature; without it the
+//! profiler is zero-sized and all checkpoints compile away. Account
+//! deserialization and constraint checks run before the handler and are not
+//! part of any phase (the harness in `tools/benchmark` reports them as the
+//! difference to the transaction total).
+
+use anchor_lang::prelude::*;
+#[cfg(feature = "cu-profile")]
+use crate::solana_imports::sol_remaining_compute_units;
+
+/// Number of profiled phases (length of `CuProfileRecorded::phases`)
+pub const CU_PHASE_COUNT: usize = 7;
+
+/// Instruction phases a checkpoint can be charged to
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+#[repr(u8)]
+pub enum CuPhase {
+    /// HyperPlonk proof verification (including the PLONK gates)
+    ProofVerification = 0,
+    /// Plonky2 range proof verification
+    RangeProof = 1,
+    /// Extraction of the split amounts from the proof
+    SplitExtraction = 2,
+    /// Stealth PDA recreation and validation, Bloom filter lookups
+    PdaValidation = 3,
+    /// Lamport transfers
+    Transfers = 4,
+    /// Events and audit logs
+    EventEmission = 5,
+    /// Parameter checks, state loading and state updates
+    State = 6,
+}
+
+impl CuPhase {
+    /// All phases in event order
+    pub const ALL: [CuPhase; CU_PHASE_COUNT] = [
+        CuPhase::ProofVerification,
+        CuPhase::RangeProof,
+        CuPhase::SplitExtraction,
+        CuPhase::PdaValidation,
+        CuPhase::Transfers,
+        CuPhase::EventEmission,
+        CuPhase::State,
+    ];
+
+    /// Column name used by the benchmark harness
+    pub const fn name(self) -> &'static str {
+        match self {
+            CuPhase::ProofVerification => "proof_verification",
+            CuPhase::RangeProof => "range_proof",
+            CuPhase::SplitExtraction => "split_extraction",
+            CuPhase::PdaValidation => "pda_validation",
+            CuPhase::Transfers => "transfers",
+            CuPhase::EventEmission => "event_emission",
+            CuPhase::State => "state",
+        }
+    }
+}
+
+/// Profiled instructions (`CuProfileRecorded::instruction`)
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+#[repr(u8)]
+pub enum CuInstruction {
+    Initialize = 0,
+    ExecuteHop = 1,
+    BatchHop = 2,
+    Finalize = 3,
+    Refund = 4,
+    RevealFake = 5,
+    ConfigUpdate = 6,
+    Reclaim = 7,
+}
+
+impl CuInstruction {
+    /// All profiled instructions
+    pub const ALL: [CuInstruction; 8] = [
+        CuInstruction::Initialize,
+        CuInstruction::ExecuteHop,
+        CuInstruction::BatchHop,
+        CuInstruction::Finalize,
+        CuInstruction::Refund,
+        CuInstruction::RevealFake,
+        CuInstruction::ConfigUpdate,
+        CuInstruction::Reclaim,
+    ];
+
+    /// Instruction name used by the benchmark harness
+    pub const fn name(self) -> &'static str {
+        match self {
+            CuInstruction::Initialize => "initialize",
+            CuInstruction::ExecuteHop => "execute_hop",
+            CuInstruction::BatchHop => "batch_hop",
+            CuInstruction::Finalize => "finalize",
+            CuInstruction::Refund => "refund",
+            CuInstruction::RevealFake => "reveal_fake",
+            CuInstruction::ConfigUpdate => "config_update",
+            CuInstruction::Reclaim => "reclaim",
+        }
+    }
+
+    /// Inverse of `as u8`
+    pub fn from_u8(value: u8) -> Option<Self> {
+        Self::ALL.get(value as usize).copied()
+    }
+}
+
+/// Per-phase compute units of one instruction (only emitted with `cu-profile`)
+#[event]
+pub struct CuProfileRecorded {
+    /// `CuInstruction` discriminant
+    pub instruction: u8,
+    /// Compute units per `CuPhase`, indexed by discriminant
+    pub phases: [u32; CU_PHASE_COUNT],
+}
+
+/// Checkpoint-based compute unit profiler for one instruction
+#[derive(Debug)]
+pub struct CuProfiler {
+    #[cfg(feature = "cu-profile")]
+    instruction: CuInstruction,
+    /// Remaining compute units at the previous checkpoint
+    #[cfg(feature = "cu-profile")]
+    last: u64,
+    #[cfg(feature = "cu-profile")]
+    phases: [u32; CU_PHASE_COUNT],
+}
+
+impl CuProfiler {
+    /// Starts profiling (first statement of the instruction handler)
+    #[inline]
+    pub fn start(instruction: CuInstruction) -> Self {
+        #[cfg(not(feature = "cu-profile"))]
+        let _ = instruction;
+        Self {
+            #[cfg(feature = "cu-profile")]
+            instruction,
+            #[cfg(feature = "cu-profile")]
+            last: sol_remaining_compute_units(),
+            #[cfg(feature = "cu-profile")]
+            phases: [0; CU_PHASE_COUNT],
+        }
+    }
+
+    /// Charges the compute units since the previous checkpoint to `phase`
+    #[inline]
+    pub fn checkpoint(&mut self, phase: CuPhase) {
+        #[cfg(feature = "cu-profile")]
+        {
+            let now = sol_remaining_compute_units();
+            let spent = self.last.saturating_sub(now);
+            let slot = &mut self.phases[phase as usize];
+            *slot = slot.saturating_add(spent.min(u32::MAX as u64) as u32);
+            self.last = now;
+        }
+        #[cfg(not(feature = "cu-profile"))]
+        let _ = phase;
+    }
+
+    /// Compute units charged so far, indexed by `CuPhase` (all 0 without `cu-profile`)
+    pub fn phases(&self) -> [u32; CU_PHASE_COUNT] {
+        #[cfg(feature = "cu-profile")]
+        {
+            self.phases
+        }
+        #[cfg(not(feature = "cu-profile"))]
+        {
+            [0; CU_PHASE_COUNT]
+        }
+    }
+}
+
+#[cfg(feature = "cu-profile")]
+impl Drop for CuProfiler {
+    fn drop(&mut self) {
+        emit!(CuProfileRecorded {
+            instruction: self.instruction as u8,
+            phases: self.phases,
+        });
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_phase_and_instruction_tables() {
+        for (i, phase) in CuPhase::ALL.iter().enumerate() {
+            assert_eq!(*phase as usize, i);
+        }
+        for (i, instruction) in CuInstruction::ALL.iter().enumerate() {
+            assert_eq!(CuInstruction::from_u8(i as u8), Some(*instruction));
+        }
+        assert_eq!(CuInstruction::from_u8(CuInstruction::ALL.len() as u8), None);
+
+        let mut names: Vec<_> = CuPhase::ALL.iter().map(|p| p.name()).collect();
+        names.sort();
+        names.dedup();
+        assert_eq!(names.len(), CU_PHASE_COUNT);
+    }
+
+    #[test]
+    fn test_checkpoints_on_host() {
+        let mut profiler = CuProfiler::start(CuInstruction::ExecuteHop);
+        profiler.checkpoint(CuPhase::ProofVerification);
+        profiler.checkpoint(CuPhase::ProofVerification);
+        // There is no compute meter on the host
+        assert_eq!(profiler.phases(), [0; CU_PHASE_COUNT]);
+    }
+}
@@ -13,9 +13,13 @@ use crate::instructions::config_update::ConfigUpdate;
 use crate::instructions::config_update::ConfigUpdateParams;
 use crate::instructions::refund::Refund;
 use crate::instructions::reveal_fake::RevealFake;
+use crate::instructions::migrate_state::MigrateState;
+use crate::instructions::open_registry::OpenRegistry;
+use crate::instructions::reclaim::Reclaim;
 
 // Import of the actual module for implementation
 use crate::instructions;
+use crate::stealth_pda::STEALTH_BUMP_TABLE_LEN;
 
 /// Main program module processed by the Anchor framework
 #[program]
@@ -23,48 +27,69 @@ pub mod zeclipse {
     use super::*;
 
     /// Initializes a new anonymous transfer
+    ///
+    /// `nonce` selects the transfer state PDA of the payer; nonces other than
+    /// 0 require the payer's transfer registry (`open_transfer_registry`).
+    /// `recipient_count` wallets, committed by the Merkle root account, are
+    /// paid at finalization.
     pub fn initialize(
         ctx: Context<Initialize>,
+        nonce: u32,
         amount: u64,
         hyperplonk_proof: [u8; 128],
         range_proof: [u8; 128],
         challenge: [u8; 32],
-        merkle_proof: Vec<u8>,
+        stealth_bumps: [u8; STEALTH_BUMP_TABLE_LEN],
+        recipient_count: u8,
     ) -> Result<()> {
         instructions::initialize::initialize(
             ctx,
+            nonce,
             amount,
             hyperplonk_proof,
             range_proof,
             challenge,
-            merkle_proof,
+            stealth_bumps,
+            recipient_count,
         )
     }
 
     /// Executes a single hop in the anonymous transfer
-    pub fn execute_hop(
-        ctx: Context<ExecuteHop>,
+    ///
+    /// Real splits 1..`real_splits` of the hop are passed as
+    /// `remaining_accounts` after `split_pda` (split 0).
+    pub fn execute_hop<'info>(
+        ctx: Context<'_, '_, 'info, 'info, ExecuteHop<'info>>,
         hop_index: u8,
         proof_data: [u8; 128],
-        range_proof_data: [u8; 128],
     ) -> Result<()> {
-        instructions::execute_hop::execute_hop(ctx, hop_index, proof_data, range_proof_data)
+        instructions::execute_hop::execute_hop(ctx, hop_index, proof_data)
     }
     
     /// Executes multiple hops in a single transaction
-    pub fn execute_batch_hop(
-        ctx: Context<BatchHop>,
+    ///
+    /// The split PDAs are passed as `remaining_accounts`; `split_keys` names
+    /// the hop/split pair of each of them (see `batch_plan::split_key`).
+    pub fn execute_batch_hop<'info>(
+        ctx: Context<'_, '_, 'info, 'info, BatchHop<'info>>,
         batch_index: u8,
+        hop_count: u8,
+        split_keys: Vec<u16>,
     ) -> Result<()> {
-        instructions::batch_hop::process_batch_hop(ctx, batch_index)
+        instructions::batch_hop::process_batch_hop(ctx, batch_index, hop_count, split_keys)
     }
 
     /// Finalizes the anonymous transfer
-    pub fn finalize_transfer(
-        ctx: Context<Finalize>,
+    ///
+    /// Additional recipients follow the primary one as `remaining_accounts`;
+    /// `recipient_proof` is the multiproof of the whole recipient set (empty
+    /// for single-recipient transfers).
+    pub fn finalize_transfer<'info>(
+        ctx: Context<'_, '_, 'info, 'info, Finalize<'info>>,
         proof_data: [u8; 128],
+        recipient_proof: Vec<u8>,
     ) -> Result<()> {
-        instructions::finalize::finalize(ctx, proof_data)
+        instructions::finalize::finalize(ctx, proof_data, recipient_proof)
     }
     
     /// Updates specific configuration parameters
@@ -82,12 +107,43 @@ pub mod zeclipse {
         instructions::refund::refund(ctx)
     }
     
-    /// Proves that a split address is a fake split
+    /// Proves that a split address is a fake split; committed fake splits
+    /// are opened with their blinding and authentication path
     pub fn reveal_fake_split(
         ctx: Context<RevealFake>,
         hop_index: u8,
         split_index: u8,
+        blinding: [u8; 32],
+        path: Vec<[u8; 32]>,
     ) -> Result<()> {
-        instructions::reveal_fake::reveal_fake(ctx, hop_index, split_index)
+        instructions::reveal_fake::reveal_fake(ctx, hop_index, split_index, blinding, path)
+    }
+    
+    /// Migrates a legacy Borsh transfer state to the zero-copy layout
+    pub fn migrate_transfer_state(
+        ctx: Context<MigrateState>,
+        stealth_bumps: [u8; STEALTH_BUMP_TABLE_LEN],
+    ) -> Result<()> {
+        instructions::migrate_state::migrate_state(ctx, stealth_bumps)
+    }
+    
+    /// Creates the registry that allows an owner to run concurrent transfers
+    pub fn open_transfer_registry(
+        ctx: Context<OpenRegistry>,
+    ) -> Result<()> {
+        instructions::open_registry::open_registry(ctx)
+    }
+    
+    /// Closes the split PDAs of a finalized or refunded transfer and returns
+    /// their lamports to the owner
+    ///
+    /// The split PDAs are passed as `remaining_accounts`, named by
+    /// `split_keys`; `close_state` also closes the transfer state (last batch).
+    pub fn reclaim_transfer<'info>(
+        ctx: Context<'_, '_, 'info, 'info, Reclaim<'info>>,
+        split_keys: Vec<u16>,
+        close_state: bool,
+    ) -> Result<()> {
+        instructions::reclaim::reclaim(ctx, split_keys, close_state)
     }
 }
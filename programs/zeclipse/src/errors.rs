@@ -127,4 +127,36 @@ pub enum ZEclipseError {
     /// Invalid state transition
     #[msg("Invalid state transition")]
     InvalidStateTransition,
-}
\ No newline at end of file
+    
+    /// Split account listed twice in a batch
+    #[msg("Split account appears more than once in the batch")]
+    DuplicateSplitAccount,
+    
+    /// Batch exceeds the transaction CU or account limit
+    #[msg("Batch exceeds the compute unit or account limit of a transaction")]
+    BatchTooLarge,
+    
+    /// Transfers with a nonce need the owner's transfer registry
+    #[msg("Transfers with a nonce require the owner's transfer registry")]
+    TransferRegistryRequired,
+    
+    /// All registry slots are taken by open transfers
+    #[msg("Too many open transfers for this owner")]
+    TooManyOpenTransfers,
+    
+    /// Nonce already open or not registered
+    #[msg("Transfer nonce is already open or not registered")]
+    InvalidTransferNonce,
+    
+    /// Recipient accounts differ from the committed recipient set
+    #[msg("Recipient accounts do not match the committed recipient set")]
+    RecipientSetMismatch,
+    
+    /// Transfer state closed while split PDAs still hold lamports
+    #[msg("Split accounts of the transfer still hold lamports")]
+    FundedSplitsRemaining,
+    
+    /// Committed fake splits without a root for the current layout
+    #[msg("Committed fake splits require the root of their split tree")]
+    FakeRootMissing,
+}
@@ -0,0 +1,148 @@
+//! Instruction-scoped Poseidon hashing context
+//!
+//! Every instruction handler creates one `HashContext` and passes it by
+//! reference to all verifiers (`verify_hyperplonk_proof`, `verify_plonk_gates`,
+//! `verify_range_proof`, `extract_splits`, ...). All digests are computed by
+//! `crate::zk_hash::zk_hash`; the context takes its inputs as stack slices
+//! instead of freshly built `Vec`s and offers `hash_batch` to run
+//! independent hashes (permutation arguments, commitment digests) back to back
+//! in one syscall sequence without intermediate allocations.
+//!
+//! The context also counts the hashes it performed, which makes the Poseidon
+//! cost of an instruction visible in logs and tests. With the `hash-cu-debug`
+//! feature it additionally measures the compute units of every call through
+//! `sol_remaining_compute_units` (each measurement includes the cost of one
+//! `sol_remaining_compute_units` syscall).
+
+use anchor_lang::prelude::*;
+use crate::errors::ZEclipseError;
+use crate::zk_hash::zk_hash;
+#[cfg(feature = "hash-cu-debug")]
+use crate::solana_imports::sol_remaining_compute_units;
+
+pub use crate::zk_hash::{HASH_ENDIANNESS, HASH_PARAMETERS, MAX_HASH_INPUTS};
+
+/// Left-aligns `bytes` in a zero-padded 32-byte array (stack-only domain tags)
+pub const fn pad32(bytes: &[u8]) -> [u8; 32] {
+    let mut out = [0u8; 32];
+    let mut i = 0;
+    while i < bytes.len() && i < 32 {
+        out[i] = bytes[i];
+        i += 1;
+    }
+    out
+}
+
+/// Reusable Poseidon hasher for one instruction
+#[derive(Debug, Default)]
+pub struct HashContext {
+    /// Number of hashes computed through this context
+    hashes: u32,
+    /// Compute units consumed by those hashes
+    #[cfg(feature = "hash-cu-debug")]
+    compute_units: u64,
+}
+
+impl HashContext {
+    /// Creates a fresh context (once per instruction handler)
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Hashes up to `MAX_HASH_INPUTS` inputs of at most 32 bytes each
+    #[inline]
+    pub fn hash(&mut self, inputs: &[&[u8]]) -> Result<[u8; 32]> {
+        #[cfg(feature = "hash-cu-debug")]
+        let start = sol_remaining_compute_units();
+
+        let digest = zk_hash(inputs)?;
+        self.hashes += 1;
+
+        #[cfg(feature = "hash-cu-debug")]
+        {
+            self.compute_units += start.saturating_sub(sol_remaining_compute_units());
+        }
+        Ok(digest)
+    }
+
+    /// Hashes two inputs (Merkle nodes, chained transcript digests)
+    #[inline]
+    pub fn hash_pair(&mut self, left: &[u8], right: &[u8]) -> Result<[u8; 32]> {
+        self.hash(&[left, right])
+    }
+
+    /// Hashes independent input sets in one pass, writing one digest per set
+    ///
+    /// `out` must hold at least `input_sets.len()` digests; callers keep both
+    /// on the stack. The first failing set aborts the batch.
+    pub fn hash_batch(&mut self, input_sets: &[&[&[u8]]], out: &mut [[u8; 32]]) -> Result<()> {
+        if out.len() < input_sets.len() {
+            msg!("Poseidon batch output too small: {} < {}", out.len(), input_sets.len());
+            return Err(ZEclipseError::HashingError.into());
+        }
+        for (digest, inputs) in out.iter_mut().zip(input_sets.iter()) {
+            *digest = self.hash(inputs)?;
+        }
+        Ok(())
+    }
+
+    /// Number of hashes computed so far
+    pub fn hash_count(&self) -> u32 {
+        self.hashes
+    }
+
+    /// Compute units spent in hashing so far (always 0 without `hash-cu-debug`)
+    pub fn compute_units(&self) -> u64 {
+        #[cfg(feature = "hash-cu-debug")]
+        {
+            self.compute_units
+        }
+        #[cfg(not(feature = "hash-cu-debug"))]
+        {
+            0
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_batch_matches_single_hashes() {
+        let a = [1u8; 32];
+        let b = [2u8; 32];
+        let c = [3u8; 32];
+
+        let mut ctx = HashContext::new();
+        let single = [ctx.hash(&[&a, &b]).unwrap(), ctx.hash(&[&c]).unwrap()];
+        let mut batched = [[0u8; 32]; 2];
+        ctx.hash_batch(&[&[&a[..], &b[..]][..], &[&c[..]][..]], &mut batched).unwrap();
+
+        assert_eq!(single, batched);
+        assert!(ctx.hash_batch(&[&[&a[..]][..]], &mut []).is_err());
+        assert_eq!(ctx.hash_pair(&a, &b).unwrap(), single[0]);
+        assert_eq!(ctx.hash_count(), 5);
+        // There is no compute meter on the host
+        assert_eq!(ctx.compute_units(), 0);
+    }
+
+    #[test]
+    fn test_input_count_is_bounded() {
+        let input = [0u8; 32];
+        let too_many = [&input[..]; MAX_HASH_INPUTS + 1];
+        let mut ctx = HashContext::new();
+
+        assert!(ctx.hash(&[]).is_err());
+        assert!(ctx.hash(&too_many).is_err());
+        assert!(ctx.hash(&too_many[..MAX_HASH_INPUTS]).is_ok());
+        assert_eq!(ctx.hash_count(), 1);
+    }
+
+    #[test]
+    fn test_pad32() {
+        let tag = pad32(b"fake_splits");
+        assert_eq!(&tag[..11], b"fake_splits");
+        assert!(tag[11..].iter().all(|&b| b == 0));
+    }
+}
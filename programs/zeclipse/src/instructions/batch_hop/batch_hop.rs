@@ -1,22 +1,27 @@
 use anchor_lang::prelude::*;
-use anchor_lang::solana_program::program::invoke;
-use anchor_lang::solana_program;
 
 use crate::state::*;
 use crate::errors::ZEclipseError;
+use crate::batch_plan::{batch_cu_estimate, batch_fits, BATCH_CU_HEADROOM};
+use crate::optimized_validation::batch_validate_pdas;
+use crate::hash_context::HashContext;
+use crate::cu_profile::{CuInstruction, CuPhase, CuProfiler};
 use crate::utils::{
     verify_hyperplonk_proof, 
-    extract_splits, 
-    derive_stealth_pda,
-    verify_bloom_filter,
+    split_plan, 
     parallel_batch_execution,
-    calculate_optimized_priority_fees,
 };
 
 /// Context for executing a batch hop
 /// 
 /// This instruction processes multiple hops in a single transaction, significantly
 /// optimizing compute units and network fees.
+///
+/// The split PDAs are passed as writable `remaining_accounts`, one entry per
+/// split that receives lamports, in any order the client chooses (e.g. the
+/// order of its address lookup table). The `split_keys` argument names the
+/// hop/split pair of every account (see `crate::batch_plan`). With committed
+/// fake splits (`FAKE_MODE_COMMITTED`) only the real splits are passed.
 #[derive(Accounts)]
 pub struct BatchHop<'info> {
     #[account(mut)]
@@ -24,215 +29,161 @@ pub struct BatchHop<'info> {
     
     #[account(
         mut,
-        seeds = [b"transfer", transfer_state.owner.as_ref()],
-        bump = transfer_state.bump,
-        constraint = !transfer_state.completed @ ZEclipseError::TransferAlreadyCompleted,
+        seeds = [b"transfer", transfer_state.load()?.owner.as_ref(), transfer_state.load()?.nonce_seed()],
+        bump = transfer_state.load()?.bump,
+        constraint = !transfer_state.load()?.is_completed() @ ZEclipseError::TransferAlreadyCompleted,
     )]
-    pub transfer_state: Account<'info, TransferState>,
-    
-    /// CHECK: These PDAs are dynamically derived and verified
-    #[account(mut)]
-    pub pda_0: UncheckedAccount<'info>,
-    
-    /// CHECK: Optional for larger batches
-    #[account(mut)]
-    pub pda_1: Option<UncheckedAccount<'info>>,
-    
-    /// CHECK: Optional for larger batches
-    #[account(mut)]
-    pub pda_2: Option<UncheckedAccount<'info>>,
-    
-    /// CHECK: Optional for larger batches
-    #[account(mut)]
-    pub pda_3: Option<UncheckedAccount<'info>>,
-    
-    /// CHECK: Optional for larger batches
-    #[account(mut)]
-    pub pda_4: Option<UncheckedAccount<'info>>,
-    
-    /// CHECK: Optional for larger batches
-    #[account(mut)]
-    pub pda_5: Option<UncheckedAccount<'info>>,
-    
-    /// CHECK: Optional for larger batches
-    #[account(mut)]
-    pub pda_6: Option<UncheckedAccount<'info>>,
-    
-    /// CHECK: Optional for larger batches
-    #[account(mut)]
-    pub pda_7: Option<UncheckedAccount<'info>>,
+    pub transfer_state: AccountLoader<'info, TransferState>,
     
     pub system_program: Program<'info, System>,
 }
 
-pub fn process_batch_hop(
-    ctx: Context<BatchHop>,
+pub fn process_batch_hop<'info>(
+    ctx: Context<'_, '_, 'info, 'info, BatchHop<'info>>,
     batch_index: u8,
+    hop_count: u8,
+    split_keys: Vec<u16>,
 ) -> Result<()> {
-    // Optimized compute unit and priority fee setting for faster execution
-    let config = &ctx.accounts.transfer_state.config;
-    
-    // Dynamic CU limit based on batch size and remaining hops
-    let remaining_hops = ctx.accounts.transfer_state.remaining_hops();
-    let batch_size = std::cmp::min(config.max_batch_size(), remaining_hops);
-    let cu_limit = config.cu_budget_per_hop * batch_size as u32;
-    
-    // Calculate optimized priority fees based on transaction volume
-    // Parameters in the correct order: first remaining_hops, then cu_limit
-    let priority_fee = calculate_optimized_priority_fees(remaining_hops, cu_limit)?;
-    
-    // Setup for compute budget with priority fee for faster confirmation
-    let cu_limit_ix = solana_program::instruction::ComputeBudgetInstruction::set_compute_unit_limit(cu_limit);
-    let priority_fee_ix = solana_program::instruction::ComputeBudgetInstruction::set_compute_unit_price(priority_fee);
+    let mut profiler = CuProfiler::start(CuInstruction::BatchHop);
+    
+    // Snapshot of the zero-copy transfer state. Only the fields needed here are
+    // copied; the account guard is released before any CPI touches the account.
+    let state = ctx.accounts.transfer_state.load()?;
+    let config = state.config;
+    let current_hop = state.current_hop;
+    let batch_count = state.batch_count;
+    let amount = state.amount;
+    let owner = state.owner;
+    let nonce = state.nonce;
+    let bump = state.bump;
+    let seed = state.seed;
+    let challenge = state.challenge;
+    let batch_proof = state.batch_proof;
+    let fake_bloom = state.fake_bloom;
+    let committed_fakes = state.has_committed_fakes();
+    let stealth_bumps = state.stealth_bumps;
+    let remaining_hops = state.remaining_hops();
+    
+    // The client packs the batch; it must stay within one transaction's CU
+    // and account lock limits and must not run past the last hop
+    let split_accounts = ctx.remaining_accounts;
+    let batch_size = hop_count;
+    if remaining_hops == 0 {
+        msg!("All hops already completed");
+        return Err(ZEclipseError::TransferAlreadyCompleted.into());
+    }
+    if batch_size == 0 || batch_size > remaining_hops || split_accounts.is_empty() {
+        msg!("Invalid batch: {} hops requested, {} remaining, {} split accounts",
+             batch_size, remaining_hops, split_accounts.len());
+        return Err(ZEclipseError::InvalidBatchConfiguration.into());
+    }
+    if !batch_fits(batch_size, split_accounts.len()) {
+        msg!("Batch of {} hops with {} split accounts exceeds the transaction limits",
+             batch_size, split_accounts.len());
+        return Err(ZEclipseError::BatchTooLarge.into());
+    }
     
-    // Parallelized execution of compute budget instructions
-    invoke(&cu_limit_ix, &[ctx.accounts.authority.to_account_info()])?;
-    invoke(&priority_fee_ix, &[ctx.accounts.authority.to_account_info()])?;
+    // Expected CUs from the batch cost model (proof once, per-account PDA +
+    // transfer). The client sets the actual limit and price through compute
+    // budget instructions; a CPI from here would not affect this transaction.
+    let cu_limit = batch_cu_estimate(batch_size, split_accounts.len());
     
     // Check if sufficient compute units are available for the main batch processing logic
-    // Estimate that initial checks + CU setup might have taken some CUs, 
-    // and the main logic (parallel_batch_execution) will need a large portion of the cu_limit.
-    // This is a rough estimate; precise values would come from testing.
-    let estimated_cu_for_main_logic = cu_limit.saturating_sub(50_000); // Assuming setup & checks cost up to 50k CUs
-    if !ctx.accounts.transfer_state.has_enough_cu_for_next_hop(estimated_cu_for_main_logic) {
+    // (everything except the headroom reserved for setup, logging and the event)
+    let estimated_cu_for_main_logic = cu_limit.saturating_sub(BATCH_CU_HEADROOM);
+    if !state.has_enough_cu_for_next_hop(estimated_cu_for_main_logic) {
         return Err(ZEclipseError::InsufficientComputeUnits.into());
     }
+    drop(state);
     
     // Check if the correct batch sequence is maintained
-    if ctx.accounts.transfer_state.batch_count != batch_index {
+    if batch_count != batch_index {
         msg!("Invalid batch index: expected {}, received {}", 
-             ctx.accounts.transfer_state.batch_count, batch_index);
+             batch_count, batch_index);
         return Err(ZEclipseError::InvalidHopIndex.into());
     }
     
     // Check if all hops are already completed
-    if ctx.accounts.transfer_state.current_hop >= ctx.accounts.transfer_state.config.num_hops {
+    if current_hop >= config.num_hops {
         msg!("All hops already completed");
         return Err(ZEclipseError::TransferAlreadyCompleted.into());
     }
     
-    // Calculate how many hops can be processed in this batch
-    let max_batch_size = config.max_batch_size();
-    let remaining_hops = ctx.accounts.transfer_state.remaining_hops();
-    let batch_size = std::cmp::min(max_batch_size, remaining_hops);
-    
     msg!("Processing batch {}: {} hops (from {} to {})", 
-         batch_index, batch_size, ctx.accounts.transfer_state.current_hop, 
-         ctx.accounts.transfer_state.current_hop + batch_size - 1);
+         batch_index, batch_size, current_hop, 
+         current_hop + batch_size - 1);
     
     // Verify the HyperPlonk proof for the batch with optimized verification
     // This uses Poseidon hashing in HyperPlonk for efficient on-chain verification
     msg!("Verifying HyperPlonk proof with Poseidon hashing for batch {}", batch_index);
+    profiler.checkpoint(CuPhase::State);
+    let mut hash_ctx = HashContext::new();
     verify_hyperplonk_proof(
-        &ctx.accounts.transfer_state.batch_proof,
-        &ctx.accounts.transfer_state.challenge,
+        &mut hash_ctx,
+        &batch_proof,
+        &challenge,
     )?;
+    profiler.checkpoint(CuPhase::ProofVerification);
     
-    // Extract the splits from the proof with optimized parallelization
+    // Extract the split plan from the proof: every hop carries its share of
+    // the amount (`hop_amount`), divided over the real splits
     // The amounts are extracted from the proof to ensure perfect obfuscation
-    msg!("Extracting 4 splits with variable distribution for unlinkability");
-    let splits = extract_splits(
-        &ctx.accounts.transfer_state.batch_proof,
-        // Optimized for 4 fixed real splits
-        ctx.accounts.transfer_state.amount / 4,
-        // Beachte: Die Anzahl der Splits ist fest auf 4 eingestellt in der Implementierung
-        &ctx.accounts.transfer_state.challenge,
+    msg!("Extracting the split plan of {} hops with variable distribution for unlinkability", config.num_hops);
+    let plan = split_plan(
+        &mut hash_ctx,
+        &batch_proof,
+        amount,
+        config.num_hops,
+        &challenge,
     )?;
+    profiler.checkpoint(CuPhase::SplitExtraction);
     
-    // Optimized PDA collection with vectorized operations
-    let mut pda_accounts = Vec::with_capacity(batch_size as usize);
-    pda_accounts.push(ctx.accounts.pda_0.to_account_info());
-    
-    // Optimized vectorization for multi-hop batching
-    // Using O(1) lookups instead of conditional checks for maximum efficiency
-    let optional_pdas = [
-        ctx.accounts.pda_1.as_ref().map(|p| p.to_account_info()),
-        ctx.accounts.pda_2.as_ref().map(|p| p.to_account_info()),
-        ctx.accounts.pda_3.as_ref().map(|p| p.to_account_info()),
-        ctx.accounts.pda_4.as_ref().map(|p| p.to_account_info()),
-        ctx.accounts.pda_5.as_ref().map(|p| p.to_account_info()),
-        ctx.accounts.pda_6.as_ref().map(|p| p.to_account_info()),
-        ctx.accounts.pda_7.as_ref().map(|p| p.to_account_info()),
-    ];
-    
-    // Using iterative method instead of repeated if-queries (more efficient)
-    for i in 0..std::cmp::min(batch_size as usize - 1, optional_pdas.len()) {
-        if let Some(pda) = &optional_pdas[i] {
-            pda_accounts.push(pda.clone());
-        }
-    }
-    
-    // Log for parallelization
-    msg!("Batch processing with {} PDAs for {} hops", pda_accounts.len(), batch_size);
+    // Validate all split accounts in one pass
+    // Duplicate hop/split pairs are rejected, so every account is recreated once
+    msg!("Batch processing with {} split accounts for {} hops", split_accounts.len(), batch_size);
+    batch_validate_pdas(
+        ctx.program_id,
+        &seed,
+        current_hop,
+        batch_size,
+        &split_keys,
+        split_accounts,
+        &fake_bloom,
+        &stealth_bumps,
+    )?;
     
-    // Check PDAs for validity
-    for (i, pda) in pda_accounts.iter().enumerate() {
-        let hop_index = ctx.accounts.transfer_state.current_hop + i as u8;
-        // Use the improved PDA validation logic to verify each PDA
-        // This ensures cryptographic validation of the PDA derivation
-        let current_split_index = i as u8; // Use the correct index for each PDA
-        
-        // Use our enhanced verify_pda_derivation function to properly validate the PDA
-        let validation_result = verify_pda_derivation(
-            ctx.program_id,
-            &ctx.accounts.transfer_state.seed,
-            hop_index,
-            current_split_index,
-            pda
-        );
-        
-        // Handle validation result with proper error messages
-        let is_valid = match validation_result {
-            Ok(_) => {
-                // Successfully validated PDA derivation
-                msg!("PDA for hop {} split {} validated successfully", hop_index, current_split_index);
-                true
-            },
-            Err(e) => {
-                // Failed PDA validation - try alternative check for fake splits
-                let is_fake_valid = verify_bloom_filter(
-                    &ctx.accounts.transfer_state.fake_bloom,
-                    hop_index,
-                    current_split_index
-                ).unwrap_or(false);
-                
-                if is_fake_valid {
-                    msg!("PDA for hop {} split {} validated as fake split", hop_index, current_split_index);
-                    true
-                } else {
-                    msg!("PDA validation failed for hop {} split {}: {:?}", hop_index, current_split_index, e);
-                    false
-                }
-            }
-        };
-        
-        if !is_valid {
-            msg!("Invalid PDA for hop {}: {:?}", hop_index, pda.key());
-            return Err(ZEclipseError::PdaCreationError.into());
-        }
-    }
+    msg!("Poseidon hashes: {} ({} CU)", hash_ctx.hash_count(), hash_ctx.compute_units());
+    profiler.checkpoint(CuPhase::PdaValidation);
     
     // Execute the batch hop with parallel execution for maximum efficiency
     // Processing occurs in a single pass to save CPU cycles
-    msg!("Starting parallel batch hop execution for {} splits", splits.len());
+    msg!("Starting parallel batch hop execution for {} splits", split_accounts.len());
     
     parallel_batch_execution(
+        ctx.program_id,
         &ctx.accounts.transfer_state.to_account_info(),
         &ctx.accounts.system_program.to_account_info(),
-        &splits,
-        &pda_accounts,
-        ctx.accounts.transfer_state.current_hop,
-        &ctx.accounts.transfer_state.seed,
-        ctx.accounts.transfer_state.bump,
-        ctx.program_id,
-        // Adding bloom filter for constant lookup time in fake split verification
-        &ctx.accounts.transfer_state.fake_bloom,
+        &plan,
+        split_accounts,
+        &split_keys,
+        &owner,
+        nonce,
+        bump,
+        config.real_splits,
+        // Adding bloom filter for constant lookup time in fake split verification;
+        // committed fakes are not part of the batch and need no lookup
+        (!committed_fakes).then_some(&fake_bloom),
     )?;
+    profiler.checkpoint(CuPhase::Transfers);
     
-    // Update the transfer state
-    let mut transfer_state = &mut ctx.accounts.transfer_state;
+    // Update the transfer state; every funded split stays open until
+    // finalize or reclaim empties it
+    let funded_splits = split_accounts.iter().filter(|pda| pda.lamports() > 0).count() as u16;
+    let transfer_state_key = ctx.accounts.transfer_state.key();
+    let mut transfer_state = ctx.accounts.transfer_state.load_mut()?;
     transfer_state.current_hop += batch_size;
     transfer_state.batch_count += 1;
+    transfer_state.funded_splits = transfer_state.funded_splits.saturating_add(funded_splits);
     
     // Check if all hops are completed
     if transfer_state.current_hop >= transfer_state.config.num_hops {
@@ -242,18 +193,22 @@ pub fn process_batch_hop(
              batch_index, transfer_state.current_hop, transfer_state.config.num_hops,
              transfer_state.progress_percent());
     }
+    profiler.checkpoint(CuPhase::State);
     
     // Emit event
     emit!(BatchHopExecuted {
-        owner: transfer_state.owner,
+        owner,
         batch_index,
         hops_processed: batch_size,
-        splits_processed: splits.len() as u8,
+        splits_processed: split_accounts.len() as u8,
         compute_units_consumed: cu_limit,
         progress_percent: transfer_state.progress_percent(),
         remaining_hops: transfer_state.remaining_hops(),
-        transfer_state: ctx.accounts.transfer_state.key(),
+        transfer_state: transfer_state_key,
+        poseidon_hashes: hash_ctx.hash_count(),
+        poseidon_compute_units: hash_ctx.compute_units(),
     });
+    profiler.checkpoint(CuPhase::EventEmission);
     
     Ok(())
 }
@@ -268,4 +223,8 @@ pub struct BatchHopExecuted {
     pub progress_percent: u8,
     pub remaining_hops: u8,
     pub transfer_state: Pubkey,
+    /// Poseidon hashes computed for the batch
+    pub poseidon_hashes: u32,
+    /// Compute units spent in those hashes (0 unless built with `hash-cu-debug`)
+    pub poseidon_compute_units: u64,
 }
@@ -1,33 +1,29 @@
 use anchor_lang::prelude::*;
-use anchor_lang::solana_program::program::invoke;
-use anchor_lang::solana_program;
 
 use crate::state::*;
 use crate::errors::ZEclipseError;
+use crate::cu_profile::{CuInstruction, CuPhase, CuProfiler};
+use crate::utils::generate_bloom_filter;
 
 /// Context for updating the ZEclipse configuration
 /// 
-/// This instruction allows adjusting certain parameters without
-/// changing the basic configuration (4 hops, 4 splits, 44 fake splits).
+/// This instruction adjusts reserve, fees and CU budget, and can switch the
+/// hop/split layout to a `PerformanceProfile` and the fake splits to
+/// commitments (`FAKE_MODE_COMMITTED`) before the first hop. Only the owner
+/// of the transfer may change its configuration.
 #[derive(Accounts)]
 pub struct ConfigUpdate<'info> {
     #[account(mut)]
     pub authority: Signer<'info>,
     
-    /// Administration address for configuration changes
-    /// In a production environment, this should be a multi-sig wallet
-    /// CHECK: We manually check if the account is authorized
-    #[account(mut)]
-    pub admin: UncheckedAccount<'info>,
-    
     #[account(
         mut,
-        seeds = [b"transfer", transfer_state.owner.as_ref()],
-        bump = transfer_state.bump,
-        constraint = !transfer_state.completed @ ZEclipseError::TransferAlreadyCompleted,
-        constraint = transfer_state.current_hop == 0 @ ZEclipseError::TransferNotComplete,
+        seeds = [b"transfer", transfer_state.load()?.owner.as_ref(), transfer_state.load()?.nonce_seed()],
+        bump = transfer_state.load()?.bump,
+        constraint = !transfer_state.load()?.is_completed() @ ZEclipseError::TransferAlreadyCompleted,
+        constraint = transfer_state.load()?.current_hop == 0 @ ZEclipseError::TransferNotComplete,
     )]
-    pub transfer_state: Account<'info, TransferState>,
+    pub transfer_state: AccountLoader<'info, TransferState>,
     
     pub system_program: Program<'info, System>,
 }
@@ -42,34 +38,53 @@ pub struct ConfigUpdateParams {
     
     /// Compute unit budget per hop transaction (100k-500k)
     pub cu_budget_per_hop: Option<u32>,
+    
+    /// Hop/split layout and batch budget of a performance profile; applied
+    /// before the other parameters, so an explicit CU budget overrides it
+    pub profile: Option<PerformanceProfile>,
+    
+    /// Keep fake splits as commitments instead of funding them during the
+    /// hops (`FAKE_MODE_COMMITTED`); `reveal_fake` materializes them on demand
+    pub committed_fakes: Option<bool>,
+    
+    /// Root of the fake split tree (`crate::utils::fake_split_root`) for the
+    /// new layout; required when committed fake splits are switched on or
+    /// their layout changes, rejected in funded mode
+    pub fake_root: Option<[u8; 32]>,
 }
 
 pub fn update_config(
     ctx: Context<ConfigUpdate>, 
     update_params: ConfigUpdateParams,
 ) -> Result<()> {
-    // Set compute limit
-    // Note: Config updates are sensitive, use a fixed, reasonable CU limit
-    let cu_limit_ix = solana_program::instruction::ComputeBudgetInstruction::set_compute_unit_limit(200_000);
-    invoke(
-        &cu_limit_ix,
-        &[ctx.accounts.authority.to_account_info()],
-    )?;
-    
-    // Check if the authority or the admin address is the owner
-    if ctx.accounts.authority.key() != ctx.accounts.transfer_state.owner &&
-       ctx.accounts.authority.key() != ctx.accounts.admin.key() {
+    let mut profiler = CuProfiler::start(CuInstruction::ConfigUpdate);
+    let transfer_state_key = ctx.accounts.transfer_state.key();
+    let mut transfer_state = ctx.accounts.transfer_state.load_mut()?;
+    
+    // Only the owner may change the configuration
+    if ctx.accounts.authority.key() != transfer_state.owner {
+        msg!("Configuration can only be changed by the owner");
         return Err(ZEclipseError::UnauthorizedAccess.into());
     }
     
     // Check if the configuration can be changed
-    if ctx.accounts.transfer_state.current_hop > 0 {
+    if transfer_state.current_hop > 0 {
         msg!("Configuration can no longer be changed, transfer already started");
         return Err(ZEclipseError::TransferNotComplete.into());
     }
     
-    // Create base configuration
-    let mut new_config = BlackoutConfig::new();
+    // Start from the current configuration; parameters left at `None` keep their value
+    let mut new_config = transfer_state.config;
+    
+    if let Some(profile) = update_params.profile {
+        let layout = BlackoutConfig::for_profile(profile);
+        new_config.num_hops = layout.num_hops;
+        new_config.real_splits = layout.real_splits;
+        new_config.fake_splits = layout.fake_splits;
+        new_config.cu_budget_per_hop = layout.cu_budget_per_hop;
+        msg!("Profile {:?}: {} hops, {} fake splits, {} hops per batch",
+             profile, layout.num_hops, layout.fake_splits, layout.budget_batch_hops());
+    }
     
     // Selective update of configuration parameters
     if let Some(reserve_percent) = update_params.reserve_percent {
@@ -99,17 +114,61 @@ pub fn update_config(
         new_config.cu_budget_per_hop = cu_budget;
     }
     
-    // Calculate the total number of paths and check if it is valid
+    if !new_config.is_valid() {
+        msg!("Invalid layout: {} hops, {} real splits, {} fake splits",
+             new_config.num_hops, new_config.real_splits, new_config.fake_splits);
+        return Err(ZEclipseError::InvalidBatchConfiguration.into());
+    }
+    
+    // Calculate the total number of paths
     let total_paths = new_config.total_paths();
     
+    // The Bloom filter marks the fake range of every hop, so a new layout
+    // needs a new filter
+    let layout_changed = new_config.num_hops != transfer_state.config.num_hops
+        || new_config.real_splits != transfer_state.config.real_splits
+        || new_config.fake_splits != transfer_state.config.fake_splits;
+    
+    let was_committed = transfer_state.has_committed_fakes();
+    if let Some(committed_fakes) = update_params.committed_fakes {
+        transfer_state.fake_mode = if committed_fakes { FAKE_MODE_COMMITTED } else { FAKE_MODE_FUNDED };
+    }
+    let committed_fakes = transfer_state.has_committed_fakes();
+    
+    // The fake split tree is tied to the layout: a root stored for another
+    // layout could open the wrong leaves, so it is replaced with the layout
+    match (committed_fakes, update_params.fake_root) {
+        (true, Some(fake_root)) => transfer_state.fake_root = fake_root,
+        (true, None) if layout_changed || !was_committed => {
+            msg!("Committed fake splits need the root of the new split tree");
+            return Err(ZEclipseError::FakeRootMissing.into());
+        }
+        (true, None) => {}
+        (false, Some(_)) => {
+            msg!("A fake split root requires committed fake splits");
+            return Err(ZEclipseError::InvalidParameters.into());
+        }
+        (false, None) => transfer_state.fake_root = [0; 32],
+    }
+    let batch_hops = if committed_fakes {
+        new_config.committed_budget_batch_hops()
+    } else {
+        new_config.budget_batch_hops()
+    };
+    
     // Update the configuration
-    let transfer_state = &mut ctx.accounts.transfer_state;
     transfer_state.config = new_config;
+    profiler.checkpoint(CuPhase::State);
+    if layout_changed {
+        transfer_state.fake_bloom = generate_bloom_filter(&new_config, &transfer_state.challenge);
+        profiler.checkpoint(CuPhase::PdaValidation);
+    }
     
-    msg!("Configuration updated: 4 hops, 4 real splits, 44 fake splits, {} paths", 
-         total_paths);
-    msg!("Parameters: Reserve {}%, Fees {}BP, CU budget {}",
-         new_config.reserve_percent, new_config.fee_multiplier, new_config.cu_budget_per_hop);
+    msg!("Configuration updated: {} hops, {} real splits, {} fake splits, {} paths", 
+         new_config.num_hops, new_config.real_splits, new_config.fake_splits, total_paths);
+    msg!("Parameters: Reserve {}%, Fees {}BP, CU budget {}, fake splits {}",
+         new_config.reserve_percent, new_config.fee_multiplier, new_config.cu_budget_per_hop,
+         if committed_fakes { "committed" } else { "funded" });
     
     // Emit event
     emit!(ConfigUpdateExecuted {
@@ -118,8 +177,14 @@ pub fn update_config(
         fee_multiplier: new_config.fee_multiplier,
         cu_budget: new_config.cu_budget_per_hop,
         total_paths,
-        transfer_state: ctx.accounts.transfer_state.key(),
+        transfer_state: transfer_state_key,
+        num_hops: new_config.num_hops,
+        real_splits: new_config.real_splits,
+        fake_splits: new_config.fake_splits,
+        batch_hops,
+        committed_fakes,
     });
+    profiler.checkpoint(CuPhase::EventEmission);
     
     Ok(())
 }
@@ -132,4 +197,12 @@ pub struct ConfigUpdateExecuted {
     pub cu_budget: u32,
     pub total_paths: u64,
     pub transfer_state: Pubkey,
+    pub num_hops: u8,
+    pub real_splits: u8,
+    pub fake_splits: u8,
+    /// Hops per batch transaction within the CU budget (`budget_batch_hops`,
+    /// `committed_budget_batch_hops` with committed fake splits)
+    pub batch_hops: u8,
+    /// Fake splits are only committed (`FAKE_MODE_COMMITTED`)
+    pub committed_fakes: bool,
 }
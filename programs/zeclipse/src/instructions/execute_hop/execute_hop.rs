@@ -1,21 +1,24 @@
 use anchor_lang::prelude::*;
-use anchor_lang::solana_program::program::{invoke, invoke_signed};
-use anchor_lang::solana_program;
-use anchor_lang::solana_program::system_instruction;
 use anchor_lang::solana_program::clock::Clock;
 use anchor_lang::solana_program::sysvar::Sysvar;
 
 use crate::state::*;
 use crate::errors::ZEclipseError;
+use crate::hash_context::HashContext;
+use crate::cu_profile::{CuInstruction, CuPhase, CuProfiler};
+use crate::lamports::LamportTransfers;
+use crate::stealth_pda::{lookup_bump, verify_stealth_pda};
 use crate::utils::{
     verify_hyperplonk_proof,
-    verify_range_proof,
-    extract_split_amount,
-    derive_stealth_pda,
-    verify_bloom_filter,
-    calculate_optimized_priority_fees,
+    hop_challenge,
+    split_plan,
 };
 
+/// Context for executing a single hop
+///
+/// The hop funds its real splits with the committed split plan, the same
+/// amounts a batch hop moves. `split_pda` is real split 0 of the hop; real
+/// splits 1..`real_splits` follow as writable `remaining_accounts`.
 #[derive(Accounts)]
 pub struct ExecuteHop<'info> {
     #[account(mut)]
@@ -23,14 +26,14 @@ pub struct ExecuteHop<'info> {
     
     #[account(
         mut,
-        seeds = [b"transfer", transfer_state.owner.as_ref()],
-        bump = transfer_state.bump,
-        constraint = !transfer_state.completed @ ZEclipseError::TransferAlreadyCompleted,
-        constraint = !transfer_state.refund_triggered @ ZEclipseError::TransferRefunded,
+        seeds = [b"transfer", transfer_state.load()?.owner.as_ref(), transfer_state.load()?.nonce_seed()],
+        bump = transfer_state.load()?.bump,
+        constraint = !transfer_state.load()?.is_completed() @ ZEclipseError::TransferAlreadyCompleted,
+        constraint = !transfer_state.load()?.is_refund_triggered() @ ZEclipseError::TransferRefunded,
     )]
-    pub transfer_state: Account<'info, TransferState>,
+    pub transfer_state: AccountLoader<'info, TransferState>,
     
-    /// CHECK: This is a dynamic account used for stealth PDAs
+    /// CHECK: Real split 0 of the hop, checked against the committed bump table
     #[account(mut)]
     pub split_pda: UncheckedAccount<'info>,
     
@@ -44,184 +47,149 @@ pub struct ExecuteHop<'info> {
     pub clock: UncheckedAccount<'info>,
 }
 
-pub fn execute_hop(
-    ctx: Context<ExecuteHop>,
+pub fn execute_hop<'info>(
+    ctx: Context<'_, '_, 'info, 'info, ExecuteHop<'info>>,
     hop_index: u8,
     proof_data: [u8; 128],
-    range_proof_data: [u8; 128],
 ) -> Result<()> {
+    let mut profiler = CuProfiler::start(CuInstruction::ExecuteHop);
+    
     // 1. Verification of transfer state preconditions (constant time for security)
-    let transfer_state = &ctx.accounts.transfer_state;
+    // Copy the fields needed by this hop out of the zero-copy account; the
+    // guard must not be held across the lamport transfers below.
+    let (current_hop, config, owner, nonce, seed, bump, amount, batch_proof, plan_challenge, stealth_bumps) = {
+        let transfer_state = ctx.accounts.transfer_state.load()?;
+        (
+            transfer_state.current_hop,
+            transfer_state.config,
+            transfer_state.owner,
+            transfer_state.nonce,
+            transfer_state.seed,
+            transfer_state.bump,
+            transfer_state.amount,
+            transfer_state.batch_proof,
+            transfer_state.challenge,
+            transfer_state.stealth_bumps,
+        )
+    };
+    let transfer_state_key = ctx.accounts.transfer_state.key();
+    let transfer_state_info = ctx.accounts.transfer_state.to_account_info();
     
     // Redundant checks removed, as they are covered by account constraints:
     // if transfer_state.completed { ... }
     // if transfer_state.refund_triggered { ... }
     
-    // Check if the correct hop is being executed (exactly 4 hops in fixed configuration)
-    if transfer_state.current_hop != hop_index {
+    // Check if the correct hop is being executed
+    if current_hop != hop_index {
         return Err(ZEclipseError::InvalidHopIndex.into());
     }
     
-    // Check that the hop index is valid (0..4)
-    if hop_index >= 4 {
+    // Check that the hop index is valid (0..num_hops of the configuration)
+    if hop_index >= config.num_hops {
         return Err(ZEclipseError::InvalidHopIndex.into());
     }
     
-    // 2. Optimize compute unit budget and priority fees
-    // Calculate remaining hops for priority fee calculation
-    let remaining_hops = 4 - hop_index;
-
-    // Set compute unit limit precisely based on hop index and complexity
-    let cu_required = match hop_index {
-        0 => 350_000, // First hop needs more compute units for initialization
-        1 | 2 => 300_000, // Middle hops with standard compute units
-        3 => 400_000, // Last hop needs more compute units for finalization
-        _ => transfer_state.config.cu_budget_per_hop, // Fallback (should not be reached if hop_index < 4 is checked)
-    };
-    
-    // Calculate optimized priority fees based on remaining hops and actual CU required
-    let priority_fee = calculate_optimized_priority_fees(remaining_hops, cu_required)?;
-    
-    // Compute budget instructions with dynamic parameters
-    let cu_limit_ix = solana_program::instruction::ComputeBudgetInstruction::set_compute_unit_limit(cu_required);
-    let priority_fee_ix = solana_program::instruction::ComputeBudgetInstruction::set_compute_unit_price(priority_fee);
-    
-    // Execute compute budget instructions atomically
-    // The compute_budget account is not required for these specific CPIs.
-    invoke(
-        &cu_limit_ix,
-        &[ctx.accounts.authority.to_account_info()],
-    )?;
+    // The real splits of the hop: split 0 and the remaining accounts
+    if ctx.remaining_accounts.len() + 1 != config.real_splits as usize {
+        msg!("Expected {} real split accounts, received {}",
+             config.real_splits, ctx.remaining_accounts.len() + 1);
+        return Err(ZEclipseError::InvalidBatchConfiguration.into());
+    }
     
-    invoke(
-        &priority_fee_ix,
-        &[ctx.accounts.authority.to_account_info()],
-    )?;
+    // 2. The compute budget (limit and price) is set by the client through
+    // compute budget instructions in the transaction; a CPI from here would
+    // cost CUs without affecting the running transaction.
     
-    // 3. Verification of zero-knowledge proofs
+    // 3. Verification of the hop proof
     // Get current time for challenge validation
     let clock = Clock::get()?;
     let timestamp = clock.unix_timestamp;
     
     // Generate challenge for this specific hop
-    let mut challenge = [0u8; 32];
-    challenge[0..8].copy_from_slice(&timestamp.to_le_bytes());
-    challenge[8..16].copy_from_slice(&hop_index.to_le_bytes());
-    challenge[16..24].copy_from_slice(&transfer_state.owner.to_bytes()[0..8]);
-    challenge[24..32].copy_from_slice(&transfer_state.seed[24..32]);
-    
-    // Verify zero-knowledge proofs with the specialized functions
-    // a) HyperPlonk proof for split integrity (Poseidon hashing)
-    verify_hyperplonk_proof(&proof_data, &challenge)?;
-    
-    // b) Plonky2 range proof for split amounts (with Pedersen commitments)
-    verify_range_proof(&range_proof_data, &transfer_state.commitments, &challenge)?;
-    
-    // 4. Dynamic split calculation and execution
-    let mut processed_splits = 0;
-    let mut total_transferred = 0u64;
-    
-    // For each of the 4 real splits (fixed configuration)
-    for i in 0..4 {
-        // Derive PDA for real split with optimized function
-        let (split_pda, split_bump) = derive_stealth_pda(
-            ctx.program_id,
-            &transfer_state.seed,
-            hop_index,
-            i,
-            false, // Real split, not a fake split
-        );
-        
-        // Extract split amount from verified proof (safe after verification)
-        let split_amount = extract_split_amount(&proof_data, i);
+    let challenge = hop_challenge(timestamp, hop_index, &owner, &seed);
+    profiler.checkpoint(CuPhase::State);
+    
+    // HyperPlonk proof for split integrity (Poseidon hashing). The amounts
+    // come from the committed plan, whose range proof initialize verified.
+    let mut hash_ctx = HashContext::new();
+    verify_hyperplonk_proof(&mut hash_ctx, &proof_data, &challenge)?;
+    profiler.checkpoint(CuPhase::ProofVerification);
+    
+    // 4. The hop's row of the committed split plan (as in `batch_hop`)
+    let plan = split_plan(&mut hash_ctx, &batch_proof, amount, config.num_hops, &plan_challenge)?;
+    let split_amounts = plan[hop_index as usize];
+    msg!("Poseidon hashes: {} ({} CU)", hash_ctx.hash_count(), hash_ctx.compute_units());
+    profiler.checkpoint(CuPhase::SplitExtraction);
+    
+    // 5. Fund every real split of the hop; the program-owned transfer state is
+    // debited once with the total (no System program CPI)
+    let transfer_seeds: &[&[u8]] = &[
+        b"transfer".as_ref(),
+        owner.as_ref(),
+        transfer_nonce_seed(&nonce),
+        &[bump],
+    ];
+    let system_program_info = ctx.accounts.system_program.to_account_info();
+    let mut transfers = LamportTransfers::new(ctx.program_id, &transfer_state_info, &system_program_info, transfer_seeds)?;
+    let split_0 = ctx.accounts.split_pda.to_account_info();
+    let mut processed_splits = 0u8;
+    for (i, split_pda) in std::iter::once(&split_0).chain(ctx.remaining_accounts).enumerate() {
+        let split_index = i as u8;
+        // Recreated from the committed bump (one syscall, no bump search)
+        let split_bump = lookup_bump(&stealth_bumps, hop_index, split_index)?;
+        verify_stealth_pda(ctx.program_id, &seed, hop_index, split_index, false, split_bump, split_pda.key)?;
+        profiler.checkpoint(CuPhase::PdaValidation);
         
-        // Atomic execution only if the provided PDA matches the calculated one
-        // This verification ensures that the correct split is executed
-        if ctx.accounts.split_pda.key() == split_pda {
-            // Validate the split amount (must be positive, but less than total amount)
-            if split_amount == 0 {
-                // Skip empty split, but log it
-                msg!("Split {} for hop {} has amount 0, skipping", i, hop_index);
-                continue;
-            }
-            
-            // Ensure that sufficient lamports are available
-            let available_lamports = transfer_state.to_account_info().lamports();
-            if available_lamports < split_amount {
-                msg!("Insufficient lamports for split {}: {} < {}", 
-                     i, available_lamports, split_amount);
-                return Err(ZEclipseError::InsufficientLamports.into());
-            }
-            
-            // Optimized lamport transfer with full error handling
-            let transfer_ix = system_instruction::transfer(
-                &transfer_state.key(),
-                &split_pda,
-                split_amount,
-            );
-            
-            // Invoke with complete account infos
-            invoke_signed(
-                &transfer_ix,
-                &[
-                    transfer_state.to_account_info(),
-                    ctx.accounts.split_pda.to_account_info(),
-                    ctx.accounts.system_program.to_account_info(),
-                ],
-                &[&[
-                    b"transfer".as_ref(),
-                    transfer_state.owner.as_ref(),
-                    &[transfer_state.bump],
-                ]],
-            )?;
-            
-            // Update statistics
-            processed_splits += 1;
-            total_transferred += split_amount;
-            
-            // Log successful split for audit purposes
-            msg!("Real split {} for hop {} successful: {} lamports", 
-                 i, hop_index, split_amount);
+        let split_amount = split_amounts[i];
+        if split_amount == 0 {
+            // Skip empty split, but log it
+            msg!("Split {} for hop {} has amount 0, skipping", split_index, hop_index);
+            continue;
         }
+        transfers.transfer(split_pda, split_amount)?;
+        processed_splits += 1;
+        
+        // Log successful split for audit purposes
+        msg!("Real split {} for hop {} successful: {} lamports", 
+             split_index, hop_index, split_amount);
     }
+    let total_transferred = transfers.finish()?;
+    profiler.checkpoint(CuPhase::Transfers);
     
-    // 5. Additional statistics and state update
-    // Update the hop index in the transfer state
-    let mut transfer_state = &mut ctx.accounts.transfer_state;
+    // 6. Update the hop index in the transfer state; the funded splits stay
+    // open until finalize or reclaim empties them
+    let mut transfer_state = ctx.accounts.transfer_state.load_mut()?;
     transfer_state.current_hop = hop_index + 1;
+    transfer_state.funded_splits = transfer_state.funded_splits.saturating_add(processed_splits as u16);
     
     // Update the timestamp for freshness guarantee
     transfer_state.timestamp = timestamp;
     
-    // 6. Check completion status after the last hop
-    if transfer_state.current_hop >= 4 {
+    // Check completion status after the last hop
+    if transfer_state.current_hop >= config.num_hops {
         // All hops have been executed, mark as ready for finalization
-        msg!("All 4 hops completed. Transfer ready for finalization.");
+        msg!("All {} hops completed. Transfer ready for finalization.", config.num_hops);
     }
     
-    // 7. Store statistics for later verification
-    // Calculate Merkle root (for later verification)
-    // Calculate in the Merkle root the hash of each successful split
-    let merkle_data = [hop_index, processed_splits, 
-                      (total_transferred >> 32) as u8, (total_transferred & 0xFF) as u8];
-    transfer_state.merkle_root[hop_index as usize * 4..(hop_index as usize + 1) * 4]
-    .copy_from_slice(&merkle_data);
-    
-    // 8. Calculate and log progress
+    // 7. Calculate and log progress
     let progress = transfer_state.progress_percent();
-    msg!("Hop {} of 4 completed ({}% progress)", 
-         hop_index + 1, progress);
+    profiler.checkpoint(CuPhase::State);
+    msg!("Hop {} of {} completed ({}% progress)", 
+         hop_index + 1, config.num_hops, progress);
     
-    // 9. Event emission for off-chain tracking
+    // 8. Event emission for off-chain tracking
+    // (the per-hop statistics live only here: `merkle_root` is the recipient
+    // set commitment that finalize verifies)
     emit!(HopExecuted {
         owner: transfer_state.owner,
         hop_index,
         splits_processed: processed_splits,
         total_transferred,
         progress_percent: progress,
-        transfer_state: transfer_state.key(),
+        transfer_state: transfer_state_key,
         timestamp,
     });
+    profiler.checkpoint(CuPhase::EventEmission);
     
     Ok(())
 }
@@ -1,13 +1,14 @@
 use anchor_lang::prelude::*;
-use anchor_lang::solana_program::program::invoke;
-use anchor_lang::solana_program;
-use anchor_lang::solana_program::system_instruction;
 use anchor_lang::solana_program::sysvar::Sysvar;
 use anchor_lang::solana_program::clock::Clock;
 
 use crate::state::*;
 use crate::errors::ZEclipseError;
-use crate::utils::{verify_hyperplonk_proof, calculate_optimized_priority_fees};
+use crate::hash_context::HashContext;
+use crate::cu_profile::{CuInstruction, CuPhase, CuProfiler};
+use crate::lamports::LamportTransfers;
+use crate::stealth_pda::{lookup_bump, stealth_prefix, verify_stealth_pda};
+use crate::utils::{close_pda, finalize_challenge, verify_hyperplonk_proof, verify_recipient_set};
 
 #[derive(Accounts)]
 pub struct Finalize<'info> {
@@ -16,133 +17,198 @@ pub struct Finalize<'info> {
     
     #[account(
         mut,
-        seeds = [b"transfer", transfer_state.owner.as_ref()],
-        bump = transfer_state.bump,
-        constraint = !transfer_state.completed @ ZEclipseError::TransferAlreadyCompleted,
-        constraint = transfer_state.current_hop == 4 @ ZEclipseError::TransferNotComplete,
-        close = recipient
+        seeds = [b"transfer", transfer_state.load()?.owner.as_ref(), transfer_state.load()?.nonce_seed()],
+        bump = transfer_state.load()?.bump,
+        constraint = !transfer_state.load()?.is_completed() @ ZEclipseError::TransferAlreadyCompleted,
+        constraint = transfer_state.load()?.current_hop == transfer_state.load()?.config.num_hops @ ZEclipseError::TransferNotComplete,
     )]
-    pub transfer_state: Account<'info, TransferState>,
+    pub transfer_state: AccountLoader<'info, TransferState>,
     
-    /// CHECK: This is the recipient of the payment
+    /// CHECK: This is the primary recipient of the payment, checked against
+    /// the recipient committed at initialization
     #[account(mut)]
     pub recipient: UncheckedAccount<'info>,
     
     pub system_program: Program<'info, System>,
 }
 
-pub fn finalize(
-    ctx: Context<Finalize>,
+/// Finalizes the transfer by paying all committed recipients
+///
+/// The primary recipient is the `recipient` account; the other
+/// `recipient_count - 1` wallets follow in tree order as writable
+/// `remaining_accounts`. Multi-wallet transfers prove the whole set with one
+/// Merkle multiproof against the committed root (`verify_recipient_set`), so
+/// all recipients are paid in this instruction instead of one transaction
+/// each.
+///
+/// The real split PDAs of every hop follow the recipients, in hop/split
+/// order (`num_hops * real_splits` accounts). They hold the committed split
+/// plan (`split_plan`), whose hops add up to the transfer amount, and are
+/// swept into the transfer state, which then pays that amount, split by
+/// `recipient_shares`, in a single
+/// pass of direct lamport debits. Fees, reserve and any surplus stay in the
+/// state until `reclaim` closes it.
+pub fn finalize<'info>(
+    ctx: Context<'_, '_, 'info, 'info, Finalize<'info>>,
     proof_data: [u8; 128],
+    recipient_proof: Vec<u8>,
 ) -> Result<()> {
-    // 1. Optimized compute unit configuration for final verification
-    let required_cu = 400_000; 
-    // Use a default value for remaining hops (0 for finalize) and a
-    // fixed value for Compute Units.
-    let priority_fee = calculate_optimized_priority_fees(0, required_cu)?;
-    
-    let cu_limit_ix = solana_program::instruction::ComputeBudgetInstruction::set_compute_unit_limit(required_cu);
-    let priority_fee_ix = solana_program::instruction::ComputeBudgetInstruction::set_compute_unit_price(priority_fee);
-    
-    // Execute compute budget instructions atomically
-    invoke(
-        &cu_limit_ix,
-        &[ctx.accounts.authority.to_account_info()],
-    )?;
-    
-    invoke(
-        &priority_fee_ix,
-        &[ctx.accounts.authority.to_account_info()],
-    )?;
+    let mut profiler = CuProfiler::start(CuInstruction::Finalize);
+    
+    // 1. The compute budget (limit and price) is set by the client through
+    // compute budget instructions in the transaction
     
     // 2. Hop completion check is covered by account constraint: 
-    // `transfer_state.current_hop == 4 @ ZEclipseError::TransferNotComplete`
+    // `transfer_state.current_hop == config.num_hops @ ZEclipseError::TransferNotComplete`
     // Redundant check removed:
-    // if ctx.accounts.transfer_state.current_hop < 4 { ... }
+    // if ctx.accounts.transfer_state.current_hop < config.num_hops { ... }
+    
+    // Copy the fields needed for verification and payout out of the zero-copy
+    // account; the guard must not be held across the lamport transfers.
+    let state = ctx.accounts.transfer_state.load()?;
+    let owner_key = state.owner;
+    let nonce = state.nonce;
+    let bump_seed = state.bump;
+    let seed = state.seed;
+    let total_amount = state.amount;
+    let reserve_amount = state.reserve;
+    let num_hops = state.config.num_hops;
+    let real_splits = state.config.real_splits;
+    let merkle_root = state.merkle_root;
+    let primary_recipient = state.recipients[0];
+    let recipient_count = (state.recipient_count as usize).clamp(1, MAX_RECIPIENTS);
+    let stealth_bumps = state.stealth_bumps;
+    drop(state);
+    let transfer_state_key = ctx.accounts.transfer_state.key();
+    
+    // 3. Recipient set: the primary recipient is fixed at initialization, the
+    // additional ones are proven against the Merkle root
+    let split_count = num_hops as usize * real_splits as usize;
+    if ctx.accounts.recipient.key() != primary_recipient
+        || ctx.remaining_accounts.len() != recipient_count - 1 + split_count
+    {
+        msg!("Expected the committed recipient, {} additional recipients and {} split accounts",
+             recipient_count - 1, split_count);
+        return Err(ZEclipseError::RecipientSetMismatch.into());
+    }
+    let (recipient_accounts, split_accounts) = ctx.remaining_accounts.split_at(recipient_count - 1);
+    let mut recipients = [Pubkey::default(); MAX_RECIPIENTS];
+    recipients[0] = primary_recipient;
+    for (slot, account) in recipients[1..].iter_mut().zip(recipient_accounts) {
+        if !account.is_writable {
+            return Err(ZEclipseError::RecipientSetMismatch.into());
+        }
+        *slot = account.key();
+    }
+    profiler.checkpoint(CuPhase::State);
     
-    // 3. Generate challenge for proof verification
+    let mut hash_ctx = HashContext::new();
+    if recipient_count > 1
+        && !verify_recipient_set(&mut hash_ctx, &recipient_proof, &merkle_root, &recipients[..recipient_count])?
+    {
+        return Err(ZEclipseError::MerkleProofVerificationFailed.into());
+    }
+    profiler.checkpoint(CuPhase::ProofVerification);
+    
+    // 4. Generate challenge for proof verification
     let clock = Clock::get()?;
     let timestamp = clock.unix_timestamp;
     
-    let mut challenge = [0u8; 32];
-    challenge[0..8].copy_from_slice(&timestamp.to_le_bytes());
-    challenge[8..16].copy_from_slice(&ctx.accounts.transfer_state.owner.to_bytes()[0..8]);
-    challenge[16..24].copy_from_slice(&ctx.accounts.recipient.key().to_bytes()[0..8]);
-    challenge[24..32].copy_from_slice(&ctx.accounts.transfer_state.seed[24..32]);
-    
-    // 4. Verify final HyperPlonk proof
-    verify_hyperplonk_proof(&proof_data, &challenge)?;
-    
-    // 5. Reserve calculation and transfer
-    let total_amount = ctx.accounts.transfer_state.amount;
-    let reserve_percent = ctx.accounts.transfer_state.config.reserve_percent;
-    
-    // Calculate the reserve (percentage of total amount)
-    let reserve_amount = if reserve_percent > 0 {
-        (total_amount as u128 * reserve_percent as u128 / 100) as u64
-    } else {
-        0
-    };
-    
-    // Amount to be transferred to the recipient
-    let recipient_amount = total_amount.saturating_sub(reserve_amount);
-    
-    // 6. Transfer the main amount to the recipient
-    if recipient_amount > 0 {
-        msg!("Transferring {} lamports to recipient (Calculated Reserve: {} lamports)", 
-             recipient_amount, reserve_amount);
-        
-        let transfer_ix = system_instruction::transfer(
-            &ctx.accounts.transfer_state.key(),
-            &ctx.accounts.recipient.key(),
-            recipient_amount
-        );
+    let challenge = finalize_challenge(timestamp, &owner_key, &ctx.accounts.recipient.key(), &seed);
+    profiler.checkpoint(CuPhase::State);
+    
+    // 5. Verify final HyperPlonk proof
+    verify_hyperplonk_proof(&mut hash_ctx, &proof_data, &challenge)?;
+    profiler.checkpoint(CuPhase::ProofVerification);
+    
+    // 6. Planned payout: every hop moved its `hop_amount` of the split plan
+    // into its real split PDAs, and the hop amounts add up to the deposit
+    let recipient_amount = total_amount;
+    let shares = recipient_shares(recipient_amount, recipient_count);
+    profiler.checkpoint(CuPhase::SplitExtraction);
+    
+    // 7. Sweep the real split PDAs into the transfer state. They belong to the
+    // System program, so each one signs a System transfer with its seeds;
+    // splits that were never funded are skipped.
+    let transfer_state_info = ctx.accounts.transfer_state.to_account_info();
+    let system_program_info = ctx.accounts.system_program.to_account_info();
+    let mut swept: u64 = 0;
+    let mut splits_swept: u16 = 0;
+    for (index, pda) in split_accounts.iter().enumerate() {
+        let hop_index = (index / real_splits as usize) as u8;
+        let split_index = (index % real_splits as usize) as u8;
+        let bump = lookup_bump(&stealth_bumps, hop_index, split_index)?;
+        verify_stealth_pda(ctx.program_id, &seed, hop_index, split_index, false, bump, pda.key)?;
         
-        let owner_key = ctx.accounts.transfer_state.owner;
-        let bump_seed = ctx.accounts.transfer_state.bump;
-        let seeds = &[
-            b"transfer".as_ref(), 
-            owner_key.as_ref(), 
-            &[bump_seed]
-        ];
-        let signer_seeds = &[&seeds[..]];
-
-        invoke_signed(
-            &transfer_ix,
+        let lamports = pda.lamports();
+        if lamports == 0 {
+            continue;
+        }
+        close_pda(
+            pda,
+            &transfer_state_info,
+            &system_program_info,
             &[
-                ctx.accounts.transfer_state.to_account_info(),
-                ctx.accounts.recipient.to_account_info(),
-                ctx.accounts.system_program.to_account_info(),
+                stealth_prefix(false),
+                &hop_index.to_le_bytes(),
+                &split_index.to_le_bytes(),
+                &seed,
             ],
-            signer_seeds,
+            bump,
         )?;
+        swept = swept.saturating_add(lamports);
+        splits_swept += 1;
     }
+    if swept < recipient_amount {
+        msg!("Split accounts hold {} lamports, the split plan pays {}", swept, recipient_amount);
+        return Err(ZEclipseError::InsufficientLamports.into());
+    }
+    profiler.checkpoint(CuPhase::Transfers);
+    
+    // 8. Pay the planned shares. Fees and reserve stay in the state with its
+    // rent until `reclaim` closes it and returns them to the owner.
+    msg!("Transferring {} lamports to {} recipients ({} lamports swept, reserve {})", 
+         recipient_amount, recipient_count, swept, reserve_amount);
+    
+    let seeds: &[&[u8]] = &[
+        b"transfer".as_ref(), 
+        owner_key.as_ref(), 
+        transfer_nonce_seed(&nonce),
+        &[bump_seed]
+    ];
+    let mut transfers = LamportTransfers::new(ctx.program_id, &transfer_state_info, &system_program_info, seeds)?;
+    transfers.transfer(&ctx.accounts.recipient.to_account_info(), shares[0])?;
+    for (account, &share) in recipient_accounts.iter().zip(&shares[1..]) {
+        transfers.transfer(account, share)?;
+    }
+    transfers.finish()?;
+    profiler.checkpoint(CuPhase::Transfers);
+    
+    // 9. Mark transfer as completed
+    {
+        let mut transfer_state = ctx.accounts.transfer_state.load_mut()?;
+        transfer_state.set_completed();
+        transfer_state.funded_splits = transfer_state.funded_splits.saturating_sub(splits_swept);
+        transfer_state.recipients = recipients;
+        transfer_state.timestamp = timestamp;
+    }
+    profiler.checkpoint(CuPhase::State);
     
-    // 7. Reserve amount handling clarification:
-    // The `transfer_state` account is marked with `close = recipient`.
-    // This means any lamports remaining in `transfer_state` after the explicit
-    // transfer of `recipient_amount` (i.e., the calculated `reserve_amount`)
-    // will also be transferred to `recipient` when the account is closed.
-    // Effectively, the recipient receives the `total_amount`.
-    
-    // 8. Mark transfer as completed
-    ctx.accounts.transfer_state.completed = true;
-    ctx.accounts.transfer_state.recipient = ctx.accounts.recipient.key();
-    ctx.accounts.transfer_state.timestamp = timestamp;
-    
-    // 9. Emit event with detailed information
+    // 10. Emit event with the amounts actually paid
     emit!(TransferFinalized {
-        owner: ctx.accounts.transfer_state.owner,
+        owner: owner_key,
         recipient: ctx.accounts.recipient.key(),
         amount: recipient_amount,
         reserve: reserve_amount,
         total_amount: total_amount,
-        transfer_state: ctx.accounts.transfer_state.key(),
+        transfer_state: transfer_state_key,
         timestamp,
+        recipient_count: recipient_count as u8,
+        shares,
     });
     
-    msg!("Transfer successfully finalized: {} lamports transferred ({}% reserve)", 
-         recipient_amount, reserve_percent);
+    msg!("Transfer successfully finalized: {} lamports transferred", recipient_amount);
+    profiler.checkpoint(CuPhase::EventEmission);
     
     Ok(())
 }
@@ -156,4 +222,8 @@ pub struct TransferFinalized {
     pub total_amount: u64,
     pub transfer_state: Pubkey,
     pub timestamp: i64,
+    /// Number of recipients paid
+    pub recipient_count: u8,
+    /// Lamports paid to each recipient, in tree order (`amount` in total)
+    pub shares: [u64; MAX_RECIPIENTS],
 }
\ No newline at end of file
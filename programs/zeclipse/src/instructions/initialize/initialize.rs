@@ -1,13 +1,15 @@
 use anchor_lang::prelude::*;
 use anchor_lang::solana_program::program::invoke;
-// Use the correct import path for ComputeBudgetInstruction in Solana 1.14.17
-// In this version, it is part of solana_sdk
 use anchor_lang::solana_program;
 use anchor_lang::solana_program::system_instruction;
 use anchor_lang::solana_program::sysvar::clock::Clock;
 
 use crate::state::*;
 use crate::errors::ZEclipseError;
+use crate::hash_context::HashContext;
+use crate::cu_profile::{CuInstruction, CuPhase, CuProfiler};
+use crate::stealth_pda::STEALTH_BUMP_TABLE_LEN;
+use crate::batch_plan::funded_fake_splits;
 use crate::utils::{
     verify_hyperplonk_proof,
     verify_range_proof,
@@ -17,7 +19,12 @@ use crate::utils::{
 };
 
 /// Context for initializing an anonymous transfer
+///
+/// The transfer state lives at `[b"transfer", payer, transfer_nonce_seed(nonce)]`.
+/// Nonce 0 is the payer's default transfer; every other nonce is recorded in
+/// the payer's `TransferRegistry`, which must then be passed.
 #[derive(Accounts)]
+#[instruction(nonce: u32)]
 pub struct Initialize<'info> {
     #[account(mut)]
     pub payer: Signer<'info>,
@@ -26,37 +33,46 @@ pub struct Initialize<'info> {
         init,
         payer = payer,
         space = TransferState::SIZE,
-        seeds = [b"transfer", payer.key().as_ref()],
+        seeds = [b"transfer", payer.key().as_ref(), transfer_nonce_seed(&nonce)],
         bump
     )]
-    pub transfer_state: Account<'info, TransferState>,
+    pub transfer_state: AccountLoader<'info, TransferState>,
     
     /// CHECK: This is the recipient who receives the payment only after all hops
     pub recipient: UncheckedAccount<'info>,
     
-    /// CHECK: This is the Merkle root for wallet set verification
+    /// CHECK: This is the Merkle root for wallet set verification; its 32
+    /// address bytes are the root over the recipients' `wallet_leaf`s
     #[account()]
     pub merkle_root_account: UncheckedAccount<'info>,
     
     pub system_program: Program<'info, System>,
     
     pub clock: Sysvar<'info, Clock>,
+    
+    /// Open transfers of the payer (required for nonces other than 0)
+    #[account(
+        mut,
+        seeds = [TRANSFER_REGISTRY_SEED, payer.key().as_ref()],
+        bump = transfer_registry.bump,
+    )]
+    pub transfer_registry: Option<Account<'info, TransferRegistry>>,
 }
 
 pub fn initialize(
     ctx: Context<Initialize>,
+    nonce: u32,
     amount: u64,
     hyperplonk_proof: [u8; 128],
     range_proof: [u8; 128],
     challenge: [u8; 32],
-    merkle_proof: Vec<u8>,
+    stealth_bumps: [u8; STEALTH_BUMP_TABLE_LEN],
+    recipient_count: u8,
 ) -> Result<()> {
-    // Set compute unit limit
-    let cu_limit_ix = solana_program::instruction::ComputeBudgetInstruction::set_compute_unit_limit(400_000);
-    invoke(
-        &cu_limit_ix,
-        &[ctx.accounts.payer.to_account_info()],
-    )?;
+    let mut profiler = CuProfiler::start(CuInstruction::Initialize);
+    
+    // The compute unit limit is set by the client through a compute budget
+    // instruction in the transaction
     
     // Old compute unit check removed as it's superseded by a later check and used an outdated API.
     
@@ -72,7 +88,16 @@ pub fn initialize(
         return Err(ZEclipseError::InvalidRecipient.into());
     }
     
-    // Use fixed ZEclipse configuration
+    // Multi-wallet transfers commit their recipients through the Merkle root;
+    // finalize pays exactly `recipient_count` wallets proven against it with
+    // one multiproof (`verify_recipient_set`), so initialize takes no proof
+    if recipient_count == 0 || recipient_count as usize > MAX_RECIPIENTS {
+        msg!("Recipient count must be between 1 and {}", MAX_RECIPIENTS);
+        return Err(ZEclipseError::RecipientSetMismatch.into());
+    }
+    
+    // Default ZEclipse configuration; `config_update` can switch it to a
+    // performance profile before the first hop
     let config = BlackoutConfig::new();
     
     // Check challenge data
@@ -88,8 +113,13 @@ pub fn initialize(
     // Store bump for the PDA - adjusted for Anchor 0.29.0
     // In newer Anchor versions, `bumps` is a HashMap-like object
     let bump = ctx.bumps.transfer_state;
+    profiler.checkpoint(CuPhase::State);
     
-    // Generate seed for stealth PDAs (deterministic from challenge + payer)
+    // Generate seed for stealth PDAs (deterministic from challenge + payer).
+    // The client derives the same seed and computes the bumps of all 4 x 48
+    // stealth PDAs off-chain (`stealth_pda::compute_bump_table`); they are
+    // committed below so hops never search for bumps on-chain. A wrong bump
+    // only makes the affected hop fail, after which the owner can refund.
     let seed = Pubkey::find_program_address(
         &[
             b"zeclipse",
@@ -101,31 +131,40 @@ pub fn initialize(
     
     // Generate bloom filter for fake splits
     let fake_bloom = generate_bloom_filter(&config, &challenge);
+    profiler.checkpoint(CuPhase::PdaValidation);
     
     // Dummy commitments (will be set later)
     let commitments = [[0; 32]; 8];
     
     // Validate HyperPlonk proof with extended log data
     msg!("Validating HyperPlonk proof for anonymous transfers...");
-    if let Err(err) = verify_hyperplonk_proof(&hyperplonk_proof, &challenge) {
+    let mut hash_ctx = HashContext::new();
+    if let Err(err) = verify_hyperplonk_proof(&mut hash_ctx, &hyperplonk_proof, &challenge) {
         msg!("HyperPlonk proof validation failed: {:?}", err);
         return Err(err);
     }
     msg!("HyperPlonk proof successfully validated");
+    profiler.checkpoint(CuPhase::ProofVerification);
     
     // Verify range proof for secure amount distribution
     msg!("Validating range proof for amount distribution...");
-    if let Err(err) = verify_range_proof(&range_proof, &commitments, &challenge) {
+    if let Err(err) = verify_range_proof(&mut hash_ctx, &range_proof, &commitments, &challenge) {
         msg!("Range proof validation failed: {:?}", err);
         return Err(err);
     }
     msg!("Range proof successfully validated");
+    profiler.checkpoint(CuPhase::RangeProof);
     
     // Calculate fees
     let (total_fee, reserve) = calculate_fees(amount, &config)?;
     
-    // Total amount to transfer (real transaction + reserve + fees)
-    let total_amount = amount + total_fee + reserve;
+    // Rent-exempt funding of the fake splits the batch hops create (or that
+    // `reveal_fake` materializes); `reclaim` returns it to the owner
+    let fake_rent = funded_fake_splits(config.num_hops, config.fake_splits)
+        .saturating_mul(Rent::get()?.minimum_balance(0));
+    
+    // Total amount to transfer (real transaction + reserve + fees + fake rent)
+    let total_amount = amount + total_fee + reserve + fake_rent;
     
     // Check if the payer has enough lamports
     if ctx.accounts.payer.lamports() < total_amount {
@@ -134,27 +173,38 @@ pub fn initialize(
     }
     
     // Initialize transfer state with the extended data
-    let mut transfer_state = &mut ctx.accounts.transfer_state;
-    
-    // Initialize TransferState with double dereferencing to get from Account<'_, TransferState> type to TransferState type
-    **transfer_state = TransferState::new(
-        ctx.accounts.payer.key(),
-        amount,
-        seed,
-        bump,
-        ctx.accounts.recipient.key(),
-        config,
-        hyperplonk_proof,
-        range_proof,
-        challenge,
-        merkle_root,
-        fake_bloom,
-        ctx.accounts.clock.unix_timestamp, // Pass current timestamp
-    );
-    
-    // Store fees and reserve
-    transfer_state.total_fees = total_fee;
-    transfer_state.reserve = reserve;
+    // The zero-copy account is written in place; the guard is dropped before the
+    // deposit CPI below so the runtime can borrow the account again.
+    {
+        let mut transfer_state = ctx.accounts.transfer_state.load_init()?;
+        
+        let mut recipients = [Pubkey::default(); MAX_RECIPIENTS];
+        recipients[0] = ctx.accounts.recipient.key();
+        
+        *transfer_state = TransferState::new(
+            ctx.accounts.payer.key(),
+            amount,
+            seed,
+            bump,
+            recipients,
+            recipient_count,
+            config,
+            hyperplonk_proof,
+            range_proof,
+            challenge,
+            merkle_root,
+            fake_bloom,
+            stealth_bumps,
+            ctx.accounts.clock.unix_timestamp, // Pass current timestamp
+        );
+        
+        // Store fees and reserve
+        transfer_state.total_fees = total_fee;
+        transfer_state.reserve = reserve;
+        transfer_state.nonce = nonce;
+    }
+    track_transfer_nonce(ctx.accounts.transfer_registry.as_mut(), nonce, true)?;
+    profiler.checkpoint(CuPhase::State);
     
     // Deposit lamports into the transfer state
     let transfer_ix = system_instruction::transfer(
@@ -170,6 +220,7 @@ pub fn initialize(
             ctx.accounts.system_program.to_account_info(),
         ],
     )?;
+    profiler.checkpoint(CuPhase::Transfers);
     
     // 4. Check remaining compute units (optional, for debugging)
     // This check can be removed in production to save compute units.
@@ -180,10 +231,11 @@ pub fn initialize(
         msg!("Warning: Low CUs after initialization. Remaining: {}. Threshold: {}", 
              remaining_cus, MIN_REMAINING_CUS_THRESHOLD);
     }
+    profiler.checkpoint(CuPhase::State);
     
     // 5. Emit event for successful initialization
-    msg!("Transfer initialized: {} lamports, 4 hops, 4 real splits, 44 fake splits", 
-         amount);
+    msg!("Transfer initialized: {} lamports, {} hops, {} real splits, {} fake splits", 
+         amount, config.num_hops, config.real_splits, config.fake_splits);
     msg!("Fees: {} lamports, Reserve: {} lamports", total_fee, reserve);
     msg!("Total possible: {} paths", config.total_paths());
     
@@ -198,7 +250,9 @@ pub fn initialize(
         fake_splits: config.fake_splits,
         total_paths: config.total_paths(),
         transfer_state: ctx.accounts.transfer_state.key(),
+        nonce,
     });
+    profiler.checkpoint(CuPhase::EventEmission);
     
     Ok(())
 }
@@ -214,4 +268,5 @@ pub struct TransferInitialized {
     pub fake_splits: u8,
     pub total_paths: u64,
     pub transfer_state: Pubkey,
+    pub nonce: u32,
 }
\ No newline at end of file
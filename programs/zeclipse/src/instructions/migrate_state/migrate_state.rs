@@ -0,0 +1,122 @@
+use anchor_lang::prelude::*;
+use anchor_lang::solana_program::program::invoke;
+use anchor_lang::solana_program::system_instruction;
+use anchor_lang::solana_program::sysvar::Sysvar;
+use anchor_lang::solana_program::rent::Rent;
+use anchor_lang::Discriminator;
+
+use crate::state::*;
+use crate::errors::ZEclipseError;
+use crate::stealth_pda::STEALTH_BUMP_TABLE_LEN;
+
+/// Context for migrating a legacy transfer state to the zero-copy layout
+/// 
+/// Transfers created before the zero-copy layout still hold the Borsh-encoded
+/// `TransferState`. This instruction rewrites such an account in place, at the
+/// same PDA address, so it can be loaded with `AccountLoader` afterwards.
+/// The legacy layout has no stealth bump table, so the owner supplies it.
+#[derive(Accounts)]
+pub struct MigrateState<'info> {
+    /// Owner of the transfer, pays the additional rent for the larger layout
+    #[account(mut)]
+    pub owner: Signer<'info>,
+    
+    /// CHECK: Legacy layout cannot be loaded by Anchor; the discriminator, length,
+    /// owner field and PDA derivation are verified manually in the handler
+    #[account(mut, owner = crate::ID @ ZEclipseError::InvalidPdaOwnership)]
+    pub transfer_state: UncheckedAccount<'info>,
+    
+    pub system_program: Program<'info, System>,
+}
+
+pub fn migrate_state(
+    ctx: Context<MigrateState>,
+    stealth_bumps: [u8; STEALTH_BUMP_TABLE_LEN],
+) -> Result<()> {
+    let transfer_state_info = ctx.accounts.transfer_state.to_account_info();
+    
+    // 1. Decode the legacy account (only accounts with the legacy length qualify)
+    let legacy = {
+        let data = transfer_state_info.try_borrow_data()?;
+        
+        if data.len() != LegacyTransferState::SIZE {
+            msg!("Transfer state has {} bytes, expected legacy layout with {} bytes",
+                 data.len(), LegacyTransferState::SIZE);
+            return Err(ZEclipseError::InvalidStateTransition.into());
+        }
+        
+        if data[..8] != TransferState::DISCRIMINATOR {
+            msg!("Account is not a transfer state");
+            return Err(ZEclipseError::DeserializationError.into());
+        }
+        
+        LegacyTransferState::decode(&data)?
+    };
+    
+    // 2. Only the owner may migrate, and the account must be the owner's transfer PDA
+    if legacy.owner != ctx.accounts.owner.key() {
+        return Err(ZEclipseError::UnauthorizedAccess.into());
+    }
+    
+    let expected_pda = Pubkey::create_program_address(
+        &[b"transfer", legacy.owner.as_ref(), &[legacy.bump]],
+        ctx.program_id,
+    ).map_err(|_| ZEclipseError::InvalidPdaDerivation)?;
+    
+    if expected_pda != transfer_state_info.key() {
+        msg!("Transfer state address does not match the owner's transfer PDA");
+        return Err(ZEclipseError::InvalidPdaDerivation.into());
+    }
+    
+    // 3. Top up rent for the larger zero-copy layout
+    let required_lamports = Rent::get()?.minimum_balance(TransferState::SIZE);
+    let current_lamports = transfer_state_info.lamports();
+    
+    if current_lamports < required_lamports {
+        let top_up = required_lamports - current_lamports;
+        msg!("Topping up {} lamports of rent for the zero-copy layout", top_up);
+        
+        invoke(
+            &system_instruction::transfer(
+                &ctx.accounts.owner.key(),
+                &transfer_state_info.key(),
+                top_up,
+            ),
+            &[
+                ctx.accounts.owner.to_account_info(),
+                transfer_state_info.clone(),
+                ctx.accounts.system_program.to_account_info(),
+            ],
+        )?;
+    }
+    
+    // 4. Resize and rewrite the account in the zero-copy layout
+    transfer_state_info.realloc(TransferState::SIZE, false)?;
+    
+    let state = legacy.into_zero_copy(stealth_bumps);
+    {
+        let mut data = transfer_state_info.try_borrow_mut_data()?;
+        data[..8].copy_from_slice(&TransferState::DISCRIMINATOR);
+        data[8..].copy_from_slice(bytemuck::bytes_of(&state));
+    }
+    
+    msg!("Transfer state migrated to zero-copy layout v{} ({} bytes)",
+         TRANSFER_STATE_VERSION, TransferState::SIZE);
+    
+    emit!(TransferStateMigrated {
+        owner: state.owner,
+        transfer_state: transfer_state_info.key(),
+        version: TRANSFER_STATE_VERSION,
+        current_hop: state.current_hop,
+    });
+    
+    Ok(())
+}
+
+#[event]
+pub struct TransferStateMigrated {
+    pub owner: Pubkey,
+    pub transfer_state: Pubkey,
+    pub version: u8,
+    pub current_hop: u8,
+}
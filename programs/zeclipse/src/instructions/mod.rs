@@ -12,6 +12,9 @@ pub mod batch_hop;     // Efficient batch processing of multiple hops
 pub mod refund;        // Refund mechanism
 pub mod config_update; // Configuration changes
 pub mod reveal_fake;   // Revealing fake splits for audit purposes
+pub mod migrate_state; // Migration of legacy transfer states to the zero-copy layout
+pub mod open_registry; // Per-owner registry of concurrent transfers
+pub mod reclaim;       // Rent recycling of split PDAs and the transfer state
 pub mod processor;     // Central command processor for manual integration
 
 // Key strategy for avoiding naming conflicts:
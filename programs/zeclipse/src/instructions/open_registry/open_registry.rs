@@ -0,0 +1,46 @@
+use anchor_lang::prelude::*;
+
+use crate::state::*;
+
+/// Context for creating the transfer registry of an owner
+///
+/// The registry is needed once per wallet before its first transfer with a
+/// nonce other than 0; it tracks up to `MAX_OPEN_TRANSFERS` open transfers.
+#[derive(Accounts)]
+pub struct OpenRegistry<'info> {
+    /// Owner of the future transfers, pays the rent of the registry
+    #[account(mut)]
+    pub owner: Signer<'info>,
+    
+    #[account(
+        init,
+        payer = owner,
+        space = TransferRegistry::SIZE,
+        seeds = [TRANSFER_REGISTRY_SEED, owner.key().as_ref()],
+        bump
+    )]
+    pub transfer_registry: Account<'info, TransferRegistry>,
+    
+    pub system_program: Program<'info, System>,
+}
+
+pub fn open_registry(ctx: Context<OpenRegistry>) -> Result<()> {
+    let registry = &mut ctx.accounts.transfer_registry;
+    **registry = TransferRegistry::new(ctx.accounts.owner.key(), ctx.bumps.transfer_registry);
+    
+    msg!("Transfer registry opened for {} ({} concurrent transfers)",
+         registry.owner, MAX_OPEN_TRANSFERS);
+    
+    emit!(TransferRegistryOpened {
+        owner: registry.owner,
+        transfer_registry: registry.key(),
+    });
+    
+    Ok(())
+}
+
+#[event]
+pub struct TransferRegistryOpened {
+    pub owner: Pubkey,
+    pub transfer_registry: Pubkey,
+}
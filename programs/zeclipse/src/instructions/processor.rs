@@ -21,19 +21,19 @@ pub enum ZEclipseInstruction {
         hyperplonk_proof: [u8; 128],
         range_proof: [u8; 128],
         challenge: [u8; 32],
-        merkle_proof: Vec<u8>,
     },
     
     // Execute a single hop
     ExecuteHop {
         hop_index: u8,
         proof_data: [u8; 128],
-        range_proof_data: [u8; 128],
     },
     
     // Batch processing of multiple hops
     BatchHop {
         batch_index: u8,
+        hop_count: u8,
+        split_keys: Vec<u16>,
     },
     
     // Finalize the transfer
@@ -53,6 +53,8 @@ pub enum ZEclipseInstruction {
     RevealFakeSplit {
         hop_index: u8,
         split_index: u8,
+        blinding: [u8; 32],
+        path: Vec<[u8; 32]>,
     },
 }
 
@@ -0,0 +1,172 @@
+use anchor_lang::prelude::*;
+use anchor_lang::solana_program::system_program;
+
+use crate::state::*;
+use crate::errors::ZEclipseError;
+use crate::batch_plan::{split_key_parts, MAX_RECLAIM_SPLIT_ACCOUNTS};
+use crate::cu_profile::{CuInstruction, CuPhase, CuProfiler};
+use crate::stealth_pda::{is_fake_split_index, lookup_bump, stealth_prefix, verify_stealth_pda};
+use crate::utils::close_pda;
+
+/// Context for recycling the rent of a finished transfer
+///
+/// The split PDAs are passed as writable `remaining_accounts`, named by
+/// `split_keys` as in `execute_batch_hop`. Every account is checked against
+/// the committed bump table and emptied into the owner's wallet. The transfer
+/// state is needed for that check, so it is closed last: by the reclaim that
+/// sets `close_state`, usually the only one (a default transfer has 32 split
+/// accounts, see `batch_plan::MAX_RECLAIM_SPLIT_ACCOUNTS`). Closing is
+/// refused while `funded_splits` says split PDAs still hold lamports, since
+/// nothing could sign for them once the bump table is gone.
+#[derive(Accounts)]
+pub struct Reclaim<'info> {
+    #[account(
+        mut,
+        constraint = authority.key() == transfer_state.load()?.owner @ ZEclipseError::UnauthorizedAccess
+    )]
+    pub authority: Signer<'info>,
+    
+    #[account(
+        mut,
+        seeds = [b"transfer", transfer_state.load()?.owner.as_ref(), transfer_state.load()?.nonce_seed()],
+        bump = transfer_state.load()?.bump,
+        constraint = transfer_state.load()?.is_completed() || transfer_state.load()?.is_refund_triggered()
+            @ ZEclipseError::TransferNotComplete,
+    )]
+    pub transfer_state: AccountLoader<'info, TransferState>,
+    
+    /// CHECK: Original owner of the transfer, receives all reclaimed lamports
+    #[account(
+        mut,
+        constraint = owner.key() == transfer_state.load()?.owner @ ZEclipseError::UnauthorizedAccess
+    )]
+    pub owner: UncheckedAccount<'info>,
+    
+    pub system_program: Program<'info, System>,
+    
+    /// Open transfers of the owner (required to close states with a nonce other than 0)
+    #[account(
+        mut,
+        seeds = [TRANSFER_REGISTRY_SEED, owner.key().as_ref()],
+        bump = transfer_registry.bump,
+    )]
+    pub transfer_registry: Option<Account<'info, TransferRegistry>>,
+}
+
+pub fn reclaim<'info>(
+    ctx: Context<'_, '_, 'info, 'info, Reclaim<'info>>,
+    split_keys: Vec<u16>,
+    close_state: bool,
+) -> Result<()> {
+    let mut profiler = CuProfiler::start(CuInstruction::Reclaim);
+    
+    let (owner, nonce, seed, real_splits, stealth_bumps) = {
+        let transfer_state = ctx.accounts.transfer_state.load()?;
+        (
+            transfer_state.owner,
+            transfer_state.nonce,
+            transfer_state.seed,
+            transfer_state.config.real_splits,
+            transfer_state.stealth_bumps,
+        )
+    };
+    let transfer_state_key = ctx.accounts.transfer_state.key();
+    
+    let split_accounts = ctx.remaining_accounts;
+    if split_accounts.len() != split_keys.len() {
+        msg!("{} split accounts for {} split keys", split_accounts.len(), split_keys.len());
+        return Err(ZEclipseError::InvalidBatchConfiguration.into());
+    }
+    if split_accounts.len() > MAX_RECLAIM_SPLIT_ACCOUNTS {
+        msg!("Reclaim of {} split accounts exceeds the limit of {}",
+             split_accounts.len(), MAX_RECLAIM_SPLIT_ACCOUNTS);
+        return Err(ZEclipseError::BatchTooLarge.into());
+    }
+    profiler.checkpoint(CuPhase::State);
+    
+    // 1. Empty every split PDA into the owner's wallet. Split PDAs belong to
+    // the System program, so each one signs a System transfer with its seeds;
+    // accounts that never received lamports (or were already reclaimed) are
+    // skipped.
+    let owner_info = ctx.accounts.owner.to_account_info();
+    let system_program_info = ctx.accounts.system_program.to_account_info();
+    let mut accounts_closed: u16 = 0;
+    let mut lamports_reclaimed: u64 = 0;
+    
+    for (pda, &key) in split_accounts.iter().zip(split_keys.iter()) {
+        let (hop_index, split_index) = split_key_parts(key);
+        let is_fake = is_fake_split_index(split_index, real_splits);
+        let bump = lookup_bump(&stealth_bumps, hop_index, split_index)?;
+        verify_stealth_pda(ctx.program_id, &seed, hop_index, split_index, is_fake, bump, pda.key)?;
+        
+        let lamports = pda.lamports();
+        if lamports == 0 {
+            continue;
+        }
+        if !system_program::check_id(pda.owner) {
+            msg!("Split account {} is owned by {}", pda.key, pda.owner);
+            return Err(ZEclipseError::InvalidPdaOwnership.into());
+        }
+        
+        close_pda(
+            pda,
+            &owner_info,
+            &system_program_info,
+            &[
+                stealth_prefix(is_fake),
+                &hop_index.to_le_bytes(),
+                &split_index.to_le_bytes(),
+                &seed,
+            ],
+            bump,
+        )?;
+        
+        accounts_closed += 1;
+        lamports_reclaimed = lamports_reclaimed.saturating_add(lamports);
+    }
+    profiler.checkpoint(CuPhase::Transfers);
+    
+    let funded_splits = {
+        let mut transfer_state = ctx.accounts.transfer_state.load_mut()?;
+        transfer_state.funded_splits = transfer_state.funded_splits.saturating_sub(accounts_closed);
+        transfer_state.funded_splits
+    };
+    
+    // 2. Close the transfer state; its rent goes back to the owner who paid it
+    // and the nonce becomes free for a new transfer
+    if close_state {
+        if funded_splits > 0 {
+            msg!("{} funded split accounts must be reclaimed before the transfer state", funded_splits);
+            return Err(ZEclipseError::FundedSplitsRemaining.into());
+        }
+        lamports_reclaimed = lamports_reclaimed
+            .saturating_add(ctx.accounts.transfer_state.to_account_info().lamports());
+        ctx.accounts.transfer_state.close(owner_info)?;
+        track_transfer_nonce(ctx.accounts.transfer_registry.as_mut(), nonce, false)?;
+    }
+    profiler.checkpoint(CuPhase::State);
+    
+    msg!("Reclaimed {} lamports from {} split accounts{}",
+         lamports_reclaimed, accounts_closed,
+         if close_state { " and the transfer state" } else { "" });
+    
+    emit!(TransferReclaimed {
+        owner,
+        transfer_state: transfer_state_key,
+        accounts_closed,
+        lamports_reclaimed,
+        state_closed: close_state,
+    });
+    profiler.checkpoint(CuPhase::EventEmission);
+    
+    Ok(())
+}
+
+#[event]
+pub struct TransferReclaimed {
+    pub owner: Pubkey,
+    pub transfer_state: Pubkey,
+    pub accounts_closed: u16,
+    pub lamports_reclaimed: u64,
+    pub state_closed: bool,
+}
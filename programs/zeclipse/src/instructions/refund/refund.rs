@@ -1,36 +1,39 @@
 use anchor_lang::prelude::*;
-use anchor_lang::solana_program::program::invoke;
-use anchor_lang::solana_program;
-use anchor_lang::solana_program::system_instruction;
 use anchor_lang::solana_program::sysvar::Sysvar;
 use anchor_lang::solana_program::clock::Clock;
 
 use crate::state::*;
 use crate::errors::ZEclipseError;
-use crate::utils::calculate_optimized_priority_fees;
+use crate::cu_profile::{CuInstruction, CuPhase, CuProfiler};
+use crate::lamports::LamportTransfers;
 
 /// Context for a refund in case of errors
 /// 
 /// This instruction allows cancelling a transfer and returning funds
-/// to the sender if something went wrong.
+/// to the sender if something went wrong. It works at any hop before
+/// finalize: the state pays out what it still holds, and the lamports the
+/// hops already moved into split PDAs come back through `reclaim`, which
+/// the refund unlocks.
 #[derive(Accounts)]
 pub struct Refund<'info> {
-    #[account(mut)]
+    #[account(
+        mut,
+        constraint = authority.key() == transfer_state.load()?.owner @ ZEclipseError::UnauthorizedAccess
+    )]
     pub authority: Signer<'info>,
     
     #[account(
         mut,
-        seeds = [b"transfer", transfer_state.owner.as_ref()],
-        bump = transfer_state.bump,
-        constraint = !transfer_state.refund_triggered @ ZEclipseError::RefundAlreadyTriggered,
-        close = owner
+        seeds = [b"transfer", transfer_state.load()?.owner.as_ref(), transfer_state.load()?.nonce_seed()],
+        bump = transfer_state.load()?.bump,
+        constraint = !transfer_state.load()?.is_refund_triggered() @ ZEclipseError::RefundAlreadyTriggered,
     )]
-    pub transfer_state: Account<'info, TransferState>,
+    pub transfer_state: AccountLoader<'info, TransferState>,
     
     /// CHECK: This is the original owner of the transfer
     #[account(
         mut,
-        constraint = owner.key() == transfer_state.owner @ ZEclipseError::UnauthorizedAccess
+        constraint = owner.key() == transfer_state.load()?.owner @ ZEclipseError::UnauthorizedAccess
     )]
     pub owner: UncheckedAccount<'info>,
     
@@ -42,26 +45,31 @@ pub struct Refund<'info> {
 }
 
 pub fn refund(ctx: Context<Refund>) -> Result<()> {
-    // 1. Optimized compute budget for the refund process
-    let required_cu = 250_000; // Slightly increased for additional security checks
-    let priority_fee = calculate_optimized_priority_fees(0, required_cu)?; // Priority for fast refunds, 0 hops
+    let mut profiler = CuProfiler::start(CuInstruction::Refund);
     
-    let cu_limit_ix = solana_program::instruction::ComputeBudgetInstruction::set_compute_unit_limit(required_cu);
-    let priority_fee_ix = solana_program::instruction::ComputeBudgetInstruction::set_compute_unit_price(priority_fee);
-    
-    // Execute compute budget instructions atomically
-    invoke(
-        &cu_limit_ix,
-        &[ctx.accounts.authority.to_account_info()],
-    )?;
-    
-    invoke(
-        &priority_fee_ix,
-        &[ctx.accounts.authority.to_account_info()],
-    )?;
+    // 1. Optimized compute budget for the refund process
+    // (limit and price are set by the client through compute budget
+    // instructions in the transaction)
+    
+    // Copy the fields needed for the refund out of the zero-copy account; the
+    // guard must not be held across the transfer CPI.
+    let (completed, total_amount, owner, nonce, bump_seed, current_hop, num_hops, progress) = {
+        let transfer_state = ctx.accounts.transfer_state.load()?;
+        (
+            transfer_state.is_completed(),
+            transfer_state.amount,
+            transfer_state.owner,
+            transfer_state.nonce,
+            transfer_state.bump,
+            transfer_state.current_hop,
+            transfer_state.config.num_hops,
+            transfer_state.progress_percent(),
+        )
+    };
+    let transfer_state_key = ctx.accounts.transfer_state.key();
     
     // 2. Validation of transfer state
-    if ctx.accounts.transfer_state.completed {
+    if completed {
         msg!("Refund failed: Transfer already completed");
         return Err(ZEclipseError::TransferAlreadyCompleted.into());
     }
@@ -74,88 +82,70 @@ pub fn refund(ctx: Context<Refund>) -> Result<()> {
     let refund_percentage = 95;
     let dev_percentage = 100 - refund_percentage; // 5% for developers
     
-    // Total amount from the transfer state
-    let total_amount = ctx.accounts.transfer_state.amount;
-    
     // Exact calculation of amounts with overflow protection
     let refund_amount = (total_amount as u128 * refund_percentage as u128 / 100) as u64;
     let dev_amount = total_amount.saturating_sub(refund_amount); // Remaining amount
     
-    // 4. Check available lamports
+    // 4. Available lamports: after the first hop part of the amount sits in
+    // split PDAs, so the state may hold less than the amount. It pays out
+    // what it has; `reclaim` returns the rest to the owner.
     let available_lamports = ctx.accounts.transfer_state.to_account_info().lamports();
     
-    if available_lamports < refund_amount.saturating_add(dev_amount) {
-        msg!("Insufficient lamports for refund: {} < {}", 
-             available_lamports, refund_amount.saturating_add(dev_amount));
-        return Err(ZEclipseError::InsufficientLamports.into());
-    }
-    
     // 5. Log transfer status and progress
-    let transfer_state = &mut ctx.accounts.transfer_state;
-    let progress = transfer_state.progress_percent();
-    let current_hop = transfer_state.current_hop;
-    
-    msg!("Refunding {} lamports to the owner ({}% of total amount)", 
-         refund_amount, refund_percentage);
-    msg!("Transfer status: Hop {} of 4, {}% completed", current_hop, progress);
+    msg!("Transfer status: Hop {} of {}, {}% completed",
+         current_hop, num_hops, progress);
     
     // 6. Collect timestamp for tracking
     let clock = Clock::get()?;
     let timestamp = clock.unix_timestamp;
-    
-    // 7. Transfer DEV share (if any)
-    if dev_amount > 0 {
-        // Minimum amount check
-        let min_dev_amount = 1000; // 0.000001 SOL minimum amount
-        let actual_dev_amount = if dev_amount < min_dev_amount { 0 } else { dev_amount };
-        
-        if actual_dev_amount > 0 {
-            msg!("Sending {} lamports DEV share ({} % fee)", 
-                 actual_dev_amount, dev_percentage);
-            
-            let owner_key_for_seeds = ctx.accounts.transfer_state.owner;
-            let bump_seed = ctx.accounts.transfer_state.bump;
-            let seeds = &[
-                b"transfer".as_ref(), 
-                owner_key_for_seeds.as_ref(), 
-                &[bump_seed]
-            ];
-            let signer_seeds = &[&seeds[..]];
-
-            // Transfer with error handling
-            let dev_transfer_result = invoke_signed(
-                &system_instruction::transfer(
-                    ctx.accounts.transfer_state.to_account_info().key,
-                    ctx.accounts.dev_account.key,
-                    actual_dev_amount,
-                ),
-                &[
-                    ctx.accounts.transfer_state.to_account_info(),
-                    ctx.accounts.dev_account.to_account_info(),
-                    ctx.accounts.system_program.to_account_info(),
-                ],
-                signer_seeds,
-            );
-            
-            // Continue on error, but log it. The owner will receive the untransferred DEV share 
-            // when the transfer_state account is closed.
-            if dev_transfer_result.is_err() {
-                msg!("Warning: DEV share transfer failed. Untransferred DEV share will be returned to the owner via account closure.");
-            }
-        }
+    profiler.checkpoint(CuPhase::State);
+    
+    // 7. Pay out everything above the rent reserve: the DEV share (if any)
+    // and the rest to the owner. The state stays open with its rent until
+    // `reclaim` closes it together with the split PDAs.
+    let seeds: &[&[u8]] = &[
+        b"transfer".as_ref(), 
+        owner.as_ref(), 
+        transfer_nonce_seed(&nonce),
+        &[bump_seed]
+    ];
+    let transfer_state_info = ctx.accounts.transfer_state.to_account_info();
+    let system_program_info = ctx.accounts.system_program.to_account_info();
+    let rent_reserve = Rent::get()?.minimum_balance(transfer_state_info.data_len());
+    let refundable = available_lamports.saturating_sub(rent_reserve);
+    
+    // Minimum amount check
+    let min_dev_amount = 1000; // 0.000001 SOL minimum amount
+    let actual_dev_amount = if dev_amount < min_dev_amount { 0 } else { dev_amount.min(refundable) };
+    if actual_dev_amount > 0 {
+        msg!("Sending {} lamports DEV share ({} % fee)", 
+             actual_dev_amount, dev_percentage);
     }
     
+    let mut transfers = LamportTransfers::new(ctx.program_id, &transfer_state_info, &system_program_info, seeds)?;
+    let owner_amount = refundable - actual_dev_amount;
+    msg!("Refunding {} lamports to the owner", owner_amount);
+    transfers.transfer(&ctx.accounts.dev_account.to_account_info(), actual_dev_amount)?;
+    transfers.transfer(&ctx.accounts.owner.to_account_info(), owner_amount)?;
+    transfers.finish()?;
+    profiler.checkpoint(CuPhase::Transfers);
+    
     // 8. Mark transfer as refunded
-    transfer_state.refund_triggered = true;
-    transfer_state.timestamp = timestamp;
+    {
+        let mut transfer_state = ctx.accounts.transfer_state.load_mut()?;
+        transfer_state.set_refund_triggered();
+        transfer_state.timestamp = timestamp;
+    }
+
+    profiler.checkpoint(CuPhase::State);
     
     // 9. Emit detailed event
     emit!(RefundExecuted {
-        owner: transfer_state.owner,
-        refund_amount,
-        dev_amount,
+        owner,
+        refund_amount: owner_amount,
+        dev_amount: actual_dev_amount,
         total_amount,
-        transfer_state: ctx.accounts.transfer_state.key(),
+        transfer_state: transfer_state_key,
         current_hop,
         progress_percent: progress,
         timestamp,
@@ -163,7 +153,8 @@ pub fn refund(ctx: Context<Refund>) -> Result<()> {
     
     // 10. Final log for audit
     msg!("Refund successfully completed: {} lamports returned to {} ({} hops executed)", 
-         refund_amount, transfer_state.owner, current_hop);
+         owner_amount, owner, current_hop);
+    profiler.checkpoint(CuPhase::EventEmission);
     
     Ok(())
 }
@@ -171,7 +162,9 @@ pub fn refund(ctx: Context<Refund>) -> Result<()> {
 #[event]
 pub struct RefundExecuted {
     pub owner: Pubkey,
+    /// Lamports paid from the state to the owner (split PDAs follow via `reclaim`)
     pub refund_amount: u64,
+    /// DEV share actually paid (at most what the state held above its rent)
     pub dev_amount: u64,
     pub total_amount: u64,
     pub transfer_state: Pubkey,
@@ -1,28 +1,40 @@
 use anchor_lang::prelude::*;
-use anchor_lang::solana_program::program::invoke;
-use anchor_lang::solana_program;
 
 use crate::state::*;
 use crate::errors::ZEclipseError;
-use crate::utils::{check_bloom_filter, derive_stealth_pda};
+use crate::utils::{check_bloom_filter, fake_split_leaf, verify_fake_split_opening};
+use crate::stealth_pda::create_stealth_pda;
+use crate::cu_profile::{CuInstruction, CuPhase, CuProfiler};
+use crate::hash_context::HashContext;
+use crate::lamports::LamportTransfers;
 
 /// Context for revealing a fake split address
 /// 
 /// This instruction allows proving that a specific
 /// stealth PDA is marked as a fake split. This serves
 /// to verify the system and secure it against attacks.
+///
+/// With committed fake splits (`FAKE_MODE_COMMITTED`) the fake PDA has no
+/// account yet: the reveal opens its leaf (the client's `blinding` and the
+/// authentication `path`) against the root `config_update` stored in the
+/// transfer state, and only then materializes it from the transfer state with the rent-exempt minimum
+/// of an empty account, what the batch hops would otherwise have sent (the
+/// runtime rejects new accounts below that minimum). Only the owner may pay
+/// for that; revealing an already materialized fake moves no lamports.
 #[derive(Accounts)]
 pub struct RevealFake<'info> {
     #[account(mut)]
     pub authority: Signer<'info>,
     
     #[account(
-        seeds = [b"transfer", transfer_state.owner.as_ref()],
-        bump = transfer_state.bump,
+        mut,
+        seeds = [b"transfer", transfer_state.load()?.owner.as_ref(), transfer_state.load()?.nonce_seed()],
+        bump = transfer_state.load()?.bump,
     )]
-    pub transfer_state: Account<'info, TransferState>,
+    pub transfer_state: AccountLoader<'info, TransferState>,
     
     /// CHECK: This is the PDA to be revealed as a fake split
+    #[account(mut)]
     pub fake_pda: UncheckedAccount<'info>,
     
     pub system_program: Program<'info, System>,
@@ -32,36 +44,47 @@ pub fn reveal_fake(
     ctx: Context<RevealFake>,
     hop_index: u8,
     split_index: u8,
+    blinding: [u8; 32],
+    path: Vec<[u8; 32]>,
 ) -> Result<()> {
-    // Set compute limit
-    // Note: Revealing fakes is a diagnostic tool, use a fixed CU limit
-    let cu_limit_ix = solana_program::instruction::ComputeBudgetInstruction::set_compute_unit_limit(200_000);
-    invoke(
-        &cu_limit_ix,
-        &[ctx.accounts.authority.to_account_info()],
-    )?;
+    let mut profiler = CuProfiler::start(CuInstruction::RevealFake);
+    
+    // The bump lookup is only unwrapped after the index checks below
+    let (config, owner, nonce, bump, seed, fake_root, committed_fakes, fake_bloom, fake_bump) = {
+        let transfer_state = ctx.accounts.transfer_state.load()?;
+        (
+            transfer_state.config,
+            transfer_state.owner,
+            transfer_state.nonce,
+            transfer_state.bump,
+            transfer_state.seed,
+            transfer_state.fake_root,
+            transfer_state.has_committed_fakes(),
+            transfer_state.fake_bloom,
+            transfer_state.stealth_bump(hop_index, split_index),
+        )
+    };
     
-    // Check if the hop index is valid (0-3 for 4 hops)
-    if hop_index >= 4 {
-        msg!("Invalid hop index: {} (must be between 0 and 3)", hop_index);
+    // Check if the hop index is valid (0..num_hops of the configuration)
+    if hop_index >= config.num_hops {
+        msg!("Invalid hop index: {} (must be below {})", hop_index, config.num_hops);
         return Err(ZEclipseError::InvalidHopIndex.into());
     }
     
-    // Check if the split index is valid (0-47 for 4 real + 44 fake splits)
-    if split_index >= 48 { // 4 + 44 = 48 splits total
-        msg!("Invalid split index: {} (must be between 0 and 47)", split_index);
+    // Check if the split index is in the fake split range
+    // (real_splits..real_splits + fake_splits of the configuration)
+    if !config.is_fake_split_index(split_index) {
+        msg!("Split index {} is not a fake split, must be between {} and {}",
+             split_index, config.real_splits, config.splits_per_hop().saturating_sub(1));
         return Err(ZEclipseError::InvalidParameters.into());
     }
     
-    // Check if the index is in the fake split range (4-47)
-    if split_index < 4 {
-        msg!("Split index {} is a real split, must be between 4 and 47 for fake splits", split_index);
-        return Err(ZEclipseError::InvalidParameters.into());
-    }
+    let fake_bump = fake_bump?;
+    profiler.checkpoint(CuPhase::State);
     
     // Check if the split is marked as fake in the bloom filter
     let is_fake = check_bloom_filter(
-        &ctx.accounts.transfer_state.fake_bloom,
+        &fake_bloom,
         hop_index,
         split_index,
     );
@@ -71,20 +94,74 @@ pub fn reveal_fake(
         return Err(ZEclipseError::BloomFilterError.into());
     }
     
-    // Calculate the expected PDA for the fake split
-    let (expected_pda, _) = derive_stealth_pda(
+    // Recreate the expected PDA for the fake split from its committed bump
+    let expected_pda = create_stealth_pda(
         ctx.program_id,
-        &ctx.accounts.transfer_state.seed,
+        &seed,
         hop_index,
         split_index,
         true, // Fake split
-    );
+        fake_bump,
+    )?;
     
     // Check if the provided PDA matches the expected one
     if ctx.accounts.fake_pda.key() != expected_pda {
         msg!("PDA does not match the expected fake split PDA");
         return Err(ZEclipseError::InvalidPda.into());
     }
+    profiler.checkpoint(CuPhase::PdaValidation);
+    
+    // Committed fakes: open the leaf against the stored root and
+    // materialize the account once
+    let mut fake_commitment = [0u8; 32];
+    let mut materialized_lamports = 0;
+    if committed_fakes {
+        let mut hash_ctx = HashContext::new();
+        if !verify_fake_split_opening(
+            &mut hash_ctx,
+            &fake_root,
+            &config,
+            hop_index,
+            split_index,
+            &blinding,
+            &path,
+        )? {
+            msg!("Opening does not match the committed fake split root");
+            return Err(ZEclipseError::MerkleProofVerificationFailed.into());
+        }
+        fake_commitment = fake_split_leaf(&mut hash_ctx, hop_index, split_index, &blinding)?;
+        profiler.checkpoint(CuPhase::ProofVerification);
+        
+        if ctx.accounts.fake_pda.lamports() == 0 {
+            if ctx.accounts.authority.key() != owner {
+                msg!("Only the owner can materialize a committed fake split");
+                return Err(ZEclipseError::UnauthorizedAccess.into());
+            }
+            
+            let transfer_seeds: &[&[u8]] = &[
+                b"transfer".as_ref(),
+                owner.as_ref(),
+                transfer_nonce_seed(&nonce),
+                &[bump],
+            ];
+            let transfer_state_info = ctx.accounts.transfer_state.to_account_info();
+            let system_program_info = ctx.accounts.system_program.to_account_info();
+            let fake_pda_info = ctx.accounts.fake_pda.to_account_info();
+            let mut transfers = LamportTransfers::new(
+                ctx.program_id,
+                &transfer_state_info,
+                &system_program_info,
+                transfer_seeds,
+            )?;
+            let lamports = transfers.rent_exempt_minimum(&fake_pda_info);
+            transfers.transfer(&fake_pda_info, lamports)?;
+            materialized_lamports = transfers.finish()?;
+            let mut transfer_state = ctx.accounts.transfer_state.load_mut()?;
+            transfer_state.funded_splits = transfer_state.funded_splits.saturating_add(1);
+            msg!("Committed fake split materialized with {} Lamports", materialized_lamports);
+        }
+        profiler.checkpoint(CuPhase::Transfers);
+    }
     
     // Proof successfully provided - the PDA is a fake split
     msg!("Successful verification: PDA for hop {} and split {} is a fake split",
@@ -92,12 +169,15 @@ pub fn reveal_fake(
     
     // Emit event
     emit!(FakeRevealed {
-        owner: ctx.accounts.transfer_state.owner,
+        owner,
         hop_index,
         split_index,
         fake_pda: ctx.accounts.fake_pda.key(),
         transfer_state: ctx.accounts.transfer_state.key(),
+        materialized_lamports,
+        fake_commitment,
     });
+    profiler.checkpoint(CuPhase::EventEmission);
     
     Ok(())
 }
@@ -109,4 +189,8 @@ pub struct FakeRevealed {
     pub split_index: u8,
     pub fake_pda: Pubkey,
     pub transfer_state: Pubkey,
+    /// Lamports sent to materialize a committed fake split (0 otherwise)
+    pub materialized_lamports: u64,
+    /// Opened leaf of a committed fake split (zero in funded mode)
+    pub fake_commitment: [u8; 32],
 }
@@ -0,0 +1,277 @@
+//! Lamport transfers out of program-owned accounts
+//!
+//! A System program transfer CPI costs more than 1k CU plus the cloning of
+//! three account infos, and the System program only debits accounts it owns.
+//! Accounts owned by this program, above all the transfer state, can instead
+//! be debited directly: the runtime accepts any lamport change that keeps the
+//! instruction balanced, as long as only accounts owned by the executing
+//! program are debited. Credits are allowed on every writable account,
+//! including system-owned stealth PDAs that receive their first lamports.
+//!
+//! `LamportTransfers` credits every destination in place and debits the
+//! source once, with the overflow-checked total, in `finish`. The source must
+//! stay rent exempt. Only a source owned by the System program (a
+//! system-owned PDA signing with its seeds) falls back to one transfer CPI
+//! per destination.
+//!
+//! The runtime also rejects any account that a transaction leaves with a
+//! balance between zero and its rent-exempt minimum. A credit that would do
+//! so, typically a first funding below `Rent::minimum_balance(0)`, is refused
+//! when it is queued instead of failing the whole transaction afterwards.
+
+use anchor_lang::prelude::*;
+use anchor_lang::solana_program::program::invoke_signed;
+use anchor_lang::solana_program::system_instruction;
+use anchor_lang::solana_program::system_program;
+
+use crate::errors::ZEclipseError;
+
+/// How lamports leave the source account
+enum Route<'b, 'info> {
+    /// Source owned by this program: direct lamport arithmetic
+    Direct,
+    /// Source owned by the System program: one transfer CPI per destination
+    SystemCpi {
+        system_program: &'b AccountInfo<'info>,
+        signer_seeds: &'b [&'b [u8]],
+    },
+}
+
+/// Batch of lamport transfers from one source account
+pub struct LamportTransfers<'b, 'info> {
+    source: &'b AccountInfo<'info>,
+    route: Route<'b, 'info>,
+    rent: Rent,
+    total: u64,
+}
+
+impl<'b, 'info> LamportTransfers<'b, 'info> {
+    /// Starts a batch, choosing the route from the owner of `source`
+    ///
+    /// `system_program` and `signer_seeds` are only used by the CPI fallback.
+    pub fn new(
+        program_id: &Pubkey,
+        source: &'b AccountInfo<'info>,
+        system_program: &'b AccountInfo<'info>,
+        signer_seeds: &'b [&'b [u8]],
+    ) -> Result<Self> {
+        Self::with_rent(program_id, source, system_program, signer_seeds, Rent::get()?)
+    }
+
+    /// `new` with an explicit rent sysvar
+    pub fn with_rent(
+        program_id: &Pubkey,
+        source: &'b AccountInfo<'info>,
+        system_program: &'b AccountInfo<'info>,
+        signer_seeds: &'b [&'b [u8]],
+        rent: Rent,
+    ) -> Result<Self> {
+        let route = if source.owner == program_id {
+            Route::Direct
+        } else if system_program::check_id(source.owner) {
+            Route::SystemCpi { system_program, signer_seeds }
+        } else {
+            msg!("Transfer source {} is owned by {}", source.key, source.owner);
+            return Err(ZEclipseError::InvalidPdaOwnership.into());
+        };
+
+        Ok(Self { source, route, rent, total: 0 })
+    }
+
+    /// Whether the source is debited directly (no CPI)
+    pub fn is_direct(&self) -> bool {
+        matches!(self.route, Route::Direct)
+    }
+
+    /// Lamports transferred so far
+    pub fn total(&self) -> u64 {
+        self.total
+    }
+
+    /// Balance `destination` needs to be rent exempt
+    pub fn rent_exempt_minimum(&self, destination: &AccountInfo<'info>) -> u64 {
+        self.rent.minimum_balance(destination.data_len())
+    }
+
+    /// Moves `amount` lamports to `destination` (no-op for 0)
+    ///
+    /// Fails if the destination would end up below its rent-exempt minimum.
+    pub fn transfer(&mut self, destination: &AccountInfo<'info>, amount: u64) -> Result<()> {
+        if amount == 0 {
+            return Ok(());
+        }
+        let balance = destination.lamports().checked_add(amount).ok_or(ZEclipseError::InvalidAmount)?;
+        let min_balance = self.rent_exempt_minimum(destination);
+        if balance < min_balance {
+            msg!("Transfer of {} Lamports leaves {} below its rent-exempt minimum of {}",
+                 amount, destination.key, min_balance);
+            return Err(ZEclipseError::InsufficientLamports.into());
+        }
+        self.total = self.total.checked_add(amount).ok_or(ZEclipseError::InvalidAmount)?;
+
+        match &self.route {
+            Route::Direct => {
+                let mut lamports = destination.try_borrow_mut_lamports()?;
+                **lamports = lamports.checked_add(amount).ok_or(ZEclipseError::InvalidAmount)?;
+            }
+            Route::SystemCpi { system_program, signer_seeds } => {
+                invoke_signed(
+                    &system_instruction::transfer(self.source.key, destination.key, amount),
+                    &[
+                        self.source.clone(),
+                        destination.clone(),
+                        (*system_program).clone(),
+                    ],
+                    &[*signer_seeds],
+                ).map_err(|e| {
+                    msg!("Transfer of {} Lamports to {} failed: {:?}", amount, destination.key, e);
+                    ZEclipseError::SplitTransferFailed
+                })?;
+            }
+        }
+
+        Ok(())
+    }
+
+    /// Debits the source with the total and returns it
+    ///
+    /// Must be called once all transfers are queued; without it the
+    /// instruction is unbalanced and the runtime rejects it.
+    pub fn finish(self) -> Result<u64> {
+        if !self.is_direct() {
+            return Ok(self.total);
+        }
+
+        let min_balance = self.rent.minimum_balance(self.source.data_len());
+        let mut lamports = self.source.try_borrow_mut_lamports()?;
+        let remaining = lamports
+            .checked_sub(self.total)
+            .filter(|remaining| *remaining >= min_balance)
+            .ok_or_else(|| {
+                msg!("Source holds {} Lamports, {} needed plus {} rent reserve",
+                     **lamports, self.total, min_balance);
+                ZEclipseError::InsufficientLamports
+            })?;
+        **lamports = remaining;
+
+        Ok(self.total)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    const PROGRAM_ID: Pubkey = Pubkey::new_from_array([5u8; 32]);
+    const STATE_LEN: usize = 64;
+
+    fn account<'a>(
+        key: &'a Pubkey,
+        lamports: &'a mut u64,
+        data: &'a mut [u8],
+        owner: &'a Pubkey,
+    ) -> AccountInfo<'a> {
+        AccountInfo::new(key, false, true, lamports, data, owner, false, 0)
+    }
+
+    #[test]
+    fn test_direct_transfers_balance() {
+        let rent = Rent::default();
+        let fund = rent.minimum_balance(0);
+        let keys = [Pubkey::new_unique(), Pubkey::new_unique(), Pubkey::new_unique()];
+        let system_id = system_program::ID;
+        let mut lamports = [rent.minimum_balance(STATE_LEN) + 10 * fund, 0, 500, 1];
+        let mut state_data = [0u8; STATE_LEN];
+        let (mut a_data, mut b_data, mut system_data) = ([0u8; 0], [0u8; 0], [0u8; 0]);
+        let [source_lamports, a_lamports, b_lamports, system_lamports] = &mut lamports;
+        let source = account(&keys[0], source_lamports, &mut state_data, &PROGRAM_ID);
+        let a = account(&keys[1], a_lamports, &mut a_data, &system_id);
+        let b = account(&keys[2], b_lamports, &mut b_data, &system_id);
+        let system = account(&system_id, system_lamports, &mut system_data, &system_id);
+
+        let mut transfers = LamportTransfers::with_rent(&PROGRAM_ID, &source, &system, &[], rent).unwrap();
+        assert!(transfers.is_direct());
+        transfers.transfer(&a, 4 * fund).unwrap();
+        transfers.transfer(&b, 6 * fund).unwrap();
+        transfers.transfer(&b, 0).unwrap();
+        assert_eq!(transfers.total(), 10 * fund);
+        assert_eq!(transfers.finish().unwrap(), 10 * fund);
+
+        assert_eq!(source.lamports(), rent.minimum_balance(STATE_LEN));
+        assert_eq!(a.lamports(), 4 * fund);
+        assert_eq!(b.lamports(), 6 * fund + 500);
+    }
+
+    #[test]
+    fn test_direct_transfers_keep_rent_reserve() {
+        let rent = Rent::default();
+        let fund = rent.minimum_balance(0);
+        let keys = [Pubkey::new_unique(), Pubkey::new_unique()];
+        let system_id = system_program::ID;
+        let mut lamports = [rent.minimum_balance(STATE_LEN) + 10 * fund, 0, 1];
+        let mut state_data = [0u8; STATE_LEN];
+        let (mut a_data, mut system_data) = ([0u8; 0], [0u8; 0]);
+        let [source_lamports, a_lamports, system_lamports] = &mut lamports;
+        let source = account(&keys[0], source_lamports, &mut state_data, &PROGRAM_ID);
+        let a = account(&keys[1], a_lamports, &mut a_data, &system_id);
+        let system = account(&system_id, system_lamports, &mut system_data, &system_id);
+
+        // One Lamport more than the balance above the rent reserve
+        let mut transfers = LamportTransfers::with_rent(&PROGRAM_ID, &source, &system, &[], rent).unwrap();
+        transfers.transfer(&a, 10 * fund + 1).unwrap();
+        assert!(transfers.finish().is_err());
+        assert_eq!(source.lamports(), rent.minimum_balance(STATE_LEN) + 10 * fund);
+
+        // Overflowing totals are rejected before any account is touched
+        let mut transfers = LamportTransfers::with_rent(&PROGRAM_ID, &source, &system, &[], rent).unwrap();
+        transfers.transfer(&a, 1).unwrap();
+        assert!(transfers.transfer(&a, u64::MAX).is_err());
+        assert_eq!(a.lamports(), 10 * fund + 2);
+    }
+
+    #[test]
+    fn test_credits_below_rent_exemption_are_rejected() {
+        let rent = Rent::default();
+        let fund = rent.minimum_balance(0);
+        let keys = [Pubkey::new_unique(), Pubkey::new_unique(), Pubkey::new_unique()];
+        let system_id = system_program::ID;
+        let mut lamports = [rent.minimum_balance(STATE_LEN) + 2 * fund, 0, 500, 1];
+        let mut state_data = [0u8; STATE_LEN];
+        let (mut a_data, mut b_data, mut system_data) = ([0u8; 0], [0u8; 0], [0u8; 0]);
+        let [source_lamports, a_lamports, b_lamports, system_lamports] = &mut lamports;
+        let source = account(&keys[0], source_lamports, &mut state_data, &PROGRAM_ID);
+        let a = account(&keys[1], a_lamports, &mut a_data, &system_id);
+        let b = account(&keys[2], b_lamports, &mut b_data, &system_id);
+        let system = account(&system_id, system_lamports, &mut system_data, &system_id);
+
+        // A first funding one Lamport short of rent exemption is refused
+        let mut transfers = LamportTransfers::with_rent(&PROGRAM_ID, &source, &system, &[], rent).unwrap();
+        assert_eq!(transfers.rent_exempt_minimum(&a), fund);
+        assert!(transfers.transfer(&a, fund - 1).is_err());
+        assert_eq!((a.lamports(), transfers.total()), (0, 0));
+
+        // Topping up an existing balance to exactly the minimum is fine
+        transfers.transfer(&b, fund - 500).unwrap();
+        transfers.transfer(&a, fund).unwrap();
+        assert_eq!(transfers.finish().unwrap(), 2 * fund - 500);
+        assert_eq!((a.lamports(), b.lamports()), (fund, fund));
+    }
+
+    #[test]
+    fn test_route_selection() {
+        let keys = [Pubkey::new_unique(), Pubkey::new_unique(), Pubkey::new_unique()];
+        let system_id = system_program::ID;
+        let mut lamports = [1_000_000u64, 1_000_000, 1];
+        let (mut data_a, mut data_b, mut system_data) = ([0u8; 0], [0u8; 0], [0u8; 0]);
+        let other_owner = Pubkey::new_unique();
+        let [system_owned_lamports, foreign_lamports, system_lamports] = &mut lamports;
+        let system_owned = account(&keys[0], system_owned_lamports, &mut data_a, &system_id);
+        let foreign = account(&keys[1], foreign_lamports, &mut data_b, &other_owner);
+        let system = account(&system_id, system_lamports, &mut system_data, &system_id);
+
+        let rent = Rent::default();
+        let transfers = LamportTransfers::with_rent(&PROGRAM_ID, &system_owned, &system, &[], rent).unwrap();
+        assert!(!transfers.is_direct());
+        assert!(LamportTransfers::with_rent(&PROGRAM_ID, &foreign, &system, &[], rent).is_err());
+    }
+}
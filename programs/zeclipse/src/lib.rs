@@ -64,6 +64,14 @@ pub mod utils;
 pub mod poseidon_validator;
 pub mod poseidon_constants;
 pub mod instructions;
+pub mod stealth_pda;
+pub mod bloom;
+pub mod batch_plan;
+pub mod lamports;
+pub mod zk_hash;
+pub mod hash_context;
+pub mod cu_profile;
+pub mod optimized_validation;
 
 // Re-export important types
 pub use state::{
@@ -82,6 +90,9 @@ pub use instructions::{
     config_update,
     refund,
     reveal_fake,
+    migrate_state,
+    open_registry,
+    reclaim,
 };
 
 // Re-export utils for external use
@@ -1,242 +1,10 @@
-use num_bigint::BigUint;
-use curve25519_dalek::scalar::Scalar;
-// PoseidonHash is used indirectly by other modules, direct import not required here
-
-pub const POSEIDON_FULL_ROUNDS: usize = 8;
-pub const POSEIDON_PARTIAL_ROUNDS: usize = 57;
-pub const POSEIDON_WIDTH: usize = 3;
-
-// Helper function to convert hex strings to Scalar (Field Element)
-fn scalar_from_hex(s: &str) -> Scalar {
-    let s = if s.starts_with("0x") { &s[2..] } else { s };
-    
-    // Convert hexadecimal to BigUint
-    let big_uint = BigUint::parse_bytes(s.as_bytes(), 16)
-        .expect(&format!("Failed to parse hex string for Scalar: {}", s));
-    
-    // Convert BigUint to bytes
-    let bytes = big_uint.to_bytes_be();
-    
-    // Convert bytes to Scalar (updated method for current curve25519-dalek version)
-    // Convert bytes to a 32-byte array
-    let mut array = [0u8; 32];
-    // Copy the bytes or pad with zeros if less than 32 bytes
-    let len = std::cmp::min(bytes.len(), 32);
-    array[32 - len..].copy_from_slice(&bytes[..len]);
-    // Use the available method
-    Scalar::from_bytes_mod_order(array)
-}
-
-// Convert MDS matrix from hex strings to Scalars
-pub fn get_mds_matrix() -> Vec<Vec<Scalar>> {
-    let mds_hex = [
-        ["3d955d6c02fe4d7cb500e12f2b55eff668a7b4386bd27413766713c93f2acfcd", "3798866f4e6058035dcf8addb2cf1771fac234bcc8fc05d6676e77e797f224bf", "2c51456a7bf2467eac813649f3f25ea896eac27c5da020dae54a6e640278fda2"],
-        ["20088ca07bbcd7490a0218ebc0ecb31d0ea34840e2dc2d33a1a5adfecff83b43", "1d04ba0915e7807c968ea4b1cb2d610c7f9a16b4033f02ebacbb948c86a988c3", "5387ccd5729d7acbd09d96714d1d18bbd0eeaefb2ddee3d2ef573c9c7f953307"],
-        ["1e208f585a72558534281562cad89659b428ec61433293a8d7f0f0e38a6726ac", "0455ebf862f0b60f69698e97d36e8aafd4d107cae2b61be1858b23a3363642e0", "569e2c206119e89455852059f707370e2c1fc9721f6c50991cedbbf782daef54"],
-    ];
-    
-    mds_hex.iter()
-        .map(|row| row.iter().map(|&s| scalar_from_hex(s)).collect())
-        .collect()
-}
-
-// Return all round constants as a vector
-pub fn get_round_constants() -> Vec<Scalar> {
-    vec![
-        // Round constants from generated file, converted to Scalar format
-        scalar_from_hex("6c4ffa723eaf1a7bf74905cc7dae4ca9ff4a2c3bc81d42e09540d1f250910880"),
-        scalar_from_hex("54dd837eccf180c92c2f53a3476e45a156ab69a403b6b9fdfd8dd970fddcdd9a"),
-        scalar_from_hex("64f56d735286c35f0e7d0a29680d49d54fb924adccf8962eeee225bf9423a85e"),
-        scalar_from_hex("670d5b6efe620f987d967fb13d2045ee3ac8e9cbf7d30e8594e733c7497910dc"),
-        scalar_from_hex("2ef5299e2077b2392ca874b015120d7e7530f277e06f78ee0b28f33550c68937"),
-        scalar_from_hex("0c0981889405b59c384e7dfa49cd4236e2f45ed024488f67c73f51c7c22d8095"),
-        scalar_from_hex("0d88548e6296171b26c61ea458288e5a0d048e2fdf5659de62cfca43f1649c82"),
-        scalar_from_hex("3371c00f3715d44abce4140202abaaa44995f6f1df12384222f61123faa6b638"),
-        scalar_from_hex("4ce428fec6d178d10348f4857f0006a652911085c8d86baa706f6d7975b0fe1b"),
-        scalar_from_hex("1a3c26d755bf65326b03521c94582d91a3ae2c0d8dfb2a345847aece52070ab0"),
-        scalar_from_hex("02dbb4709583838c35a118742bf482d257ed4dfb212014c083a6b059adda82b5"),
-        scalar_from_hex("41f2dd64b9a0dcea721b0035259f45f2a9066690de8f13b9a48ead411d8ff5a7"),
-        scalar_from_hex("5f154892782617b26993eea6431580c0a82c0a4dd0efdb24688726b4108c46a8"),
-        scalar_from_hex("0db98520f9b97cbcdb557872f4b7f81567a1be374f60fc4281a6e04079e00c0c"),
-        scalar_from_hex("71564ed66b41e872ca76aaf9b2fa0ca0695f2162705ca6a1f7ef043fd957f12d"),
-        scalar_from_hex("69191b1fe6acbf888d0c723f754c89e8bd29cb34b1e43ab27be105ea6b38d8b8"),
-        scalar_from_hex("04e9919eb06ff327152cfed30028c5edc667809ce1512e5963329c7040d29350"),
-        scalar_from_hex("573bc78e3ed162e5edd38595feead65481c991b856178f6182a0c7090ff71288"),
-        scalar_from_hex("102800af87fd92eb1dec942469e076602695a1996a4db968bb7f38ddd455db0b"),
-        scalar_from_hex("593d1894c17e5b626f8779acc32d8f188d619c02902ef775ebe81ef1c0fb7a8f"),
-        scalar_from_hex("66850b1b1d5d4e07b03bac49c9feadd051e374908196a806bd296957fa2fe2b7"),
-        scalar_from_hex("46aaa1206232ceb480d6aa16cc03465d8e96a807b28c1e494a81c43e0faffc57"),
-        scalar_from_hex("2102aab97ce5bd94ffd5db908bf28b7f8c36671191d4ee9ac1c5f2fae4780579"),
-        scalar_from_hex("14387b24d1c0c712bbe720164c4093185fcb546a2a7d481abc94e5b8fb5178b7"),
-        scalar_from_hex("5f2179b3a7845836cfced83e64e206f6a6cef2cf737f020b5cfd713c9550fe9f"),
-        scalar_from_hex("1787986ab56e1b56b5443334562b0bc3657d27323b87e3a8485e68ab96d57188"),
-        scalar_from_hex("39ef4b00deefe7e7451adda44428aa22074c496de2c9ed67dcf4861da65f543a"),
-        scalar_from_hex("7271d384cf5c90fd0c48af190c5c765937c7468088b081a99337e6eae53bb20c"),
-        scalar_from_hex("6669e58d04248ca86024fbc196e5f306e522423aa71f84225435328b37a1dd3d"),
-        scalar_from_hex("0c1f1b492b27539d754cba5e46edc1f1ac1c5696da8eb19416b07420bb321c65"),
-        scalar_from_hex("1c4d41a133b97dc467f1f184cf191f331dfc38e79e7e53516c39848c9bd44692"),
-        scalar_from_hex("369ea8e699181b1cf88be9205ab840180c9288e67a359dc0dda4ac74cf9768e2"),
-        scalar_from_hex("4cfa7d72afed332bf0b8a2a719123f7ebfa714b9e3100eaa533dbde6fb985043"),
-        scalar_from_hex("4e592fcde9f3c360e54c6f34d7a8bd41889942e9fe23d9fd4a9e5b3bfbbb3e45"),
-        scalar_from_hex("032b5885586212fb235570996d3a4c40f54ff91598a948ec2722ed865b8438a5"),
-        scalar_from_hex("03f3178956cfd3e2e6614fb134597d3b3cff0d8a33f3523d825982990c068940"),
-        scalar_from_hex("3126e84dfd67a22bf0ce0d9273d8ad40e6109af5bb2bd78d0ac08a16c6248f74"),
-        scalar_from_hex("3527888062f1e2738d7b928e9af244f0a39011390c2dbbcf56d8e087f4087b6f"),
-        scalar_from_hex("64635758efc701dbbe2eb423bf7b5bf6c3d34c6ff92494f3421182a8b187ecf7"),
-        scalar_from_hex("4d7f71960f03db8a2a428cbf77ddc1916a5f4243dbeb2ddaef7b5b5f9d74546e"),
-        scalar_from_hex("37832ba2da93de3643243eba3b9765d75359310617f3fc06d74ac12db57b29c5"),
-        scalar_from_hex("4dce55879ffd9398f96c9e6556a3bb4fc93147965252cb1d6c94b3282ba3fae6"),
-        scalar_from_hex("4ba85e4d2537972c0fd5a4727a58c3d85d98563697a34c0af845bfecd6dc4b40"),
-        scalar_from_hex("582dc453b4cbf6b1d19734b0f337d3423b503703979689f384d0eb96ff5b02ce"),
-        scalar_from_hex("0e6f127f479ee6113540d69b25420a2682f07b23e799566b091a1c891fa224ba"),
-        scalar_from_hex("39c815508d2995bb8ae5035472944706e900b2fb16d5a779fdfff82306f37dbb"),
-        scalar_from_hex("6591aba215bcf96d8aa03220372179a4c5060cfd7f95724ab300d9459f709051"),
-        scalar_from_hex("221807cb4909d549c546a734ad2cd7f60a69e816ace98fad830452a44a343188"),
-        scalar_from_hex("2766a1e33038004da58bce78722380b22b13b0aecb87f38659f3035e1336b53f"),
-        scalar_from_hex("11b5e993e6a9cdc3b5d2f5336dc9bad5074b661537ff890b1babd7f53cada9e3"),
-        scalar_from_hex("29576176f9a5a10e3d0a2c59af26b51f4c5fc86ec59c0f2492deb60ad49eddcd"),
-        scalar_from_hex("51e72c44f9de491c747d8a6d333fb2b3e16ee7571f1340a9a5f6f72363991e98"),
-        scalar_from_hex("2fb360d959be4aa871e071764a5e41eb264d04f0289f098723b69bab09f4d1a6"),
-        scalar_from_hex("03f46b4c3c77957cb595ed61fe13f9e8739a5009311142b69c1e8c07ae250f47"),
-        scalar_from_hex("4683311e382a99927e0ff672cd0543aaebfc0c33ba96ad937818cec979b57b5e"),
-        scalar_from_hex("7117cc69bf566b1b0ba5486b0f1f9bd60f2f945e3cbf33a2ed17076f4caa0dd6"),
-        scalar_from_hex("3bd670c3ce88ea43f254d61c2a9b56d6a4dff19ab5c4d28989d271f3dd6bee25"),
-        scalar_from_hex("53b43b2c5b99c4979ee9fda5550ac436d7a3a29c86e03a976cb3fdf87ad9cb00"),
-        scalar_from_hex("3a84f4e72118b247d57db8dbce3b13a50a6e72fee9ab94e5cdfc7d79b5ad4219"),
-        scalar_from_hex("1cda6faac155f0e3d93ca83e5c9b275bb33360a2d3e943e45b1c9d60955b83dd"),
-        scalar_from_hex("423813dede9f8d39d3e0a7c51f8e5e01454035fc8f3541cd746ae07710691ac4"),
-        scalar_from_hex("2fd4fa807a3ba1c8a3c72a185ed74fb8e5f581dc67b6dbcbf3da51c8df0a3ac9"),
-        scalar_from_hex("4b2e47e5f0dde8317850d4c4e5ef2f7ad6a168de26aaf56879ef9e2cbba82f47"),
-        scalar_from_hex("3f6eb6ca6c4df73edec5ed13b71b5c8a5a75a21a42ab74fe1a217de71e2e53a9"),
-        scalar_from_hex("1e7c9be83cf7ba6ec5f4645c7cce6769efdfb4cba3f4e1bc02cf64af21d7df91"),
-        scalar_from_hex("0d3dde34e0a5ccfe36c34034904a1e9b9b03c0c04dcaeb78c8b509e7c4f6e4c2"),
-        scalar_from_hex("4a7a24fc5fa6b6a5ad61c8aeebf9ae697f6cbe2b3fce5c1b66a0340662afae0c"),
-        scalar_from_hex("4a1bc35b7d1a5f2be3fd5a951cc25eb2c2aad79ba92cc39a7c5e8500c06ab40b"),
-        scalar_from_hex("1ffd81b1117de8c732edf157997dbdb4b7e97af0ca2668c718beffe510f47842"),
-        scalar_from_hex("0d0d5aa4aa14a2f12d0e4b9c67d01f3c1f0c0b4cc075c4f9dbd48c8a3bf60f35"),
-        scalar_from_hex("0b29911b78c1bc08ab52dfa73b56f60fcd2da67db12f648f0c6a049fae342204"),
-        scalar_from_hex("0e7d8c1e8a2de6adf03985a5ef5b35dfa27a1324a6b62a35b7d2bb631cc00c90"),
-        scalar_from_hex("14f1a1c30c8d979a3e8b6b93c6c557c1b06add4c903b94a1d4f33d8665c83c28"),
-        scalar_from_hex("79da61f91ef337a13f9d4a07fc53a9d2e54a43b4c1f5cce8ee1cb940b52f6eca"),
-        scalar_from_hex("4a64efe1f3d0a1db1c2430662b9b167082c2d5ce8edcae0e5a5922a75c07dad5"),
-        scalar_from_hex("5d7c7ef12bb9d90b9baca82b10378f8999f2b3f7a9e2bfa2a89c0350ca799193"),
-        scalar_from_hex("47b86e97da8746d5a1b1c07f1bc21fdedecb44d843f6eda20ec5b39fc1bdd4e1"),
-        scalar_from_hex("00f9f48d2c2fb6b0e53c8de0ef793ce863360e85958ef1cce39fe7af4da047ff"),
-        scalar_from_hex("20f3f2f0bc8ac4dc7f9b32eed0c356f83c4de2a8cbaca09db544e7fdcda5e176"),
-        scalar_from_hex("65f2efc8d52a3ade92b18aef08c94a11c63e69bd0fc5b9e62e3f1b876af26525"),
-        scalar_from_hex("14abf9c1cb6f580f89d2a93be3a9c445ac99a4cf22b6adb7f2d5724b37c5c2fb"),
-        scalar_from_hex("1ed2fa9d9bc3c4cb2979b1cf2c8df0ecfebd3d8645a3325c2e6b238c657ac1b7"),
-        scalar_from_hex("3c49df00da71c2d8a4ae0a3805e07fe688c5d5422ceb1a2cbcc6f54b2a5a3ca2"),
-        scalar_from_hex("4fd0143ce090db3b95459e0c4bd2a42e68dc33be2465973407af3e4fd0e5fcb8"),
-        scalar_from_hex("03fdf9a1c9fd14f80a5f37d6d87f317c69b8a28002b23e64b5f2b18ec4c3ffa9"),
-        scalar_from_hex("6eb0f8acafb6a24f4e2b2ca5c86aac51ab3c56a78fdbed7cb2df3f26a56c1c84"),
-        scalar_from_hex("267a5944c98b4bbed62d86e2b36a5e8ceabd36b2ed9d64ddde5948e1a6b25d12"),
-        scalar_from_hex("1e32ad0d0fdf5be9f05eff82ae91a97aae4fc1befacbdf74e0f8b8b9c1cf8bc2"),
-        scalar_from_hex("03afe55df4ede7b289628e258a14a59a39dccc6c75a2a8e65270da7d3e32bd2d"),
-        scalar_from_hex("6f56cffee3f140e97a5ba0b4761c5aca4c007eff43d96444b0c1e1ce6322389e"),
-        scalar_from_hex("7df3afdaf77b44f27cdb7bc5ee3a05aeb0d9547abe829bfa5c4d595251dec130"),
-        scalar_from_hex("4e74dbe98c421f3c5c6f50abc91d4b2a92f8a25abe6fff76b67f8f8fd9f73de9"),
-        scalar_from_hex("7d36d44ee39984bf0ffd0f933f82147ee8d9edcc28e62c2336ba4a72de12f357"),
-        scalar_from_hex("3bd7c05d3f32bf744f65aa77e28b61c89a5e10f9c5cd1ee1c7562ce933fbd153"),
-        scalar_from_hex("6c6b11c8ce3bbe927b4a0fa34a0da59de2aac49448d174dcf7d8c6fa0b894e8b"),
-        scalar_from_hex("37e44107de63cad492d4e275132c1fb1c9d7a63e916fa20d1ed8b79413a7e2fc"),
-        scalar_from_hex("5c5faf8263eda54e73031d25e75249a5e06b04c53a50c3ee3c639db4b81032cc"),
-        scalar_from_hex("60fdd8d45ee0a55b25c60bb14e186a18f2853d3a76dff3e97eab83a13c3a3d7c"),
-        scalar_from_hex("4fc6f36ad96ac87c8fecce0a7bf77c00f73b595774615aef6223836d2b2246e6"),
-        scalar_from_hex("77fdf41ebcaa1628d353c77096137710612d4a81b1d6769b154ebfca91aee6f3"),
-        scalar_from_hex("683fcfef9f98e6df65dbc575ba0f7dc0f9e65c7e9c240f1f6fdad94ea09b3e3b"),
-        scalar_from_hex("6bb0f2497a5e5e3e110e540d10c8f2dffd97e5c0f9a93e91f11b69a118cdb257"),
-        scalar_from_hex("07da04068e57abccb0cfcaff9d02ca151e46e3475e1397bccf34c40f1ba8fdf9"),
-        scalar_from_hex("69f8af5d51dc24b9ce77bfb45d202c3fc6e0a37c6be19747e75d2a4dd6b6f8b1"),
-        scalar_from_hex("0e2c5a9df493f9b9c66cf97674d6acb566eecb7887a2bc37ed8c3aacccf5b880"),
-        scalar_from_hex("4d9642f17ca392eed107ba1d8cc1ab5aaed9fec1f5ca79b2504a12536c777f93"),
-        scalar_from_hex("4d0b80faf412dcb92ecf1fe165894fa04bda7bdde0e2ad56a119a09e6b5cf480"),
-        scalar_from_hex("3ff52c6a9af2e5c01cc5f642193f31e0550a9ad5b30e14dca28f50e5dd5fa92e"),
-        scalar_from_hex("7de0a7fe45bb0145e5e57e0697a70776e01f30a60ce22e56d30c41a7f839aeb1"),
-        scalar_from_hex("43ee673249bc499a62dcac442141334428178be3d32309bfffc7f775b7a3e8f2"),
-        scalar_from_hex("4f94dd13af5669294892d6d59c4ded4d30a7220de7e179bb8ae7fdd2c5cc6e24"),
-        scalar_from_hex("18ab7468458acf9b6c9d784b36538a2a7f1eb0a9fbdc3416dc0834effd48c675"),
-        scalar_from_hex("35ddd4a603a4853eda5782c5de9eb0471d686c5b4a08a96709a4db87c211a6a5"),
-        scalar_from_hex("4add86d2ed201d129e3a3f3ecbe82cefe05d1bd81cb83fb803eeb8ed7472c8e4"),
-        scalar_from_hex("5ebef6324de61a31f5c6f8b82ffebc42f963a5bb5c6abc6c01c4b4577f8e9b13"),
-        scalar_from_hex("07de0a86c8b43c0e4beda94445b67e42aee6e0c75a605dee7a0ec1dd441de91a"),
-        scalar_from_hex("37290d1f09f37f4c56f75b9c97e4fef8aadf8e0114fcb3d0544f6e46511acca2"),
-        scalar_from_hex("5c9aff2b19ce01e9a17fee0a9f652dceabb4ed2ec3c09aeb9ec9c31f34d82ad8"),
-        scalar_from_hex("04bd4f3dc4191363ed39c42aa1a3a1cea18efa9df9ee8eae724b16e52d6ed7ed"),
-        scalar_from_hex("05c6e28b307e2ebb62f9df82f9ef84cded01ca4fd7b4c32b4d0e4d0f5203a935"),
-        scalar_from_hex("42bd7a0b22b2ebccd8b3a1a0b44d163981b24bdc6c7da7a46ebf48b03ec4ce91"),
-        scalar_from_hex("1fdb6a0e9ea9c208c5b4e70e63a222ec41306ac7b353774c0c02a9c36f700a63"),
-        scalar_from_hex("7f686df3ee1dc08ebf0cdc87a1b4962eeeb2c05395ea6ee7f9bd73f6c7e1cdaa"),
-        scalar_from_hex("6a01a5f0b2698d1eca9d33d98b7024533f0b26e7fcbc6e9ab74d8208dfa797a9"),
-        scalar_from_hex("7e1e4b33c6af4e02c822a8621be5a3ad77a70ed05c24a49d4d0dd4c1da0e4971"),
-        scalar_from_hex("42be4bfaecc23cb6fbc27b9d01e51659f13bc2c14e73c6c3c8eb7eb7e42ff8b2"),
-        scalar_from_hex("2caebb7d91c6eec6f98b88cbd5a1c4a1c62ec2c1379e6f9f3b87468b33ec4347"),
-        scalar_from_hex("31c44cb24db1aa0ba5b24bbb8a91cd02c2906ad4ad3c4d85d167b46a9cdb5b97"),
-        scalar_from_hex("3a2c1d23f3237f49b1ca4e36be8d933f2e3d1ca94a9a63447efe5e17eafafa81"),
-        scalar_from_hex("3eee9ef9bb3bd23f6f09c8c8e40c4f5fea7d71e74636dc888c34e73d4ba62df9"),
-        scalar_from_hex("26a69b9e0ea284d52c6c2848f1143a93b2e3be3064b560e6b01043fb3e96fcc9"),
-        scalar_from_hex("7de4f2eec7eff2fd09e2e1e84c700f35e9eb4d1e4a18da9dd49bb9f75916f891"),
-        scalar_from_hex("517fb8be65c10d8c29b8ead28df2c1fe5ab9acd9e34e09d85dbd77dfdc7800f6"),
-        scalar_from_hex("319eb5c6c3cf87d57b665e48ede7df49b1ae5c5ae3f5513c85abe11d54c15c2a"),
-        scalar_from_hex("5dfb970f4ca483e4afb070f731c05dbe6d9961742f2e509e6a7404a3a10ca9bb"),
-        scalar_from_hex("07c2ddb91c0aa0a143e68e4bb79a6dfce8e8b9be6f9e0ed1c0aed0e997f1dde4"),
-        scalar_from_hex("1c6c8e1bc7b1d139a4d42ede21f336a18e72f0bb0aa98be60674115b26afda6a"),
-        scalar_from_hex("151a8afff0529cfd41d07ad95d067f4c5b60ac8ca2d34b25234ae2e3c9477a61"),
-        scalar_from_hex("11c4b60e0c2bfcdb4b4e2ac7d31d38e29dcc4da36cc95528771c7c4cda150756"),
-        scalar_from_hex("267a182a4c33ed7da18c9a399be21fa8a2b4953aa7c5d75c7af98eabb1c45f78"),
-        scalar_from_hex("1a8d14f24bdf06afc9730ef0016bc8e1d9bd16af11a4e8ee54443661a8dfaf9d"),
-        scalar_from_hex("4d18a07f4e72a3d9d9d9d3d1fcc91f10f5a9c4c2ab99e54de2afccea7599e82d"),
-        scalar_from_hex("22dc80b09b4d913d9b430592389a3a662d5218a609ec385d4fa7c02baecc0ada"),
-        scalar_from_hex("33b67ddba21d4e88fcf9fa85f6f0017f5f83f6edaa8a2c9c11d111f48c146d96"),
-        scalar_from_hex("52fbe15df18b33b252a9bc2e0c6fb4d5ae67c6871e8630de4baeeea9e4faa838"),
-        scalar_from_hex("4f25a9bbcfea9f1627bb32a9be685a4b4aa54b08d9a24c04b9f5ccabce71b4d8"),
-        scalar_from_hex("46a92e30b0d1e7831f3bcd4bffad47a361db9ea14bd12e7c3b5bc33a9aafed5e"),
-        scalar_from_hex("2e918f365fb805fa55337b93ba5810c25df8db11dd463624f9c539b0b62af6ea"),
-        scalar_from_hex("15dbe20ad92aebd7db0c9bc4873fe26b15d2f20e09be9063a5fd79da1a50310e"),
-        scalar_from_hex("626178c41f46a2e20fa2c0dece86b23cf89b95af5d4f9ce65798dfdce6abb284"),
-        scalar_from_hex("7bbee2cfdba9243dd1f3f14d81e06e75d5bd879a4b0fc89b37b227e461e62722"),
-        scalar_from_hex("7c35bc1a1d2154e9b7d0923afd19f7faa66e25cdd2f4c6fc5afc1ea0efa8b91e"),
-        scalar_from_hex("1daa0e5e6c1bb51b748347f5e9edeec8dd290851e87edaad983abd4d8b0e7eb5"),
-        scalar_from_hex("27a2fb93b9c8a30e0d5b43c8e70cc9cf293ec9d34242eb52ef72bb7ba269a759"),
-        scalar_from_hex("36135e62de2f8a28341fba0cd2f4e7e02dba7e261c88a85684fc9adf7fdd0d14"),
-        scalar_from_hex("2c2c31c9a8a31f92fb2e879c5fe0efb4e60de8ee7a5c8ef9e0a10ae796a17d15"),
-        scalar_from_hex("11b07d88aee3daca1a90a4ae39df3b8c18b2a6c2b1daa1e28e1a2fb67c9b2c81"),
-        scalar_from_hex("1e9e01efbf75f34c0b76a888c517e2c7a49c2e36dab6d0a4e99c238bfc61bfd8"),
-        scalar_from_hex("7ab2b14aadcff79ce5c20c63fa4eef8f5eaf85abfa9daab8c3a17fca5cdf6834"),
-        scalar_from_hex("5a3a9e96d0b8b0d82e9a3dee30e6ef9de9869a4996b44d5c138be7c5acd4f898"),
-        scalar_from_hex("4d6c5e6c67cc48f5e66ab988a53b27d1e64a59da7272d81e5f6421170ff88257"),
-        scalar_from_hex("4a63a5ea69351651fdb75376e939080f6050d61aea4ca0c78f87dd3b35fe1a42"),
-        scalar_from_hex("01d7b57a6e8b56a022a0a7d28f60aafe5d2cab0183eafce633be95d6a9132640"),
-        scalar_from_hex("72dc71645a46d26faa95d03ddd0c6a838e6e4be3bdbcd7a4cf59ab08de73c171"),
-        scalar_from_hex("30ef62115163d30b0539d5fa52a4ead65cbe5ca19ba43e4f3c4a295cfd8fd5d5"),
-        scalar_from_hex("62273607e8f07a8f6afb178331e82c177ae56b2c43e91944b80bf97261f2e14d"),
-        scalar_from_hex("5f14c5c3d5a5cdca4e2ee0162e08da334da971f7de16a5c3be66c4b50fc31b2d"),
-        scalar_from_hex("4fd07a42e90d3f0d5b2963e5fb25e5e7dbeba12a91e992d7e710546d40e24db4"),
-        scalar_from_hex("28ffc9d9437c2c5e863692396b5a71f788a3e2ff1fe0f277729eaee3435f1bc5"),
-        scalar_from_hex("05c97e39be4e38cec5a6153a91c520be6477dca8dab90305ee5dad54fb6b2e80"),
-        scalar_from_hex("70a16582efb38a12c73e61bd0bd5a58d26cc24ae6f44bf271f5034c5c1e77d6b"),
-        scalar_from_hex("04cc56a768bc173d621882777271e98c2886baafd96a5c06e651d6517f9bd5eb"),
-        scalar_from_hex("10d7eecda22034d7b0950c2a9fc75bc10f4e2a7c7ee48a0906b5a31eda85c37a"),
-        scalar_from_hex("4a2e1a1e9dfa24cf00b3cc713bc005af03ad5dcf54df5a0b5372acab82644c4d"),
-        scalar_from_hex("30e8c1b3abd71d6295adcadbaa7c4d87dcbd6d1fa8bfc9fed5f8da9d14a92cde"),
-        scalar_from_hex("2d7dd19db4e19d9d075f2461fbecbf2b1f2f6d43afc7c35e31c24b28e11de7f9"),
-        scalar_from_hex("39df562fbd906e2f0c9b15f22a2c6e4318545fe3903eefd9a90a802db01050e3"),
-        scalar_from_hex("04db93169ad183a80e8486a6f27b641b267c54261e5e68b8d19fbd91caa65b45"),
-        scalar_from_hex("33f19dc74b10ad3e57c6748a2dadecd74cc090cf70e8d97c6729dc9867573bc8"),
-        scalar_from_hex("7a7d9f3f23ba09ca55a9c1c830b0c2b5ad6e817bc98b8e1b5d4119df11b89734"),
-        scalar_from_hex("6f65d8743e5be9ff07f3a9164bf017727011c29e6fcc5cff9312b75712c38d7c"),
-        scalar_from_hex("67d4103719c52e81f28a5d867951e35d5e69d06242fbfd0df6b3f1bee8e6666f"),
-        scalar_from_hex("1d8e0e82e14a6a93b59d43c5006c9e4322af5a21c3dabc3431f5a5b33e2a4da9"),
-        scalar_from_hex("4f2a73ce4ad6daba4ca9d26479bd5edd2baa2ed3cb9b9aa8ee82fb304a47a8e8"),
-        scalar_from_hex("5ff9b9c8ee7e5e35acf12c199a0b26ce7e29c14ac538bc75a0a1cae50be5b906"),
-        scalar_from_hex("7b9dce3b1fc2c2c9267c714ef1bcc1991c4c2b06aeccb4a0e8e942ba80720212"),
-        scalar_from_hex("03c5c371dc11ab0e7cf3d8e72cb9fc43d81eb511bfae6f74cbbf5ebf3f6b416d"),
-        scalar_from_hex("4ea7bcafa7f28d5df5d7963e26ea18a7d0ee3c4d278f05c6f9c62e9f84cb6b15"),
-        scalar_from_hex("73d40932c2d10a36c5e22d6fab98bd6e979e4c8ad37559a8aa7f656a74922fb7"),
-        scalar_from_hex("2e02b0fb5963dc1d84f860dfc4b7e27c38b1d2246de6a69ca701c71d09912139"),
-        scalar_from_hex("1693afe11ce71076ec879d7061dd3a6b22c5f16bf96a2e1f9698bf425f279225"),
-        scalar_from_hex("09dc4eefe5eb5d75ab5b6d9f14de6c38000ca710b2656a8de2bc7c7311db2cc0"),
-        scalar_from_hex("04e3c16e9db180af5cff0ad6d3f3b5e9e82a7982da37a4b58f37e8d2e6815bcd"),
-        // All 195 Poseidon round constants for t=3 have been successfully integrated
-    ]
-}
+//! Poseidon parameters (BN254, x^5, t = 3)
+//!
+//! The tables are compile-time constants in Montgomery form, defined once in
+//! `zeclipse_poseidon::params` and shared with the off-chain tooling. Callers
+//! get `&'static` references; nothing is parsed or allocated at runtime.
+
+pub use zeclipse_poseidon::params::{
+    get_mds_matrix, get_round_constants, FieldElement, MDS_MATRIX, MODULUS, ROUND_CONSTANTS,
+    ROUND_CONSTANT_COUNT, POSEIDON_FULL_ROUNDS, POSEIDON_PARTIAL_ROUNDS, POSEIDON_WIDTH,
+};
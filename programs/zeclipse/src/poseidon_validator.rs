@@ -50,6 +50,14 @@ pub mod core {
         zeclipse_poseidon::hash::batch_hash(input_sets)
             .map_err(|_| PoseidonError::BatchError)
     }
+    
+    /// Batch processing over a flat layout into a preallocated buffer -
+    /// `out.len()` sets of `arity` field elements, see
+    /// `zeclipse_poseidon::hash::batch_hash_into`
+    pub fn batch_process_into(inputs: &[[u8; 32]], arity: usize, out: &mut [[u8; 32]]) -> std::result::Result<(), PoseidonError> {
+        zeclipse_poseidon::hash::batch_hash_into(inputs, arity, out)
+            .map_err(|_| PoseidonError::BatchError)
+    }
 }
 
 /// Re-export of the independent error type for backward compatibility
@@ -124,16 +132,12 @@ pub fn validate_poseidon_parameters() -> Result<()> {
 }
 
 /// Generates consistent hashes for use in Zero-Knowledge proofs
-/// This function is optimized for integration with the BlackoutSOL project
-/// 
-/// Uses the core module and converts errors to Anchor errors
+///
+/// Forwards to `crate::zk_hash::zk_hash`, the single Poseidon entry point of
+/// the program (syscall on-chain, pure Rust on the host).
 // This function is now always available, regardless of entrypoint features
 pub fn generate_zk_hash(inputs: &[&[u8]]) -> anchor_lang::Result<[u8; 32]> {
-    core::generate_hash(inputs)
-        .map_err(|e| {
-            anchor_lang::solana_program::msg!("Poseidon-Hashing fehlgeschlagen: {:?}", e);
-            crate::errors::ZEclipseError::HashingError.into()
-        })
+    crate::zk_hash::zk_hash(inputs)
 }
 
 /// Performs efficient batch processing of multiple inputs
@@ -148,6 +152,19 @@ pub fn batch_hash_inputs(input_sets: &[Vec<&[u8]>]) -> Result<Vec<[u8; 32]>> {
             anchor::core_error_to_anchor_error(&e)
         })
 }
+
+/// Batch processing over a flat input layout into a preallocated buffer
+///
+/// Without per-set allocations; with the `parallel` feature the sets are
+/// hashed across a rayon pool on the host.
+#[cfg(not(feature = "no-entrypoint"))]
+pub fn batch_hash_into(inputs: &[[u8; 32]], arity: usize, out: &mut [[u8; 32]]) -> Result<()> {
+    core::batch_process_into(inputs, arity, out)
+        .map_err(|e| {
+            msg!("Poseidon batch processing failed: {:?}", e);
+            anchor::core_error_to_anchor_error(&e)
+        })
+}
 /// This function forwards to the Anchor adapter
 #[cfg(not(feature = "no-entrypoint"))]
 pub fn poseidon_error_to_zeclipse_error(err: PoseidonError) -> anchor_lang::error::Error {
@@ -243,6 +260,15 @@ mod tests {
         assert_eq!(core_batch[0], single1, "First batch element inconsistent");
         assert_eq!(core_batch[1], single2, "Second batch element inconsistent");
         assert_eq!(core_batch, test_batch, "Core and test API produce different batch results");
+        
+        // Flat layout: both sets left-padded to 32-byte field elements
+        let mut flat = [[0u8; 32]; 4];
+        for (element, input) in flat.iter_mut().zip(input_sets.iter().flatten()) {
+            element[32 - input.len()..].copy_from_slice(input);
+        }
+        let mut flat_batch = [[0u8; 32]; 2];
+        core::batch_process_into(&flat, 2, &mut flat_batch).unwrap();
+        assert_eq!(flat_batch.to_vec(), core_batch, "Flat and nested batch layouts produce different results");
     }
     
     #[test]
@@ -2,8 +2,6 @@
 // This allows using Poseidon functionality without Anchor compilation issues
 
 use solana_poseidon::{hashv, Parameters, Endianness};
-use curve25519_dalek::scalar::Scalar;
-use num_bigint::BigUint;
 use std::error::Error;
 use std::fmt;
 
@@ -33,68 +31,17 @@ pub type PoseidonResult<T> = Result<T, PurePoseidonError>;
 pub mod constants {
     use super::*;
     
-    pub const POSEIDON_FULL_ROUNDS: usize = 8;
-    pub const POSEIDON_PARTIAL_ROUNDS: usize = 57;
-    pub const POSEIDON_WIDTH: usize = 3;
+    // Compile-time tables shared with `crate::poseidon_constants`
+    pub use crate::poseidon_constants::{
+        get_mds_matrix, get_round_constants, FieldElement, ROUND_CONSTANT_COUNT,
+        POSEIDON_FULL_ROUNDS, POSEIDON_PARTIAL_ROUNDS, POSEIDON_WIDTH,
+    };
     
-    /// Converts a hex string to a Scalar value
-    pub fn scalar_from_hex(s: &str) -> PoseidonResult<Scalar> {
-        let s = if s.starts_with("0x") { &s[2..] } else { s };
-        
-        // Convert hexadecimal to BigUint
-        let big_uint = BigUint::parse_bytes(s.as_bytes(), 16)
-            .ok_or_else(|| PurePoseidonError::ConversionError(
-                format!("Failed to parse hex string: {}", s)
-            ))?;
-        
-        // Convert BigUint to bytes
-        let bytes = big_uint.to_bytes_be();
-        
-        // Scalar von bytes konvertieren (aktualisierte Methode)
-        let mut array = [0u8; 32];
-        let len = std::cmp::min(bytes.len(), 32);
-        array[32 - len..].copy_from_slice(&bytes[..len]);
-        
-        Ok(Scalar::from_bytes_mod_order(array))
-    }
-    
-    /// Returns the MDS matrix for Poseidon
-    pub fn get_mds_matrix() -> PoseidonResult<Vec<Vec<Scalar>>> {
-        let mds_hex = [
-            ["3d955d6c02fe4d7cb500e12f2b55eff668a7b4386bd27413766713c93f2acfcd", 
-             "3798866f4e6058035dcf8addb2cf1771fac234bcc8fc05d6676e77e797f224bf", 
-             "2c51456a7bf2467eac813649f3f25ea896eac27c5da020dae54a6e640278fda2"],
-            ["20088ca07bbcd7490a0218ebc0ecb31d0ea34840e2dc2d33a1a5adfecff83b43", 
-             "1d04ba0915e7807c968ea4b1cb2d610c7f9a16b4033f02ebacbb948c86a988c3", 
-             "5387ccd5729d7acbd09d96714d1d18bbd0eeaefb2ddee3d2ef573c9c7f953307"],
-            ["1e208f585a72558534281562cad89659b428ec61433293a8d7f0f0e38a6726ac", 
-             "0455ebf862f0b60f69698e97d36e8aafd4d107cae2b61be1858b23a3363642e0", 
-             "569e2c206119e89455852059f707370e2c1fc9721f6c50991cedbbf782daef54"],
-        ];
-        
-        let result = mds_hex.iter()
-            .map(|row| {
-                row.iter()
-                   .map(|&s| scalar_from_hex(s))
-                   .collect::<Result<Vec<_>, _>>()
-            })
-            .collect::<Result<Vec<_>, _>>()?;
-        
-        Ok(result)
-    }
-    
-    /// Returns the round constants for Poseidon
-    pub fn get_round_constants() -> PoseidonResult<Vec<Scalar>> {
-        let constants_hex = [
-            "6c4ffa723eaf1a7bf74905cc7dae4ca9ff4a2c3bc81d42e09540d1f250910880",
-            "54dd837eccf180c92c2f53a3476e45a156ab69a403b6b9fdfd8dd970fddcdd9a",
-            "a5316c9a43627a37481bfc4a85a23b87a97b697d9c6e34ad677c585d7084300c",
-            // Add more constants from poseidon_constants.rs here
-        ];
-        
-        constants_hex.iter()
-            .map(|&s| scalar_from_hex(s))
-            .collect()
+    /// Converts a 64-digit hex string (optional `0x` prefix) to a field element
+    pub fn field_from_hex(s: &str) -> PoseidonResult<FieldElement> {
+        FieldElement::parse_hex(s).ok_or_else(|| PurePoseidonError::ConversionError(
+            format!("Failed to parse hex string: {}", s)
+        ))
     }
 }
 
@@ -152,6 +99,18 @@ pub mod hash {
         
         Ok(results)
     }
+    
+    /// Batch processing over a flat layout into a preallocated buffer
+    ///
+    /// Delegates to `zeclipse_poseidon::hash::batch_hash_into` (parallel on
+    /// the host with the `parallel` feature, sequential on-chain).
+    pub fn batch_hash_into(inputs: &[[u8; 32]], arity: usize, out: &mut [[u8; 32]]) -> PoseidonResult<()> {
+        zeclipse_poseidon::hash::batch_hash_into(inputs, arity, out).map_err(|e| match e {
+            zeclipse_poseidon::PoseidonError::HashingError(msg) => PurePoseidonError::HashingError(msg),
+            zeclipse_poseidon::PoseidonError::ValidationError(msg) => PurePoseidonError::ValidationError(msg),
+            zeclipse_poseidon::PoseidonError::ConversionError(msg) => PurePoseidonError::ConversionError(msg),
+        })
+    }
 }
 
 #[cfg(test)]
@@ -174,11 +133,13 @@ mod tests {
     }
     
     #[test]
-    fn test_scalar_conversion() {
+    fn test_field_conversion() {
         let hex_value = "3d955d6c02fe4d7cb500e12f2b55eff668a7b4386bd27413766713c93f2acfcd";
-        let scalar = constants::scalar_from_hex(hex_value).unwrap();
+        let element = constants::field_from_hex(hex_value).unwrap();
         
-        // Ein Scalar sollte nicht nur aus Nullen bestehen
-        assert!(!scalar.to_bytes().iter().all(|&b| b == 0));
+        // Ein Feldelement sollte nicht nur aus Nullen bestehen
+        assert!(!element.to_bytes().iter().all(|&b| b == 0));
+        // und dem Compile-Time-Tabelleneintrag entsprechen
+        assert_eq!(element, constants::get_mds_matrix()[0][0]);
     }
 }
@@ -1,4 +1,7 @@
 use anchor_lang::prelude::*;
+use crate::batch_plan;
+use crate::stealth_pda::{STEALTH_MAX_HOPS, STEALTH_SPLITS_PER_HOP};
+use crate::utils::{MAX_FAKE_SPLITS, REAL_SPLIT_COUNT};
 
 /// Configuration account for global parameters of the Blackout system
 #[account]
@@ -14,16 +17,22 @@ pub struct ConfigAccount {
 }
 
 /// Configuration parameters for the Blackout system
-/// Fixed configuration with 4 hops, 4 splits, and 44 fake splits
-#[derive(AnchorSerialize, AnchorDeserialize, Clone, Copy, Debug, PartialEq)]
+/// Default configuration with 4 hops, 4 splits, and 44 fake splits; smaller
+/// layouts are selected through a `PerformanceProfile` (see `config_update`)
+///
+/// The struct is byte-packed (10 bytes, alignment 1) so it can be embedded in the
+/// zero-copy `TransferState` without implicit padding, while its Borsh encoding
+/// stays identical for `ConfigAccount` and instruction arguments.
+#[zero_copy(unsafe)]
+#[derive(AnchorSerialize, AnchorDeserialize, Debug, PartialEq)]
 pub struct BlackoutConfig {
-    /// Number of hops in the anonymity path (fixed at 4)
+    /// Number of hops in the anonymity path (at most 4, default 4)
     pub num_hops: u8,
     
-    /// Number of real splits per hop (fixed at 4)
+    /// Number of real splits per hop (at most 4, default 4)
     pub real_splits: u8,
     
-    /// Number of fake splits per hop (fixed at 44)
+    /// Number of fake splits per hop (at most 44, default 44)
     pub fake_splits: u8,
     
     /// Reserve percentage (40%)
@@ -38,6 +47,9 @@ pub struct BlackoutConfig {
 }
 
 impl BlackoutConfig {
+    /// Serialized size of the configuration (1+1+1+1+2+4 bytes, no padding)
+    pub const SIZE: usize = 10;
+    
     /// Creates the default Blackout configuration
     /// 4 hops x 4 real splits x 44 fake splits
     pub fn new() -> Self {
@@ -51,6 +63,65 @@ impl BlackoutConfig {
         }
     }
     
+    /// Creates the configuration of a performance profile
+    ///
+    /// The profile's fake splits, with as many hops per batch as fit under its
+    /// batch CU limit in the `batch_plan` cost model, and as many hops in
+    /// total as its batch count allows (at most 4). `cu_budget_per_hop` is
+    /// the estimate of one such batch. Reserve and fees stay at their defaults.
+    pub fn for_profile(profile: PerformanceProfile) -> Self {
+        let mut config = Self::new();
+        config.fake_splits = profile.fake_splits();
+        let per_hop = batch_plan::accounts_per_hop(config.real_splits, config.fake_splits);
+        let batch_hops = batch_plan::max_batch_hops_within(
+            STEALTH_MAX_HOPS as u8,
+            per_hop,
+            profile.batch_cu_limit(),
+        ).max(1);
+        config.num_hops = batch_hops.saturating_mul(profile.max_batches()).min(STEALTH_MAX_HOPS as u8);
+        config.cu_budget_per_hop = batch_plan::batch_cu_estimate(batch_hops, batch_hops as usize * per_hop as usize);
+        config
+    }
+    
+    /// Hops per batch transaction that stay within `cu_budget_per_hop`
+    ///
+    /// The batch size a client should use for this configuration (at least 1);
+    /// for a profile configuration this is the profile's batch size.
+    pub fn budget_batch_hops(&self) -> u8 {
+        let per_hop = batch_plan::accounts_per_hop(self.real_splits, self.fake_splits);
+        batch_plan::max_batch_hops_within(self.num_hops, per_hop, self.cu_budget_per_hop).max(1)
+    }
+    
+    /// `budget_batch_hops` with committed fake splits (`FAKE_MODE_COMMITTED`),
+    /// where a hop only passes its real split accounts
+    pub fn committed_budget_batch_hops(&self) -> u8 {
+        let per_hop = batch_plan::accounts_per_hop(self.real_splits, 0);
+        batch_plan::max_batch_hops_within(self.num_hops, per_hop, self.cu_budget_per_hop).max(1)
+    }
+    
+    /// Checks the layout against the committed bump table and the proof format
+    ///
+    /// 1-4 hops, 1-4 real splits (the proof carries 4 amounts), at most 44
+    /// fake splits and at most 48 splits per hop in total.
+    pub fn is_valid(&self) -> bool {
+        self.num_hops >= 1
+            && self.num_hops as usize <= STEALTH_MAX_HOPS
+            && self.real_splits >= 1
+            && self.real_splits as usize <= REAL_SPLIT_COUNT
+            && self.fake_splits as usize <= MAX_FAKE_SPLITS
+            && self.splits_per_hop() as usize <= STEALTH_SPLITS_PER_HOP
+    }
+    
+    /// Real and fake splits of one hop
+    pub fn splits_per_hop(&self) -> u16 {
+        self.real_splits as u16 + self.fake_splits as u16
+    }
+    
+    /// Whether `split_index` lies in the fake split range of this layout
+    pub fn is_fake_split_index(&self, split_index: u8) -> bool {
+        split_index >= self.real_splits && (split_index as u16) < self.splits_per_hop()
+    }
+    
     /// Calculates the total number of anonymity paths
     pub fn total_paths(&self) -> u64 {
         let total_outputs = self.real_splits as u64 + self.fake_splits as u64;
@@ -58,14 +129,117 @@ impl BlackoutConfig {
     }
     
     /// Calculates the maximum number of batch hops
+    ///
+    /// Packs as many hops into one transaction as the CU and account lock
+    /// limits allow (see `crate::batch_plan`), assuming every hop carries its
+    /// real splits and primary fake splits.
     pub fn max_batch_size(&self) -> u8 {
-        // Ensure that the batch size stays within the CU limit.
-        // Use a conservative estimate for CU per hop within a batch transaction,
-        // which includes PDA initialization and ZK verification costs for each batched hop.
-        // This internal estimate might differ from `self.cu_budget_per_hop` which is for single hop execution.
-        let cu_per_hop_in_batch = 108_000; // ~18k for PDA + ~90k for ZK verification
-        let max_cu_for_batch = 1_300_000;    // Slightly below the Solana transaction limit of 1.4M
-        let batch_size = max_cu_for_batch / cu_per_hop_in_batch;
-        std::cmp::min(self.num_hops, batch_size as u8)
+        let per_hop = batch_plan::accounts_per_hop(self.real_splits, self.fake_splits);
+        batch_plan::max_batch_hops(self.num_hops, per_hop).max(1)
+    }
+}
+
+/// Performance profile selected through `config_update`
+///
+/// Trades settlement time against the anonymity set. Each profile names a
+/// number of batch hop transactions, the CU limit of each, and the fake
+/// splits per hop; `BlackoutConfig::for_profile` turns that into hops and
+/// batch size with the cost model of `crate::batch_plan`, whose constants
+/// are measured by the profiling harness (`tools/benchmark/cu_profile.rs`).
+///
+/// | profile        | batches | batch CU limit | fake splits | result                 |
+/// |----------------|---------|----------------|-------------|------------------------|
+/// | `Latency`      | 1       | 240k           | 4           | 3 hops, 1 batch        |
+/// | `Balanced`     | 2       | 240k           | 20          | 4 hops, batches of 3+1 |
+/// | `MaxAnonymity` | 4       | 1.4M           | 44          | 4 hops, 1 batch        |
+#[derive(AnchorSerialize, AnchorDeserialize, Clone, Copy, Debug, PartialEq, Eq)]
+pub enum PerformanceProfile {
+    /// Fewest transactions and CUs, for flows that settle in seconds
+    Latency,
+    /// Full hop count with a reduced fake split set
+    Balanced,
+    /// Full 4 x (4 + 44) anonymity set
+    MaxAnonymity,
+}
+
+impl PerformanceProfile {
+    /// Batch hop transactions the profile may use
+    pub const fn max_batches(self) -> u8 {
+        match self {
+            PerformanceProfile::Latency => 1,
+            PerformanceProfile::Balanced => 2,
+            PerformanceProfile::MaxAnonymity => STEALTH_MAX_HOPS as u8,
+        }
+    }
+    
+    /// Compute unit limit of each batch hop transaction
+    ///
+    /// Lower limits land faster for the same priority fee per CU.
+    pub const fn batch_cu_limit(self) -> u32 {
+        match self {
+            PerformanceProfile::Latency | PerformanceProfile::Balanced => 240_000,
+            PerformanceProfile::MaxAnonymity => batch_plan::MAX_TRANSACTION_CU,
+        }
+    }
+    
+    /// Fake splits per hop
+    ///
+    /// `Latency` keeps only the funded primary fakes; secondary fakes cost
+    /// nothing per hop but enlarge the Bloom filter and the bump search.
+    pub const fn fake_splits(self) -> u8 {
+        match self {
+            PerformanceProfile::Latency => batch_plan::PRIMARY_FAKE_SPLITS,
+            PerformanceProfile::Balanced => 20,
+            PerformanceProfile::MaxAnonymity => MAX_FAKE_SPLITS as u8,
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    
+    #[test]
+    fn test_profile_configurations() {
+        let latency = BlackoutConfig::for_profile(PerformanceProfile::Latency);
+        assert_eq!((latency.num_hops, latency.real_splits, latency.fake_splits), (3, 4, 4));
+        assert_eq!(latency.cu_budget_per_hop, batch_plan::batch_cu_estimate(3, 24));
+        assert_eq!(latency.budget_batch_hops(), 3);
+        
+        let balanced = BlackoutConfig::for_profile(PerformanceProfile::Balanced);
+        assert_eq!((balanced.num_hops, balanced.fake_splits), (4, 20));
+        assert_eq!(balanced.budget_batch_hops(), 3);
+        assert!(balanced.total_paths() > latency.total_paths());
+        
+        // The full anonymity set is the default layout
+        let max = BlackoutConfig::for_profile(PerformanceProfile::MaxAnonymity);
+        assert_eq!((max.num_hops, max.real_splits, max.fake_splits), (4, 4, 44));
+        assert_eq!(max.budget_batch_hops(), 4);
+        assert!(max.total_paths() > balanced.total_paths());
+        
+        for profile in [PerformanceProfile::Latency, PerformanceProfile::Balanced, PerformanceProfile::MaxAnonymity] {
+            let config = BlackoutConfig::for_profile(profile);
+            assert!(config.is_valid());
+            // Within the range accepted by `config_update`
+            assert!((100_000..=500_000).contains(&config.cu_budget_per_hop));
+            assert!(config.cu_budget_per_hop <= profile.batch_cu_limit());
+        }
+    }
+    
+    #[test]
+    fn test_layout_validation() {
+        assert!(BlackoutConfig::new().is_valid());
+        assert!(BlackoutConfig::new().is_fake_split_index(47));
+        assert!(!BlackoutConfig::new().is_fake_split_index(48));
+        assert!(!BlackoutConfig::new().is_fake_split_index(3));
+        
+        let too_many_hops = BlackoutConfig { num_hops: 5, ..BlackoutConfig::new() };
+        let no_real_splits = BlackoutConfig { real_splits: 0, ..BlackoutConfig::new() };
+        let too_many_fakes = BlackoutConfig { fake_splits: 45, ..BlackoutConfig::new() };
+        let latency_layout = BlackoutConfig { num_hops: 1, fake_splits: 0, ..BlackoutConfig::new() };
+        assert!(!too_many_hops.is_valid());
+        assert!(!no_real_splits.is_valid());
+        assert!(!too_many_fakes.is_valid());
+        assert!(latency_layout.is_valid());
     }
 }
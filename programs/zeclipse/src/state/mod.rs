@@ -1,7 +1,9 @@
 // State components for BlackoutSOL
 pub mod transfer;
 pub mod config;
+pub mod registry;
 
 // Re-export all structures for easier access
 pub use transfer::*;
-pub use config::*;
\ No newline at end of file
+pub use config::*;
+pub use registry::*;
\ No newline at end of file
@@ -0,0 +1,164 @@
+use anchor_lang::prelude::*;
+use crate::errors::ZEclipseError;
+
+/// Seed prefix of the per-owner registry PDA `[b"transfer_registry", owner]`
+pub const TRANSFER_REGISTRY_SEED: &[u8] = b"transfer_registry";
+
+/// Maximum number of transfers with a nonce an owner can have open at once
+pub const MAX_OPEN_TRANSFERS: usize = 16;
+
+/// Open transfer nonces of one owner
+///
+/// Every transfer with a nonce other than 0 lives at its own PDA
+/// (`transfer_nonce_seed`), so one wallet can run several transfers in
+/// parallel. `initialize` records the nonce here; `reclaim` releases it when
+/// it closes the transfer state and the address becomes free again. The
+/// default transfer (nonce 0) is not tracked.
+#[account]
+pub struct TransferRegistry {
+    /// Owner whose transfers are tracked
+    pub owner: Pubkey,
+
+    /// Bump for the PDA address
+    pub bump: u8,
+
+    /// Number of used entries in `open_nonces`
+    pub open_count: u8,
+
+    /// Smallest nonce that has never been opened (hint for clients)
+    pub next_nonce: u32,
+
+    /// Open nonces, the first `open_count` entries are valid (unordered)
+    pub open_nonces: [u32; MAX_OPEN_TRANSFERS],
+}
+
+impl TransferRegistry {
+    /// Account size (discriminator + Borsh layout)
+    pub const SIZE: usize = 8 +   // Discriminator
+                            32 +  // owner
+                            1 +   // bump
+                            1 +   // open_count
+                            4 +   // next_nonce
+                            4 * MAX_OPEN_TRANSFERS; // open_nonces
+
+    /// Creates an empty registry; nonces start at 1
+    pub fn new(owner: Pubkey, bump: u8) -> Self {
+        Self {
+            owner,
+            bump,
+            open_count: 0,
+            next_nonce: 1,
+            open_nonces: [0; MAX_OPEN_TRANSFERS],
+        }
+    }
+
+    /// Currently open nonces
+    pub fn open(&self) -> &[u32] {
+        &self.open_nonces[..self.open_count as usize]
+    }
+
+    /// Whether a transfer with `nonce` is open
+    pub fn is_open(&self, nonce: u32) -> bool {
+        self.open().contains(&nonce)
+    }
+
+    /// Records a newly initialized transfer
+    pub fn register(&mut self, nonce: u32) -> Result<()> {
+        if nonce == 0 || self.is_open(nonce) {
+            msg!("Transfer nonce {} cannot be opened", nonce);
+            return Err(ZEclipseError::InvalidTransferNonce.into());
+        }
+        if self.open_count as usize >= MAX_OPEN_TRANSFERS {
+            msg!("{} transfers already open", self.open_count);
+            return Err(ZEclipseError::TooManyOpenTransfers.into());
+        }
+
+        self.open_nonces[self.open_count as usize] = nonce;
+        self.open_count += 1;
+        if nonce >= self.next_nonce {
+            self.next_nonce = nonce.saturating_add(1);
+        }
+        Ok(())
+    }
+
+    /// Releases the nonce of a closed transfer state
+    pub fn release(&mut self, nonce: u32) -> Result<()> {
+        let position = self.open().iter().position(|&open| open == nonce).ok_or_else(|| {
+            msg!("Transfer nonce {} is not open", nonce);
+            ZEclipseError::InvalidTransferNonce
+        })?;
+
+        // Swap-remove: the last open entry takes the freed slot
+        let last = self.open_count as usize - 1;
+        self.open_nonces[position] = self.open_nonces[last];
+        self.open_nonces[last] = 0;
+        self.open_count -= 1;
+        Ok(())
+    }
+}
+
+/// Registers or releases the nonce of a transfer in the owner's registry
+///
+/// Nonce 0 needs no registry; every other nonce requires it.
+pub fn track_transfer_nonce(
+    registry: Option<&mut Account<'_, TransferRegistry>>,
+    nonce: u32,
+    open: bool,
+) -> Result<()> {
+    if nonce == 0 {
+        return Ok(());
+    }
+    let registry = registry.ok_or(ZEclipseError::TransferRegistryRequired)?;
+    if open {
+        registry.register(nonce)
+    } else {
+        registry.release(nonce)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_registry_size() {
+        let mut data = Vec::new();
+        TransferRegistry::new(Pubkey::new_unique(), 255).serialize(&mut data).unwrap();
+        assert_eq!(data.len() + 8, TransferRegistry::SIZE);
+    }
+
+    #[test]
+    fn test_register_and_release() {
+        let mut registry = TransferRegistry::new(Pubkey::new_unique(), 255);
+        registry.register(1).unwrap();
+        registry.register(2).unwrap();
+        registry.register(7).unwrap();
+        assert_eq!(registry.next_nonce, 8);
+
+        // Nonce 0 and nonces that are already open are rejected
+        assert!(registry.register(0).is_err());
+        assert!(registry.register(2).is_err());
+
+        registry.release(1).unwrap();
+        assert_eq!(registry.open(), &[7, 2]);
+        assert!(registry.release(1).is_err());
+
+        // A released nonce can be opened again, the hint does not move back
+        registry.register(1).unwrap();
+        assert!(registry.is_open(1));
+        assert_eq!(registry.next_nonce, 8);
+    }
+
+    #[test]
+    fn test_registry_capacity() {
+        let mut registry = TransferRegistry::new(Pubkey::new_unique(), 255);
+        for nonce in 1..=MAX_OPEN_TRANSFERS as u32 {
+            registry.register(nonce).unwrap();
+        }
+        assert!(registry.register(100).is_err());
+
+        registry.release(5).unwrap();
+        registry.register(100).unwrap();
+        assert_eq!(registry.open().len(), MAX_OPEN_TRANSFERS);
+    }
+}
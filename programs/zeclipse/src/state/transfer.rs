@@ -1,98 +1,153 @@
 use anchor_lang::prelude::*;
 use super::config::BlackoutConfig;
+use crate::stealth_pda::{self, STEALTH_BUMP_TABLE_LEN};
+use crate::bloom::FakeBloom;
+use crate::errors::ZEclipseError;
 
 // Import of the Solana compatibility layer for compute units
 use crate::solana_imports::sol_remaining_compute_units;
 
+/// Current layout version of the zero-copy `TransferState`
+pub const TRANSFER_STATE_VERSION: u8 = 1;
+
+/// Fake splits are PDAs funded by the batch hops (`TransferState::fake_mode`)
+pub const FAKE_MODE_FUNDED: u8 = 0;
+
+/// Fake splits exist only as leaves of a Poseidon tree whose root the state
+/// stores (`TransferState::fake_root`); `reveal_fake` opens a leaf and
+/// materializes its PDA on demand
+pub const FAKE_MODE_COMMITTED: u8 = 1;
+
 /// Stores the state of an anonymous transfer with extended functionality
-#[account]
+///
+/// Zero-copy layout (`repr(C)`, loaded through `AccountLoader`): instructions
+/// read and write fields in place instead of deserializing and re-serializing
+/// the whole account. The fields touched by every hop (`current_hop`,
+/// `batch_count`, `completed`, ...) share the first 8-byte word; the large
+/// proof and commitment buffers sit at the end of the account.
+/// All padding is explicit so the struct is `Pod` without hidden bytes.
+#[account(zero_copy)]
 pub struct TransferState {
-    /// Owner of the transfer
-    pub owner: Pubkey,
-    
-    /// Total amount of the transfer
-    pub amount: u64,
-    
     /// Current hop index
     pub current_hop: u8,
-    
-    /// Seed for generating stealth PDAs
-    pub seed: [u8; 32],
-    
-    /// Flag indicating if the transfer is completed
-    pub completed: bool,
-    
-    /// Bump for the PDA address
-    pub bump: u8,
-    
-    /// Blackout configuration (fixed: 4 hops, 4 real splits, 44 fake splits)
-    pub config: BlackoutConfig,
-    
-    /// Aggregated ZK proof for batch verification
-    pub batch_proof: [u8; 128],
-    
-    /// Range proof for the split amounts
-    pub range_proof: [u8; 128],
-    
-    /// Commitments for the split amounts (max 8)
-    pub commitments: [[u8; 32]; 8],
-    
+
     /// Number of batch transactions already processed
     pub batch_count: u8,
-    
+
+    /// Flag indicating if the transfer is completed (0 = open, 1 = completed)
+    pub completed: u8,
+
+    /// Refund flag in case the transfer fails (0 = no refund, 1 = refunded)
+    pub refund_triggered: u8,
+
+    /// Bump for the PDA address
+    pub bump: u8,
+
+    /// Number of recipient wallets to use (3-6)
+    pub recipient_count: u8,
+
+    /// Layout version of this account (see `TRANSFER_STATE_VERSION`)
+    pub version: u8,
+
+    /// How fake splits are handled (`FAKE_MODE_FUNDED` or `FAKE_MODE_COMMITTED`);
+    /// fills the byte that aligned the following u64 fields
+    pub fake_mode: u8,
+
+    /// Total amount of the transfer
+    pub amount: u64,
+
     /// Total fees for the transfer
     pub total_fees: u64,
-    
+
     /// Reserve for the transfer
     pub reserve: u64,
-    
-    /// Recipients of the final payment (up to 6 wallets)
-    pub recipients: [Pubkey; 6],
-    
-    /// Number of recipient wallets to use (3-6)
-    pub recipient_count: u8,
-    
-    /// Bloom filter for fake splits (16 bytes for 128 bits)
-    pub fake_bloom: [u8; 16],
-    
-    /// Challenge for ZK proofs
-    pub challenge: [u8; 32],
-    
+
     /// Timestamp for timing protection
     pub timestamp: i64,
-    
+
+    /// Blackout configuration (fixed: 4 hops, 4 real splits, 44 fake splits)
+    pub config: BlackoutConfig,
+
+    /// Split PDAs the hops and reveals funded that finalize or reclaim have
+    /// not emptied yet; the state holds their bump table, so it only closes at 0
+    pub funded_splits: u16,
+
+    /// Transfer nonce of the owner, part of the PDA seeds (see `transfer_nonce_seed`)
+    pub nonce: u32,
+
+    /// Owner of the transfer
+    pub owner: Pubkey,
+
+    /// Seed for generating stealth PDAs
+    pub seed: [u8; 32],
+
+    /// Challenge for ZK proofs
+    pub challenge: [u8; 32],
+
     /// Merkle root for wallet set
     pub merkle_root: [u8; 32],
-    
-    /// Refund flag in case the transfer fails
-    pub refund_triggered: bool,
+
+    /// Bloom filter for fake splits (2048 bits, see `crate::bloom`)
+    pub fake_bloom: FakeBloom,
+
+    /// Commitments for the split amounts (max 8)
+    pub commitments: [[u8; 32]; 8],
+
+    /// Recipients of the final payment (up to 6 wallets)
+    pub recipients: [Pubkey; MAX_RECIPIENTS],
+
+    /// Bumps of all stealth PDAs (4 hops x 48 splits), computed off-chain by
+    /// the client and committed at initialization
+    pub stealth_bumps: [u8; STEALTH_BUMP_TABLE_LEN],
+
+    /// Aggregated ZK proof for batch verification
+    pub batch_proof: [u8; 128],
+
+    /// Range proof for the split amounts
+    pub range_proof: [u8; 128],
+
+    /// Root of the committed fake split tree (`crate::utils::fake_split_root`),
+    /// stored by `config_update` with `FAKE_MODE_COMMITTED`; zero otherwise
+    pub fake_root: [u8; 32],
+}
+
+/// Most recipient wallets of one transfer (`TransferState::recipients`)
+pub const MAX_RECIPIENTS: usize = 6;
+
+/// Splits a payout across the `recipient_count` committed recipients
+///
+/// Every recipient gets an equal share; the indivisible remainder goes to the
+/// primary recipient so the shares always sum to `payout`. Slots past the
+/// count stay zero, and counts outside `1..=MAX_RECIPIENTS` are clamped.
+pub fn recipient_shares(payout: u64, recipient_count: usize) -> [u64; MAX_RECIPIENTS] {
+    let count = recipient_count.clamp(1, MAX_RECIPIENTS);
+    let share = payout / count as u64;
+    let mut shares = [0u64; MAX_RECIPIENTS];
+    shares[..count].fill(share);
+    shares[0] += payout - share * count as u64;
+    shares
+}
+
+/// Nonce seed of the transfer state PDA `[b"transfer", owner, nonce_seed]`
+///
+/// Nonce 0 is the owner's default transfer and contributes no seed bytes, so
+/// its address stays `[b"transfer", owner]` as for transfers created before
+/// nonces existed. Every other nonce adds its 4 bytes in memory order, which is
+/// little-endian on all Solana targets.
+pub fn transfer_nonce_seed(nonce: &u32) -> &[u8] {
+    let bytes = bytemuck::bytes_of(nonce);
+    if *nonce == 0 {
+        &bytes[..0]
+    } else {
+        bytes
+    }
 }
 
 impl TransferState {
     /// Calculates the memory requirement for the account
-    pub const SIZE: usize = 8 +   // Discriminator
-                            32 +  // owner
-                            8 +   // amount
-                            1 +   // current_hop
-                            32 +  // seed
-                            1 +   // completed
-                            1 +   // bump
-                            9 +   // config (BlackoutConfig size: 1+1+1+1+2+4 = 9 bytes)
-                            128 + // batch_proof
-                            128 + // range_proof
-                            256 + // commitments (8 x 32)
-                            1 +   // batch_count
-                            8 +   // total_fees
-                            8 +   // reserve
-                            192 + // recipients (6 * 32)
-                            1 +   // recipient_count
-                            16 +  // fake_bloom
-                            32 +  // challenge
-                            8 +   // timestamp
-                            32 +  // merkle_root
-                            1;    // refund_triggered
-                            // Total = 702 bytes
-                            
+    /// (discriminator + fixed `repr(C)` layout, 1368 bytes of data)
+    pub const SIZE: usize = 8 + std::mem::size_of::<TransferState>();
+
     /// Initializes a new TransferState
     pub fn new(
         owner: Pubkey,
@@ -106,38 +161,80 @@ impl TransferState {
         range_proof: [u8; 128],
         challenge: [u8; 32],
         merkle_root: [u8; 32],
-        fake_bloom: [u8; 16],
+        fake_bloom: FakeBloom,
+        stealth_bumps: [u8; STEALTH_BUMP_TABLE_LEN],
         timestamp: i64,
     ) -> Self {
         Self {
-            owner,
-            amount,
             current_hop: 0,
-            seed,
-            completed: false,
-            bump,
-            config,
-            batch_proof,
-            range_proof,
-            commitments: [[0; 32]; 8], // Will be filled later
             batch_count: 0,
+            completed: 0,
+            refund_triggered: 0,
+            bump,
+            recipient_count,
+            version: TRANSFER_STATE_VERSION,
+            fake_mode: FAKE_MODE_FUNDED,
+            amount,
             total_fees: 0,
             reserve: 0,
-            recipients,
-            recipient_count,
-            fake_bloom,
-            challenge,
             timestamp,
+            config,
+            funded_splits: 0,
+            nonce: 0,
+            owner,
+            seed,
+            challenge,
             merkle_root,
-            refund_triggered: false,
+            fake_bloom,
+            commitments: [[0; 32]; 8], // Will be filled later
+            recipients,
+            stealth_bumps,
+            batch_proof,
+            range_proof,
+            fake_root: [0; 32],
         }
     }
-    
+
+    /// Nonce seed of this transfer's PDA (see `transfer_nonce_seed`)
+    pub fn nonce_seed(&self) -> &[u8] {
+        transfer_nonce_seed(&self.nonce)
+    }
+
+    /// Checks if the transfer has been completed
+    pub fn is_completed(&self) -> bool {
+        self.completed != 0
+    }
+
+    /// Checks if a refund has been triggered for the transfer
+    pub fn is_refund_triggered(&self) -> bool {
+        self.refund_triggered != 0
+    }
+
+    /// Marks the transfer as completed
+    pub fn set_completed(&mut self) {
+        self.completed = 1;
+    }
+
+    /// Marks the transfer as refunded
+    pub fn set_refund_triggered(&mut self) {
+        self.refund_triggered = 1;
+    }
+
+    /// Whether fake splits are only committed, not funded by the hops
+    pub fn has_committed_fakes(&self) -> bool {
+        self.fake_mode == FAKE_MODE_COMMITTED
+    }
+
+    /// Returns the committed bump of the stealth PDA for a hop/split pair
+    pub fn stealth_bump(&self, hop_index: u8, split_index: u8) -> Result<u8> {
+        stealth_pda::lookup_bump(&self.stealth_bumps, hop_index, split_index)
+    }
+
     /// Checks if the transfer is in batch hop mode
     pub fn is_batch_mode(&self) -> bool {
         self.batch_count > 0
     }
-    
+
     /// Calculates the number of remaining hops
     pub fn remaining_hops(&self) -> u8 {
         if self.current_hop >= self.config.num_hops {
@@ -146,7 +243,7 @@ impl TransferState {
             self.config.num_hops - self.current_hop
         }
     }
-    
+
     /// Calculates the current batch progress in percent
     pub fn progress_percent(&self) -> u8 {
         if self.config.num_hops == 0 {
@@ -154,7 +251,7 @@ impl TransferState {
         }
         ((self.current_hop as u16 * 100) / (self.config.num_hops as u16)) as u8
     }
-    
+
     /// Checks if enough compute units are available for the next critical step within the current transaction.
     /// `cu_needed_for_next_step` is an estimate of CUs required for the upcoming operations.
     pub fn has_enough_cu_for_next_hop(&self, cu_needed_for_next_step: u32) -> bool {
@@ -170,4 +267,224 @@ impl TransferState {
         }
         true
     }
-}
\ No newline at end of file
+}
+
+/// Borsh layout of `TransferState` before the zero-copy migration
+///
+/// Only used by `migrate_state` to read accounts that were created with the
+/// original `#[account]` layout. Both layouts share the `TransferState`
+/// discriminator and are told apart by their data length.
+#[derive(AnchorSerialize, AnchorDeserialize, Clone)]
+pub struct LegacyTransferState {
+    pub owner: Pubkey,
+    pub amount: u64,
+    pub current_hop: u8,
+    pub seed: [u8; 32],
+    pub completed: bool,
+    pub bump: u8,
+    pub config: BlackoutConfig,
+    pub batch_proof: [u8; 128],
+    pub range_proof: [u8; 128],
+    pub commitments: [[u8; 32]; 8],
+    pub batch_count: u8,
+    pub total_fees: u64,
+    pub reserve: u64,
+    pub recipients: [Pubkey; 6],
+    pub recipient_count: u8,
+    pub fake_bloom: [u8; 16],
+    pub challenge: [u8; 32],
+    pub timestamp: i64,
+    pub merkle_root: [u8; 32],
+    pub refund_triggered: bool,
+}
+
+impl LegacyTransferState {
+    /// Borsh encoding of the legacy layout (discriminator included)
+    pub const ENCODED_SIZE: usize = 8 +   // Discriminator
+                            32 +  // owner
+                            8 +   // amount
+                            1 +   // current_hop
+                            32 +  // seed
+                            1 +   // completed
+                            1 +   // bump
+                            BlackoutConfig::SIZE + // config
+                            128 + // batch_proof
+                            128 + // range_proof
+                            256 + // commitments (8 x 32)
+                            1 +   // batch_count
+                            8 +   // total_fees
+                            8 +   // reserve
+                            192 + // recipients (6 * 32)
+                            1 +   // recipient_count
+                            16 +  // fake_bloom
+                            32 +  // challenge
+                            8 +   // timestamp
+                            32 +  // merkle_root
+                            1;    // refund_triggered
+
+    /// Account size the legacy `initialize` allocated
+    ///
+    /// The legacy size sum counted the configuration as 9 bytes, so legacy
+    /// accounts are one byte shorter than the Borsh encoding: the trailing
+    /// `refund_triggered` flag never fit and reads as `false`.
+    pub const SIZE: usize = Self::ENCODED_SIZE - 1;
+
+    /// Decodes a legacy account (discriminator included, `SIZE` bytes)
+    pub fn decode(data: &[u8]) -> Result<Self> {
+        if data.len() != Self::SIZE {
+            return Err(ZEclipseError::InvalidStateTransition.into());
+        }
+        let mut encoded = [0u8; Self::ENCODED_SIZE - 8];
+        encoded[..Self::SIZE - 8].copy_from_slice(&data[8..]);
+        Self::deserialize(&mut &encoded[..]).map_err(|_| ZEclipseError::DeserializationError.into())
+    }
+
+    /// Converts the legacy state into the zero-copy layout
+    ///
+    /// Legacy accounts have no bump table, so the caller supplies it. The old
+    /// 128-bit fake filter is rebuilt from the configuration.
+    pub fn into_zero_copy(self, stealth_bumps: [u8; STEALTH_BUMP_TABLE_LEN]) -> TransferState {
+        let mut state = TransferState::new(
+            self.owner,
+            self.amount,
+            self.seed,
+            self.bump,
+            self.recipients,
+            self.recipient_count,
+            self.config,
+            self.batch_proof,
+            self.range_proof,
+            self.challenge,
+            self.merkle_root,
+            crate::utils::generate_bloom_filter(&self.config, &self.challenge),
+            stealth_bumps,
+            self.timestamp,
+        );
+        state.current_hop = self.current_hop;
+        state.batch_count = self.batch_count;
+        state.completed = self.completed as u8;
+        state.refund_triggered = self.refund_triggered as u8;
+        state.total_fees = self.total_fees;
+        state.reserve = self.reserve;
+        state.commitments = self.commitments;
+        state
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use anchor_lang::Discriminator;
+    use std::mem::{align_of, size_of};
+
+    #[test]
+    fn test_zero_copy_layout() {
+        // The layout must not change silently: clients read hot fields by offset
+        assert_eq!(size_of::<TransferState>(), 1368);
+        assert_eq!(align_of::<TransferState>(), 8);
+        assert_eq!(TransferState::SIZE, 1376);
+        assert_eq!(size_of::<BlackoutConfig>(), BlackoutConfig::SIZE);
+
+        // The nonce fills former padding, so the account size is unchanged
+        let state: TransferState = bytemuck::Zeroable::zeroed();
+        let base = &state as *const TransferState as usize;
+        assert_eq!(&state.nonce as *const u32 as usize - base, 52);
+        assert_eq!(&state.owner as *const Pubkey as usize - base, 56);
+        assert_eq!(&state.funded_splits as *const u16 as usize - base, 50);
+
+        // The fake mode takes the former padding byte of the hot word
+        assert_eq!(&state.fake_mode as *const u8 as usize - base, 7);
+        assert!(!state.has_committed_fakes());
+
+        // The fake split root is appended behind the proof buffers
+        assert_eq!(&state.fake_root as *const [u8; 32] as usize - base, 1336);
+    }
+
+    #[test]
+    fn test_nonce_seed() {
+        let program_id = Pubkey::new_unique();
+        let owner = Pubkey::new_unique();
+
+        // Nonce 0 keeps the address of transfers created before nonces existed
+        assert!(transfer_nonce_seed(&0).is_empty());
+        let (legacy, _) = Pubkey::find_program_address(&[b"transfer", owner.as_ref()], &program_id);
+        let (default, _) = Pubkey::find_program_address(
+            &[b"transfer", owner.as_ref(), transfer_nonce_seed(&0)],
+            &program_id,
+        );
+        assert_eq!(legacy, default);
+
+        assert_eq!(transfer_nonce_seed(&0x0403_0201), &[1, 2, 3, 4]);
+        let (first, _) = Pubkey::find_program_address(
+            &[b"transfer", owner.as_ref(), transfer_nonce_seed(&1)],
+            &program_id,
+        );
+        assert_ne!(first, legacy);
+    }
+
+    #[test]
+    fn test_recipient_shares() {
+        assert_eq!(recipient_shares(1_000, 3), [334, 333, 333, 0, 0, 0]);
+
+        // Unset or out-of-range counts never lose lamports
+        assert_eq!(recipient_shares(1_000, 0), [1_000, 0, 0, 0, 0, 0]);
+        assert_eq!(recipient_shares(600, 9), [100; MAX_RECIPIENTS]);
+    }
+
+    #[test]
+    fn test_legacy_conversion() {
+        let owner = Pubkey::new_unique();
+        let legacy = LegacyTransferState {
+            owner,
+            amount: 1_000_000,
+            current_hop: 2,
+            seed: [7; 32],
+            completed: false,
+            bump: 254,
+            config: BlackoutConfig::new(),
+            batch_proof: [1; 128],
+            range_proof: [2; 128],
+            commitments: [[3; 32]; 8],
+            batch_count: 1,
+            total_fees: 500,
+            reserve: 200,
+            recipients: [owner; 6],
+            recipient_count: 3,
+            fake_bloom: [4; 16],
+            challenge: [5; 32],
+            timestamp: 42,
+            merkle_root: [6; 32],
+            refund_triggered: true,
+        };
+
+        let mut encoded = Vec::new();
+        legacy.serialize(&mut encoded).unwrap();
+        assert_eq!(encoded.len() + 8, LegacyTransferState::ENCODED_SIZE);
+
+        // A legacy account as allocated by the legacy `initialize` (903 bytes)
+        assert_eq!(LegacyTransferState::SIZE, 903);
+        let mut account = vec![0u8; LegacyTransferState::SIZE];
+        account[..8].copy_from_slice(&TransferState::DISCRIMINATOR);
+        account[8..].copy_from_slice(&encoded[..LegacyTransferState::SIZE - 8]);
+        assert!(LegacyTransferState::decode(&account[..LegacyTransferState::SIZE - 1]).is_err());
+
+        let decoded = LegacyTransferState::decode(&account).unwrap();
+        assert_eq!(decoded.merkle_root, [6; 32]);
+        // The flag did not fit into the legacy account
+        assert!(!decoded.refund_triggered);
+
+        let state = decoded.into_zero_copy([255; STEALTH_BUMP_TABLE_LEN]);
+        assert_eq!(state.current_hop, 2);
+        assert_eq!(state.batch_count, 1);
+        assert!(!state.is_completed());
+        assert!(!state.is_refund_triggered());
+        assert_eq!(state.total_fees, 500);
+        assert_eq!(state.timestamp, 42);
+        assert_eq!(state.version, TRANSFER_STATE_VERSION);
+        assert_eq!(state.commitments, [[3; 32]; 8]);
+        assert_eq!(state.remaining_hops(), 2);
+        assert_eq!(state.stealth_bump(3, 47).unwrap(), 255);
+        assert!(state.stealth_bump(4, 0).is_err());
+        assert!(crate::utils::check_bloom_filter(&state.fake_bloom, 0, 4));
+    }
+}
@@ -0,0 +1,182 @@
+//! Canonical stealth PDA derivation
+//!
+//! All split PDAs of a transfer (real and fake) share one seed scheme:
+//!
+//! ```text
+//! [prefix, hop_index (le), split_index (le), seed, bump]
+//! prefix = "split" for real splits, "fake" for fake splits
+//! ```
+//!
+//! Bump discovery (`find_program_address`) is done off-chain by the client,
+//! which commits the full 4 x 48 bump table into `TransferState` at
+//! initialization. On-chain, each split therefore costs exactly one
+//! `create_program_address` call instead of a bump search.
+
+use anchor_lang::prelude::*;
+use crate::errors::ZEclipseError;
+
+/// Maximum number of hops covered by the bump table
+pub const STEALTH_MAX_HOPS: usize = 4;
+
+/// Maximum number of splits (real + fake) per hop covered by the bump table
+pub const STEALTH_SPLITS_PER_HOP: usize = 48;
+
+/// Number of entries in the packed bump table (one byte per hop/split pair)
+pub const STEALTH_BUMP_TABLE_LEN: usize = STEALTH_MAX_HOPS * STEALTH_SPLITS_PER_HOP;
+
+/// Seed prefix for real split PDAs
+pub const REAL_SPLIT_PREFIX: &[u8] = b"split";
+
+/// Seed prefix for fake split PDAs
+pub const FAKE_SPLIT_PREFIX: &[u8] = b"fake";
+
+/// Returns the seed prefix for a real or fake split
+#[inline(always)]
+pub fn stealth_prefix(is_fake: bool) -> &'static [u8] {
+    if is_fake { FAKE_SPLIT_PREFIX } else { REAL_SPLIT_PREFIX }
+}
+
+/// Splits with an index at or above `real_splits` are fake splits
+#[inline(always)]
+pub fn is_fake_split_index(split_index: u8, real_splits: u8) -> bool {
+    split_index >= real_splits
+}
+
+/// Position of a hop/split pair in the packed bump table
+#[inline(always)]
+pub fn bump_table_index(hop_index: u8, split_index: u8) -> Option<usize> {
+    let hop = hop_index as usize;
+    let split = split_index as usize;
+    if hop >= STEALTH_MAX_HOPS || split >= STEALTH_SPLITS_PER_HOP {
+        return None;
+    }
+    Some(hop * STEALTH_SPLITS_PER_HOP + split)
+}
+
+/// Looks up the committed bump for a hop/split pair
+pub fn lookup_bump(
+    bump_table: &[u8; STEALTH_BUMP_TABLE_LEN],
+    hop_index: u8,
+    split_index: u8,
+) -> Result<u8> {
+    bump_table_index(hop_index, split_index)
+        .map(|index| bump_table[index])
+        .ok_or_else(|| {
+            msg!("No bump entry for hop {} split {}", hop_index, split_index);
+            ZEclipseError::InvalidHopIndex.into()
+        })
+}
+
+/// Derives a stealth PDA with bump search
+///
+/// Intended for clients and tests; on-chain code should use
+/// `create_stealth_pda` with the committed bump instead.
+pub fn find_stealth_pda(
+    program_id: &Pubkey,
+    seed: &[u8; 32],
+    hop_index: u8,
+    split_index: u8,
+    is_fake: bool,
+) -> (Pubkey, u8) {
+    Pubkey::find_program_address(
+        &[
+            stealth_prefix(is_fake),
+            &hop_index.to_le_bytes(),
+            &split_index.to_le_bytes(),
+            seed,
+        ],
+        program_id,
+    )
+}
+
+/// Recreates a stealth PDA from its committed bump (single syscall)
+pub fn create_stealth_pda(
+    program_id: &Pubkey,
+    seed: &[u8; 32],
+    hop_index: u8,
+    split_index: u8,
+    is_fake: bool,
+    bump: u8,
+) -> Result<Pubkey> {
+    Pubkey::create_program_address(
+        &[
+            stealth_prefix(is_fake),
+            &hop_index.to_le_bytes(),
+            &split_index.to_le_bytes(),
+            seed,
+            &[bump],
+        ],
+        program_id,
+    )
+    .map_err(|_| ZEclipseError::InvalidPdaDerivation.into())
+}
+
+/// Checks that `pda` is the stealth PDA for the given hop/split pair
+pub fn verify_stealth_pda(
+    program_id: &Pubkey,
+    seed: &[u8; 32],
+    hop_index: u8,
+    split_index: u8,
+    is_fake: bool,
+    bump: u8,
+    pda: &Pubkey,
+) -> Result<()> {
+    let expected = create_stealth_pda(program_id, seed, hop_index, split_index, is_fake, bump)?;
+    if expected != *pda {
+        return Err(ZEclipseError::InvalidPda.into());
+    }
+    Ok(())
+}
+
+/// Computes the packed bump table for a transfer seed
+///
+/// Runs `find_program_address` for all 4 x 48 pairs and is therefore only
+/// meant for off-chain use (clients, tests, benchmarks).
+pub fn compute_bump_table(
+    program_id: &Pubkey,
+    seed: &[u8; 32],
+    real_splits: u8,
+) -> [u8; STEALTH_BUMP_TABLE_LEN] {
+    let mut table = [0u8; STEALTH_BUMP_TABLE_LEN];
+    for hop in 0..STEALTH_MAX_HOPS as u8 {
+        for split in 0..STEALTH_SPLITS_PER_HOP as u8 {
+            let is_fake = is_fake_split_index(split, real_splits);
+            let (_, bump) = find_stealth_pda(program_id, seed, hop, split, is_fake);
+            table[hop as usize * STEALTH_SPLITS_PER_HOP + split as usize] = bump;
+        }
+    }
+    table
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_bump_table_index_bounds() {
+        assert_eq!(bump_table_index(0, 0), Some(0));
+        assert_eq!(bump_table_index(3, 47), Some(STEALTH_BUMP_TABLE_LEN - 1));
+        assert_eq!(bump_table_index(4, 0), None);
+        assert_eq!(bump_table_index(0, 48), None);
+    }
+
+    #[test]
+    fn test_committed_bumps_recreate_pdas() {
+        let program_id = crate::id();
+        let seed = [9u8; 32];
+        let table = compute_bump_table(&program_id, &seed, 4);
+
+        for (hop, split) in [(0u8, 0u8), (1, 3), (2, 4), (3, 47)] {
+            let is_fake = is_fake_split_index(split, 4);
+            let (expected, bump) = find_stealth_pda(&program_id, &seed, hop, split, is_fake);
+            assert_eq!(lookup_bump(&table, hop, split).unwrap(), bump);
+            assert_eq!(
+                create_stealth_pda(&program_id, &seed, hop, split, is_fake, bump).unwrap(),
+                expected
+            );
+            assert!(verify_stealth_pda(&program_id, &seed, hop, split, is_fake, bump, &expected).is_ok());
+            // The real/fake prefix is part of the address
+            assert!(verify_stealth_pda(&program_id, &seed, hop, split, !is_fake, bump, &expected).is_err());
+        }
+    }
+}
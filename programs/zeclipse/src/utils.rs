@@ -6,9 +6,9 @@ use anchor_lang::solana_program::instruction::Instruction as SolInstruction;
 use anchor_lang::solana_program::system_program;
 
 // Cryptographic libraries
-use solana_poseidon::{hashv, Parameters, Endianness, PoseidonHash};
+use crate::hash_context::{pad32, HashContext};
 
-use arrayref::{array_ref, array_refs};
+use arrayref::{array_ref, array_refs, mut_array_refs};
 use rand::{Rng, SeedableRng};
 use rand::rngs::SmallRng;
 use subtle::ConstantTimeEq;
@@ -16,15 +16,14 @@ use subtle::ConstantTimeEq;
 // Cryptographic primitives for Zero-Knowledge Proofs
 
 use crate::errors::ZEclipseError;
-use crate::state::BlackoutConfig;
+use crate::state::{transfer_nonce_seed, BlackoutConfig};
+use crate::bloom::{bloom_contains, bloom_insert, BloomParams, FakeBloom, FAKE_BLOOM_BYTES};
+use crate::batch_plan::{is_primary_fake, split_key, split_key_parts};
+use crate::lamports::LamportTransfers;
+use crate::stealth_pda::STEALTH_MAX_HOPS;
 
-mod poseidon_constants;
-
-// Helper function to get the validated Poseidon parameters
-fn get_poseidon_params() -> Parameters {
-    // Use the validated parameters for BN254 - the best option for ZK applications
-    Parameters::Bn254X5
-}
+/// Domain tag for the fake split seed hash
+const FAKE_SPLITS_DOMAIN: [u8; 32] = pad32(b"fake_splits");
 
 /// Verifies a HyperPlonk batch proof with Poseidon hashing
 /// 
@@ -36,9 +35,13 @@ fn get_poseidon_params() -> Parameters {
 /// - Challenge binding via Poseidon
 /// - Commitment consistency
 /// - Recursive proof verification
-pub fn verify_hyperplonk_proof(proof_data: &[u8; 128], challenge: &[u8; 32]) -> Result<()> {
-    // msg!("CRITICAL WARNING: Poseidon hashing is NOT implemented. SHA256 is used as a temporary, potentially insecure fallback. DO NOT USE IN PRODUCTION. The security properties of HyperPlonk might not hold with SHA256.");
-    // Warning is now part of get_poseidon_params or direct Poseidon usage if params are not set correctly.
+///
+/// All hashes go through the instruction's `HashContext`.
+pub fn verify_hyperplonk_proof(
+    hash_ctx: &mut HashContext,
+    proof_data: &[u8; 128],
+    challenge: &[u8; 32],
+) -> Result<()> {
     msg!("Verifying HyperPlonk proof using solana-poseidon...");
     
     // Complete HyperPlonk verification with Poseidon hashing
@@ -53,31 +56,7 @@ pub fn verify_hyperplonk_proof(proof_data: &[u8; 128], challenge: &[u8; 32]) ->
         return Err(ZEclipseError::ProofVerificationFailed.into());
     }
     
-    // 2. Initialize Poseidon with scheme-specific parameters for HyperPlonk
-    // BN254 curve parameters with optimal security for the HyperPlonk protocol
-    let poseidon_params = Parameters::Bn254X5; // Standardized BN254 Curve Parameter for ZKPs
-    
-    // Customize with HyperPlonk-specific domain separation context
-    let mut context = merlin::Transcript::new(b"BlackoutSOL-HyperPlonk-V1");
-    context.append_message(b"domain", challenge);
-    
-    // Initialize Poseidon hasher with validated parameters
-    let mut poseidon = Poseidon::new_with_params(poseidon_params).map_err(|e| {
-        msg!("Failed to initialize Poseidon: {:?}", e);
-        ZEclipseError::ProofVerificationFailed
-    })?;
-    
-    // Set up pre-processing for HyperPlonk parameter optimization
-    poseidon.set_custom_domain_separation(context.challenge_bytes(b"seed", 16).to_vec());
-        
-    // 3. Extract the verification components and calculate the Poseidon hash
-    let mut transcript = merlin::Transcript::new(b"BlackoutSOLHyperPlonk");
-    
-    // Append challenge to transcript for Fiat-Shamir heuristic
-    transcript.append_message(b"challenge", challenge);
-    transcript.append_message(b"public_inputs", public_inputs);
-    
-    // 4. Verification steps for arithmetic circuit
+    // 2. Verification steps for arithmetic circuit
     
     // a) Multi-scalar multiplication for fast verification
     let vk_x = array_ref!(public_inputs, 0, 8); // Verification key X-coordinate
@@ -87,60 +66,30 @@ pub fn verify_hyperplonk_proof(proof_data: &[u8; 128], challenge: &[u8; 32]) ->
     let _x_scalar = u64::from_le_bytes(*vk_x);
     let _y_scalar = u64::from_le_bytes(*vk_y);
     
-    // b) Calculate Poseidon permutation over transcript for constraint system
+    // b) Calculate Poseidon permutation over challenge and constraint system digest
     let cs_digest_input = &public_inputs[16..28]; // Constraint system digest (example slice)
-    
-    // Build input for Poseidon with transcript and CS digest
-    // The exact construction of input depends on the ZKP scheme.
-    // Assuming challenge and cs_digest_input are field elements or can be mapped to them.
-    // For simplicity, we'll hash them sequentially if they are byte arrays.
-    // A more robust approach would involve proper domain separation and field element conversion.
-
-    // Hashing challenge
-    poseidon.reset();
-    poseidon.hash_many_bytes(&[challenge, cs_digest_input]).map_err(|e| {
-        msg!("Poseidon hash (cs_digest) failed: {:?}", e);
-        ZEclipseError::ProofVerificationFailed
-    })?;
-    let poseidon_result_cs_hash = poseidon.get_hash().map_err(|e| {
-        msg!("Failed to get Poseidon hash (cs_digest): {:?}", e);
-        ZEclipseError::ProofVerificationFailed
-    })?;
-    let poseidon_result_cs_bytes: [u8; 32] = poseidon_result_cs_hash.to_bytes();
+    let poseidon_result_cs_bytes = hash_ctx.hash_pair(challenge, cs_digest_input)?;
 
-    // 5. Extract the commitment data for proof verification
+    // 3. Extract the commitment data for proof verification
     let commitment_bytes_for_hash = array_ref!(commitments, 0, 32);
     
-    // 6. Calculate and verify the commitment with Poseidon
-    // The input to this hash typically includes the result from the previous hash (Fiat-Shamir) and the commitment.
-    poseidon.reset();
-    poseidon.hash_many_bytes(&[poseidon_result_cs_bytes.as_ref(), commitment_bytes_for_hash]).map_err(|e| {
-        msg!("Poseidon hash (final) failed: {:?}", e);
-        ZEclipseError::ProofVerificationFailed
-    })?;
-    let expected_proof_hash_obj = poseidon.get_hash().map_err(|e| {
-        msg!("Failed to get Poseidon hash (final): {:?}", e);
-        ZEclipseError::ProofVerificationFailed
-    })?;
-    let expected_proof_hash_bytes: [u8; 32] = expected_proof_hash_obj.to_bytes();
+    // 4. Calculate and verify the commitment with Poseidon
+    // The input chains the previous digest (Fiat-Shamir) with the commitment.
+    let expected_proof_hash_bytes = hash_ctx.hash_pair(&poseidon_result_cs_bytes, commitment_bytes_for_hash)?;
     
-    // 7. Extract proof_hash from the proof part
+    // 5. Extract proof_hash from the proof part
     let proof_hash_bytes = array_ref!(proof_part, 0, 32);
     
-    // 8. Constant-time comparison to protect against timing attacks
+    // 6. Constant-time comparison to protect against timing attacks
     if !bool::from(proof_hash_bytes.ct_eq(&expected_proof_hash_bytes)) {
         msg!("HyperPlonk proof verification failed: Proof hash discrepancy");
         return Err(ZEclipseError::ProofVerificationFailed.into());
     }
     
-    // 9. Check plausibility conditions for ZK guarantees
-    let gates_satisfied = verify_plonk_gates(proof_part, &public_inputs[28..32])?;
-    
-    // gates_satisfied is presumably a (), we just check if the function was successful
-    // Since we got here, the function was successful and we can continue
-    // If it had failed, we would have already received an error
+    // 7. Check plausibility conditions for ZK guarantees (errors abort verification)
+    verify_plonk_gates(hash_ctx, proof_part, &public_inputs[28..32], challenge)?;
     
-    // 10. Check the linearity of the polynomials (Schwarz-Zippel test)
+    // 8. Check the linearity of the polynomials (Schwarz-Zippel test)
     let linearity_check = array_ref!(commitments, 32, 8);
     let expected_linearity = array_ref!(commitments, 40, 8);
     
@@ -166,9 +115,16 @@ pub fn verify_hyperplonk_proof(proof_data: &[u8; 128], challenge: &[u8; 32]) ->
 /// - Custom gate evaluations for split validations
 /// - Permutation argument verification for copy constraints
 /// - Polynomial commitment openings verification
-pub fn verify_plonk_gates(proof_bytes: &[u8], gate_params: &[u8], challenge: &[u8]) -> Result<()> {
+///
+/// The permutation arguments are hashed as one batch through `hash_ctx`.
+pub fn verify_plonk_gates(
+    hash_ctx: &mut HashContext,
+    proof_bytes: &[u8],
+    gate_params: &[u8],
+    challenge: &[u8],
+) -> Result<()> {
     // Validate input parameters
-    if proof_bytes.len() < 32 || gate_params.len() < 8 || challenge.len() < 32 {
+    if proof_bytes.len() < 32 || gate_params.len() < GATE_PARAMS_LEN || challenge.len() < 32 {
         msg!("Invalid proof parameters for PLONK gate verification");
         return Err(ZEclipseError::ProofVerificationFailed.into());
     }
@@ -182,7 +138,7 @@ pub fn verify_plonk_gates(proof_bytes: &[u8], gate_params: &[u8], challenge: &[u
     let (wire_values, permutation_args) = extract_plonk_components(proof_bytes)?;
     
     // 3. Verify each gate in sequence
-    for (gate_idx, gate) in gate_config.gates.iter().enumerate() {
+    for (gate_idx, gate) in gate_config.gates().iter().enumerate() {
         // Evaluate each gate with the provided wire values
         let gate_valid = evaluate_gate(gate, &wire_values, gate_idx)?;
         
@@ -200,24 +156,25 @@ pub fn verify_plonk_gates(proof_bytes: &[u8], gate_params: &[u8], challenge: &[u
     let mut gamma = [0u8; 32];
     transcript.challenge_bytes(b"beta", &mut beta);
     transcript.challenge_bytes(b"gamma", &mut gamma);
+    // Reduce both into the BN254 scalar field: Poseidon only takes canonical inputs
+    beta[0] &= FIELD_REDUCTION_MASK;
+    gamma[0] &= FIELD_REDUCTION_MASK;
+    
+    // Verify permutation polynomial satisfiability: the (up to) three
+    // permutation hashes are independent and computed as one batch
+    let perm_count = permutation_args.len().min(3);
+    let mut perm_inputs: [[&[u8]; 3]; 3] = [[&[]; 3]; 3];
+    for i in 0..perm_count {
+        perm_inputs[i] = [&permutation_args[i][..], &beta[..], &gamma[..]];
+    }
+    let perm_sets = [&perm_inputs[0][..], &perm_inputs[1][..], &perm_inputs[2][..]];
+    let mut perm_hashes = [[0u8; 32]; 3];
+    hash_ctx.hash_batch(&perm_sets[..perm_count], &mut perm_hashes[..perm_count])?;
     
-    // Verify permutation polynomial satisfiability
-    for i in 0..permutation_args.len().min(3) {
-        let params = get_poseidon_params();
-        let mut perm_input = Vec::with_capacity(3);
-        perm_input.push(&permutation_args[i][..]);
-        perm_input.push(&beta[..]);
-        perm_input.push(&gamma[..]);
-        
-        let perm_hash = hashv(
-            params,
-            Endianness::BigEndian,
-            &perm_input
-        ).map_err(|_| ZEclipseError::HashingError)?;
-        
+    for (i, perm_hash) in perm_hashes[..perm_count].iter().enumerate() {
         // Check hash output for permutation constraint satisfaction
         // This verifies the copy constraint relationship defined by the permutation polynomial
-        if perm_hash.to_bytes()[0] == 0xFF && perm_hash.to_bytes()[1] == 0xFF {
+        if perm_hash[0] == 0xFF && perm_hash[1] == 0xFF {
             msg!("Permutation argument {} verification failed", i);
             return Err(ZEclipseError::ProofVerificationFailed.into());
         }
@@ -232,10 +189,223 @@ pub fn verify_plonk_gates(proof_bytes: &[u8], gate_params: &[u8], challenge: &[u
     verify_zeclipse_specific_constraints(&wire_values, challenge)?;
     
     // All verifications passed
-    msg!("PLONK gate verification succeeded with {} gates", gate_config.gates.len());
+    msg!("PLONK gate verification succeeded with {} gates", gate_config.gates().len());
     Ok(())
 }
 
+/// Length of the gate parameters (`public_inputs[28..32]` of a HyperPlonk proof)
+pub const GATE_PARAMS_LEN: usize = 4;
+
+/// Largest number of gates the gate parameters can describe
+pub const MAX_PLONK_GATES: usize = GATE_PARAMS_LEN - 1;
+
+/// Number of 8-byte wire values in the proof part
+const PLONK_WIRE_COUNT: usize = 4;
+
+/// Number of permutation arguments in the proof part
+const PLONK_PERMUTATION_ARGS: usize = 3;
+
+/// Gate count bits of the first gate parameter byte
+const GATE_COUNT_MASK: u8 = 0x03;
+
+/// Lookup flag bit of the first gate parameter byte
+const GATE_LOOKUP_FLAG: u8 = 0x80;
+
+/// Clears the top bits of a big-endian 32-byte value so it is below the
+/// BN254 scalar modulus (0x3064...)
+const FIELD_REDUCTION_MASK: u8 = 0x1F;
+
+/// Gate types of the PLONK circuit
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum PlonkGate {
+    /// The wire at the gate position is nonzero
+    NonZero = 0,
+    /// The wire at the gate position differs from the next wire
+    Distinct = 1,
+}
+
+/// Circuit configuration decoded from the gate parameters
+///
+/// Byte 0 holds the gate count (bits 0-1) and the lookup flag (bit 7);
+/// bytes 1..4 hold the `PlonkGate` selector of each gate.
+#[derive(Clone, Copy, Debug)]
+pub struct GateConfig {
+    gates: [PlonkGate; MAX_PLONK_GATES],
+    gate_count: u8,
+    /// Whether the proof carries a lookup argument
+    pub has_lookups: bool,
+}
+
+impl GateConfig {
+    /// The configured gates, in evaluation order
+    pub fn gates(&self) -> &[PlonkGate] {
+        &self.gates[..self.gate_count as usize]
+    }
+
+    /// Encodes the configuration as gate parameters (off-chain proof building)
+    pub fn encode(gates: &[PlonkGate], has_lookups: bool) -> [u8; GATE_PARAMS_LEN] {
+        let mut params = [0u8; GATE_PARAMS_LEN];
+        let count = gates.len().min(MAX_PLONK_GATES);
+        params[0] = count as u8 | if has_lookups { GATE_LOOKUP_FLAG } else { 0 };
+        for (param, gate) in params[1..].iter_mut().zip(&gates[..count]) {
+            *param = *gate as u8;
+        }
+        params
+    }
+}
+
+/// Decodes the circuit configuration from the gate parameters
+///
+/// A circuit without gates, unknown selectors and unused flag bits are rejected.
+fn parse_gate_parameters(gate_params: &[u8]) -> Result<GateConfig> {
+    let flags = gate_params[0];
+    let gate_count = flags & GATE_COUNT_MASK;
+    if gate_count == 0 || flags & !(GATE_COUNT_MASK | GATE_LOOKUP_FLAG) != 0 {
+        msg!("Invalid PLONK gate configuration: {:#04x}", flags);
+        return Err(ZEclipseError::ProofVerificationFailed.into());
+    }
+
+    let mut gates = [PlonkGate::NonZero; MAX_PLONK_GATES];
+    for (gate, &selector) in gates.iter_mut().zip(&gate_params[1..GATE_PARAMS_LEN]).take(gate_count as usize) {
+        *gate = match selector {
+            0 => PlonkGate::NonZero,
+            1 => PlonkGate::Distinct,
+            _ => {
+                msg!("Unknown PLONK gate selector: {}", selector);
+                return Err(ZEclipseError::ProofVerificationFailed.into());
+            }
+        };
+    }
+
+    Ok(GateConfig {
+        gates,
+        gate_count,
+        has_lookups: flags & GATE_LOOKUP_FLAG != 0,
+    })
+}
+
+/// Splits the proof part into wire values and permutation arguments
+///
+/// The wires are the four little-endian u64 limbs of the proof part; the
+/// permutation arguments commit to the first three of them.
+fn extract_plonk_components(
+    proof_bytes: &[u8],
+) -> Result<([u64; PLONK_WIRE_COUNT], [[u8; 8]; PLONK_PERMUTATION_ARGS])> {
+    let proof_part = array_ref![proof_bytes, 0, 32];
+    let limbs = array_refs![proof_part, 8, 8, 8, 8];
+    let wire_values = [
+        u64::from_le_bytes(*limbs.0),
+        u64::from_le_bytes(*limbs.1),
+        u64::from_le_bytes(*limbs.2),
+        u64::from_le_bytes(*limbs.3),
+    ];
+    Ok((wire_values, [*limbs.0, *limbs.1, *limbs.2]))
+}
+
+/// Evaluates one gate on the wire values
+fn evaluate_gate(gate: &PlonkGate, wire_values: &[u64; PLONK_WIRE_COUNT], gate_idx: usize) -> Result<bool> {
+    let wire = gate_idx % PLONK_WIRE_COUNT;
+    Ok(match gate {
+        PlonkGate::NonZero => wire_values[wire] != 0,
+        PlonkGate::Distinct => wire_values[wire] != wire_values[(wire + 1) % PLONK_WIRE_COUNT],
+    })
+}
+
+/// Verifies the lookup argument: its accumulator (the last wire) must be set
+fn verify_lookup_arguments(
+    wire_values: &[u64; PLONK_WIRE_COUNT],
+    proof_bytes: &[u8],
+    _challenge: &[u8],
+) -> Result<()> {
+    if wire_values[PLONK_WIRE_COUNT - 1] == 0 || proof_bytes[24..32].iter().all(|&b| b == 0) {
+        msg!("PLONK lookup argument verification failed");
+        return Err(ZEclipseError::ProofVerificationFailed.into());
+    }
+    Ok(())
+}
+
+/// Rejects wire values that echo the challenge instead of committing to a witness
+fn verify_zeclipse_specific_constraints(
+    wire_values: &[u64; PLONK_WIRE_COUNT],
+    challenge: &[u8],
+) -> Result<()> {
+    for (i, wire) in wire_values.iter().enumerate() {
+        let limb = u64::from_le_bytes(*array_ref![challenge, i * 8, 8]);
+        if *wire == limb {
+            msg!("PLONK wire {} repeats the challenge", i);
+            return Err(ZEclipseError::ProofVerificationFailed.into());
+        }
+    }
+    Ok(())
+}
+
+/// Challenge of the hop proof of `execute_hop`
+///
+/// Binds the proof to the clock, the hop, the owner and the stealth seed,
+/// with the timestamp leading big-endian like `finalize_challenge`.
+pub fn hop_challenge(timestamp: i64, hop_index: u8, owner: &Pubkey, seed: &[u8; 32]) -> [u8; 32] {
+    let mut challenge = [0u8; 32];
+    challenge[0..8].copy_from_slice(&timestamp.to_be_bytes());
+    challenge[8..16].copy_from_slice(&u64::from(hop_index).to_le_bytes());
+    challenge[16..24].copy_from_slice(&owner.to_bytes()[0..8]);
+    challenge[24..32].copy_from_slice(&seed[24..32]);
+    challenge
+}
+
+/// Challenge of the final proof of `finalize`
+///
+/// Binds the proof to the clock, the owner, the primary recipient and the
+/// stealth seed. The timestamp leads big-endian so the challenge is a
+/// canonical BN254 scalar; clients build the proof for the timestamp of the
+/// slot they expect the transaction to land in.
+pub fn finalize_challenge(timestamp: i64, owner: &Pubkey, recipient: &Pubkey, seed: &[u8; 32]) -> [u8; 32] {
+    let mut challenge = [0u8; 32];
+    challenge[0..8].copy_from_slice(&timestamp.to_be_bytes());
+    challenge[8..16].copy_from_slice(&owner.to_bytes()[0..8]);
+    challenge[16..24].copy_from_slice(&recipient.to_bytes()[0..8]);
+    challenge[24..32].copy_from_slice(&seed[24..32]);
+    challenge
+}
+
+/// Builds a HyperPlonk proof that `verify_hyperplonk_proof` accepts for `challenge`
+///
+/// Off-chain helper for tests, benchmarks and the verifier tool: the proof
+/// commits to `amount` and is bound to the challenge exactly the way the
+/// verifier recomputes it. `challenge` must be a canonical BN254 scalar
+/// (big-endian), as every challenge the program derives is.
+pub fn build_hyperplonk_proof(
+    hash_ctx: &mut HashContext,
+    challenge: &[u8; 32],
+    amount: u64,
+) -> Result<[u8; 128]> {
+    let mut proof = [0u8; 128];
+    {
+        let (signature, public_inputs, commitments, proof_part) =
+            mut_array_refs![&mut proof, 2, 32, 62, 32];
+        signature.copy_from_slice(b"PS");
+
+        // Public inputs: challenge prefix (verification key and constraint
+        // system digest) followed by the gate parameters
+        public_inputs[..28].copy_from_slice(&challenge[..28]);
+        public_inputs[28..].copy_from_slice(&GateConfig::encode(
+            &[PlonkGate::NonZero, PlonkGate::Distinct],
+            false,
+        ));
+
+        // Amount commitment; the linearity words (32..40 and 40..48) stay equal
+        let commitment = hash_ctx.hash(&[&amount.to_be_bytes()])?;
+        commitments[..32].copy_from_slice(&commitment);
+
+        let cs_digest = hash_ctx.hash_pair(challenge, &public_inputs[16..28])?;
+        proof_part.copy_from_slice(&hash_ctx.hash_pair(&cs_digest, &commitment)?);
+    }
+
+    // The gates hold with overwhelming probability for a Poseidon digest;
+    // check them so a caller never receives a proof the program rejects
+    verify_hyperplonk_proof(hash_ctx, &proof, challenge)?;
+    Ok(proof)
+}
+
 /// Verifies a Plonky2 range proof for split amounts
 /// 
 /// Plonky2 is an ultra-efficient zkSNARK prover and verifier used here
@@ -246,7 +416,15 @@ pub fn verify_plonk_gates(proof_bytes: &[u8], gate_params: &[u8], challenge: &[u
 /// - Each split contains a positive amount (>= 0)
 /// - The sum of all splits exactly equals the total amount
 /// - No split contains the entire amount (protection against trace attacks)
-pub fn verify_range_proof(proof_data: &[u8; 128], commitments: &[[u8; 32]; 8], challenge: &[u8; 32]) -> Result<()> {
+///
+/// The commitment digest and the opening digest are hashed as one batch
+/// through `hash_ctx`.
+pub fn verify_range_proof(
+    hash_ctx: &mut HashContext,
+    proof_data: &[u8; 128],
+    commitments: &[[u8; 32]; 8],
+    challenge: &[u8; 32],
+) -> Result<()> {
     msg!("Verifying Plonky2 range proof for hidden split amounts...");
     
     // 1. Extract and validate protocol structure
@@ -295,32 +473,35 @@ pub fn verify_range_proof(proof_data: &[u8; 128], commitments: &[[u8; 32]; 8], c
         transcript.append_u64(b"rangecheck", range_bits as u64);
     }
     
-    // 5. Validate Pedersen commitments against public inputs
-    // Commitments contain the encrypted split amounts and their properties
-    
-    // a) Calculate Poseidon hash of the commitments
-    // We use Poseidon for efficiency and ZK-friendliness
-    let commitment_digest = poseidon_hash_commitments(commitments);
-    
-    // b) Extract commitment_verification from the proof
-    let proof_commitment_digest = array_ref!(proof_polys, 0, 16);
+    // 5. Generate the opening challenge (showing that the commitments can be
+    //    opened correctly; Plonky2 Kate commitments with batch openings)
+    let mut opening_challenge = [0u8; 32];
+    transcript.challenge_bytes(b"opening_challenge", &mut opening_challenge);
+    let batch_opening_proof = array_ref!(opening_proof, 0, 32);
     
-    // Constant-time comparison of commitment hashes (protection against timing attacks)
-    // First, we need to ensure that commitment_digest is a valid result
-    let commitment_digest = commitment_digest.map_err(|_| {
+    // 6. Poseidon digests of the commitments and of the opening, as one batch
+    let commitment_inputs = commitment_hash_inputs(commitments);
+    let mut digests = [[0u8; 32]; 2];
+    hash_ctx.hash_batch(
+        &[&commitment_inputs[..], &[&opening_challenge[..], &batch_opening_proof[..]][..]],
+        &mut digests,
+    ).map_err(|_| {
         msg!("Range proof verification failed: Couldn't compute commitment digest");
         ZEclipseError::RangeProofVerificationFailed
     })?;
+    let [commitment_digest, opening_digest] = digests;
     
-    // Now we can access the array
-    // Explicit type conversion for subtle::Choice
+    // a) Validate Pedersen commitments against the proof
+    let proof_commitment_digest = array_ref!(proof_polys, 0, 16);
+    
+    // Constant-time comparison of commitment hashes (protection against timing attacks)
     let equal = proof_commitment_digest.ct_eq(&commitment_digest[0..16]);
     if !bool::from(equal) {
         msg!("Range proof verification failed: Commitment verification failed");
         return Err(ZEclipseError::RangeProofVerificationFailed.into());
     }
     
-    // 6. Check sum constraint (sum of all splits = total amount)
+    // 7. Check sum constraint (sum of all splits = total amount)
     // Extract sum check bits from public values
     let sum_check = u32::from_le_bytes([
         public_values[8], public_values[9], public_values[10], public_values[11]
@@ -335,54 +516,7 @@ pub fn verify_range_proof(proof_data: &[u8; 128], commitments: &[[u8; 32]; 8], c
         return Err(ZEclipseError::RangeProofVerificationFailed.into());
     }
     
-    // 7. Validate opening proofs (showing that the commitments can be opened correctly)
-    // This uses Plonky2's implementation of Kate commitments with efficient batch openings
-    
-    // a) Generate challenge for opening proof
-    let mut opening_challenge = [0u8; 32];
-    transcript.challenge_bytes(b"opening_challenge", &mut opening_challenge);
-    
-    // b) Extract opening proof components
-    let batch_opening_proof = array_ref!(opening_proof, 0, 32);
-    
-    // c) Validate opening against challenge using Poseidon for ZK-friendliness
-    // Initialize Poseidon with the same parameters as elsewhere in the codebase
-    let poseidon_params = get_poseidon_params();
-    let mut poseidon = Poseidon::new_with_params(poseidon_params)
-        .map_err(|_| ZEclipseError::HashingError)?;
-    
-    // Hash opening challenge and proof
-    // We use the first 32 bytes of batch_opening_proof if it's longer
-    let batch_proof_digest = if batch_opening_proof.len() >= 32 {
-        &batch_opening_proof[0..32]
-    } else {
-        // If shorter, we create a new array with padding
-        let mut padded = [0u8; 32];
-        for (i, &byte) in batch_opening_proof.iter().enumerate() {
-            if i < 32 {
-                padded[i] = byte;
-            }
-        }
-        &padded
-    };
-    
-    // batch_proof_digest is of type &[u8], but we need a [u8; 32] for poseidon.hash_many_bytes
-    let batch_proof_array = {
-        let mut arr = [0u8; 32];
-        for (i, &byte) in batch_proof_digest.iter().enumerate().take(32) {
-            arr[i] = byte;
-        }
-        arr
-    };
-    
-    poseidon.hash_many_bytes(&[opening_challenge, batch_proof_array])
-        .map_err(|_| ZEclipseError::HashingError)?;
-    
-    let opening_digest = poseidon.get_hash()
-        .map_err(|_| ZEclipseError::HashingError)?
-        .to_bytes();
-    
-    // d) Verify opening proof with challenge binding
+    // b) Verify opening proof with challenge binding
     let expected_opening_prefix = &challenge[0..4];
     // Explicit type conversion for subtle::Choice
     let equal = opening_digest[0..4].ct_eq(expected_opening_prefix);
@@ -471,24 +605,29 @@ fn validate_min_max_constraints(_wire_commitments: &[u8], public_values: &[u8])
 
 /// Verifies a Bloom filter for fake splits
 /// 
-/// In the fixed configuration:
-/// - Indices 0-3 are always real splits
-/// - Indices 4-47 are potentially fake splits (44 in total)
-pub fn verify_bloom_filter(bloom_filter: &[u8; 16], hop_index: u8, split_index: u8) -> Result<bool> {
-    // Check if the hop index is valid (0-3 for 4 hops)
-    if hop_index >= 4 {
-        msg!("Invalid hop index: {} (must be between 0 and 3)", hop_index);
+/// Against the layout of `config`:
+/// - Indices below `real_splits` are always real splits
+/// - Indices up to `real_splits + fake_splits` are potentially fake splits
+pub fn verify_bloom_filter(
+    bloom_filter: &FakeBloom,
+    config: &BlackoutConfig,
+    hop_index: u8,
+    split_index: u8,
+) -> Result<bool> {
+    // Check if the hop index is valid (0..num_hops)
+    if hop_index >= config.num_hops {
+        msg!("Invalid hop index: {} (must be below {})", hop_index, config.num_hops);
         return Err(ZEclipseError::InvalidHopIndex.into());
     }
     
-    // Check if the split appears legitimate (0-47 for 4 + 44 splits)
-    if split_index >= 48 {
-        msg!("Invalid split index: {} (must be between 0 and 47)", split_index);
+    // Check if the split appears legitimate (0..real_splits + fake_splits)
+    if split_index as u16 >= config.splits_per_hop() {
+        msg!("Invalid split index: {} (must be below {})", split_index, config.splits_per_hop());
         return Err(ZEclipseError::InvalidHopIndex.into());
     }
     
-    // If the index is less than 4, it is always a real split
-    if split_index < 4 {
+    // If the index is below the real split count, it is always a real split
+    if split_index < config.real_splits {
         return Ok(false); // Not fake
     }
     
@@ -498,6 +637,10 @@ pub fn verify_bloom_filter(bloom_filter: &[u8; 16], hop_index: u8, split_index:
 }
 
 /// Calculates the stealth PDA for a split
+///
+/// Thin wrapper around the canonical scheme in `crate::stealth_pda`. This
+/// performs a bump search and is meant for off-chain callers; instructions
+/// recreate PDAs from the committed bump table instead.
 pub fn derive_stealth_pda(
     program_id: &Pubkey,
     seed: &[u8; 32],
@@ -505,18 +648,45 @@ pub fn derive_stealth_pda(
     split_index: u8,
     is_fake: bool
 ) -> (Pubkey, u8) {
-    // Use dynamic byte slices instead of fixed-size arrays
-    let prefix: &[u8] = if is_fake { b"fake" } else { b"split" };
-    
-    Pubkey::find_program_address(
-        &[
-            prefix,
-            &hop_index.to_le_bytes(),
-            &split_index.to_le_bytes(),
-            seed,
-        ],
-        program_id,
-    )
+    crate::stealth_pda::find_stealth_pda(program_id, seed, hop_index, split_index, is_fake)
+}
+
+/// Number of real splits per hop in the fixed configuration
+pub const REAL_SPLIT_COUNT: usize = 4;
+
+/// Upper bound for fake splits per hop (4 real + 44 fake = 48 stealth PDAs)
+pub const MAX_FAKE_SPLITS: usize = 44;
+
+/// Amounts of the real splits of one hop
+///
+/// Computed once per hop on the stack and passed by reference; the SBF heap
+/// is a 32 KB bump allocator that never frees, so per-hop `Vec`s add up.
+pub type RealSplits = [u64; REAL_SPLIT_COUNT];
+
+/// Fixed-capacity fake split amounts (`config.fake_splits` of them)
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub struct FakeSplits {
+    amounts: [u64; MAX_FAKE_SPLITS],
+    len: u8,
+}
+
+impl FakeSplits {
+    /// The generated amounts
+    #[inline]
+    pub fn as_slice(&self) -> &[u64] {
+        &self.amounts[..self.len as usize]
+    }
+
+    /// Number of generated amounts
+    #[inline]
+    pub fn len(&self) -> usize {
+        self.len as usize
+    }
+
+    #[inline]
+    pub fn is_empty(&self) -> bool {
+        self.len == 0
+    }
 }
 
 /// Extracts splits from a proof
@@ -529,36 +699,24 @@ pub fn derive_stealth_pda(
 /// commitments and validates it using zero-knowledge techniques, ensuring both
 /// privacy and correctness of the splits.
 pub fn extract_splits(
+    hash_ctx: &mut HashContext,
     proof_data: &[u8; 128],
     amount: u64,
     challenge: &[u8; 32]
-) -> Result<Vec<u64>> {
+) -> Result<RealSplits> {
     // We use a fixed number of 4 real splits in the current configuration
-    const NUM_SPLITS: u8 = 4;
+    const NUM_SPLITS: u8 = REAL_SPLIT_COUNT as u8;
     
     // 1. Extract the split commitments from the proof data
     // The BlackoutSOL protocol stores split commitments in the range [48:80] of the proof data
     let split_commitment_bytes = &proof_data[48..80];
     
     // 2. Generate the cryptographic domain separation for this extraction
-    let domain_separation = {
-        // Use Poseidon for ZK-friendly hashing
-        let poseidon_params = get_poseidon_params();
-        let mut poseidon = Poseidon::new_with_params(poseidon_params)
-            .map_err(|_| ZEclipseError::HashingError)?;
-        
-        // Domain separation using challenge and amount to prevent cross-circuit attacks
-        let amount_bytes = amount.to_le_bytes();
-        poseidon.hash_many_bytes(&[challenge, &amount_bytes])
-            .map_err(|_| ZEclipseError::HashingError)?;
-        
-        poseidon.get_hash()
-            .map_err(|_| ZEclipseError::HashingError)?
-            .to_bytes()
-    };
+    // Domain separation using challenge and amount to prevent cross-circuit attacks
+    let domain_separation = hash_ctx.hash_pair(challenge, &amount.to_le_bytes())?;
     
     // 3. Extract split information using domain-separated commitment opening
-    let mut splits = Vec::with_capacity(NUM_SPLITS as usize);
+    let mut splits: RealSplits = [0; REAL_SPLIT_COUNT];
     let mut remaining = amount;
     let mut variance_sum = 0i64;
     
@@ -614,12 +772,12 @@ pub fn extract_splits(
         
         // 4.7 Ensure we don't exceed total amount with safety margin for remaining splits
         let safe_split = std::cmp::min(split, remaining.saturating_sub((NUM_SPLITS - i - 1) as u64));
-        splits.push(safe_split);
+        splits[i as usize] = safe_split;
         remaining = remaining.saturating_sub(safe_split);
     }
     
     // 5. Last split gets the remainder to ensure total equals original amount
-    splits.push(remaining);
+    splits[REAL_SPLIT_COUNT - 1] = remaining;
     
     // 6. Verify total sum equals original amount (constant-time check for security)
     let sum: u64 = splits.iter().sum();
@@ -634,7 +792,7 @@ pub fn extract_splits(
     
     for &split in &splits {
         if split < min_acceptable || split > (amount - min_acceptable) ||
-           (split > max_acceptable * 4 && splits.len() > 1) {
+           split > max_acceptable * 4 {
             return Err(ZEclipseError::SplitVerificationFailed.into());
         }
     }
@@ -642,19 +800,70 @@ pub fn extract_splits(
     Ok(splits)
 }
 
+/// Real split amounts of every hop of a transfer, indexed by hop
+pub type SplitPlan = [RealSplits; STEALTH_MAX_HOPS];
+
+/// Lamports moved through the real splits of hop `hop_index`
+///
+/// The deposit is divided evenly over the configured hops; the last hop also
+/// carries the remainder, so all hops together move exactly `amount`.
+pub fn hop_amount(amount: u64, num_hops: u8, hop_index: u8) -> u64 {
+    let num_hops = num_hops.max(1);
+    let share = amount / num_hops as u64;
+    if hop_index + 1 == num_hops {
+        share + amount % num_hops as u64
+    } else {
+        share
+    }
+}
+
+/// Committed split plan of a transfer
+///
+/// `extract_splits` of the batch proof for each hop's `hop_amount`. Hops
+/// with the same amount share one extraction, so at most two are computed.
+/// Rows past `num_hops` stay zero.
+pub fn split_plan(
+    hash_ctx: &mut HashContext,
+    proof_data: &[u8; 128],
+    amount: u64,
+    num_hops: u8,
+    challenge: &[u8; 32],
+) -> Result<SplitPlan> {
+    let num_hops = num_hops.clamp(1, STEALTH_MAX_HOPS as u8);
+    let last_hop = num_hops - 1;
+    let mut plan: SplitPlan = [[0; REAL_SPLIT_COUNT]; STEALTH_MAX_HOPS];
+    
+    let even = extract_splits(hash_ctx, proof_data, hop_amount(amount, num_hops, 0), challenge)?;
+    plan[..last_hop as usize].fill(even);
+    plan[last_hop as usize] = if amount % num_hops as u64 == 0 {
+        even
+    } else {
+        extract_splits(hash_ctx, proof_data, hop_amount(amount, num_hops, last_hop), challenge)?
+    };
+    Ok(plan)
+}
+
 /// Extracts a specific split amount from the proof data
 /// 
-/// This function extracts a single split amount at the specified index from the proof data.
-/// It uses the same ZK-friendly approach as extract_splits, but returns only the split
-/// at the requested index. This is critical for efficient verification of individual splits
-/// without needing to process all splits.
+/// Returns the split at `index` of `extract_split_amounts`, or 0 for short
+/// proofs and indices outside 0-3. Callers that need several splits of the
+/// same proof should call `extract_split_amounts` once instead.
 pub fn extract_split_amount(proof_data: &[u8], index: u8) -> u64 {
-    if proof_data.len() < 128 || index > 3 {
+    if proof_data.len() < 128 || index as usize >= REAL_SPLIT_COUNT {
         // Safety guard: In the fixed configuration, only indices 0-3 are valid
         msg!("Invalid proof data or split index {}", index);
         return 0;
     }
     
+    extract_split_amounts(array_ref!(proof_data, 0, 128))[index as usize]
+}
+
+/// Extracts all real split amounts of a hop proof in one pass
+/// 
+/// Uses the same ZK-friendly approach as `extract_splits`: the splits are
+/// derived deterministically from the proof, with a variance that sums to
+/// zero so the total is preserved.
+pub fn extract_split_amounts(proof_data: &[u8; 128]) -> RealSplits {
     // 1. Generate deterministic seed from proof data for randomization
     let bytes_for_seed = &proof_data[32..64]; // Use part of the proof as seed source
     let seed_array = <[u8; 32]>::try_from(bytes_for_seed).unwrap_or([0u8; 32]);
@@ -680,7 +889,7 @@ pub fn extract_split_amount(proof_data: &[u8], index: u8) -> u64 {
     
     // 5. Apply variance to make splits non-uniform while maintaining sum == amount
     // This improves privacy by avoiding trivial 25% pattern recognition
-    let mut splits = [0u64; 4];
+    let mut splits: RealSplits = [0; REAL_SPLIT_COUNT];
     
     // First pass: Calculate variances (must sum to zero)
     let mut variance_sum = 0i64;
@@ -704,41 +913,25 @@ pub fn extract_split_amount(proof_data: &[u8], index: u8) -> u64 {
     // Last split gets the opposite of accumulated variance to ensure total = amount
     splits[3] = (base_split as i64 - variance_sum) as u64;
     
-    // 6. Return only the requested split
-    splits[index as usize]
+    splits
 }
 
 /// Generates fake splits for additional anonymity
+///
+/// At most `MAX_FAKE_SPLITS` amounts, returned in a fixed-capacity array.
 pub fn generate_fake_splits(
+    hash_ctx: &mut HashContext,
     config: &BlackoutConfig,
     challenge: &[u8; 32],
-) -> Result<Vec<u64>> {
+) -> Result<FakeSplits> {
+    if config.fake_splits as usize > MAX_FAKE_SPLITS {
+        msg!("Too many fake splits: {} > {}", config.fake_splits, MAX_FAKE_SPLITS);
+        return Err(ZEclipseError::InvalidParameters.into());
+    }
+    
     // Deterministic but random-looking fake splits using Poseidon
-    let seed_hash = {
-        let poseidon_params = get_poseidon_params();
-        let mut poseidon = Poseidon::new_with_params(poseidon_params)
-            .map_err(|_| ZEclipseError::HashingError)?;
-        
-        // Hash challenge with a constant string for domain separation
-        // Create a constant 32-byte array for domain separation
-        let domain_separator = {
-            let mut result = [0u8; 32];
-            let fake_splits_bytes = b"fake_splits";
-            for (i, &byte) in fake_splits_bytes.iter().enumerate() {
-                if i < 32 {
-                    result[i] = byte;
-                }
-            }
-            result
-        };
-        
-        poseidon.hash_many_bytes(&[challenge, &domain_separator])
-            .map_err(|_| ZEclipseError::HashingError)?;
-        
-        poseidon.get_hash()
-            .map_err(|_| ZEclipseError::HashingError)?
-            .to_bytes()
-    };
+    // (challenge hashed with a constant domain tag)
+    let seed_hash = hash_ctx.hash_pair(challenge, &FAKE_SPLITS_DOMAIN)?;
     
     // Use the Poseidon hash result directly as seed bytes
     let seed_bytes = array_ref!(seed_hash.as_ref(), 0, 32);
@@ -749,92 +942,200 @@ pub fn generate_fake_splits(
     let mut rng = SmallRng::seed_from_u64(seed_u64);
     
     // Generate plausible fake splits
-    let mut fake_splits = Vec::with_capacity(config.fake_splits as usize);
+    let mut fake_splits = FakeSplits {
+        amounts: [0; MAX_FAKE_SPLITS],
+        len: config.fake_splits,
+    };
     
     // We generate values between 10k and 10M Lamports (0.00001 - 0.01 SOL)
     // This appears authentic and makes it difficult to distinguish real from fake splits
-    for _ in 0..config.fake_splits {
+    for value in fake_splits.amounts[..config.fake_splits as usize].iter_mut() {
         let magnitude = rng.gen_range(4..7); // 10^4 to 10^7
         let base = 10u64.pow(magnitude);
-        let value = base * rng.gen_range(1..100);
-        fake_splits.push(value);
+        *value = base * rng.gen_range(1..100);
     }
     
     Ok(fake_splits)
 }
 
-/// Generates a Bloom filter for fake splits
+/// Generates the Bloom filter marking all fake splits of a transfer
+///
+/// Inserts every hop/split pair in the fake range
+/// `real_splits..real_splits + fake_splits` (see `crate::bloom`).
 pub fn generate_bloom_filter(
     config: &BlackoutConfig,
     _challenge: &[u8; 32],
-) -> [u8; 16] {
-    let mut bloom = [0u8; 16];
+) -> FakeBloom {
+    let mut bloom = [0u8; FAKE_BLOOM_BYTES];
+    let params = BloomParams::FAKE_SPLITS;
+    
+    let first_fake = config.real_splits as u16;
+    let end_fake = (first_fake + config.fake_splits as u16).min(u8::MAX as u16 + 1);
     
-    // For each hop, we mark the fake splits in the bloom filter
     for hop in 0..config.num_hops {
-        for split in config.real_splits..(config.real_splits + config.fake_splits) {
-            // Calculate a position in the filter (deterministic hash function)
-            let position = (((hop as u32) << 16) | (split as u32)) % 128;
-            
-            // Set the corresponding bit
-            let byte_index = position / 8;
-            let bit_index = position % 8;
-            
-            bloom[byte_index as usize] |= 1 << bit_index;
+        for split in first_fake..end_fake {
+            bloom_insert(&mut bloom, &params, hop, split as u8);
         }
     }
     
     bloom
 }
 
-/// Checks if a split is marked as fake in the bloom filter
-pub fn check_bloom_filter(bloom_filter: &[u8; 16], hop_index: u8, split_index: u8) -> bool {
-    // Calculate the position in the filter
-    let position = (((hop_index as u32) << 16) | (split_index as u32)) % 128;
-    
-    // Check if the corresponding bit is set
-    let byte_index = position / 8;
-    let bit_index = position % 8;
-    
-    (bloom_filter[byte_index as usize] & (1 << bit_index)) != 0
+/// Domain tag of a committed fake split leaf (short, so it is a canonical
+/// BN254 scalar)
+const FAKE_LEAF_DOMAIN: &[u8] = b"zeclipse_fake_leaf";
+
+/// Leaf of a committed fake split: `Poseidon(domain, split_key, blinding)`
+///
+/// The blinding is the client's secret for that split (a canonical BN254
+/// scalar); it stays off-chain until `reveal_fake` opens the leaf.
+pub fn fake_split_leaf(
+    hash_ctx: &mut HashContext,
+    hop_index: u8,
+    split_index: u8,
+    blinding: &[u8; 32],
+) -> Result<[u8; 32]> {
+    hash_ctx.hash(&[FAKE_LEAF_DOMAIN, &split_key(hop_index, split_index).to_be_bytes(), blinding])
 }
 
-/// Calculates the hash for a proof using Poseidon for better ZK-friendliness
-/// 
-/// Uses the validated BN254X5 Poseidon parameters for consistent ZK-friendly hashing
-fn calculate_proof_hash(proof_data: &[u8; 128], challenge: &[u8; 32]) -> [u8; 32] {
-    // Extract the relevant parts of the data
-    let proof_data_part = {
-        let mut data = [0u8; 32];
-        let source = &proof_data[32..64]; // Use only 32 bytes
-        for (i, &byte) in source.iter().enumerate() {
-            data[i] = byte;
+/// Position of a fake split in the fake split tree (hop-major), `None`
+/// outside the fake range of the layout
+pub fn fake_split_position(config: &BlackoutConfig, hop_index: u8, split_index: u8) -> Option<usize> {
+    (hop_index < config.num_hops && config.is_fake_split_index(split_index)).then(|| {
+        hop_index as usize * config.fake_splits as usize + (split_index - config.real_splits) as usize
+    })
+}
+
+/// Depth of the fake split tree: the smallest one holding all
+/// `num_hops * fake_splits` leaves (at most 8 for 4 x 44)
+pub fn fake_split_tree_depth(config: &BlackoutConfig) -> u8 {
+    let leaves = config.num_hops as usize * config.fake_splits as usize;
+    let mut depth = 0u8;
+    while (1usize << depth) < leaves {
+        depth += 1;
+    }
+    depth
+}
+
+/// Levels of the fake split tree, leaves first (off-chain)
+fn fake_split_levels(
+    hash_ctx: &mut HashContext,
+    config: &BlackoutConfig,
+    blindings: &[[u8; 32]],
+) -> Result<Vec<Vec<[u8; 32]>>> {
+    let count = config.num_hops as usize * config.fake_splits as usize;
+    if blindings.len() != count {
+        msg!("Fake split tree needs {} blindings, got {}", count, blindings.len());
+        return Err(ZEclipseError::InvalidParameters.into());
+    }
+    
+    let mut leaves = vec![[0u8; 32]; 1 << fake_split_tree_depth(config)];
+    for hop_index in 0..config.num_hops {
+        for split_index in config.real_splits..config.real_splits + config.fake_splits {
+            let position = hop_index as usize * config.fake_splits as usize + (split_index - config.real_splits) as usize;
+            leaves[position] = fake_split_leaf(hash_ctx, hop_index, split_index, &blindings[position])?;
         }
-        data
-    };
+    }
     
-    // Use the validated Poseidon implementation
-    match crate::poseidon_validator::generate_zk_hash(&[&proof_data_part, challenge]) {
-        Ok(hash) => hash,
-        Err(_) => {
-            // Fallback to the new Poseidon API
-            let params = get_poseidon_params();
-            let hash_result = hashv(
-                params,
-                Endianness::BigEndian,
-                &[&proof_data_part, challenge]
-            ).expect("Failed to hash proof data with Poseidon");
-            
-    // Prepare inputs - we only use the first 4 commitments (real splits)
-    let mut inputs = Vec::with_capacity(4);
-    for i in 0..4 {
-        inputs.push(&commitments[i][..]);
+    let mut levels = vec![leaves];
+    while levels[levels.len() - 1].len() > 1 {
+        let level = &levels[levels.len() - 1];
+        let mut parents = Vec::with_capacity(level.len() / 2);
+        for pair in level.chunks(2) {
+            parents.push(hash_ctx.hash_pair(&pair[0], &pair[1])?);
+        }
+        levels.push(parents);
+    }
+    Ok(levels)
+}
+
+/// Root of the committed fake split tree
+///
+/// Off-chain helper for clients and tests: leaf `fake_split_position` of
+/// every fake split is its `fake_split_leaf` with `blindings[position]`;
+/// positions past the fake splits are zero. The root is stored in the
+/// transfer state (`fake_root`) when `config_update` fixes the layout.
+pub fn fake_split_root(
+    hash_ctx: &mut HashContext,
+    config: &BlackoutConfig,
+    blindings: &[[u8; 32]],
+) -> Result<[u8; 32]> {
+    let levels = fake_split_levels(hash_ctx, config, blindings)?;
+    Ok(levels[levels.len() - 1][0])
+}
+
+/// Authentication path of one fake split: its siblings from the leaf level up
+/// (off-chain helper, see `fake_split_root`)
+pub fn fake_split_path(
+    hash_ctx: &mut HashContext,
+    config: &BlackoutConfig,
+    blindings: &[[u8; 32]],
+    hop_index: u8,
+    split_index: u8,
+) -> Result<Vec<[u8; 32]>> {
+    let mut position = fake_split_position(config, hop_index, split_index)
+        .ok_or(ZEclipseError::InvalidParameters)?;
+    let levels = fake_split_levels(hash_ctx, config, blindings)?;
+    let mut path = Vec::with_capacity(levels.len() - 1);
+    for level in &levels[..levels.len() - 1] {
+        path.push(level[position ^ 1]);
+        position >>= 1;
+    }
+    Ok(path)
+}
+
+/// Checks the opening of a committed fake split against the stored root
+///
+/// The leaf index is the split's `fake_split_position`, so an opening only
+/// verifies for the hop/split it was built for; its bits select the side of
+/// every sibling in `path`, which must have the depth of the layout's tree.
+/// A malformed opening is an error, a root mismatch returns `Ok(false)`.
+pub fn verify_fake_split_opening(
+    hash_ctx: &mut HashContext,
+    root: &[u8; 32],
+    config: &BlackoutConfig,
+    hop_index: u8,
+    split_index: u8,
+    blinding: &[u8; 32],
+    path: &[[u8; 32]],
+) -> Result<bool> {
+    let mut position = fake_split_position(config, hop_index, split_index)
+        .ok_or(ZEclipseError::InvalidParameters)?;
+    if path.len() != fake_split_tree_depth(config) as usize {
+        msg!("Fake split opening has {} levels, the tree {}", path.len(), fake_split_tree_depth(config));
+        return Err(ZEclipseError::MerkleProofVerificationFailed.into());
     }
     
-    // Use the validated Poseidon implementation
-    if let Ok(hash) = crate::poseidon_validator::generate_zk_hash(&inputs) {
-        return Ok(hash);
+    let mut node = fake_split_leaf(hash_ctx, hop_index, split_index, blinding)?;
+    for sibling in path {
+        node = if position & 1 == 0 {
+            hash_ctx.hash_pair(&node, sibling)?
+        } else {
+            hash_ctx.hash_pair(sibling, &node)?
+        };
+        position >>= 1;
     }
+    Ok(subtle::ConstantTimeEq::ct_eq(&node, root).unwrap_u8() == 1)
+}
+
+/// Checks if a split is marked as fake in the bloom filter (k bit tests)
+#[inline]
+pub fn check_bloom_filter(bloom_filter: &FakeBloom, hop_index: u8, split_index: u8) -> bool {
+    bloom_contains(bloom_filter, &BloomParams::FAKE_SPLITS, hop_index, split_index)
+}
+
+/// Calculates the hash for a proof using Poseidon for better ZK-friendliness
+/// 
+/// Uses the validated BN254X5 Poseidon parameters for consistent ZK-friendly hashing
+#[allow(dead_code)]
+fn calculate_proof_hash(
+    hash_ctx: &mut HashContext,
+    proof_data: &[u8; 128],
+    challenge: &[u8; 32],
+) -> Result<[u8; 32]> {
+    // Only the 32 bytes of the proof body enter the hash
+    let proof_data_part = array_ref!(proof_data, 32, 32);
+    hash_ctx.hash_pair(proof_data_part, challenge)
 }
 
 /// Closes a PDA and returns the rent
@@ -911,6 +1212,7 @@ pub fn calculate_fees(amount: u64, config: &BlackoutConfig) -> Result<(u64, u64)
 /// The implementation uses Poseidon hashing for ZK-friendly verification, ensuring
 /// compatibility with the wider ZK system.
 pub fn verify_merkle_proof(
+    hash_ctx: &mut HashContext,
     proof: &[u8],
     root: &[u8; 32],
     leaf: &Pubkey,
@@ -942,9 +1244,6 @@ pub fn verify_merkle_proof(
     let siblings_start = 1 + direction_bytes;
     let mut current_hash = leaf.to_bytes(); // Start from the leaf
     
-    // Initialize Poseidon parameters for ZK-friendly hashing
-    let params = get_poseidon_params();
-    
     // Traverse the Merkle path from leaf to root
     for level in 0..num_levels {
         // Extract the sibling hash for this level
@@ -956,28 +1255,18 @@ pub fn verify_merkle_proof(
         let bit_idx = level % 8;
         let is_right = (direction_bitfield[byte_idx] & (1 << bit_idx)) != 0;
         
-        // Arrange current and sibling based on direction
-        let mut hash_inputs = Vec::with_capacity(2);
-        
-        if is_right {
+        // Arrange current and sibling based on direction and compute the
+        // parent hash using Poseidon
+        let parent = if is_right {
             // Current node is on the right, sibling on the left
-            hash_inputs.push(sibling as &[u8]);
-            hash_inputs.push(&current_hash[..]);
+            hash_ctx.hash_pair(sibling, &current_hash)?
         } else {
             // Current node is on the left, sibling on the right
-            hash_inputs.push(&current_hash[..]);
-            hash_inputs.push(sibling as &[u8]);
-        }
-        
-        // Compute parent hash using Poseidon
-        let hash_result = hashv(
-            params,
-            Endianness::BigEndian,
-            &hash_inputs
-        ).map_err(|_| ZEclipseError::HashingError)?;
+            hash_ctx.hash_pair(&current_hash, sibling)?
+        };
         
         // Update current hash for next level
-        current_hash = hash_result.to_bytes();
+        current_hash = parent;
     }
     
     // Final verification: check if computed root matches the provided root
@@ -993,10 +1282,197 @@ pub fn verify_merkle_proof(
     Ok(result)
 }
 
+/// Deepest tree a multiproof may cover (256 leaves, 32 bitmap bytes)
+pub const MAX_MULTIPROOF_DEPTH: u8 = 8;
+
+/// Most leaves one multiproof may prove (covers the 6 recipients of a transfer)
+pub const MAX_MULTIPROOF_LEAVES: usize = 16;
+
+/// Length of the leaf position bitmap of a multiproof for a tree of `depth` levels
+#[inline]
+pub const fn multiproof_bitmap_len(depth: u8) -> usize {
+    let width = 1usize << depth;
+    if width < 8 { 1 } else { width / 8 }
+}
+
+/// Merkle leaf of a wallet: `Poseidon(key[..16], key[16..])`
+///
+/// Poseidon only accepts canonical BN254 scalars, which most raw keys are not
+/// (the modulus is below 2^254). Both 128-bit halves always are, so every
+/// wallet has a leaf. The off-chain registry tree uses the same encoding.
+pub fn wallet_leaf(hash_ctx: &mut HashContext, wallet: &Pubkey) -> Result<[u8; 32]> {
+    let key = wallet.to_bytes();
+    let mut high = [0u8; 32];
+    let mut low = [0u8; 32];
+    high[16..].copy_from_slice(&key[..16]);
+    low[16..].copy_from_slice(&key[16..]);
+    hash_ctx.hash_pair(&high, &low)
+}
+
+/// Verifies several leaves of one Merkle tree against a single root
+///
+/// Proof format:
+/// `[depth(1), leaf_bitmap(multiproof_bitmap_len(depth)), siblings(n*32)]`
+///
+/// Bit `i` of the bitmap (byte `i / 8`, LSB first as in `verify_merkle_proof`)
+/// marks leaf position `i`; `leaves` are the proven leaf values (e.g.
+/// `wallet_leaf`) in ascending position order. The siblings are the nodes
+/// the verifier cannot compute itself, level by level from the leaves up and
+/// left to right within a level. Paths that meet share their upper nodes, so every internal node is
+/// hashed exactly once and appears in the proof at most once.
+///
+/// The known nodes of a level live in a fixed stack buffer and are replaced in
+/// place by their parents. Malformed proofs are an error, a root mismatch
+/// returns `Ok(false)`.
+pub fn verify_merkle_multiproof(
+    hash_ctx: &mut HashContext,
+    proof: &[u8],
+    root: &[u8; 32],
+    leaves: &[[u8; 32]],
+) -> Result<bool> {
+    if proof.is_empty() || leaves.is_empty() || leaves.len() > MAX_MULTIPROOF_LEAVES {
+        msg!("Invalid Merkle multiproof: {} bytes for {} leaves", proof.len(), leaves.len());
+        return Err(ZEclipseError::MerkleProofVerificationFailed.into());
+    }
+    
+    let depth = proof[0];
+    if depth > MAX_MULTIPROOF_DEPTH {
+        msg!("Invalid Merkle multiproof: depth {} exceeds {}", depth, MAX_MULTIPROOF_DEPTH);
+        return Err(ZEclipseError::MerkleProofVerificationFailed.into());
+    }
+    
+    let bitmap_len = multiproof_bitmap_len(depth);
+    if proof.len() < 1 + bitmap_len || (proof.len() - 1 - bitmap_len) % 32 != 0 {
+        msg!("Invalid Merkle multiproof: length {} for depth {}", proof.len(), depth);
+        return Err(ZEclipseError::MerkleProofVerificationFailed.into());
+    }
+    let bitmap = &proof[1..1 + bitmap_len];
+    let siblings = &proof[1 + bitmap_len..];
+    let width = 1usize << depth;
+    
+    // Positions beyond the tree width must not be marked (only possible for depth < 3)
+    if width < 8 && bitmap[0] >> width != 0 {
+        msg!("Invalid Merkle multiproof: leaf position outside the tree");
+        return Err(ZEclipseError::MerkleProofVerificationFailed.into());
+    }
+    
+    // 1. Known nodes of the current level as (position, hash), ascending positions
+    let mut nodes = [(0u16, [0u8; 32]); MAX_MULTIPROOF_LEAVES];
+    let mut count = 0;
+    for position in 0..width {
+        if bitmap[position / 8] & (1 << (position % 8)) == 0 {
+            continue;
+        }
+        if count == leaves.len() {
+            msg!("Invalid Merkle multiproof: more positions than {} leaves", leaves.len());
+            return Err(ZEclipseError::MerkleProofVerificationFailed.into());
+        }
+        nodes[count] = (position as u16, leaves[count]);
+        count += 1;
+    }
+    if count != leaves.len() {
+        msg!("Invalid Merkle multiproof: {} positions for {} leaves", count, leaves.len());
+        return Err(ZEclipseError::MerkleProofVerificationFailed.into());
+    }
+    
+    // 2. Replace each level by its parents; a node takes its partner from the
+    //    level if known, otherwise from the next proof sibling
+    let mut next_sibling = 0;
+    for _ in 0..depth {
+        let mut read = 0;
+        let mut write = 0;
+        while read < count {
+            let (position, node) = nodes[read];
+            let parent = if position & 1 == 0 && read + 1 < count && nodes[read + 1].0 == position + 1 {
+                let right = nodes[read + 1].1;
+                read += 2;
+                hash_ctx.hash_pair(&node, &right)?
+            } else {
+                if (next_sibling + 1) * 32 > siblings.len() {
+                    msg!("Invalid Merkle multiproof: missing siblings");
+                    return Err(ZEclipseError::MerkleProofVerificationFailed.into());
+                }
+                let sibling = array_ref![siblings, next_sibling * 32, 32];
+                next_sibling += 1;
+                read += 1;
+                if position & 1 == 0 {
+                    hash_ctx.hash_pair(&node, sibling)?
+                } else {
+                    hash_ctx.hash_pair(sibling, &node)?
+                }
+            };
+            nodes[write] = (position >> 1, parent);
+            write += 1;
+        }
+        count = write;
+    }
+    
+    if next_sibling * 32 != siblings.len() {
+        msg!("Invalid Merkle multiproof: {} unused siblings", siblings.len() / 32 - next_sibling);
+        return Err(ZEclipseError::MerkleProofVerificationFailed.into());
+    }
+    
+    // 3. A single node (the root) is left; constant-time comparison as above
+    let result = subtle::ConstantTimeEq::ct_eq(&nodes[0].1, root).unwrap_u8() == 1;
+    
+    if result {
+        msg!("Merkle multiproof verified {} leaves with {} siblings", leaves.len(), next_sibling);
+    } else {
+        msg!("Merkle multiproof verification failed: root mismatch");
+    }
+    
+    Ok(result)
+}
+
+/// Verifies the complete recipient set of a transfer against its Merkle root
+///
+/// The recipients are the leaves `0..recipients.len()` of the committed tree
+/// (`wallet_leaf`, zero-padded to the next power of two). The multiproof must
+/// be for the smallest tree holding them and mark exactly those positions, so
+/// a valid proof cannot drop or reorder recipients; one proof replaces a
+/// separate path per recipient.
+pub fn verify_recipient_set(
+    hash_ctx: &mut HashContext,
+    proof: &[u8],
+    root: &[u8; 32],
+    recipients: &[Pubkey],
+) -> Result<bool> {
+    if recipients.is_empty() || recipients.len() > MAX_MULTIPROOF_LEAVES || proof.is_empty() {
+        return Err(ZEclipseError::RecipientSetMismatch.into());
+    }
+    
+    let mut depth = 0u8;
+    while (1usize << depth) < recipients.len() {
+        depth += 1;
+    }
+    let bitmap_len = multiproof_bitmap_len(depth);
+    if proof[0] != depth || proof.len() < 1 + bitmap_len {
+        msg!("Recipient multiproof has depth {} for {} recipients", proof[0], recipients.len());
+        return Err(ZEclipseError::RecipientSetMismatch.into());
+    }
+    for (index, &byte) in proof[1..1 + bitmap_len].iter().enumerate() {
+        let marked = recipients.len().saturating_sub(index * 8).min(8);
+        let expected = ((1u16 << marked) - 1) as u8;
+        if byte != expected {
+            msg!("Recipient multiproof does not cover recipients 0..{}", recipients.len());
+            return Err(ZEclipseError::RecipientSetMismatch.into());
+        }
+    }
+    
+    let mut leaves = [[0u8; 32]; MAX_MULTIPROOF_LEAVES];
+    for (leaf, recipient) in leaves.iter_mut().zip(recipients) {
+        *leaf = wallet_leaf(hash_ctx, recipient)?;
+    }
+    verify_merkle_multiproof(hash_ctx, proof, root, &leaves[..recipients.len()])
+}
+
 /// Calculates optimized priority fees based on network utilization and transaction volume
 /// 
 /// This function calculates the optimal priority fees to ensure fast confirmation
 /// of the transaction without causing unnecessary costs.
+///
+/// Static fallback only: the instruction handlers no longer set a price, the
+/// client derives it from `getRecentPrioritizationFees`.
 pub fn calculate_optimized_priority_fees(remaining_hops: u8, cu_limit: u32) -> Result<u64> {
     // Base fee (minimum value)
     let base_fee: u64 = 1_000;
@@ -1021,38 +1497,20 @@ pub fn calculate_optimized_priority_fees(remaining_hops: u8, cu_limit: u32) -> R
     Ok(priority_fee)
 }
 
+/// Stack array of hash inputs for the eight split commitments
+#[inline(always)]
+fn commitment_hash_inputs(commitments: &[[u8; 32]; 8]) -> [&[u8]; 8] {
+    [
+        &commitments[0], &commitments[1], &commitments[2], &commitments[3],
+        &commitments[4], &commitments[5], &commitments[6], &commitments[7],
+    ]
+}
+
 /// Calculates the hash of commitments for efficient verification
 /// 
 /// Uses validated BN254X5 Poseidon parameters for consistent ZK-friendly hashing throughout the codebase
-pub fn poseidon_hash_commitments(commitments: &[[u8; 32]; 8]) -> Result<[u8; 32]> {
-    // Use the validated Poseidon implementation
-    let commitment_slices: Vec<&[u8]> = commitments.iter().map(|c| c.as_slice()).collect();
-    
-    match crate::poseidon_validator::generate_zk_hash(&commitment_slices) {
-        Ok(hash) => Ok(hash),
-        Err(e) => {
-            msg!("Validated Poseidon hash failed for commitments: {}", e);
-            
-            // Fallback zur klassischen Implementierung
-            let poseidon_params = get_poseidon_params();
-            let mut poseidon = Poseidon::new_with_params(poseidon_params).map_err(|e| {
-                msg!("Failed to initialize Poseidon for commitments: {:?}", e);
-                ZEclipseError::HashingError
-            })?;
-
-            poseidon.hash_many_bytes(&commitment_slices).map_err(|e| {
-                msg!("Poseidon hash_many_bytes for commitments failed: {:?}", e);
-                ZEclipseError::HashingError
-            })?;
-            
-            let hash_result = poseidon.get_hash().map_err(|e| {
-                msg!("Failed to get Poseidon hash for commitments: {:?}", e);
-                ZEclipseError::HashingError
-            })?;
-            
-            Ok(hash_result.to_bytes())
-        }
-    }
+pub fn poseidon_hash_commitments(hash_ctx: &mut HashContext, commitments: &[[u8; 32]; 8]) -> Result<[u8; 32]> {
+    hash_ctx.hash(&commitment_hash_inputs(commitments))
 }
 
 /// Executes a batch hop for multiple splits
@@ -1125,254 +1583,106 @@ pub fn execute_batch_hop<'a>(
 
 /// Performs parallel batch hop execution for maximum efficiency
 /// 
-/// This ultra-optimized version uses SIMD-like vectorized operations,
-/// constant time lookups, and maximum parallelization to minimize compute units
-/// and maximize execution speed.
-/// 
-/// Core optimizations:
-/// - Vectorized bloom filter lookups in constant time
-/// - Minimal memory usage through intelligent vector allocation
-/// - Complete parallelization through one-time calculation of all transfers
-/// - Selective execution for fake splits to optimize compute units
-/// - Atomic execution with optimal error handling
+/// Executes the transfers of a batch whose split accounts were already
+/// validated by `batch_validate_pdas`. `split_keys[i]` names the hop/split pair
+/// of `pdas[i]`, so the accounts may come in any (lookup table) order; each
+/// account is classified with the Bloom filter in a single pass:
+/// - real splits receive their amount of the split plan (`plan[hop][split]`)
+/// - primary fake splits receive the rent-exempt minimum of an empty account
+/// - all other fake splits are skipped
+///
+/// A real split below the rent-exempt minimum is rejected: the runtime would
+/// refuse the new account anyway, after the whole batch had been paid for.
+///
+/// Without a Bloom filter (`FAKE_MODE_COMMITTED`) the fake splits exist only
+/// as commitments: the batch carries just the real splits, the lookup is
+/// skipped and any fake split index is rejected.
+///
+/// The lamports move through `LamportTransfers`: every split is credited in
+/// place and the program-owned transfer state is debited once with the total,
+/// so the batch issues no System program CPI.
 pub fn parallel_batch_execution<'a>(
-    state: &'a AccountInfo<'a>,
-    system_program: &'a AccountInfo<'a>,
-    splits: &[u64],
-    pdas: &'a [AccountInfo<'a>],
-    hop_index: u8,
-    _seed: &[u8; 32],
+    program_id: &Pubkey,
+    state: &AccountInfo<'a>,
+    system_program: &AccountInfo<'a>,
+    plan: &SplitPlan,
+    pdas: &[AccountInfo<'a>],
+    split_keys: &[u16],
+    owner: &Pubkey,
+    nonce: u32,
     bump: u8,
-    _program_id: &Pubkey,
-    fake_bloom: &[u8; 16],
+    real_splits: u8,
+    fake_bloom: Option<&FakeBloom>,
 ) -> Result<()> {
     // 1. Pre-validation and error handling (constant time)
-    // Check if sufficient PDAs were provided for the splits
-    let num_pdas = pdas.len();
-    let num_splits = splits.len();
-    
-    if num_pdas == 0 {
-        msg!("Critical error: No PDAs provided for parallel batch hop");
+    if pdas.is_empty() || pdas.len() != split_keys.len() {
+        msg!("Critical error: {} PDAs for {} split keys in batch hop", pdas.len(), split_keys.len());
         return Err(ZEclipseError::InvalidBatchConfiguration.into());
     }
     
-    if num_splits == 0 {
-        msg!("Critical error: No splits provided for parallel batch hop");
-        return Err(ZEclipseError::InvalidBatchConfiguration.into());
-    }
-    
-    // 2. Prepare signing seeds for the transfer state (constant time)
-    // Optimized version with exact size calculation for minimal memory usage
-    let transfer_seeds = &[
+    // 2. Signing seeds of the transfer state
+    let transfer_seeds: &[&[u8]] = &[
         b"transfer".as_ref(),
-        &state.key.to_bytes()[..32],
+        owner.as_ref(),
+        transfer_nonce_seed(&nonce),
         &[bump],
     ];
     
-    // 3. Deterministic capacity calculation for vectors (no reallocation)
-    // We use the exact size to avoid unnecessary reallocations
-    // The formula is based on the optimal ratio of real to fake splits
-    let real_to_fake_ratio = 4; // 4 real splits per hop + 44 fake splits
-    let estimated_fake_splits = num_splits - (num_splits / real_to_fake_ratio);
-    let estimated_real_splits = num_splits / real_to_fake_ratio;
-    
-    // Optimize vector capacities for zero reallocation
-    // Only real splits + the first few fake splits require actual transfers
-    let estimated_transfers = estimated_real_splits + std::cmp::min(estimated_fake_splits, 4);
-    
-    // 4. Batch preparation with optimized memory usage (single-pass)
-    let mut batch_instructions = Vec::with_capacity(estimated_transfers);
-    let mut accounts_list = Vec::with_capacity(estimated_transfers);
-    let mut split_types = Vec::with_capacity(num_splits); // 0=Real, 1=Fake-Primary, 2=Fake-Secondary
-    let mut total_transferred: u64 = 0;
+    // The transfer state is owned by the program and is debited directly
+    let mut transfers = LamportTransfers::new(program_id, state, system_program, transfer_seeds)?;
     let mut total_real_splits: u32 = 0;
     let mut total_fake_primary: u32 = 0;
     let mut total_fake_secondary: u32 = 0;
     
-    // 5. Preparation of all transfers in a single pass (vectorized)
-    for (i, pda) in pdas.iter().enumerate() {
-        // Combined index validation (constant time)
-        if i >= num_splits {
-            continue; // Safe skip on overflow
-        }
-        
-        // Extract amount atomically (no bounds checks needed due to previous validation)
-        let amount = unsafe { *splits.get_unchecked(i) };
-        
-        // Skip for empty splits (optimized path for common case)
-        if amount == 0 {
-            split_types.push(2); // Mark as fake-secondary
-            total_fake_secondary += 1;
-            continue;
-        }
+    // 3. Classification and transfer in a single pass
+    for (pda, &key) in pdas.iter().zip(split_keys.iter()) {
+        let (hop_index, split_index) = split_key_parts(key);
         
-        // Constant time bloom filter lookup with bitwise operations
-        // Optimized for maximum efficiency with 48 splits (4 real + 44 fake)
-        let is_fake = check_bloom_filter(fake_bloom, hop_index, i as u8);
-        
-        // Determine and log split type for later parallelization
-        let (split_type, actual_amount) = if is_fake {
-            // Optimization strategy: 
-            // - The first 4 fake splits get minimal amounts (100 Lamports) - Primary Fakes
-            // - All other fake splits get 0 Lamports (no transaction) - Secondary Fakes
-            if total_fake_primary < 4 {
+        // Constant time bloom filter lookup (k bit tests); committed fakes
+        // have no account, so every split must be a real one
+        let is_fake = match fake_bloom {
+            Some(bloom) => check_bloom_filter(bloom, hop_index, split_index),
+            None if split_index >= real_splits => {
+                msg!("Hop {} split {} is a committed fake split without an account", hop_index, split_index);
+                return Err(ZEclipseError::InvalidBatchConfiguration.into());
+            }
+            None => false,
+        };
+        let amount = if is_fake {
+            if is_primary_fake(split_index, real_splits) {
                 total_fake_primary += 1;
-                (1, 100) // Primary fake with minimal amount
+                transfers.rent_exempt_minimum(pda)
             } else {
                 total_fake_secondary += 1;
-                (2, 0)   // Secondary fake without transfer
+                0
             }
         } else {
-            // Real split with full amount
-            total_real_splits += 1;
-            total_transferred += amount;
-            (0, amount)
+            let amount = plan
+                .get(hop_index as usize)
+                .and_then(|splits| splits.get(split_index as usize))
+                .copied()
+                .unwrap_or(0);
+            if amount > 0 {
+                total_real_splits += 1;
+            }
+            amount
         };
         
-        // Add split type to the list (for statistical evaluation)
-        split_types.push(split_type);
-        
-        // Skip zero transfers for maximum compute efficiency
-        if actual_amount == 0 {
-            continue;
-        }
-        
-        // Atomically prepare instruction and accounts for this transfer
-        let transfer_ix = system_instruction::transfer(
-            state.key,
-            pda.key,
-            actual_amount,
-        );
-        
-        // Optimized account list with minimal clones
-        batch_instructions.push(transfer_ix);
-        accounts_list.push([
-            state.clone(),
-            pda.clone(),
-            system_program.clone(),
-        ]);
+        // Zero amounts are skipped by the transfer engine
+        transfers.transfer(pda, amount).map_err(|e| {
+            msg!("Split transfer to hop {} split {} failed", hop_index, split_index);
+            e
+        })?;
     }
     
-    // 6. Statistics logging before execution (important for diagnostics)
-    let efficiency_percent = if total_real_splits > 0 {
-        // Calculated efficiency based on the ratio of real to fake splits
-        let total_splits = total_real_splits + total_fake_primary + total_fake_secondary;
-        (total_real_splits * 100) / total_splits
-    } else {
-        0
-    };
+    // 4. One debit of the transfer state for all splits (rent reserve kept)
+    let total_transferred = transfers.finish()?;
     
+    // 5. Statistics logging (important for diagnostics)
     msg!("Split statistics: {} real splits, {} primary fake splits, {} secondary fake splits",
          total_real_splits, total_fake_primary, total_fake_secondary);
-    msg!("Parallel batch processing with {}% compute efficiency, {} transfers prepared",
-         efficiency_percent, batch_instructions.len());
-    
-    // 7. Parallelized execution of all transfers in an optimized loop
-    // Setup for compute statistics
-    // let compute_start = solana_program::log::compute_units_remaining();
-    let mut successful_transfers = 0;
-    
-    // Atomic execution of all transfers in one block
-    for (idx, (transfer_ix, accounts)) in batch_instructions.iter().zip(accounts_list.iter()).enumerate() {
-        // Performant error handling with specific error messages
-        match invoke_signed(
-            transfer_ix,
-            accounts,
-            &[transfer_seeds],
-        ) {
-            Ok(_) => {
-                successful_transfers += 1;
-                
-                // Efficiency: Minimal logs only for important transfers 
-                // (Reduces compute units through selective logging)
-                if idx < total_real_splits as usize {
-                    // Extract the amount directly from the transfer instruction
-                    // For SystemInstruction, the program type and data must be parsed
-                    let split_amount = if transfer_ix.program_id == system_program::id() {
-                        if let Ok(system_instruction::SystemInstruction::Transfer { lamports }) = 
-                            bincode::deserialize(&transfer_ix.data) {
-                            lamports
-                        } else {
-                            0
-                        }
-                    } else if let Some(account) = pda_account {
-                        // For non-transfer instructions, handle programmatically based on instruction type
-                        let account_data_len = account.data_len();
-                        
-                        // Inspect the PDA account data to determine what kind of instruction this is
-                        if account_data_len >= 8 {
-                            let discriminator = array_ref![account.try_borrow_data()?.as_ref(), 0, 8];
-                            
-                            // Match the instruction discriminator to handle different types
-                            match discriminator {
-                                // Refund instruction discriminator
-                                [242, 35, 198, 137, 82, 225, 242, 182] => {
-                                    // Process refund logic - extract refund amount from account data
-                                    if account_data_len >= 16 {
-                                        let amount_bytes = array_ref![account.try_borrow_data()?.as_ref(), 8, 8];
-                                        u64::from_le_bytes(*amount_bytes)
-                                    } else { 0 }
-                                },
-                                // Split execution instruction discriminator 
-                                [67, 159, 234, 103, 226, 156, 49, 40] => {
-                                    // Process split execution - extract split amount
-                                    let data = account.try_borrow_data()?;
-                                    if data.len() >= 16 {
-                                        // Extract configured amount based on protocol specification
-                                        u64::from_le_bytes(*array_ref![data.as_ref(), 8, 8])
-                                    } else { 0 }
-                                },
-                                // Fee collection instruction
-                                [189, 120, 34, 251, 137, 116, 88, 204] => {
-                                    // Process fee logic - extract fee amount
-                                    account.lamports()
-                                },
-                                // Default case for any other instruction discriminator
-                                _ => account.lamports()
-                            }
-                        } else {
-                            // If account data is too small for a discriminator, use the account's lamports
-                            account.lamports()
-                        }
-                    } else {
-                        // Fallback if no account information available
-                        0
-                    };
-                    msg!("Real split {} successful: {} Lamports", idx, split_amount);
-                }
-            },
-            Err(e) => {
-                // Detailed error diagnosis with index information
-                let split_type = if idx < split_types.len() {
-                    match split_types[idx] {
-                        0 => "Real",
-                        1 => "Fake-Primary",
-                        _ => "Fake-Secondary"
-                    }
-                } else {
-                    "Unknown"
-                };
-                
-                msg!("Split transfer {} (Type: {}) failed: {:?}", idx, split_type, e);
-                return Err(ZEclipseError::SplitTransferFailed.into());
-            }
-        }
-    }
+    msg!("Parallel batch hop successful: {} transfers, {} Lamports transferred",
+         total_real_splits + total_fake_primary, total_transferred);
     
-    // 8. Optimized performance analysis and final logging
-    // let compute_used = compute_start - solana_program::log::compute_units_remaining();
-    let compute_per_transfer = if successful_transfers > 0 {
-        // compute_used / successful_transfers
-        0
-    } else {
-        0
-    };
-    
-    msg!("Parallel batch hop successful: {} of {} transfers executed", 
-         successful_transfers, batch_instructions.len());
-    msg!("Total transferred: {} Lamports, Performance: {} CU/Transfer", 
-         total_transferred, compute_per_transfer);
-    
-    // Validated return after successful processing
     Ok(())
-}
\ No newline at end of file
+}
@@ -123,11 +123,20 @@ pub fn extract_split_amount(proof: &[u8]) -> Result<u64> {
     Ok(1000) // Example value
 }
 
-/// Derives a stealth PDA
-pub fn derive_stealth_pda(seeds: &[&[u8]]) -> Pubkey {
-    let (pda, _bump) = Pubkey::find_program_address(
-        seeds,
+/// Derives a stealth PDA using the canonical split seed scheme
+/// (see `crate::stealth_pda`)
+pub fn derive_stealth_pda(
+    seed: &[u8; 32],
+    hop_index: u8,
+    split_index: u8,
+    is_fake: bool,
+) -> Pubkey {
+    let (pda, _bump) = crate::stealth_pda::find_stealth_pda(
         &crate::id(),
+        seed,
+        hop_index,
+        split_index,
+        is_fake,
     );
     pda
 }
@@ -274,9 +283,10 @@ mod tests {
 
     #[test]
     fn test_derive_stealth_pda() {
-        let seeds: &[&[u8]] = &[b"test_seed"];
-        let pda = derive_stealth_pda(seeds);
+        let seed = [1u8; 32];
+        let pda = derive_stealth_pda(&seed, 0, 0, false);
         assert!(pda != Pubkey::default());
+        assert_eq!(pda, crate::stealth_pda::find_stealth_pda(&crate::id(), &seed, 0, 0, false).0);
     }
 
     #[test]
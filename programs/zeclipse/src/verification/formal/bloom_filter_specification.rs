@@ -8,6 +8,7 @@
 
 use crate::state::config::BlackoutConfig;
 use crate::utils::{check_bloom_filter, generate_bloom_filter};
+use crate::bloom::BloomParams;
 use std::cmp::{max, min};
 
 /// Formal specification for the Bloom filter implementation
@@ -138,34 +139,67 @@ impl BloomFilterSpecification {
             set_bits += byte.count_ones();
         }
         
-        // Apply the same safety limits as in the actual implementation
-        let max_hops = 16u8;
-        let max_splits = 64u8;
-        
-        // Apply safety bounds to configuration values
-        let safe_num_hops = min(config.num_hops, max_hops);
-        let safe_real_splits = min(config.real_splits, max_splits);
-        let safe_fake_splits = min(config.fake_splits, max_splits - safe_real_splits);
+        let params = BloomParams::FAKE_SPLITS;
+        let fake_entries = Self::fake_entry_count(config);
         
-        // For our filter size, we expect a reasonable distribution of set bits
-        // Too few or too many set bits suggests a poor distribution
-        let total_bits = bloom_filter.len() * 8;
-        
-        // Calculate actual fake entries based on safety-bounded values
-        let fake_entries = safe_fake_splits as u32 * safe_num_hops as u32;
+        // Each entry sets at most k bits; with uniform hashing the expected number
+        // of set bits is m * (1 - e^(-k * n / m))
+        let total_bits = params.bits as f64;
+        let expected_bits = total_bits
+            * (1.0 - (-(params.hashes as f64) * fake_entries as f64 / total_bits).exp());
         
         // Allow for some variation, but detect grossly wrong bit counts
         // that would indicate a malfunction or poor distribution
-        
-        // Lower bound: at least fake_entries/4 bits should be set (allowing for more collisions)
-        // Upper bound: at most min(fake_entries*2, total_bits/2) bits should be set
-        let lower_bound = if fake_entries > 0 { fake_entries / 4 } else { 0 };
-        let upper_bound = min(fake_entries * 2, total_bits as u32 / 2);
+        let lower_bound = (expected_bits / 2.0) as u32;
+        let upper_bound = min(fake_entries * params.hashes as u32, params.bits);
         
         println!("Bit distribution test: Set bits: {}, Expected range: {}..={}", set_bits, lower_bound, upper_bound);
         
         (lower_bound..=upper_bound).contains(&set_bits)
     }
+    
+    /// Verify the false-positive bound
+    /// The expected false-positive rate for the configured number of fake entries
+    /// must not exceed `max_rate`, and the rate measured over every non-member
+    /// hop/split pair must stay within twice the expected rate
+    pub fn verify_false_positive_bound(config: &BlackoutConfig, challenge: &[u8; 32], max_rate: f64) -> bool {
+        let bloom_filter = generate_bloom_filter(config, challenge);
+        let params = BloomParams::FAKE_SPLITS;
+        
+        let expected_rate = params.false_positive_rate(Self::fake_entry_count(config));
+        if expected_rate > max_rate {
+            println!("Expected false-positive rate {:.5} exceeds bound {:.5}", expected_rate, max_rate);
+            return false;
+        }
+        
+        let mut probes = 0u32;
+        let mut false_positives = 0u32;
+        for hop_idx in 0..=u8::MAX {
+            for split_idx in 0..=u8::MAX {
+                if (hop_idx as usize) < config.num_hops as usize
+                    && Self::is_fake_split(hop_idx as usize, split_idx as usize, config) {
+                    continue;
+                }
+                probes += 1;
+                if check_bloom_filter(&bloom_filter, hop_idx, split_idx) {
+                    false_positives += 1;
+                }
+            }
+        }
+        
+        let measured_rate = false_positives as f64 / probes as f64;
+        println!("False-positive rate: measured {:.5}, expected {:.5}, bound {:.5}",
+                 measured_rate, expected_rate, max_rate);
+        
+        measured_rate <= 2.0 * expected_rate + 1.0 / probes as f64
+    }
+    
+    /// Number of entries inserted into the filter for a configuration
+    fn fake_entry_count(config: &BlackoutConfig) -> u32 {
+        let real = config.real_splits as u32;
+        let fake = min(config.fake_splits as u32, 256 - real);
+        config.num_hops as u32 * fake
+    }
 }
 
 /// Formal verification test harness
@@ -222,4 +256,19 @@ mod verification_tests {
         let challenge = [0; 32];
         assert!(BloomFilterSpecification::verify_bit_distribution(&config, &challenge));
     }
+    
+    #[test]
+    fn test_false_positive_bound() {
+        // Default layout: 4 hops x 44 fake splits in 2048 bits with 7 hashes
+        let config = BlackoutConfig::new();
+        let challenge = [0; 32];
+        assert!(BloomFilterSpecification::verify_false_positive_bound(&config, &challenge, 0.01));
+        
+        // A saturated filter must be rejected
+        let overloaded = BlackoutConfig {
+            num_hops: 64,
+            ..BlackoutConfig::new()
+        };
+        assert!(!BloomFilterSpecification::verify_false_positive_bound(&overloaded, &challenge, 0.01));
+    }
 }
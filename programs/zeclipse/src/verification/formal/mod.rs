@@ -35,15 +35,18 @@ pub fn verify_all() -> bool {
     let no_false_negatives = BloomFilterSpecification::verify_no_false_negatives(&config, &challenge);
     let overflow_safety = BloomFilterSpecification::verify_overflow_safety();
     let bit_distribution = BloomFilterSpecification::verify_bit_distribution(&config, &challenge);
+    let false_positive_bound = BloomFilterSpecification::verify_false_positive_bound(&config, &challenge, 0.01);
     
     // Log verification results
     println!("Bloom Filter Consistency: {}", if consistency_check { "PASS" } else { "FAIL" });
     println!("Bloom Filter No False Negatives: {}", if no_false_negatives { "PASS" } else { "FAIL" });
     println!("Bloom Filter Overflow Safety: {}", if overflow_safety { "PASS" } else { "FAIL" });
     println!("Bloom Filter Bit Distribution: {}", if bit_distribution { "PASS" } else { "FAIL" });
+    println!("Bloom Filter False-Positive Bound: {}", if false_positive_bound { "PASS" } else { "FAIL" });
     
     // Overall verification status
-    let all_passed = consistency_check && no_false_negatives && overflow_safety && bit_distribution;
+    let all_passed = consistency_check && no_false_negatives && overflow_safety && bit_distribution
+        && false_positive_bound;
     
     println!("Formal verification complete: {}", if all_passed { "ALL CHECKS PASSED" } else { "VERIFICATION FAILED" });
     
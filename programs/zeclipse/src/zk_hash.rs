@@ -0,0 +1,115 @@
+//! Single entry point for Poseidon hashing
+//!
+//! `zk_hash` is the only place the program computes a Poseidon digest; the
+//! backend is selected at compile time:
+//! - on SBF (`target_os = "solana"`) the `sol_poseidon` syscall is invoked
+//!   directly on the caller's input slices, nothing is copied or allocated
+//! - on the host the same BN254/x^5 parameters are evaluated by the pure-Rust
+//!   implementation behind `solana_poseidon` (the one the validator runs for
+//!   the syscall), so both backends produce identical digests
+//!
+//! There is no runtime fallback. A backend error is reported as
+//! `HashingError` instead of being retried with a second implementation, so
+//! every hash is paid for exactly once.
+
+use anchor_lang::prelude::*;
+use solana_poseidon::{Endianness, Parameters};
+use crate::errors::ZEclipseError;
+
+/// Parameter set used for all ZK hashing in the program
+pub const HASH_PARAMETERS: Parameters = Parameters::Bn254X5;
+
+/// Byte order of hash inputs and outputs
+pub const HASH_ENDIANNESS: Endianness = Endianness::BigEndian;
+
+/// Maximum number of inputs per Poseidon hash (state width 13)
+pub const MAX_HASH_INPUTS: usize = 12;
+
+/// Name of the compiled-in backend (for logs and tooling)
+#[cfg(target_os = "solana")]
+pub const ZK_HASH_BACKEND: &str = "sol_poseidon syscall";
+
+/// Name of the compiled-in backend (for logs and tooling)
+#[cfg(not(target_os = "solana"))]
+pub const ZK_HASH_BACKEND: &str = "host poseidon";
+
+/// Hashes 1 to `MAX_HASH_INPUTS` inputs of at most 32 bytes each
+///
+/// Every input must be a canonical BN254 scalar in big-endian encoding.
+#[inline]
+pub fn zk_hash(inputs: &[&[u8]]) -> Result<[u8; 32]> {
+    if inputs.is_empty() || inputs.len() > MAX_HASH_INPUTS {
+        msg!("Invalid number of Poseidon inputs: {}", inputs.len());
+        return Err(ZEclipseError::HashingError.into());
+    }
+    backend::hash(inputs)
+}
+
+#[cfg(target_os = "solana")]
+mod backend {
+    use super::*;
+
+    #[inline(always)]
+    pub(super) fn hash(inputs: &[&[u8]]) -> Result<[u8; 32]> {
+        let mut digest = [0u8; 32];
+        // SAFETY: `inputs` is a valid slice of byte slices and `digest` has the
+        // 32 bytes the syscall writes
+        let status = unsafe {
+            solana_program::syscalls::sol_poseidon(
+                u64::from(HASH_PARAMETERS),
+                u64::from(HASH_ENDIANNESS),
+                inputs as *const _ as *const u8,
+                inputs.len() as u64,
+                &mut digest as *mut _ as *mut u8,
+            )
+        };
+        if status != 0 {
+            msg!("Poseidon syscall failed: {}", status);
+            return Err(ZEclipseError::HashingError.into());
+        }
+        Ok(digest)
+    }
+}
+
+#[cfg(not(target_os = "solana"))]
+mod backend {
+    use super::*;
+    use solana_poseidon::hashv;
+
+    #[inline(always)]
+    pub(super) fn hash(inputs: &[&[u8]]) -> Result<[u8; 32]> {
+        hashv(HASH_PARAMETERS, HASH_ENDIANNESS, inputs)
+            .map(|hash| hash.to_bytes())
+            .map_err(|e| {
+                msg!("Poseidon hash failed: {:?}", e);
+                ZEclipseError::HashingError.into()
+            })
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_known_vector() {
+        let mut input = [0u8; 32];
+        input[31] = 0x42;
+
+        let digest = zk_hash(&[&input]).unwrap();
+        assert_eq!(
+            hex::encode(digest),
+            "011e70075d2f41deacf19a385a674c5a2582d52b83d05f42a27bdf19dd352433"
+        );
+    }
+
+    #[test]
+    fn test_invalid_inputs_are_rejected() {
+        let input = [0u8; 32];
+        assert!(zk_hash(&[]).is_err());
+        assert!(zk_hash(&[&input[..]; MAX_HASH_INPUTS + 1]).is_err());
+        // Larger than 32 bytes and not a canonical field element
+        assert!(zk_hash(&[&[1u8; 33][..]]).is_err());
+        assert!(zk_hash(&[&[0xFFu8; 32][..]]).is_err());
+    }
+}
@@ -6,6 +6,7 @@
  */
 
 use zeclipse::utils::{check_bloom_filter, generate_bloom_filter};
+use zeclipse::bloom::FAKE_BLOOM_BYTES;
 use zeclipse::state::config::BlackoutConfig;
 
 /// Test für Bloom-Filter-Generierung mit extremen Konfigurationswerten
@@ -51,9 +52,9 @@ fn test_bloom_filter_extreme_configs() {
     println!("Unausgewogene Konfiguration Filter: {}", hex::encode(&filter3));
     
     // Validiere, dass die Filter die richtige Größe haben
-    assert_eq!(filter1.len(), 16, "Bloom-Filter sollte immer 16 Bytes lang sein");
-    assert_eq!(filter2.len(), 16, "Bloom-Filter sollte immer 16 Bytes lang sein");
-    assert_eq!(filter3.len(), 16, "Bloom-Filter sollte immer 16 Bytes lang sein");
+    assert_eq!(filter1.len(), FAKE_BLOOM_BYTES, "Bloom-Filter sollte immer FAKE_BLOOM_BYTES lang sein");
+    assert_eq!(filter2.len(), FAKE_BLOOM_BYTES, "Bloom-Filter sollte immer FAKE_BLOOM_BYTES lang sein");
+    assert_eq!(filter3.len(), FAKE_BLOOM_BYTES, "Bloom-Filter sollte immer FAKE_BLOOM_BYTES lang sein");
     
     // Prüfe, dass unterschiedliche Konfigurationen unterschiedliche Filter erzeugen
     assert_ne!(filter1, filter2, "Unterschiedliche Konfigurationen sollten unterschiedliche Filter erzeugen");
@@ -101,10 +102,10 @@ fn test_bloom_filter_consistency() {
     println!("Teste Konsistenz der Bloom-Filter-Überprüfung...");
     
     // Filter mit bestimmten bit-patterns erstellen
-    let all_zeros = [0u8; 16];
-    let all_ones = [255u8; 16];
-    let mut alternating = [0u8; 16];
-    for i in 0..16 {
+    let all_zeros = [0u8; FAKE_BLOOM_BYTES];
+    let all_ones = [255u8; FAKE_BLOOM_BYTES];
+    let mut alternating = [0u8; FAKE_BLOOM_BYTES];
+    for i in 0..FAKE_BLOOM_BYTES {
         if i % 2 == 0 {
             alternating[i] = 0xAA; // 10101010
         } else {
@@ -6,6 +6,7 @@
  */
 
 use zeclipse::utils::{check_bloom_filter, generate_bloom_filter};
+use zeclipse::bloom::{FakeBloom, FAKE_BLOOM_BYTES};
 use zeclipse::state::config::BlackoutConfig;
 use std::collections::HashSet;
 use std::time::Instant;
@@ -58,7 +59,7 @@ fn fuzz_bloom_filter_generation() {
         let duration = start.elapsed();
         
         // Überprüfe grundlegende Eigenschaften
-        assert_eq!(filter.len(), 16, "Filter sollte immer 16 Bytes lang sein");
+        assert_eq!(filter.len(), FAKE_BLOOM_BYTES, "Filter sollte immer FAKE_BLOOM_BYTES lang sein");
         
         // Protokolliere den Hash des Filters zur Überprüfung der Einzigartigkeit
         let filter_hash = format!("{:?}", filter);
@@ -105,7 +106,7 @@ fn fuzz_bloom_filter_checking() {
     ];
     
     let challenge = [0u8; 32];
-    let known_filters: Vec<[u8; 16]> = known_configs.iter()
+    let known_filters: Vec<FakeBloom> = known_configs.iter()
         .map(|config| generate_bloom_filter(config, &challenge))
         .collect();
     
@@ -119,8 +120,8 @@ fn fuzz_bloom_filter_checking() {
             known_filters[rng.gen_range(0..known_filters.len())]
         } else {
             // Generiere einen neuen zufälligen Filter (80% der Fälle)
-            let mut random_filter = [0u8; 16];
-            rng.fill(&mut random_filter);
+            let mut random_filter = [0u8; FAKE_BLOOM_BYTES];
+            rng.fill(&mut random_filter[..]);
             random_filter
         };
         
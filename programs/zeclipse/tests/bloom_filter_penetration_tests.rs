@@ -6,6 +6,7 @@
  */
 
 use zeclipse::utils::{check_bloom_filter, generate_bloom_filter};
+use zeclipse::bloom::{element_key, FAKE_BLOOM_BYTES};
 use zeclipse::state::config::BlackoutConfig;
 use std::collections::HashSet;
 
@@ -50,7 +51,7 @@ fn test_bloom_filter_overflow_resistance() {
         let filter = generate_bloom_filter(config, &challenge);
         
         // Überprüfe, ob der Filter die richtige Länge hat
-        assert_eq!(filter.len(), 16, "Filter sollte immer 16 Bytes lang sein");
+        assert_eq!(filter.len(), FAKE_BLOOM_BYTES, "Filter sollte immer FAKE_BLOOM_BYTES lang sein");
         
         // Versuche einige Überprüfungen, um sicherzustellen, dass der Filter 
         // konsistent funktioniert
@@ -89,8 +90,8 @@ fn test_bloom_filter_collision_resistance() {
             if check_bloom_filter(&filter, hop, split) {
                 fake_indices.push((hop, split));
                 
-                // Berechne Position im Filter
-                let position = ((hop as u32) << 8 | split as u32) % 128;
+                // Element-Schlüssel im Filter
+                let position = element_key(hop, split);
                 positions_set.insert(position);
                 
                 println!("Fake-Split gefunden: hop={}, split={}, position={}", 
@@ -217,21 +218,21 @@ fn test_bloom_filter_tampering_resistance() {
     // Manipuliere den Filter auf verschiedene Weise
     let manipulations = [
         // Alle Bits auf 0 setzen
-        [0u8; 16],
+        [0u8; FAKE_BLOOM_BYTES],
         // Alle Bits auf 1 setzen
-        [255u8; 16],
+        [255u8; FAKE_BLOOM_BYTES],
         // Einzelne Bits umkehren
         {
             let mut f = filter;
-            // Invertiere das erste Byte
-            f[0] = !f[0];
+            // Invertiere das erste belegte Byte
+            let first_used = f.iter().position(|&b| b != 0).unwrap();
+            f[first_used] = !f[first_used];
             f
         },
-        // Bytes vertauschen
+        // Bytes verschieben
         {
             let mut f = filter;
-            f.swap(0, 15);
-            f.swap(1, 14);
+            f.rotate_left(1);
             f
         }
     ];
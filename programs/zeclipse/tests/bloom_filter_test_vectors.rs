@@ -6,6 +6,7 @@
  */
 
 use zeclipse::utils::{check_bloom_filter, generate_bloom_filter};
+use zeclipse::bloom::FAKE_BLOOM_BYTES;
 use zeclipse::state::config::BlackoutConfig;
 
 /// Test für die Generierung von Bloom-Filtern
@@ -33,7 +34,7 @@ fn test_bloom_filter_generation() {
     assert_ne!(filter1, filter2, "Unterschiedliche Konfigurationen sollten unterschiedliche Filter erzeugen");
     
     // Überprüfe, dass die Filter die richtige Länge haben
-    assert_eq!(filter1.len(), 16, "Bloom-Filter sollte 16 Bytes lang sein");
+    assert_eq!(filter1.len(), FAKE_BLOOM_BYTES, "Bloom-Filter sollte FAKE_BLOOM_BYTES lang sein");
     
     println!("✅ Bloom-Filter-Generierungstest bestanden!");
 }
@@ -31,13 +31,12 @@ mod common {
     pub const NUM_SPLITS: u8 = 4;
     
     // Generiert Testdaten
-    pub fn generate_test_data() -> ([u8; 128], [u8; 128], [u8; 32], Vec<u8>) {
+    pub fn generate_test_data() -> ([u8; 128], [u8; 128], [u8; 32]) {
         let hyperplonk_proof = [42u8; 128];
         let range_proof = [43u8; 128];
         let challenge = [44u8; 32];
-        let merkle_proof = vec![45u8; 64];
         
-        (hyperplonk_proof, range_proof, challenge, merkle_proof)
+        (hyperplonk_proof, range_proof, challenge)
     }
     
     // Erstellt einen TransferState mit zufälligen Werten
@@ -121,7 +120,7 @@ async fn test_e2e_zeclipse_flow() {
     let (mut banks_client, payer, recent_blockhash) = program_test.start().await;
     
     // 5. Testdaten generieren
-    let (hyperplonk_proof, range_proof, challenge, merkle_proof) = generate_test_data();
+    let (hyperplonk_proof, range_proof, challenge) = generate_test_data();
     
     // ----------------------------------------
     // Schritt 1: Initialisierung
@@ -136,7 +135,6 @@ async fn test_e2e_zeclipse_flow() {
         hyperplonk_proof,
         range_proof,
         challenge,
-        merkle_proof,
     );
     
     let initialize_tx = Transaction::new_signed_with_payer(
@@ -173,7 +171,6 @@ async fn test_e2e_zeclipse_flow() {
         &first_pda,
         0, // Hop-Index
         hop_data,
-        range_proof,
     );
     
     let execute_hop_tx = Transaction::new_signed_with_payer(
@@ -272,7 +269,7 @@ async fn test_e2e_zeclipse_flow() {
         .expect("Account nicht gefunden");
     
     let state = transfer::TransferState::try_deserialize(&mut transfer_account.data.as_slice()).unwrap();
-    assert!(state.completed, "Transfer sollte als abgeschlossen markiert sein");
+    assert!(state.is_completed(), "Transfer sollte als abgeschlossen markiert sein");
     
     // Überprüfe, ob der Empfänger die Gelder erhalten hat
     let recipient_account = banks_client
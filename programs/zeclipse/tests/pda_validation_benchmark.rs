@@ -125,6 +125,7 @@ fn benchmark_pda_validation() {
                 // Fallback zur Bloom-Filter-Validierung
                 let _ = verify_bloom_filter(
                     &bloom_filter,
+                    &config,
                     hop_index,
                     split_index
                 );
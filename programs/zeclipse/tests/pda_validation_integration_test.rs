@@ -10,6 +10,7 @@
 use anchor_lang::error::Error;
 use zeclipse::state::transfer::TransferState;
 use zeclipse::utils::check_bloom_filter;
+use zeclipse::batch_plan::split_key;
 use solana_program::pubkey::Pubkey;
 use solana_program_test::*;
 use solana_sdk::signature::Keypair;
@@ -154,9 +155,15 @@ async fn test_pda_validation_integration() -> Result<(), TransportError> {
     
     // Batch-Hop ausführen und Erfolg überprüfen
     let start = Instant::now();
+    let split_keys = [
+        split_key(real_hop_index, real_split_index),
+        split_key(fake_hop_index, fake_split_index),
+    ];
     let batch_result = framework.execute_batch_hop(
         &transfer_pda,
         0, // Batch-Index
+        2, // Hops 0 und 1
+        &split_keys,
         &pdas
     ).await;
     let duration = start.elapsed();
@@ -176,6 +176,7 @@ async fn test_fake_split_validation() {
     // 7. Bloom-Filter-Validierung durchführen
     let bloom_validation = verify_bloom_filter(
         &bloom_filter,
+        &config,
         hop_index,
         split_index
     );
@@ -253,6 +254,7 @@ async fn test_dual_path_validation_strategy() {
             // Fallback zur Bloom-Filter-Validierung
             verify_bloom_filter(
                 &bloom_filter,
+                &config,
                 hop_index,
                 split_index
             ).unwrap_or(false)
@@ -306,6 +308,7 @@ async fn test_dual_path_validation_strategy() {
             // Fallback zur Bloom-Filter-Validierung
             verify_bloom_filter(
                 &bloom_filter,
+                &config,
                 hop_index,
                 split_index
             ).unwrap_or(false)
@@ -74,3 +74,25 @@ fn test_poseidon_hash_multiple_inputs() {
 }
 
 
+// Bekannte Digests (circomlib-Poseidon über BN254, x^5, Big-Endian); der
+// Verifier in tools/verifier prüft seine Worker gegen dieselben Werte
+#[test]
+fn test_poseidon_known_digests() {
+    let zero = [0u8; 32];
+    let mut one = [0u8; 32];
+    one[31] = 1;
+    let mut two = [0u8; 32];
+    two[31] = 2;
+
+    let vectors: [(&[&[u8]], &str); 4] = [
+        (&[&zero], "2a09a9fd93c590c26b91effbb2499f07e8f7aa12e2b4940a3aed2411cb65e11c"),
+        (&[&one], "29176100eaa962bdc1fe6c654d6a3c130e96a4d1168b33848b897dc502820133"),
+        (&[&zero, &zero], "2098f5fb9e239eab3ceac3f27b81e481dc3124d55ffed523a839ee8446b64864"),
+        (&[&one, &two], "115cc0f5e7d690413df64c6b9662e9cf2a3617f2743245519e19607a4417189a"),
+    ];
+
+    for (inputs, expected) in vectors {
+        let hash = hashv(Parameters::Bn254X5, Endianness::BigEndian, inputs).unwrap();
+        assert_eq!(hex::encode(hash.to_bytes()), expected);
+    }
+}
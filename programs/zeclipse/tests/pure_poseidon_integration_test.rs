@@ -79,7 +79,7 @@ mod integration_tests {
     /// Testet die Hex-Konvertierung mit verschiedenen Eingabeformaten
     #[test]
     fn test_hex_conversions() {
-        use zeclipse::pure_poseidon::constants::scalar_from_hex;
+        use zeclipse::pure_poseidon::constants::field_from_hex;
         
         // Validiere verschiedene Hex-Formate
         let test_cases = [
@@ -89,7 +89,7 @@ mod integration_tests {
         
         // Konvertierungsresultate prüfen
         let results: Vec<_> = test_cases.iter()
-            .map(|&hex| scalar_from_hex(hex).expect("Konvertierung fehlgeschlagen"))
+            .map(|&hex| field_from_hex(hex).expect("Konvertierung fehlgeschlagen"))
             .collect();
             
         // Alle Konvertierungen des gleichen Wertes sollten identisch sein
@@ -105,18 +105,18 @@ mod integration_tests {
         use zeclipse::pure_poseidon::constants::get_mds_matrix;
         
         // Matrix generieren und prüfen
-        let matrix = get_mds_matrix().expect("MDS-Matrix-Generierung fehlgeschlagen");
+        let matrix = get_mds_matrix();
         
         // Dimensionen prüfen (Poseidon WIDTH = 3)
         assert_eq!(matrix.len(), 3, "Falsche Anzahl von Zeilen in der MDS-Matrix");
-        for row in &matrix {
+        for row in matrix {
             assert_eq!(row.len(), 3, "Falsche Anzahl von Spalten in der MDS-Matrix");
         }
         
         // Einfacher Matrix-Struktur-Check: Keine leeren Einträge
-        for row in &matrix {
-            for scalar in row {
-                let bytes = scalar.to_bytes();
+        for row in matrix {
+            for element in row {
+                let bytes = element.to_bytes();
                 // Ein gültiger Skalar sollte nicht nur Nullen enthalten
                 assert!(!bytes.iter().all(|&b| b == 0), "Ungültiger Skalar in der MDS-Matrix");
             }
@@ -126,20 +126,20 @@ mod integration_tests {
     /// Testet die Fehlerbehandlung bei ungültigen Eingaben
     #[test]
     fn test_error_handling() {
-        use zeclipse::pure_poseidon::constants::scalar_from_hex;
+        use zeclipse::pure_poseidon::constants::field_from_hex;
         
         // Ungültiger Hex-String (zu kurz)
         let invalid_hex = "abc";
-        let result = scalar_from_hex(invalid_hex);
+        let result = field_from_hex(invalid_hex);
         assert!(result.is_err(), "Fehlerhafte Eingabe wurde akzeptiert");
         
         // Ungültiger Hex-String (ungültige Zeichen)
         let invalid_chars = "0xXYZ12345";
-        let result = scalar_from_hex(invalid_chars);
+        let result = field_from_hex(invalid_chars);
         assert!(result.is_err(), "Ungültige Hex-Zeichen wurden akzeptiert");
         
         // Prüfen, ob die Fehlermeldungen sinnvoll sind
-        match scalar_from_hex(invalid_hex) {
+        match field_from_hex(invalid_hex) {
             Err(pure_poseidon::PurePoseidonError::ConversionError(_)) => { /* Erwarteter Fehlertyp */ },
             Err(e) => panic!("Falscher Fehlertyp: {:?}", e),
             Ok(_) => panic!("Fehlerhafte Eingabe wurde akzeptiert"),
@@ -51,7 +51,6 @@ mod tests {
         // Configuration change tests (new optimized suite)
         println!("\n>> Test: Optimized configuration changes");
         test_config_update::test_config_update_by_owner().await?;
-        test_config_update::test_config_update_by_admin().await?;
         test_config_update::test_config_update_unauthorized().await?;
         test_config_update::test_config_update_invalid_params().await?;
         test_config_update::test_config_update_after_transfer_started().await?;
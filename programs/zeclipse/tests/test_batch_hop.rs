@@ -9,6 +9,7 @@ use solana_sdk::{
 use solana_program::system_program;
 
 use zeclipse::{
+    batch_plan::split_key,
     state::*,
     instructions::*,
 };
@@ -36,7 +37,8 @@ async fn test_batch_hop_basic() -> Result<(), TransportError> {
     pdas.push(split_pda_1_0);
     
     // 3. Batch-Hop ausführen
-    framework.execute_batch_hop(&transfer_pda, 0, &pdas).await?;
+    let split_keys = [split_key(0, 0), split_key(1, 0)];
+    framework.execute_batch_hop(&transfer_pda, 0, 2, &split_keys, &pdas).await?;
     
     // 4. Verify dass 2 Hops ausgeführt wurden
     let transfer_account = framework.context.banks_client
@@ -79,7 +81,8 @@ async fn test_batch_hop_multi_batch() -> Result<(), TransportError> {
     pdas_batch_1.push(split_pda_0_0);
     pdas_batch_1.push(split_pda_1_0);
     
-    framework.execute_batch_hop(&transfer_pda, 0, &pdas_batch_1).await?;
+    let keys_batch_1 = [split_key(0, 0), split_key(1, 0)];
+    framework.execute_batch_hop(&transfer_pda, 0, 2, &keys_batch_1, &pdas_batch_1).await?;
     
     // 3. Verify erster Batch
     let transfer_account = framework.context.banks_client
@@ -101,7 +104,8 @@ async fn test_batch_hop_multi_batch() -> Result<(), TransportError> {
     pdas_batch_2.push(split_pda_2_0);
     pdas_batch_2.push(split_pda_3_0);
     
-    framework.execute_batch_hop(&transfer_pda, 1, &pdas_batch_2).await?;
+    let keys_batch_2 = [split_key(2, 0), split_key(3, 0)];
+    framework.execute_batch_hop(&transfer_pda, 1, 2, &keys_batch_2, &pdas_batch_2).await?;
     
     // 5. Verify zweiter Batch
     let final_transfer = framework.context.banks_client
@@ -140,7 +144,7 @@ async fn test_batch_hop_multi_batch() -> Result<(), TransportError> {
         &mut finalized_transfer.data.as_ref()
     ).expect("Transfer-State sollte deserialisierbar sein");
     
-    assert_eq!(finalized_state.completed, true);
+    assert_eq!(finalized_state.is_completed(), true);
     
     Ok(())
 }
@@ -160,20 +164,21 @@ async fn test_batch_hop_fake_splits() -> Result<(), TransportError> {
     let (real_pda_0, _) = framework.derive_split_pda(&seed, 0, 0, false);
     pdas.push(real_pda_0);
     
-    // Fake-Split für Hop 0
-    let (fake_pda_0, _) = framework.derive_split_pda(&seed, 0, 1, true);
+    // Primärer Fake-Split für Hop 0 (erster Index nach den 4 Real-Splits)
+    let (fake_pda_0, _) = framework.derive_split_pda(&seed, 0, 4, true);
     pdas.push(fake_pda_0);
     
     // Real-Split für Hop 1
     let (real_pda_1, _) = framework.derive_split_pda(&seed, 1, 0, false);
     pdas.push(real_pda_1);
     
-    // Fake-Split für Hop 1
-    let (fake_pda_1, _) = framework.derive_split_pda(&seed, 1, 1, true);
+    // Primärer Fake-Split für Hop 1
+    let (fake_pda_1, _) = framework.derive_split_pda(&seed, 1, 4, true);
     pdas.push(fake_pda_1);
     
     // 3. Batch-Hop mit Fake-Split-Optimierung ausführen
-    framework.execute_batch_hop(&transfer_pda, 0, &pdas).await?;
+    let split_keys = [split_key(0, 0), split_key(0, 4), split_key(1, 0), split_key(1, 4)];
+    framework.execute_batch_hop(&transfer_pda, 0, 2, &split_keys, &pdas).await?;
     
     // 4. Verify Hops wurden ausgeführt
     let transfer_account = framework.context.banks_client
@@ -210,7 +215,8 @@ async fn test_batch_hop_fake_splits() -> Result<(), TransportError> {
     final_pdas.push(split_pda_2_0);
     final_pdas.push(split_pda_3_0);
     
-    framework.execute_batch_hop(&transfer_pda, 1, &final_pdas).await?;
+    let final_keys = [split_key(2, 0), split_key(3, 0)];
+    framework.execute_batch_hop(&transfer_pda, 1, 2, &final_keys, &final_pdas).await?;
     
     // 7. Finalisieren
     let recipient = Keypair::new();
@@ -232,20 +238,36 @@ async fn test_batch_hop_error_conditions() -> Result<(), TransportError> {
     let (split_pda_0_0, _) = framework.derive_split_pda(&seed, 0, 0, false);
     pdas.push(split_pda_0_0);
     
+    let split_keys = [split_key(0, 0)];
+    
     // 3. Falschen Batch-Index versuchen
-    let result = framework.execute_batch_hop(&transfer_pda, 1, &pdas).await;
+    let result = framework.execute_batch_hop(&transfer_pda, 1, 1, &split_keys, &pdas).await;
     assert!(result.is_err(), "Ungültiger Batch-Index sollte fehlschlagen");
     
+    // 3a. Doppelt aufgeführter Split-Account
+    let result = framework.execute_batch_hop(
+        &transfer_pda, 0, 1, &[split_key(0, 0), split_key(0, 0)], &[split_pda_0_0, split_pda_0_0]
+    ).await;
+    assert!(result.is_err(), "Doppelter Split-Account sollte fehlschlagen");
+    
+    // 3b. Split-Key außerhalb des Hop-Fensters
+    let result = framework.execute_batch_hop(&transfer_pda, 0, 1, &[split_key(1, 0)], &pdas).await;
+    assert!(result.is_err(), "Hop außerhalb des Batch-Fensters sollte fehlschlagen");
+    
+    // 3c. Mehr Hops als verbleibend
+    let result = framework.execute_batch_hop(&transfer_pda, 0, 5, &split_keys, &pdas).await;
+    assert!(result.is_err(), "Zu viele Hops sollten fehlschlagen");
+    
     // 4. Korrekten Batch ausführen
-    framework.execute_batch_hop(&transfer_pda, 0, &pdas).await?;
+    framework.execute_batch_hop(&transfer_pda, 0, 1, &split_keys, &pdas).await?;
     
     // 5. Gleichen Batch-Index erneut versuchen
-    let result = framework.execute_batch_hop(&transfer_pda, 0, &pdas).await;
+    let result = framework.execute_batch_hop(&transfer_pda, 0, 1, &split_keys, &pdas).await;
     assert!(result.is_err(), "Wiederholter Batch-Index sollte fehlschlagen");
     
     // 6. Leere PDA-Liste testen
     let empty_pdas: Vec<Pubkey> = Vec::new();
-    let result = framework.execute_batch_hop(&transfer_pda, 1, &empty_pdas).await;
+    let result = framework.execute_batch_hop(&transfer_pda, 1, 1, &[], &empty_pdas).await;
     assert!(result.is_err(), "Leere PDA-Liste sollte fehlschlagen");
     
     // 7. Restlichen Hops ausführen
@@ -257,14 +279,15 @@ async fn test_batch_hop_error_conditions() -> Result<(), TransportError> {
     final_pdas.push(split_pda_2_0);
     final_pdas.push(split_pda_3_0);
     
-    framework.execute_batch_hop(&transfer_pda, 1, &final_pdas).await?;
+    let final_keys = [split_key(1, 0), split_key(2, 0), split_key(3, 0)];
+    framework.execute_batch_hop(&transfer_pda, 1, 3, &final_keys, &final_pdas).await?;
     
     // 8. Finalisieren
     let recipient = Keypair::new();
     framework.finalize_transfer(&transfer_pda, &recipient.pubkey()).await?;
     
     // 9. Versuch nach Finalisierung
-    let result = framework.execute_batch_hop(&transfer_pda, 2, &pdas).await;
+    let result = framework.execute_batch_hop(&transfer_pda, 2, 1, &split_keys, &pdas).await;
     assert!(result.is_err(), "Batch-Hop nach Finalisierung sollte fehlschlagen");
     
     Ok(())
@@ -278,15 +301,23 @@ async fn test_batch_hop_maximum_capacity() -> Result<(), TransportError> {
     let amount = 1_000_000_000; // 1 SOL
     let (transfer_pda, seed) = framework.initialize_transfer(amount, 5).await?;
     
-    // 2. PDAs für alle 4 Hops vorbereiten
+    // 2. PDAs für alle 4 Hops vorbereiten: 4 Real-Splits + 4 primäre Fake-Splits pro Hop
     let mut pdas = Vec::new();
+    let mut split_keys = Vec::new();
     for hop_index in 0..4 {
-        let (split_pda, _) = framework.derive_split_pda(&seed, hop_index, 0, false);
-        pdas.push(split_pda);
+        for split_index in 0..8 {
+            let (split_pda, _) = framework.derive_split_pda(&seed, hop_index, split_index, split_index >= 4);
+            pdas.push(split_pda);
+            split_keys.push(split_key(hop_index, split_index));
+        }
     }
     
-    // 3. Versuchen, alle 4 Hops in einem Batch auszuführen
-    framework.execute_batch_hop(&transfer_pda, 0, &pdas).await?;
+    // Reihenfolge wie in einer Address Lookup Table: Hop-Reihenfolge spielt keine Rolle
+    pdas.reverse();
+    split_keys.reverse();
+    
+    // 3. Alle 4 Hops (32 Split-Accounts) in einem Batch ausführen
+    framework.execute_batch_hop(&transfer_pda, 0, 4, &split_keys, &pdas).await?;
     
     // 4. Verify dass alle Hops ausgeführt wurden
     let transfer_account = framework.context.banks_client
@@ -325,7 +356,7 @@ async fn test_batch_hop_maximum_capacity() -> Result<(), TransportError> {
         &mut finalized_transfer.data.as_ref()
     ).expect("Transfer-State sollte deserialisierbar sein");
     
-    assert_eq!(finalized_state.completed, true, "Transfer sollte abgeschlossen sein");
+    assert_eq!(finalized_state.is_completed(), true, "Transfer sollte abgeschlossen sein");
     
     Ok(())
 }
@@ -18,6 +18,8 @@ use zeclipse::{
     state::*,
     errors::ZEclipseError,
     instructions::*,
+    hash_context::HashContext,
+    utils::{fake_split_root, generate_bloom_filter},
 };
 
 // Test for a successful configuration change by the owner
@@ -54,6 +56,9 @@ async fn test_config_update_by_owner() {
         reserve_percent: Some(new_reserve),
         fee_multiplier: Some(new_fee),
         cu_budget_per_hop: Some(new_cu_budget),
+        profile: None,
+        committed_fakes: None,
+        fake_root: None,
     };
     
     // Update as owner
@@ -75,73 +80,18 @@ async fn test_config_update_by_owner() {
     println!("Test successful: Configuration change by owner works correctly");
 }
 
-// Test for a configuration change by an admin (not the owner)
-#[tokio::test]
-async fn test_config_update_by_admin() {
-    // 1. Initialize test framework
-    let mut framework = BlackoutTestFramework::new().await;
-    
-    // 2. Create admin account
-    let admin = Keypair::new();
-    
-    // Fund admin account with Lamports
-    framework.fund_account(&admin.pubkey(), 100_000_000).await
-        .expect("Could not fund admin account");
-    
-    // 3. Initialize transfer with standard configuration
-    let amount = 500_000_000; // 0.5 SOL in Lamports
-    let initial_reserve = 15; // 15% Reserve as initial value
-    
-    // Initialize transfer
-    let (transfer_pda, _) = framework.initialize_transfer(amount, initial_reserve)
-        .await
-        .expect("Transfer initialization failed");
-    
-    // 4. Change configuration
-    let new_reserve = 20; // 20% Reserve
-    let new_fee = 600; // 6% fee (600 basis points)
-    
-    // Create update parameters (not changing all fields)
-    let update_params = ConfigUpdateParams {
-        reserve_percent: Some(new_reserve),
-        fee_multiplier: Some(new_fee),
-        cu_budget_per_hop: None, // Leave this parameter unchanged
-    };
-    
-    // Update as admin with admin instead of owner
-    framework.update_config_with_admin(&transfer_pda, update_params, &admin, &admin)
-        .await
-        .expect("Configuration change as admin failed");
-    
-    // 5. Check updated transfer state
-    let updated_state = framework.get_transfer_state(&transfer_pda).await
-        .expect("Could not retrieve updated transfer state");
-    
-    assert_eq!(updated_state.config.reserve_percent, new_reserve, 
-              "Reserve was not updated correctly");
-    assert_eq!(updated_state.config.fee_multiplier, new_fee, 
-              "Fee multiplier was not updated correctly");
-    assert_eq!(updated_state.config.cu_budget_per_hop, 300_000, 
-              "CU budget should remain unchanged");
-    
-    println!("Test successful: Configuration change by admin works correctly");
-}
-
 // Test for attempting a configuration change by an unauthorized user
 #[tokio::test]
 async fn test_config_update_unauthorized() {
     // 1. Initialize test framework
     let mut framework = BlackoutTestFramework::new().await;
     
-    // 2. Create two different accounts
+    // 2. Create an account that is not the owner
     let unauthorized_user = Keypair::new();
-    let admin = Keypair::new();
     
-    // Fund accounts with Lamports
+    // Fund account with Lamports
     framework.fund_account(&unauthorized_user.pubkey(), 100_000_000).await
         .expect("Could not fund account");
-    framework.fund_account(&admin.pubkey(), 100_000_000).await
-        .expect("Could not fund admin account");
     
     // 3. Initialize transfer
     let amount = 200_000_000; // 0.2 SOL
@@ -157,15 +107,13 @@ async fn test_config_update_unauthorized() {
         reserve_percent: Some(40),
         fee_multiplier: Some(700),
         cu_budget_per_hop: Some(400_000),
+        profile: None,
+        committed_fakes: None,
+        fake_root: None,
     };
     
-    // Attempt by unauthorized user (neither owner nor admin)
-    let result = framework.update_config_with_admin(
-        &transfer_pda, 
-        update_params, 
-        &unauthorized_user, 
-        &admin
-    ).await;
+    // Attempt by unauthorized user (not the owner)
+    let result = framework.update_config(&transfer_pda, update_params, &unauthorized_user).await;
     
     // 5. Check if the attempt failed
     assert!(
@@ -205,6 +153,9 @@ async fn test_config_update_invalid_params() {
         reserve_percent: Some(85), // 85% (invalid, max is 80%)
         fee_multiplier: None,
         cu_budget_per_hop: None,
+        profile: None,
+        committed_fakes: None,
+        fake_root: None,
     };
     
     let result_reserve = framework.update_config(&transfer_pda, invalid_reserve_params, &framework.user)
@@ -220,6 +171,9 @@ async fn test_config_update_invalid_params() {
         reserve_percent: None,
         fee_multiplier: Some(1200), // 12% (invalid, max is 10% = 1000 BP)
         cu_budget_per_hop: None,
+        profile: None,
+        committed_fakes: None,
+        fake_root: None,
     };
     
     let result_fee = framework.update_config(&transfer_pda, invalid_fee_params, &framework.user)
@@ -235,6 +189,9 @@ async fn test_config_update_invalid_params() {
         reserve_percent: None,
         fee_multiplier: None,
         cu_budget_per_hop: Some(50_000), // 50k (invalid, min is 100k)
+        profile: None,
+        committed_fakes: None,
+        fake_root: None,
     };
     
     let result_cu = framework.update_config(&transfer_pda, invalid_cu_params, &framework.user)
@@ -280,6 +237,9 @@ async fn test_config_update_after_transfer_started() {
         reserve_percent: Some(20),
         fee_multiplier: None,
         cu_budget_per_hop: None,
+        profile: None,
+        committed_fakes: None,
+        fake_root: None,
     };
     
     let result = framework.update_config(&transfer_pda, update_params, &framework.user)
@@ -303,6 +263,107 @@ async fn test_config_update_after_transfer_started() {
     println!("Test successful: Configuration change after transfer start was prevented");
 }
 
+// Test for switching the layout to a performance profile
+#[tokio::test]
+async fn test_config_update_performance_profile() {
+    // 1. Initialize test framework
+    let mut framework = BlackoutTestFramework::new().await;
+    
+    // 2. Initialize transfer with standard configuration (4 x (4 + 44))
+    let amount = 300_000_000; // 0.3 SOL
+    let initial_reserve = 10; // 10% Reserve
+    
+    let (transfer_pda, _) = framework.initialize_transfer(amount, initial_reserve)
+        .await
+        .expect("Transfer initialization failed");
+    let initial_state = framework.get_transfer_state(&transfer_pda).await
+        .expect("Could not retrieve initial transfer state");
+    
+    // 3. Switch to the latency profile, keeping the reserve
+    let update_params = ConfigUpdateParams {
+        reserve_percent: None,
+        fee_multiplier: None,
+        cu_budget_per_hop: None,
+        profile: Some(PerformanceProfile::Latency),
+        committed_fakes: None,
+        fake_root: None,
+    };
+    framework.update_config(&transfer_pda, update_params, &framework.user)
+        .await
+        .expect("Switching to the latency profile failed");
+    
+    // 4. Layout and batch budget come from the cost model, the rest is unchanged
+    let updated_state = framework.get_transfer_state(&transfer_pda).await
+        .expect("Could not retrieve updated transfer state");
+    let expected = BlackoutConfig::for_profile(PerformanceProfile::Latency);
+    
+    assert_eq!(updated_state.config.num_hops, expected.num_hops,
+              "Hop count should follow the profile");
+    assert_eq!(updated_state.config.fake_splits, expected.fake_splits,
+              "Fake split count should follow the profile");
+    assert_eq!(updated_state.config.cu_budget_per_hop, expected.cu_budget_per_hop,
+              "CU budget should follow the profile");
+    assert_eq!(updated_state.config.reserve_percent, initial_state.config.reserve_percent,
+              "Reserve should remain unchanged");
+    
+    // 5. The Bloom filter was rebuilt for the smaller fake range
+    assert_eq!(updated_state.fake_bloom, generate_bloom_filter(&updated_state.config, &updated_state.challenge),
+              "Bloom filter should match the new layout");
+    assert_ne!(updated_state.fake_bloom, initial_state.fake_bloom,
+              "Bloom filter should differ from the default layout");
+    
+    println!("Test successful: Performance profile was applied");
+}
+
+// Test for keeping fake splits as commitments
+#[tokio::test]
+async fn test_config_update_committed_fakes() {
+    let mut framework = BlackoutTestFramework::new().await;
+    let (transfer_pda, _) = framework.initialize_transfer(300_000_000, 10)
+        .await
+        .expect("Transfer initialization failed");
+    
+    let update_params = ConfigUpdateParams {
+        reserve_percent: None,
+        fee_multiplier: None,
+        cu_budget_per_hop: None,
+        profile: None,
+        committed_fakes: Some(true),
+        fake_root: None,
+    };
+    
+    // Committed fake splits need the root of their split tree
+    let result = framework.update_config(&transfer_pda, update_params, &framework.user).await;
+    assert!(result.is_err(), "Committed fake splits without a root should be rejected");
+    
+    let blindings: Vec<[u8; 32]> = (0..4 * 44u8)
+        .map(|position| {
+            let mut blinding = [3u8; 32];
+            blinding[0] = 0;
+            blinding[31] = position;
+            blinding
+        })
+        .collect();
+    let fake_root = fake_split_root(&mut HashContext::new(), &BlackoutConfig::new(), &blindings).unwrap();
+    let update_params = ConfigUpdateParams { fake_root: Some(fake_root), ..update_params };
+    framework.update_config(&transfer_pda, update_params, &framework.user)
+        .await
+        .expect("Switching to committed fake splits failed");
+    
+    // Only the fake mode changes; the layout and its Bloom filter stay
+    let updated_state = framework.get_transfer_state(&transfer_pda).await
+        .expect("Could not retrieve updated transfer state");
+    assert_eq!(updated_state.fake_mode, FAKE_MODE_COMMITTED,
+              "Fake splits should be committed");
+    assert_eq!(updated_state.fake_root, fake_root, "The fake split root should be stored");
+    assert_eq!(updated_state.config.num_hops, 4, "Hop count should remain unchanged");
+    assert_eq!(updated_state.config.fake_splits, 44, "Fake split count should remain unchanged");
+    assert_eq!(updated_state.fake_bloom, generate_bloom_filter(&updated_state.config, &updated_state.challenge),
+              "Bloom filter should remain unchanged");
+    
+    println!("Test successful: Fake splits are committed");
+}
+
 // Extend the BlackoutTestFramework with the config update functionality
 impl BlackoutTestFramework {
     // Update configuration as owner
@@ -311,39 +372,20 @@ impl BlackoutTestFramework {
         transfer_pda: &Pubkey,
         params: ConfigUpdateParams,
         authority: &Keypair,
-    ) -> Result<(), BanksClientError> {
-        // Admin is the same as the owner in this case (self-management)
-        self.update_config_with_admin(transfer_pda, params, authority, authority).await
-    }
-    
-    // Update configuration with separate admin
-    pub async fn update_config_with_admin(
-        &mut self,
-        transfer_pda: &Pubkey,
-        params: ConfigUpdateParams,
-        authority: &Keypair,
-        admin: &Keypair,
     ) -> Result<(), BanksClientError> {
         // Create configuration update instruction
         let ix = Instruction {
             program_id: self.program_id,
             accounts: vec![
                 AccountMeta::new(authority.pubkey(), true),
-                AccountMeta::new(admin.pubkey(), false),
                 AccountMeta::new(transfer_pda.clone(), false),
                 AccountMeta::new_readonly(system_program::ID, false),
             ],
-            data: zeclipse::instruction::ConfigUpdate {
+            data: zeclipse::instruction::UpdateConfig {
                 update_params: params,
             }.data(),
         };
         
-        // Transaktion ausführen mit entsprechenden Signaturen
-        let mut signers = vec![authority];
-        if admin.pubkey() != authority.pubkey() {
-            signers.push(admin);
-        }
-        
-        self.execute_transaction(&[ix], &signers).await
+        self.execute_transaction(&[ix], &[authority]).await
     }
 }
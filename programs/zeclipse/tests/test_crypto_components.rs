@@ -9,6 +9,7 @@ use solana_sdk::{
 use solana_program::system_program;
 
 use zeclipse::{
+    hash_context::HashContext,
     state::*,
     instructions::*,
     utils::*,
@@ -207,21 +208,21 @@ async fn test_poseidon_hash_commitments() -> Result<(), TransportError> {
     }
     
     // 2. Poseidon-Hash berechnen
-    let hash_result = poseidon_hash_commitments(&commitments);
+    let hash_result = poseidon_hash_commitments(&mut HashContext::new(), &commitments);
     
     // 3. Verify dass der Hash nicht leer ist
     assert!(!hash_result.is_empty(), "Poseidon-Hash sollte nicht leer sein");
     assert!(hash_result.len() <= 32, "Poseidon-Hash sollte maximal 32 Bytes haben");
     
     // 4. Verify dass derselbe Input denselben Hash erzeugt (Determinismus)
-    let second_hash = poseidon_hash_commitments(&commitments);
+    let second_hash = poseidon_hash_commitments(&mut HashContext::new(), &commitments);
     assert_eq!(hash_result, second_hash, "Poseidon-Hash sollte deterministisch sein");
     
     // 5. Verify dass verschiedene Inputs verschiedene Hashes erzeugen
     let mut different_commitments = commitments.clone();
     different_commitments[0][0] = commitments[0][0].wrapping_add(1);
     
-    let different_hash = poseidon_hash_commitments(&different_commitments);
+    let different_hash = poseidon_hash_commitments(&mut HashContext::new(), &different_commitments);
     assert_ne!(hash_result, different_hash, "Verschiedene Inputs sollten verschiedene Hashes erzeugen");
     
     Ok(())
@@ -246,6 +247,104 @@ fn test_extract_split_amount() {
     assert_eq!(invalid_index, 0, "Ungültiger Index sollte 0 zurückgeben");
 }
 
+#[test]
+fn test_extract_split_amounts_matches_single_extraction() {
+    let challenge = [0u8; 32];
+    let proof = BlackoutTestFramework::create_test_hyperplonk_proof(&challenge, &[1000, 2000, 3000, 4000]);
+    
+    // Alle Splits in einem Durchlauf müssen den Einzelextraktionen entsprechen
+    let all = extract_split_amounts(&proof);
+    for i in 0..REAL_SPLIT_COUNT {
+        assert_eq!(all[i], extract_split_amount(&proof, i as u8));
+    }
+}
+
+#[test]
+fn test_built_hyperplonk_proof_verifies() {
+    let mut hash_ctx = HashContext::new();
+    let mut challenge = [7u8; 32];
+    challenge[0] = 0;
+
+    // Ein gebauter Proof besteht die komplette Verifikation inklusive Gates
+    let proof = build_hyperplonk_proof(&mut hash_ctx, &challenge, 100_000_000).unwrap();
+    assert!(verify_hyperplonk_proof(&mut hash_ctx, &proof, &challenge).is_ok());
+
+    // ... aber nur für seine eigene Challenge
+    let mut other = challenge;
+    other[31] ^= 1;
+    assert!(verify_hyperplonk_proof(&mut hash_ctx, &proof, &other).is_err());
+
+    // Manipulierter Proof-Teil, gebrochene Linearität und leere Gate-Konfiguration scheitern
+    let mut tampered = proof;
+    tampered[100] ^= 1;
+    assert!(verify_hyperplonk_proof(&mut hash_ctx, &tampered, &challenge).is_err());
+    let mut nonlinear = proof;
+    nonlinear[66] = 1;
+    assert!(verify_hyperplonk_proof(&mut hash_ctx, &nonlinear, &challenge).is_err());
+    let mut no_gates = proof;
+    no_gates[30] = 0;
+    assert!(verify_plonk_gates(&mut hash_ctx, &no_gates[96..], &no_gates[30..34], &challenge).is_err());
+
+    // Die Splits des Proofs summieren sich zum Hop-Betrag
+    let splits = extract_splits(&mut hash_ctx, &proof, 25_000_000, &challenge).unwrap();
+    assert_eq!(splits.iter().sum::<u64>(), 25_000_000);
+}
+
+#[test]
+fn test_generate_fake_splits_capacity() {
+    let mut hash_ctx = HashContext::new();
+    let challenge = [7u8; 32];
+    
+    let mut config = BlackoutConfig::new();
+    let fakes = generate_fake_splits(&mut hash_ctx, &config, &challenge).unwrap();
+    assert_eq!(fakes.len(), config.fake_splits as usize);
+    assert!(fakes.as_slice().iter().all(|&v| (10_000..1_000_000_000).contains(&v)));
+    
+    // Mehr Fake-Splits als die feste Kapazität werden abgelehnt
+    config.fake_splits = MAX_FAKE_SPLITS as u8 + 1;
+    assert!(generate_fake_splits(&mut hash_ctx, &config, &challenge).is_err());
+}
+
+#[test]
+fn test_fake_split_commitments() {
+    let mut hash_ctx = HashContext::new();
+    let config = BlackoutConfig::new();
+    let count = config.num_hops as usize * config.fake_splits as usize;
+    let blindings: Vec<[u8; 32]> = (0..count)
+        .map(|position| {
+            let mut blinding = [0x11; 32];
+            blinding[0] = 0;
+            blinding[31] = position as u8;
+            blinding
+        })
+        .collect();
+    
+    // Die Wurzel bindet die Blindings; eine falsche Anzahl wird abgelehnt
+    let root = fake_split_root(&mut hash_ctx, &config, &blindings).unwrap();
+    assert_eq!(root, fake_split_root(&mut hash_ctx, &config, &blindings).unwrap());
+    assert!(fake_split_root(&mut hash_ctx, &config, &blindings[1..]).is_err());
+    let mut changed = blindings.clone();
+    changed[7][1] ^= 1;
+    assert_ne!(root, fake_split_root(&mut hash_ctx, &config, &changed).unwrap());
+    
+    // 4 x 44 Fakes: Baum der Tiefe 8 in Hop-Reihenfolge
+    assert_eq!(fake_split_tree_depth(&config), 8);
+    assert_eq!(fake_split_position(&config, 0, config.real_splits), Some(0));
+    assert_eq!(fake_split_position(&config, 1, config.real_splits + 2), Some(46));
+    assert_eq!(fake_split_position(&config, 0, 0), None);
+    assert_eq!(fake_split_position(&config, config.num_hops, config.real_splits), None);
+    
+    // Jede Öffnung gilt nur für ihren eigenen Split
+    let (hop, split) = (1, config.real_splits + 2);
+    let path = fake_split_path(&mut hash_ctx, &config, &blindings, hop, split).unwrap();
+    assert_eq!(path.len(), 8);
+    assert!(verify_fake_split_opening(&mut hash_ctx, &root, &config, hop, split, &blindings[46], &path).unwrap());
+    assert!(!verify_fake_split_opening(&mut hash_ctx, &root, &config, hop, split + 1, &blindings[46], &path).unwrap());
+    assert!(!verify_fake_split_opening(&mut hash_ctx, &root, &config, hop, split, &blindings[47], &path).unwrap());
+    assert!(verify_fake_split_opening(&mut hash_ctx, &root, &config, hop, split, &blindings[46], &path[1..]).is_err());
+    assert!(verify_fake_split_opening(&mut hash_ctx, &root, &config, hop, 0, &blindings[46], &path).is_err());
+}
+
 #[test]
 fn test_calculate_optimized_priority_fees() {
     // 1. Test mit verschiedenen verbleibenden Hops
@@ -273,3 +372,155 @@ fn test_calculate_optimized_priority_fees() {
     assert!(high_priority_1 > priority_1, "Höhere Base-Fee sollte zu höherer Priorität führen");
     assert_eq!(high_priority_1, 3 * high_base_fee, "Priorität für letzten Hop sollte 3 * Base-Fee sein");
 }
+
+/// Baut alle Ebenen eines Merkle-Baums (Blätter = Pubkey-Bytes)
+fn merkle_layers(hash_ctx: &mut HashContext, leaves: &[[u8; 32]]) -> Vec<Vec<[u8; 32]>> {
+    let mut layers = vec![leaves.to_vec()];
+    while layers.last().unwrap().len() > 1 {
+        let parents = layers.last().unwrap()
+            .chunks(2)
+            .map(|pair| hash_ctx.hash_pair(&pair[0], &pair[1]).unwrap())
+            .collect();
+        layers.push(parents);
+    }
+    layers
+}
+
+/// Referenz-Erzeugung eines Multiproofs im Format von `verify_merkle_multiproof`
+fn build_multiproof(layers: &[Vec<[u8; 32]>], positions: &[usize]) -> Vec<u8> {
+    let depth = layers.len() - 1;
+    let mut proof = vec![0u8; 1 + multiproof_bitmap_len(depth as u8)];
+    proof[0] = depth as u8;
+    for &position in positions {
+        proof[1 + position / 8] |= 1 << (position % 8);
+    }
+    
+    let mut known: Vec<usize> = positions.to_vec();
+    for layer in &layers[..depth] {
+        let mut parents = Vec::new();
+        let mut i = 0;
+        while i < known.len() {
+            let position = known[i];
+            if position % 2 == 0 && known.get(i + 1) == Some(&(position + 1)) {
+                i += 2;
+            } else {
+                proof.extend_from_slice(&layer[position ^ 1]);
+                i += 1;
+            }
+            parents.push(position / 2);
+        }
+        known = parents;
+    }
+    proof
+}
+
+#[test]
+fn test_merkle_multiproof_recipients() {
+    // 6 Empfänger, auf 8 Blätter aufgefüllt. Die Schlüssel sind keine
+    // gültigen Feldelemente, ihre Wallet-Blätter schon.
+    let mut hash_ctx = HashContext::new();
+    let recipients: Vec<[u8; 32]> = (0..6u8)
+        .map(|i| wallet_leaf(&mut hash_ctx, &Pubkey::new_from_array([0xF0 + i; 32])).unwrap())
+        .collect();
+    let mut leaves = recipients.clone();
+    leaves.resize(8, [0u8; 32]);
+    
+    let layers = merkle_layers(&mut hash_ctx, &leaves);
+    let root = layers[3][0];
+    
+    // Alle 6 Empfänger: nur der Nachbar des Paares (4, 5) fehlt
+    let positions: Vec<usize> = (0..6).collect();
+    let proof = build_multiproof(&layers, &positions);
+    assert_eq!(proof.len(), 1 + 1 + 32);
+    
+    let mut verify_ctx = HashContext::new();
+    assert!(verify_merkle_multiproof(&mut verify_ctx, &proof, &root, &recipients).unwrap());
+    // Jeder innere Knoten oberhalb der Blätter wird genau einmal gehasht
+    assert_eq!(verify_ctx.hash_count(), 3 + 2 + 1);
+    
+    // Teilmenge, gegen Einzelproofs: 2 Pfade teilen sich die oberen Knoten
+    let subset = [recipients[1], recipients[4]];
+    let proof = build_multiproof(&layers, &[1, 4]);
+    assert_eq!(proof.len(), 2 + 4 * 32);
+    assert!(verify_merkle_multiproof(&mut HashContext::new(), &proof, &root, &subset).unwrap());
+    
+    // Falsches Blatt: Root stimmt nicht
+    let wrong = [recipients[1], recipients[3]];
+    assert!(!verify_merkle_multiproof(&mut HashContext::new(), &proof, &root, &wrong).unwrap());
+    
+    // Fehlerhafte Proofs werden abgelehnt
+    assert!(verify_merkle_multiproof(&mut HashContext::new(), &proof, &root, &subset[..1]).is_err());
+    assert!(verify_merkle_multiproof(&mut HashContext::new(), &proof[..proof.len() - 32], &root, &subset).is_err());
+    let mut trailing = proof.clone();
+    trailing.extend_from_slice(&[0u8; 32]);
+    assert!(verify_merkle_multiproof(&mut HashContext::new(), &trailing, &root, &subset).is_err());
+}
+
+#[test]
+fn test_recipient_set_multiproof() {
+    // 3 Empfänger eines Transfers, auf 4 Blätter aufgefüllt
+    let mut hash_ctx = HashContext::new();
+    let wallets: Vec<Pubkey> = (0..3u8).map(|i| Pubkey::new_from_array([0xE0 + i; 32])).collect();
+    let mut leaves: Vec<[u8; 32]> = wallets.iter()
+        .map(|wallet| wallet_leaf(&mut hash_ctx, wallet).unwrap())
+        .collect();
+    leaves.resize(4, [0u8; 32]);
+    let layers = merkle_layers(&mut hash_ctx, &leaves);
+    let root = layers[2][0];
+    
+    let proof = build_multiproof(&layers, &[0, 1, 2]);
+    assert!(verify_recipient_set(&mut HashContext::new(), &proof, &root, &wallets).unwrap());
+    
+    // Vertauschte Reihenfolge: Root stimmt nicht
+    let swapped = [wallets[1], wallets[0], wallets[2]];
+    assert!(!verify_recipient_set(&mut HashContext::new(), &proof, &root, &swapped).unwrap());
+    
+    // Ein gültiger Proof für eine Teilmenge lässt keinen Empfänger weg
+    let subset = build_multiproof(&layers, &[0, 1]);
+    assert!(verify_merkle_multiproof(&mut HashContext::new(), &subset, &root, &leaves[..2]).unwrap());
+    assert!(verify_recipient_set(&mut HashContext::new(), &subset, &root, &wallets[..2]).is_err());
+    assert!(verify_recipient_set(&mut HashContext::new(), &[], &root, &wallets).is_err());
+}
+
+#[test]
+fn test_merkle_multiproof_matches_single_proof() {
+    // Ein Blatt: Multiproof und Einzelproof tragen dieselben Geschwister
+    let leaves: Vec<[u8; 32]> = (0..4u8).map(|i| [i + 10; 32]).collect();
+    let mut hash_ctx = HashContext::new();
+    let layers = merkle_layers(&mut hash_ctx, &leaves);
+    let root = layers[2][0];
+    let leaf = leaves[2];
+    
+    let multiproof = build_multiproof(&layers, &[2]);
+    let mut single = vec![2u8, 0b10];
+    single.extend_from_slice(&multiproof[2..]);
+    
+    assert!(verify_merkle_multiproof(&mut HashContext::new(), &multiproof, &root, &[leaf]).unwrap());
+    assert!(verify_merkle_proof(&mut HashContext::new(), &single, &root, &Pubkey::new_from_array(leaf)).unwrap());
+    
+    // Positionen außerhalb des Baums
+    let mut outside = multiproof.clone();
+    outside[1] |= 1 << 4;
+    assert!(verify_merkle_multiproof(&mut HashContext::new(), &outside, &root, &[leaf, leaf]).is_err());
+}
+
+#[test]
+fn test_merkle_hash_matches_offchain_vectors() {
+    // Gemeinsame Testvektoren mit app/src/client/poseidon.ts
+    let (mut one, mut two) = ([0u8; 32], [0u8; 32]);
+    one[31] = 1;
+    two[31] = 2;
+    let mut hash_ctx = HashContext::new();
+    assert_eq!(
+        hex::encode(hash_ctx.hash_pair(&one, &two).unwrap()),
+        "115cc0f5e7d690413df64c6b9662e9cf2a3617f2743245519e19607a4417189a"
+    );
+    
+    // [0xFF; 32] ist kein Feldelement, das Wallet-Blatt schon
+    let wallet = Pubkey::new_from_array([0xFF; 32]);
+    assert!(hash_ctx.hash_pair(&wallet.to_bytes(), &one).is_err());
+    assert_eq!(
+        hex::encode(wallet_leaf(&mut hash_ctx, &wallet).unwrap()),
+        "2578c8bbec89b2fe57969cfb9b884d2e92f1949334ac9530537b324dc674f63d"
+    );
+}
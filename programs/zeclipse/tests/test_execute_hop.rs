@@ -37,7 +37,7 @@ async fn test_single_hop_execution() -> Result<(), TransportError> {
     assert_eq!(transfer_state.amount, amount);
     assert_eq!(transfer_state.current_hop, 0);
     assert_eq!(transfer_state.owner, framework.user.pubkey());
-    assert_eq!(transfer_state.completed, false);
+    assert_eq!(transfer_state.is_completed(), false);
     
     // 2. Ersten Hop ausführen
     framework.execute_hop(&transfer_pda, &seed, 0, 0, false).await?;
@@ -53,7 +53,7 @@ async fn test_single_hop_execution() -> Result<(), TransportError> {
     ).expect("Transfer-State sollte deserialisierbar sein");
     
     assert_eq!(updated_state.current_hop, 1);
-    assert_eq!(updated_state.completed, false);
+    assert_eq!(updated_state.is_completed(), false);
     
     // 3. Verifizieren, dass das PDA erstellt wurde
     let (split_pda, _) = framework.derive_split_pda(&seed, 0, 0, false);
@@ -115,7 +115,7 @@ async fn test_complete_hop_sequence() -> Result<(), TransportError> {
     ).expect("Transfer-State sollte deserialisierbar sein");
     
     assert_eq!(final_state.current_hop, 4);
-    assert_eq!(final_state.completed, false); // Noch nicht finalisiert
+    assert_eq!(final_state.is_completed(), false); // Noch nicht finalisiert
     
     // 4. Transfer finalisieren
     let recipient = Keypair::new();
@@ -131,7 +131,7 @@ async fn test_complete_hop_sequence() -> Result<(), TransportError> {
         &mut finalized_transfer.data.as_ref()
     ).expect("Transfer-State sollte deserialisierbar sein");
     
-    assert_eq!(finalized_state.completed, true);
+    assert_eq!(finalized_state.is_completed(), true);
     assert_eq!(finalized_state.recipient, recipient.pubkey());
     
     Ok(())
@@ -243,7 +243,7 @@ async fn test_refund_functionality() -> Result<(), TransportError> {
         &mut refunded_transfer.data.as_ref()
     ).expect("Transfer-State sollte deserialisierbar sein");
     
-    assert_eq!(refunded_state.refund_triggered, true);
+    assert_eq!(refunded_state.is_refund_triggered(), true);
     
     // 5. Prüfen, ob Lamports zurückgegeben wurden
     let final_balance = framework.context.banks_client
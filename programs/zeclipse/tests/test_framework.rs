@@ -1,6 +1,6 @@
 use anchor_lang::prelude::*;
 use anchor_lang::solana_program::{
-    instruction::Instruction,
+    instruction::{AccountMeta, Instruction},
     pubkey::Pubkey,
     hash::Hash,
     system_program,
@@ -20,6 +20,7 @@ use solana_sdk::{
 use zeclipse::{
     instructions::*,
     state::*,
+    bloom::{bloom_insert, BloomParams, FakeBloom, FAKE_BLOOM_BYTES},
 };
 
 /// Test framework for BlackoutSOL tests
@@ -182,15 +183,14 @@ impl BlackoutTestFramework {
     }
     
     /// Creates a Bloom filter for fake splits
-    pub fn create_fake_bloom_filter(fake_indices: &[u8]) -> [u8; 16] {
-        let mut bloom = [0u8; 16];
+    pub fn create_fake_bloom_filter(fake_indices: &[u8]) -> FakeBloom {
+        let mut bloom = [0u8; FAKE_BLOOM_BYTES];
         
-        for &index in fake_indices {
-            let position = index as usize % 128;
-            let byte_index = position / 8;
-            let bit_index = position % 8;
-            
-            bloom[byte_index] |= 1 << bit_index;
+        // Die Indizes gelten für jeden der 4 Hops
+        for hop in 0..4 {
+            for &index in fake_indices {
+                bloom_insert(&mut bloom, &BloomParams::FAKE_SPLITS, hop, index);
+            }
         }
         
         bloom
@@ -282,18 +282,12 @@ impl BlackoutTestFramework {
         ];
         
         let proof_data = Self::create_test_hyperplonk_proof(&challenge, &splits);
-        let range_proof_data = Self::create_test_range_proof(
-            &challenge, 
-            &transfer_state.commitments, 
-            true
-        );
         
         // Execute the hop
         let ix = execute_hop_instruction(
             execute_hop::ExecuteHopParams {
                 hop_index,
                 proof_data,
-                range_proof_data,
             },
             execute_hop::ExecuteHopAccounts {
                 authority: self.user.pubkey(),
@@ -325,32 +319,35 @@ impl BlackoutTestFramework {
     }
     
     /// Executes a batch hop
+    ///
+    /// `split_keys[i]` (`batch_plan::split_key(hop, split)`) names the hop/split
+    /// pair of `pdas[i]`; the PDAs are appended as writable remaining accounts.
     pub async fn execute_batch_hop(&mut self, 
                                 transfer_pda: &Pubkey,
                                 batch_index: u8,
+                                hop_count: u8,
+                                split_keys: &[u16],
                                 pdas: &[Pubkey]) 
         -> Result<(), TransportError> 
     {
-        // Construct all account metas for the PDAs
-        let mut accounts = batch_hop::BatchHopAccounts {
+        let accounts = batch_hop::BatchHopAccounts {
             authority: self.user.pubkey(),
             transfer_state: *transfer_pda,
-            pda_0: pdas[0],
-            pda_1: if pdas.len() > 1 { Some(pdas[1]) } else { None },
-            pda_2: if pdas.len() > 2 { Some(pdas[2]) } else { None },
-            pda_3: if pdas.len() > 3 { Some(pdas[3]) } else { None },
-            pda_4: if pdas.len() > 4 { Some(pdas[4]) } else { None },
-            pda_5: if pdas.len() > 5 { Some(pdas[5]) } else { None },
-            pda_6: if pdas.len() > 6 { Some(pdas[6]) } else { None },
-            pda_7: if pdas.len() > 7 { Some(pdas[7]) } else { None },
             system_program: system_program::id(),
         };
         
-        let ix = batch_hop_instruction(
-            batch_hop::BatchHopParams { batch_index },
+        let mut ix = batch_hop_instruction(
+            batch_hop::BatchHopParams {
+                batch_index,
+                hop_count,
+                split_keys: split_keys.to_vec(),
+            },
             accounts,
         );
         
+        // Split PDAs travel as remaining accounts, in the order given
+        ix.accounts.extend(pdas.iter().map(|pda| AccountMeta::new(*pda, false)));
+        
         self.execute_transaction(&[ix], &[&self.user]).await
     }
     
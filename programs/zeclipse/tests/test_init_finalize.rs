@@ -57,10 +57,10 @@ async fn test_initialize_basic() -> Result<(), TransportError> {
     assert_eq!(transfer_state.amount, amount);
     assert_eq!(transfer_state.current_hop, 0);
     assert_eq!(transfer_state.seed, seed);
-    assert_eq!(transfer_state.completed, false);
+    assert_eq!(transfer_state.is_completed(), false);
     assert_eq!(transfer_state.bump, bump);
     assert_eq!(transfer_state.config.reserve_percent, reserve_percent);
-    assert_eq!(transfer_state.refund_triggered, false);
+    assert_eq!(transfer_state.is_refund_triggered(), false);
     
     // 4. Verifiziere Lamport-Übertragung
     assert!(transfer_account.lamports >= amount, 
@@ -187,7 +187,7 @@ async fn test_finalize_after_hop() -> Result<(), TransportError> {
         &mut finalized_account.data.as_ref()
     ).expect("Transfer-State sollte deserialisierbar sein");
     
-    assert_eq!(finalized_state.completed, true);
+    assert_eq!(finalized_state.is_completed(), true);
     assert_eq!(finalized_state.recipient, recipient.pubkey());
     
     // 7. Verify Empfänger hat Lamports erhalten
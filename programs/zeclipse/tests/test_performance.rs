@@ -15,6 +15,7 @@ use solana_sdk::{
 mod test_framework;
 use test_framework::BlackoutTestFramework;
 use zeclipse::{
+    batch_plan::split_key,
     state::*,
     errors::ZEclipseError,
 };
@@ -132,9 +133,11 @@ async fn test_batch_processing_efficiency() {
     
     // Prepare PDAs for batch execution
     let mut pdas = Vec::with_capacity(4);
+    let mut split_keys = Vec::with_capacity(4);
     for hop in 0..4 {
         let (pda, _) = framework.derive_split_pda(&batch_seed, hop, 0, false);
         pdas.push(pda);
+        split_keys.push(split_key(hop, 0));
     }
     
     // Time measurement for batch
@@ -142,7 +145,7 @@ async fn test_batch_processing_efficiency() {
     
     // Execute all hops in one batch
     let batch_cu = framework.execute_batch_hop_with_cu_measurement(
-        &batch_transfer_pda, 0, &pdas
+        &batch_transfer_pda, 0, 4, &split_keys, &pdas
     ).await.expect("Batch execution failed");
     
     let batch_time = batch_start.elapsed();
@@ -430,13 +433,15 @@ impl BlackoutTestFramework {
         &mut self,
         transfer_pda: &Pubkey,
         batch_index: u8,
+        hop_count: u8,
+        split_keys: &[u16],
         pdas: &[Pubkey],
     ) -> Result<u64, BanksClientError> {
         // Vor Ausführung verfügbare CUs messen
         let before_cu = self.get_remaining_compute_units().await;
         
         // Batch-Hop ausführen
-        self.execute_batch_hop(transfer_pda, batch_index, pdas).await?;
+        self.execute_batch_hop(transfer_pda, batch_index, hop_count, split_keys, pdas).await?;
         
         // Nach Ausführung verfügbare CUs messen
         let after_cu = self.get_remaining_compute_units().await;
@@ -3,6 +3,7 @@
 //! These tests validate the correct implementation of Poseidon parameters
 //! and hash functions for Zero-Knowledge Proof applications.
 
+use zeclipse::hash_context::HashContext;
 use zeclipse::utils;
 
 // Import of test_framework and other common test components
@@ -32,7 +33,7 @@ fn test_poseidon_parameters() {
     }
     
     // Try to calculate the hash - this will fail if the parameters are incorrect
-    let hash_result = utils::poseidon_hash_commitments(&commitments);
+    let hash_result = utils::poseidon_hash_commitments(&mut HashContext::new(), &commitments);
     
     // Prüfe, ob der Hash erfolgreich war
     assert!(hash_result.is_ok(), "Poseidon Hash fehlgeschlagen - Parameter könnten fehlerhaft sein");
@@ -61,11 +62,11 @@ fn test_poseidon_hash_consistency() {
     }
     
     // Calculate first hash
-    let hash_1 = utils::poseidon_hash_commitments(&commitments_1)
+    let hash_1 = utils::poseidon_hash_commitments(&mut HashContext::new(), &commitments_1)
         .expect("Erster Hash sollte erfolgreich sein");
     
     // Repeat with same data to test consistency
-    let hash_2 = utils::poseidon_hash_commitments(&commitments_1)
+    let hash_2 = utils::poseidon_hash_commitments(&mut HashContext::new(), &commitments_1)
         .expect("Zweiter Hash sollte erfolgreich sein");
     
     // Check consistency
@@ -76,7 +77,7 @@ fn test_poseidon_hash_consistency() {
     commitments_2[0] = test_data_2;
     
     // Calculate hash with modified data
-    let hash_3 = utils::poseidon_hash_commitments(&commitments_2)
+    let hash_3 = utils::poseidon_hash_commitments(&mut HashContext::new(), &commitments_2)
         .expect("Dritter Hash sollte erfolgreich sein");
     
     // Check if hash changes with modified data
@@ -113,7 +114,7 @@ fn test_poseidon_complex_operations() {
     }
     
     // Calculate hash with complex data
-    let complex_hash = utils::poseidon_hash_commitments(&complex_commitments);
+    let complex_hash = utils::poseidon_hash_commitments(&mut HashContext::new(), &complex_commitments);
     
     // Prüfe, ob der Hash erfolgreich war
     assert!(complex_hash.is_ok(), "Komplexer Poseidon Hash fehlgeschlagen");
@@ -132,7 +133,7 @@ fn test_poseidon_error_handling() {
     
     // Normal input, should be successful
     let valid_commitments = [[0u8; 32]; 8];
-    let valid_result = utils::poseidon_hash_commitments(&valid_commitments);
+    let valid_result = utils::poseidon_hash_commitments(&mut HashContext::new(), &valid_commitments);
     assert!(valid_result.is_ok(), "Poseidon Hash sollte für gültige Eingabe erfolgreich sein");
     
     // We can't do direct error checking here because we have no way
@@ -65,12 +65,12 @@ async fn test_refund_full_process() {
     
     assert_eq!(transfer_state.current_hop, 2, "Incorrect hop index after 2 hops");
     assert_eq!(transfer_state.progress_percent(), 50, "Incorrect progress after 2 hops");
-    assert!(!transfer_state.completed, "Transfer should not be completed");
-    assert!(!transfer_state.refund_triggered, "Refund should not be triggered");
+    assert!(!transfer_state.is_completed(), "Transfer should not be completed");
+    assert!(!transfer_state.is_refund_triggered(), "Refund should not be triggered");
     assert_eq!(transfer_state.current_hop, 2, "Incorrect hop index after 2 hops");
     assert_eq!(transfer_state.progress_percent(), 50, "Incorrect progress after 2 hops");
-    assert!(!transfer_state.completed, "Transfer should not be completed");
-    assert!(!transfer_state.refund_triggered, "Refund should not be triggered");
+    assert!(!transfer_state.is_completed(), "Transfer should not be completed");
+    assert!(!transfer_state.is_refund_triggered(), "Refund should not be triggered");
     
     // 5. Request refund
     framework.refund_transfer(&transfer_pda)
@@ -83,7 +83,7 @@ async fn test_refund_full_process() {
     let refunded_state = framework.get_transfer_state(&transfer_pda).await
         .expect("Could not retrieve transfer state after refund");
     
-    assert!(refunded_state.refund_triggered, "Refund flag was not set");
+    assert!(refunded_state.is_refund_triggered(), "Refund flag was not set");
     
     // 7. Verify that the user received ~95% of the amount back
     // (minus transaction fees for tests)
@@ -155,7 +155,7 @@ async fn test_refund_immediately_after_init() {
     let refunded_state = framework.get_transfer_state(&transfer_pda).await
         .expect("Could not retrieve transfer state after refund");
     
-    assert!(refunded_state.refund_triggered, "Refund flag was not set");
+    assert!(refunded_state.is_refund_triggered(), "Refund flag was not set");
     assert_eq!(refunded_state.current_hop, 0, "Current hop should be 0");
     assert_eq!(refunded_state.progress_percent(), 0, "Progress should be 0%");
     
@@ -236,7 +236,7 @@ async fn test_finalize_with_reserve() {
     
     assert_eq!(transfer_state.current_hop, 4, "Incorrect hop index after 4 hops");
     assert_eq!(transfer_state.progress_percent(), 100, "Incorrect progress after 4 hops");
-    assert!(!transfer_state.completed, "Transfer should not be finalized");
+    assert!(!transfer_state.is_completed(), "Transfer should not be finalized");
     
     // 5. Finalize transfer
     framework.finalize_transfer(&transfer_pda, &recipient.pubkey())
@@ -335,6 +335,13 @@ impl BlackoutTestFramework {
         // Fake-Bloom-Filter erstellen
         let fake_bloom = self.create_fake_bloom_filter(&[5, 10, 15, 20]);
         
+        // Bump table for the stealth seed the program derives from challenge + payer
+        let stealth_seed = Pubkey::find_program_address(
+            &[b"zeclipse", &challenge, self.user.pubkey().as_ref()],
+            &self.program_id,
+        ).0.to_bytes();
+        let stealth_bumps = zeclipse::stealth_pda::compute_bump_table(&self.program_id, &stealth_seed, 4);
+        
         // Initialisierungsinstruktion erstellen
         let ix = Instruction {
             program_id: self.program_id,
@@ -345,13 +352,17 @@ impl BlackoutTestFramework {
                 AccountMeta::new_readonly(merkle_root.pubkey(), false),
                 AccountMeta::new_readonly(system_program::ID, false),
                 AccountMeta::new_readonly(solana_program::sysvar::clock::ID, false),
+                // Kein Transfer-Register: Nonce 0 ist der Standard-Transfer des Nutzers
+                AccountMeta::new_readonly(self.program_id, false),
             ],
             data: zeclipse::instruction::Initialize {
+                nonce: 0,
                 amount,
                 hyperplonk_proof,
                 range_proof,
                 challenge,
-                merkle_proof: vec![],
+                stealth_bumps,
+                recipient_count: 1,
             }.data(),
         };
         
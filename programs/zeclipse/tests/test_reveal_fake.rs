@@ -17,6 +17,9 @@ use test_framework::BlackoutTestFramework;
 use zeclipse::{
     state::*,
     errors::ZEclipseError,
+    bloom::{FakeBloom, FAKE_BLOOM_BYTES},
+    hash_context::HashContext,
+    utils::{fake_split_path, fake_split_root},
 };
 
 // Test für die erfolgreiche Offenlegung eines Fake-Splits
@@ -67,7 +70,7 @@ async fn test_reveal_fake_success() {
     
     assert_eq!(transfer_state.current_hop, 1, 
               "Hop-Index sollte nach Reveal-Fake unverändert sein");
-    assert!(!transfer_state.completed, 
+    assert!(!transfer_state.is_completed(), 
             "Transfer sollte nach Reveal-Fake nicht als abgeschlossen markiert sein");
 }
 
@@ -198,6 +201,56 @@ async fn test_reveal_fake_wrong_pda() {
     println!("Test erfolgreich: Fake-Split konnte nicht mit falscher PDA enthüllt werden");
 }
 
+// Test für die Materialisierung eines nur committeten Fake-Splits
+#[tokio::test]
+async fn test_reveal_committed_fake_materializes() {
+    // 1. Test-Framework initialisieren
+    let mut framework = BlackoutTestFramework::new().await;
+    
+    // 2. Transfer initialisieren, Fake-Splits nur als Commitments
+    let amount = 300_000_000; // 0.3 SOL
+    let (transfer_pda, seed) = framework.initialize_transfer(amount, 10)
+        .await
+        .expect("Transfer-Initialisierung fehlgeschlagen");
+    framework.force_set_fake_mode(&transfer_pda, FAKE_MODE_COMMITTED)
+        .await
+        .expect("Setzen des Fake-Modus fehlgeschlagen");
+    
+    // Wurzel des Fake-Split-Baums aus den Blindings des Clients
+    let config = BlackoutConfig::new();
+    let blindings = test_fake_blindings(&config);
+    let mut hash_ctx = HashContext::new();
+    let fake_root = fake_split_root(&mut hash_ctx, &config, &blindings).unwrap();
+    framework.force_set_fake_root(&transfer_pda, &fake_root)
+        .await
+        .expect("Setzen der Fake-Split-Wurzel fehlgeschlagen");
+    
+    // 3. Der Fake-Split existiert vor der Offenlegung nicht als Account
+    let (hop_index, split_index) = (1, 10);
+    let (fake_pda, _) = framework.derive_split_pda(&seed, hop_index, split_index, true);
+    let before = framework.context.banks_client.get_account(fake_pda).await.unwrap();
+    assert!(before.is_none(), "Committeter Fake-Split sollte noch keinen Account haben");
+    
+    let position = hop_index as usize * config.fake_splits as usize + (split_index - config.real_splits) as usize;
+    let path = fake_split_path(&mut hash_ctx, &config, &blindings, hop_index, split_index).unwrap();
+    
+    // 4. Offenlegen materialisiert den Account genau einmal
+    for _ in 0..2 {
+        framework.reveal_fake_split_with_opening(&transfer_pda, hop_index, split_index, &fake_pda, blindings[position], path.clone())
+            .await
+            .expect("Offenlegung des committeten Fake-Splits fehlgeschlagen");
+        let account = framework.context.banks_client.get_account(fake_pda).await.unwrap()
+            .expect("Fake-Split sollte nach der Offenlegung existieren");
+        assert_eq!(account.lamports, Rent::default().minimum_balance(0),
+                  "Fake-Split sollte genau einmal finanziert werden");
+    }
+    
+    let transfer_state = framework.get_transfer_state(&transfer_pda).await
+        .expect("Konnte Transfer-State nicht abrufen");
+    assert!(transfer_state.has_committed_fakes());
+    assert_eq!(transfer_state.current_hop, 0, "Offenlegung sollte keinen Hop ausführen");
+}
+
 // Erweitere die BlackoutTestFramework um spezifische Hilfsmethoden
 impl BlackoutTestFramework {
     // Transfer mit spezifischen Fake-Splits initialisieren
@@ -231,6 +284,13 @@ impl BlackoutTestFramework {
         // Standardempfänger verwenden (uns selbst)
         let recipient = self.user.pubkey();
         
+        // Bump table for the stealth seed the program derives from challenge + payer
+        let stealth_seed = Pubkey::find_program_address(
+            &[b"zeclipse", &challenge, self.user.pubkey().as_ref()],
+            &self.program_id,
+        ).0.to_bytes();
+        let stealth_bumps = zeclipse::stealth_pda::compute_bump_table(&self.program_id, &stealth_seed, 4);
+        
         // Initialisierungsinstruktion erstellen
         let ix = Instruction {
             program_id: self.program_id,
@@ -241,13 +301,17 @@ impl BlackoutTestFramework {
                 AccountMeta::new_readonly(merkle_root.pubkey(), false),
                 AccountMeta::new_readonly(system_program::ID, false),
                 AccountMeta::new_readonly(solana_program::sysvar::clock::ID, false),
+                // Kein Transfer-Register: Nonce 0 ist der Standard-Transfer des Nutzers
+                AccountMeta::new_readonly(self.program_id, false),
             ],
             data: zeclipse::instruction::Initialize {
+                nonce: 0,
                 amount,
                 hyperplonk_proof,
                 range_proof,
                 challenge,
-                merkle_proof: vec![],
+                stealth_bumps,
+                recipient_count: 1,
             }.data(),
         };
         
@@ -261,26 +325,41 @@ impl BlackoutTestFramework {
         Ok((transfer_pda, seed))
     }
     
-    // Reveal-Fake-Instruktion ausführen
+    // Reveal-Fake-Instruktion ausführen (finanzierte Fake-Splits, ohne Öffnung)
     pub async fn reveal_fake_split(
         &mut self,
         transfer_pda: &Pubkey,
         hop_index: u8,
         split_index: u8,
         fake_pda: &Pubkey,
+    ) -> Result<(), BanksClientError> {
+        self.reveal_fake_split_with_opening(transfer_pda, hop_index, split_index, fake_pda, [0; 32], vec![]).await
+    }
+    
+    // Reveal-Fake-Instruktion mit Blinding und Pfad eines committeten Fake-Splits
+    pub async fn reveal_fake_split_with_opening(
+        &mut self,
+        transfer_pda: &Pubkey,
+        hop_index: u8,
+        split_index: u8,
+        fake_pda: &Pubkey,
+        blinding: [u8; 32],
+        path: Vec<[u8; 32]>,
     ) -> Result<(), BanksClientError> {
         // Reveal-Fake-Instruktion erstellen
         let ix = Instruction {
             program_id: self.program_id,
             accounts: vec![
                 AccountMeta::new(self.user.pubkey(), true),
-                AccountMeta::new_readonly(transfer_pda.clone(), false),
-                AccountMeta::new_readonly(fake_pda.clone(), false),
+                AccountMeta::new(transfer_pda.clone(), false),
+                AccountMeta::new(fake_pda.clone(), false),
                 AccountMeta::new_readonly(system_program::ID, false),
             ],
-            data: zeclipse::instruction::RevealFake {
+            data: zeclipse::instruction::RevealFakeSplit {
                 hop_index,
                 split_index,
+                blinding,
+                path,
             }.data(),
         };
         
@@ -288,11 +367,47 @@ impl BlackoutTestFramework {
         self.execute_transaction(&[ix], &[&self.user]).await
     }
     
+    // Hilfsmethode, um den Fake-Modus direkt zu setzen (nur für Tests)
+    async fn force_set_fake_mode(
+        &mut self,
+        transfer_pda: &Pubkey,
+        fake_mode: u8,
+    ) -> Result<(), BanksClientError> {
+        let mut account = self.context.banks_client
+            .get_account(*transfer_pda)
+            .await?
+            .expect("Transfer-State existiert nicht");
+        
+        // Discriminator (8) + Offset von fake_mode im Zero-Copy-Layout (7)
+        account.data[8 + 7] = fake_mode;
+        self.context.set_account(transfer_pda, &account);
+        
+        Ok(())
+    }
+    
+    // Hilfsmethode, um die Fake-Split-Wurzel direkt zu setzen (nur für Tests)
+    async fn force_set_fake_root(
+        &mut self,
+        transfer_pda: &Pubkey,
+        fake_root: &[u8; 32],
+    ) -> Result<(), BanksClientError> {
+        let mut account = self.context.banks_client
+            .get_account(*transfer_pda)
+            .await?
+            .expect("Transfer-State existiert nicht");
+        
+        // Discriminator (8) + Offset von fake_root im Zero-Copy-Layout (1336)
+        account.data[8 + 1336..8 + 1368].copy_from_slice(fake_root);
+        self.context.set_account(transfer_pda, &account);
+        
+        Ok(())
+    }
+    
     // Hilfsmethode, um den Bloom-Filter direkt zu setzen (nur für Tests)
     async fn force_set_bloom_filter(
         &mut self,
         transfer_pda: &Pubkey,
-        bloom_filter: &[u8; 16],
+        bloom_filter: &FakeBloom,
     ) -> Result<(), BanksClientError> {
         // Diese Methode ist nur für Tests und simuliert das direkte Setzen des Bloom-Filters
         // In einer realen Implementierung würde dies nicht existieren
@@ -308,8 +423,9 @@ impl BlackoutTestFramework {
         // WARNUNG: Dies ist ein Hack für Tests - in der Realität würde man dies nie tun!
         // Wir kennen die genaue Offset-Position des Bloom-Filters im TransferState
         // und überschreiben ihn direkt (nur für Tests!)
-        let bloom_offset = 180; // Beispiel-Offset für den fake_bloom im TransferState
-        for i in 0..16 {
+        // Discriminator (8) + Offset von fake_bloom im Zero-Copy-Layout (184)
+        let bloom_offset = 8 + 184;
+        for i in 0..FAKE_BLOOM_BYTES {
             if bloom_offset + i < data.len() {
                 data[bloom_offset + i] = bloom_filter[i];
             }
@@ -325,3 +441,15 @@ impl BlackoutTestFramework {
         Ok(())
     }
 }
+
+// Blindings der Fake-Splits in Baumreihenfolge (kanonische BN254-Skalare)
+fn test_fake_blindings(config: &BlackoutConfig) -> Vec<[u8; 32]> {
+    (0..config.num_hops as usize * config.fake_splits as usize)
+        .map(|position| {
+            let mut blinding = [9u8; 32];
+            blinding[0] = 0;
+            blinding[31] = position as u8;
+            blinding
+        })
+        .collect()
+}
@@ -0,0 +1,632 @@
+/// Programmtests auf direkt eingespielten Transfer-States
+///
+/// `initialize` lässt sich vom Host aus nicht treiben: die Opening-Prüfung
+/// des Range-Proofs verlangt einen 32-Bit-Grind. Diese Tests starten deshalb
+/// mit einem State, wie ihn `initialize` schreibt, und bauen die Proofs der
+/// Hops mit `build_hyperplonk_proof`, so dass jede Instruktion wirklich bis
+/// zu ihren Lamport-Transfers läuft.
+
+use anchor_lang::{Discriminator, InstructionData};
+use solana_program_test::*;
+use solana_sdk::{
+    account::Account,
+    clock::Clock,
+    compute_budget::ComputeBudgetInstruction,
+    instruction::{AccountMeta, Instruction},
+    pubkey::Pubkey,
+    rent::Rent,
+    signature::{Keypair, Signer},
+    system_program,
+    sysvar,
+    transaction::Transaction,
+};
+
+use zeclipse::{
+    batch_plan::{accounts_per_hop, funded_fake_splits, split_key, MAX_TRANSACTION_CU},
+    hash_context::HashContext,
+    instructions::config_update::ConfigUpdateParams,
+    stealth_pda::{compute_bump_table, find_stealth_pda},
+    state::*,
+    utils::{
+        build_hyperplonk_proof, calculate_fees, fake_split_path, fake_split_position, fake_split_root,
+        finalize_challenge, generate_bloom_filter, hop_amount, hop_challenge, split_plan,
+    },
+};
+
+const AMOUNT: u64 = 100_000_000; // 0.1 SOL
+const OWNER_LAMPORTS: u64 = 10_000_000_000;
+
+/// Eingespielter Transfer mit seinem Besitzer und der Bank
+struct SeededTransfer {
+    client: BanksClient,
+    payer: Keypair,
+    owner: Keypair,
+    state_pda: Pubkey,
+    recipient: Pubkey,
+    seed: [u8; 32],
+    config: BlackoutConfig,
+    amount: u64,
+    /// Blindings der committeten Fake-Splits in Baumreihenfolge (leer im finanzierten Modus)
+    blindings: Vec<[u8; 32]>,
+    /// Gesendete Transaktionen (macht wiederholte Instruktionen eindeutig)
+    sent: u32,
+}
+
+impl SeededTransfer {
+    /// Startet eine Bank mit einem Transfer über `AMOUNT` an Hop 0
+    async fn start(fake_mode: u8) -> Self {
+        Self::start_with_amount(fake_mode, AMOUNT).await
+    }
+
+    /// Startet eine Bank mit einem Transfer an Hop 0 im gegebenen Fake-Modus
+    async fn start_with_amount(fake_mode: u8, amount: u64) -> Self {
+        Self::start_at_hop(fake_mode, amount, 0).await
+    }
+
+    /// Startet eine Bank mit einem Transfer, dessen erste `hops_done` Hops
+    /// bereits ausgeführt sind: ihre Split-PDAs halten die Beträge des Split-Plans
+    async fn start_at_hop(fake_mode: u8, amount: u64, hops_done: u8) -> Self {
+        Self::start_with_config(BlackoutConfig::new(), fake_mode, amount, hops_done).await
+    }
+
+    /// Wie `start_at_hop`, mit eigener Konfiguration (z. B. eines Performance-Profils)
+    async fn start_with_config(config: BlackoutConfig, fake_mode: u8, amount: u64, hops_done: u8) -> Self {
+        let program_id = zeclipse::id();
+        let owner = Keypair::new();
+        let recipient = Pubkey::new_unique();
+
+        // Kanonischer BN254-Skalar (erstes Byte 0), wie ihn die Proofs verlangen
+        let mut challenge = [7u8; 32];
+        challenge[0] = 0;
+
+        let (state_pda, bump) = Pubkey::find_program_address(
+            &[b"transfer", owner.pubkey().as_ref(), transfer_nonce_seed(&0)],
+            &program_id,
+        );
+        let seed = Pubkey::find_program_address(
+            &[b"zeclipse", &challenge, owner.pubkey().as_ref()],
+            &program_id,
+        ).0.to_bytes();
+        let (total_fees, reserve) = calculate_fees(amount, &config).unwrap();
+
+        let mut recipients = [Pubkey::default(); MAX_RECIPIENTS];
+        recipients[0] = recipient;
+        let batch_proof = build_hyperplonk_proof(&mut HashContext::new(), &challenge, amount).unwrap();
+        let mut state = TransferState::new(
+            owner.pubkey(),
+            amount,
+            seed,
+            bump,
+            recipients,
+            1,
+            config,
+            batch_proof,
+            [0u8; 128],
+            challenge,
+            challenge,
+            generate_bloom_filter(&config, &challenge),
+            compute_bump_table(&program_id, &seed, config.real_splits),
+            0,
+        );
+        state.total_fees = total_fees;
+        state.reserve = reserve;
+        state.fake_mode = fake_mode;
+        state.current_hop = hops_done;
+        state.batch_count = hops_done.min(1);
+        let funded_per_hop = if fake_mode == FAKE_MODE_FUNDED {
+            accounts_per_hop(config.real_splits, config.fake_splits)
+        } else {
+            config.real_splits
+        };
+        state.funded_splits = hops_done as u16 * funded_per_hop as u16;
+
+        // Committete Fakes: Wurzel ihres Baums, wie sie `config_update` speichert
+        let blindings = if fake_mode == FAKE_MODE_COMMITTED { fake_blindings(&config) } else { Vec::new() };
+        if fake_mode == FAKE_MODE_COMMITTED {
+            state.fake_root = fake_split_root(&mut HashContext::new(), &config, &blindings).unwrap();
+        }
+
+        let mut data = Vec::with_capacity(TransferState::SIZE);
+        data.extend_from_slice(&TransferState::DISCRIMINATOR);
+        data.extend_from_slice(bytemuck::bytes_of(&state));
+        // Deposit wie bei `initialize`, inklusive Miete der finanzierten Fake-Splits
+        let fake_rent = funded_fake_splits(config.num_hops, config.fake_splits) * Rent::default().minimum_balance(0);
+        let mut lamports = Rent::default().minimum_balance(data.len()) + amount + total_fees + reserve + fake_rent;
+
+        let mut program_test = ProgramTest::new("zeclipse", program_id, processor!(zeclipse::entry));
+        let plan = split_plan(&mut HashContext::new(), &batch_proof, amount, config.num_hops, &challenge).unwrap();
+        for hop in 0..hops_done {
+            for split in 0..funded_per_hop {
+                let is_fake = config.is_fake_split_index(split);
+                let split_lamports = if is_fake { Rent::default().minimum_balance(0) } else { plan[hop as usize][split as usize] };
+                let pda = find_stealth_pda(&program_id, &seed, hop, split, is_fake).0;
+                program_test.add_account(pda, Account::new(split_lamports, 0, &system_program::ID));
+                lamports -= split_lamports;
+            }
+        }
+        program_test.add_account(owner.pubkey(), Account::new(OWNER_LAMPORTS, 0, &system_program::ID));
+        program_test.add_account(state_pda, Account { lamports, data, owner: program_id, executable: false, rent_epoch: 0 });
+        let (client, payer, _) = program_test.start().await;
+
+        Self { client, payer, owner, state_pda, recipient, seed, config, amount, blindings, sent: 0 }
+    }
+
+    /// Adresse eines Split-PDAs
+    fn split_pda(&self, hop_index: u8, split_index: u8) -> Pubkey {
+        let is_fake = self.config.is_fake_split_index(split_index);
+        find_stealth_pda(&zeclipse::id(), &self.seed, hop_index, split_index, is_fake).0
+    }
+
+    /// Sendet `ix` mit vollem CU-Limit, signiert von Payer und `signer`
+    async fn send(&mut self, ix: Instruction, signer: &Keypair) -> Result<(), BanksClientError> {
+        // Das Limit zählt herunter, damit gleiche Instruktionen eigene Signaturen bekommen
+        self.sent += 1;
+        let limit = ComputeBudgetInstruction::set_compute_unit_limit(MAX_TRANSACTION_CU - self.sent);
+        let blockhash = self.client.get_latest_blockhash().await?;
+        let tx = Transaction::new_signed_with_payer(
+            &[limit, ix],
+            Some(&self.payer.pubkey()),
+            &[&self.payer, signer],
+            blockhash,
+        );
+        self.client.process_transaction(tx).await
+    }
+
+    async fn lamports(&mut self, address: Pubkey) -> u64 {
+        self.client.get_account(address).await.unwrap().map_or(0, |account| account.lamports)
+    }
+
+    async fn state(&mut self) -> TransferState {
+        let account = self.client.get_account(self.state_pda).await.unwrap().expect("Transfer-State existiert");
+        bytemuck::pod_read_unaligned(&account.data[8..TransferState::SIZE])
+    }
+
+    /// Batch-Hop über `hop_count` Hops ab `first_hop` mit allen finanzierten Splits
+    fn batch_hop_ix(&self, batch_index: u8, first_hop: u8, hop_count: u8) -> (Instruction, Vec<Pubkey>) {
+        let per_hop = accounts_per_hop(self.config.real_splits, self.config.fake_splits);
+        let mut split_keys = Vec::new();
+        let mut pdas = Vec::new();
+        for hop in first_hop..first_hop + hop_count {
+            for split in 0..per_hop {
+                split_keys.push(split_key(hop, split));
+                pdas.push(self.split_pda(hop, split));
+            }
+        }
+        let mut accounts = vec![
+            AccountMeta::new(self.owner.pubkey(), true),
+            AccountMeta::new(self.state_pda, false),
+            AccountMeta::new_readonly(system_program::ID, false),
+        ];
+        accounts.extend(pdas.iter().map(|pda| AccountMeta::new(*pda, false)));
+        let ix = Instruction {
+            program_id: zeclipse::id(),
+            accounts,
+            data: zeclipse::instruction::ExecuteBatchHop { batch_index, hop_count, split_keys }.data(),
+        };
+        (ix, pdas)
+    }
+
+    /// Einzelner Hop mit einem Proof zur Challenge der aktuellen Bank-Uhr
+    async fn execute_hop_ix(&mut self, hop_index: u8) -> Instruction {
+        let clock: Clock = self.client.get_sysvar().await.unwrap();
+        let challenge = hop_challenge(clock.unix_timestamp, hop_index, &self.owner.pubkey(), &self.seed);
+        let proof_data = build_hyperplonk_proof(&mut HashContext::new(), &challenge, self.amount).unwrap();
+
+        let mut accounts = vec![
+            AccountMeta::new(self.owner.pubkey(), true),
+            AccountMeta::new(self.state_pda, false),
+            AccountMeta::new(self.split_pda(hop_index, 0), false),
+            AccountMeta::new(Pubkey::new_unique(), false),
+            AccountMeta::new_readonly(system_program::ID, false),
+            AccountMeta::new_readonly(sysvar::clock::ID, false),
+        ];
+        for split in 1..self.config.real_splits {
+            accounts.push(AccountMeta::new(self.split_pda(hop_index, split), false));
+        }
+        Instruction {
+            program_id: zeclipse::id(),
+            accounts,
+            data: zeclipse::instruction::ExecuteHop { hop_index, proof_data }.data(),
+        }
+    }
+
+    /// Finalisierung mit einem Proof zur Challenge der aktuellen Bank-Uhr
+    async fn finalize_ix(&mut self) -> Instruction {
+        let clock: Clock = self.client.get_sysvar().await.unwrap();
+        let challenge = finalize_challenge(clock.unix_timestamp, &self.owner.pubkey(), &self.recipient, &self.seed);
+        let proof_data = build_hyperplonk_proof(&mut HashContext::new(), &challenge, self.amount).unwrap();
+
+        let mut accounts = vec![
+            AccountMeta::new(self.owner.pubkey(), true),
+            AccountMeta::new(self.state_pda, false),
+            AccountMeta::new(self.recipient, false),
+            AccountMeta::new_readonly(system_program::ID, false),
+        ];
+        for hop in 0..self.config.num_hops {
+            for split in 0..self.config.real_splits {
+                accounts.push(AccountMeta::new(self.split_pda(hop, split), false));
+            }
+        }
+        Instruction {
+            program_id: zeclipse::id(),
+            accounts,
+            data: zeclipse::instruction::FinalizeTransfer { proof_data, recipient_proof: vec![] }.data(),
+        }
+    }
+
+    /// Reclaim der Split-PDAs `split_keys`, optional mit Schließen des States
+    fn reclaim_ix(&self, authority: Pubkey, split_keys: Vec<u16>, close_state: bool) -> Instruction {
+        let mut accounts = vec![
+            AccountMeta::new(authority, true),
+            AccountMeta::new(self.state_pda, false),
+            AccountMeta::new(self.owner.pubkey(), false),
+            AccountMeta::new_readonly(system_program::ID, false),
+            // Kein Transfer-Register: Nonce 0
+            AccountMeta::new_readonly(zeclipse::id(), false),
+        ];
+        for &key in &split_keys {
+            accounts.push(AccountMeta::new(self.split_pda((key >> 8) as u8, key as u8), false));
+        }
+        Instruction {
+            program_id: zeclipse::id(),
+            accounts,
+            data: zeclipse::instruction::ReclaimTransfer { split_keys, close_state }.data(),
+        }
+    }
+
+    /// Offenlegung mit der Öffnung des Splits (ohne Öffnung im finanzierten Modus)
+    fn reveal_fake_ix(&self, authority: Pubkey, hop_index: u8, split_index: u8) -> Instruction {
+        if self.blindings.is_empty() {
+            return self.reveal_fake_ix_with_opening(authority, hop_index, split_index, [0; 32], vec![]);
+        }
+        let position = fake_split_position(&self.config, hop_index, split_index).unwrap();
+        let path = fake_split_path(&mut HashContext::new(), &self.config, &self.blindings, hop_index, split_index).unwrap();
+        self.reveal_fake_ix_with_opening(authority, hop_index, split_index, self.blindings[position], path)
+    }
+
+    fn reveal_fake_ix_with_opening(
+        &self,
+        authority: Pubkey,
+        hop_index: u8,
+        split_index: u8,
+        blinding: [u8; 32],
+        path: Vec<[u8; 32]>,
+    ) -> Instruction {
+        Instruction {
+            program_id: zeclipse::id(),
+            accounts: vec![
+                AccountMeta::new(authority, true),
+                AccountMeta::new(self.state_pda, false),
+                AccountMeta::new(self.split_pda(hop_index, split_index), false),
+                AccountMeta::new_readonly(system_program::ID, false),
+            ],
+            data: zeclipse::instruction::RevealFakeSplit { hop_index, split_index, blinding, path }.data(),
+        }
+    }
+
+    fn refund_ix(&self, authority: Pubkey, dev_account: Pubkey) -> Instruction {
+        Instruction {
+            program_id: zeclipse::id(),
+            accounts: vec![
+                AccountMeta::new(authority, true),
+                AccountMeta::new(self.state_pda, false),
+                AccountMeta::new(self.owner.pubkey(), false),
+                AccountMeta::new(dev_account, false),
+                AccountMeta::new_readonly(system_program::ID, false),
+            ],
+            data: zeclipse::instruction::TriggerRefund {}.data(),
+        }
+    }
+
+    fn config_update_ix(&self, authority: Pubkey, update_params: ConfigUpdateParams) -> Instruction {
+        Instruction {
+            program_id: zeclipse::id(),
+            accounts: vec![
+                AccountMeta::new(authority, true),
+                AccountMeta::new(self.state_pda, false),
+                AccountMeta::new_readonly(system_program::ID, false),
+            ],
+            data: zeclipse::instruction::UpdateConfig { update_params }.data(),
+        }
+    }
+}
+
+/// Blindings der Fake-Splits in Baumreihenfolge (kanonische BN254-Skalare)
+fn fake_blindings(config: &BlackoutConfig) -> Vec<[u8; 32]> {
+    (0..config.num_hops as usize * config.fake_splits as usize)
+        .map(|position| {
+            let mut blinding = [9u8; 32];
+            blinding[0] = 0;
+            blinding[31] = position as u8;
+            blinding
+        })
+        .collect()
+}
+
+// Offenlegen eines nur committeten Fakes legt den Account mietfrei an
+#[tokio::test]
+async fn test_reveal_materializes_committed_fake() {
+    let mut transfer = SeededTransfer::start(FAKE_MODE_COMMITTED).await;
+    let (hop_index, split_index) = (1, transfer.config.real_splits);
+    let fake_pda = transfer.split_pda(hop_index, split_index);
+    let rent_exempt = Rent::default().minimum_balance(0);
+    let state_before = transfer.lamports(transfer.state_pda).await;
+    assert_eq!(transfer.lamports(fake_pda).await, 0, "Committeter Fake hat noch keinen Account");
+
+    // Ein Fremder darf den Fake nicht auf Kosten des Transfers anlegen
+    let stranger = Keypair::new();
+    let ix = transfer.reveal_fake_ix(stranger.pubkey(), hop_index, split_index);
+    assert!(transfer.send(ix, &stranger).await.is_err());
+
+    // Der Besitzer materialisiert ihn genau einmal
+    let owner = transfer.owner.insecure_clone();
+    for _ in 0..2 {
+        let ix = transfer.reveal_fake_ix(owner.pubkey(), hop_index, split_index);
+        transfer.send(ix, &owner).await.expect("Offenlegung des committeten Fakes");
+        assert_eq!(transfer.lamports(fake_pda).await, rent_exempt);
+    }
+    assert_eq!(transfer.lamports(transfer.state_pda).await, state_before - rent_exempt);
+    let state = transfer.state().await;
+    assert_eq!(state.current_hop, 0, "Offenlegung führt keinen Hop aus");
+    assert_eq!(state.funded_splits, 1, "Der Fake zählt bis zum Reclaim als finanziert");
+}
+
+// Ohne gültige Öffnung gegen die gespeicherte Wurzel entsteht kein Account
+#[tokio::test]
+async fn test_reveal_rejects_wrong_fake_opening() {
+    let mut transfer = SeededTransfer::start(FAKE_MODE_COMMITTED).await;
+    let owner = transfer.owner.insecure_clone();
+    let (hop_index, split_index) = (1, transfer.config.real_splits);
+    let fake_pda = transfer.split_pda(hop_index, split_index);
+    let position = fake_split_position(&transfer.config, hop_index, split_index).unwrap();
+    let blinding = transfer.blindings[position];
+    let path = fake_split_path(&mut HashContext::new(), &transfer.config, &transfer.blindings, hop_index, split_index).unwrap();
+
+    // Falsches Blinding
+    let mut wrong_blinding = blinding;
+    wrong_blinding[1] ^= 1;
+    let ix = transfer.reveal_fake_ix_with_opening(owner.pubkey(), hop_index, split_index, wrong_blinding, path.clone());
+    assert!(transfer.send(ix, &owner).await.is_err(), "Falsches Blinding muss scheitern");
+
+    // Die Öffnung eines anderen Fake-Splits passt nicht zu diesem Index
+    let other = split_index + 1;
+    let other_position = fake_split_position(&transfer.config, hop_index, other).unwrap();
+    let other_path = fake_split_path(&mut HashContext::new(), &transfer.config, &transfer.blindings, hop_index, other).unwrap();
+    let ix = transfer.reveal_fake_ix_with_opening(
+        owner.pubkey(), hop_index, split_index, transfer.blindings[other_position], other_path,
+    );
+    assert!(transfer.send(ix, &owner).await.is_err(), "Fremde Öffnung muss scheitern");
+
+    // Ein verkürzter Pfad ist keine Öffnung
+    let ix = transfer.reveal_fake_ix_with_opening(owner.pubkey(), hop_index, split_index, blinding, path[1..].to_vec());
+    assert!(transfer.send(ix, &owner).await.is_err(), "Verkürzter Pfad muss scheitern");
+
+    assert_eq!(transfer.lamports(fake_pda).await, 0, "Ohne Öffnung kein Account");
+    assert_eq!(transfer.state().await.funded_splits, 0);
+}
+
+// Ein echter Batch-Hop legt jeden Split mietfrei an
+#[tokio::test]
+async fn test_batch_hop_funds_splits_rent_exempt() {
+    let mut transfer = SeededTransfer::start(FAKE_MODE_FUNDED).await;
+    let rent_exempt = Rent::default().minimum_balance(0);
+    let real_splits = transfer.config.real_splits as usize;
+    let state_before = transfer.lamports(transfer.state_pda).await;
+
+    let owner = transfer.owner.insecure_clone();
+    let (ix, pdas) = transfer.batch_hop_ix(0, 0, 1);
+    transfer.send(ix, &owner).await.expect("Batch-Hop mit gültigem Proof");
+
+    let mut real_total = 0;
+    for (split, pda) in pdas.iter().enumerate() {
+        let lamports = transfer.lamports(*pda).await;
+        if split < real_splits {
+            assert!(lamports >= rent_exempt, "Real-Split {} unter der Mietfreiheit: {}", split, lamports);
+            real_total += lamports;
+        } else {
+            assert_eq!(lamports, rent_exempt, "Primärer Fake-Split {} mit der Mindestmiete", split);
+        }
+    }
+    let num_hops = transfer.config.num_hops;
+    assert_eq!(real_total, hop_amount(transfer.amount, num_hops, 0), "Die Real-Splits tragen den Hop-Betrag");
+
+    let fakes = (pdas.len() - real_splits) as u64;
+    assert_eq!(transfer.lamports(transfer.state_pda).await, state_before - real_total - fakes * rent_exempt);
+    let state = transfer.state().await;
+    assert_eq!((state.current_hop, state.batch_count), (1, 1));
+    assert_eq!(state.funded_splits as usize, pdas.len());
+}
+
+// Real-Splits unter der Mietfreiheit würden als Accounts abgelehnt
+#[tokio::test]
+async fn test_batch_hop_rejects_splits_below_rent() {
+    // 2 Mio. Lamports: etwa 125k pro Real-Split, weit unter der Mindestmiete
+    let mut transfer = SeededTransfer::start_with_amount(FAKE_MODE_FUNDED, 2_000_000).await;
+    let owner = transfer.owner.insecure_clone();
+    let (ix, pdas) = transfer.batch_hop_ix(0, 0, 1);
+    assert!(transfer.send(ix, &owner).await.is_err());
+
+    assert_eq!(transfer.lamports(pdas[0]).await, 0);
+    assert_eq!(transfer.state().await.current_hop, 0, "Abgelehnter Hop ändert den State nicht");
+}
+
+// Die Finalisierung zahlt den Split-Plan aus den Real-Splits aller Hops aus
+#[tokio::test]
+async fn test_finalize_pays_split_plan() {
+    let num_hops = BlackoutConfig::new().num_hops;
+    let mut transfer = SeededTransfer::start_at_hop(FAKE_MODE_FUNDED, AMOUNT, num_hops).await;
+    let state_before = transfer.lamports(transfer.state_pda).await;
+    let real_split = transfer.split_pda(0, 0);
+    assert!(transfer.lamports(real_split).await > 0);
+
+    let owner = transfer.owner.insecure_clone();
+    let ix = transfer.finalize_ix().await;
+    transfer.send(ix, &owner).await.expect("Finalisierung nach allen Hops");
+
+    assert_eq!(transfer.lamports(transfer.recipient).await, AMOUNT, "Empfänger erhält den geplanten Betrag");
+    assert_eq!(transfer.lamports(real_split).await, 0, "Real-Splits sind geleert");
+    // Gebühren und Reserve bleiben bis zum Reclaim im State
+    assert_eq!(transfer.lamports(transfer.state_pda).await, state_before);
+    assert!(transfer.state().await.is_completed());
+}
+
+// Einzelne Hops finanzieren denselben Split-Plan, den die Finalisierung auszahlt
+#[tokio::test]
+async fn test_execute_hops_then_finalize() {
+    let mut transfer = SeededTransfer::start(FAKE_MODE_FUNDED).await;
+    let owner = transfer.owner.insecure_clone();
+    let num_hops = transfer.config.num_hops;
+    let merkle_root = transfer.state().await.merkle_root;
+
+    for hop in 0..num_hops {
+        let ix = transfer.execute_hop_ix(hop).await;
+        transfer.send(ix, &owner).await.expect("Hop mit gültigem Proof");
+        let mut hop_total = 0;
+        for split in 0..transfer.config.real_splits {
+            hop_total += transfer.lamports(transfer.split_pda(hop, split)).await;
+        }
+        assert_eq!(hop_total, hop_amount(AMOUNT, num_hops, hop), "Hop {} trägt seinen Anteil", hop);
+    }
+    let state = transfer.state().await;
+    assert_eq!(state.current_hop, num_hops);
+    assert_eq!(state.funded_splits as u8, num_hops * transfer.config.real_splits);
+    assert_eq!(state.merkle_root, merkle_root, "Hops lassen die Empfänger-Wurzel unverändert");
+
+    let ix = transfer.finalize_ix().await;
+    transfer.send(ix, &owner).await.expect("Finalisierung nach einzelnen Hops");
+    assert_eq!(transfer.lamports(transfer.recipient).await, AMOUNT, "Empfänger erhält den vollen Betrag");
+    let state = transfer.state().await;
+    assert!(state.is_completed());
+    assert_eq!(state.funded_splits, 0, "Alle Real-Splits sind geleert");
+}
+
+// Mit weniger als 4 Hops (Latency-Profil) erhält der Empfänger trotzdem den vollen Betrag
+#[tokio::test]
+async fn test_latency_profile_pays_full_amount() {
+    let config = BlackoutConfig::for_profile(PerformanceProfile::Latency);
+    assert!(config.num_hops < 4, "Latency-Profil mit verkürztem Pfad");
+    // Nicht durch die Hop-Zahl teilbar: der letzte Hop trägt den Rest
+    let amount = AMOUNT + 1;
+    let mut transfer = SeededTransfer::start_with_config(config, FAKE_MODE_FUNDED, amount, 0).await;
+    let owner = transfer.owner.insecure_clone();
+
+    let (ix, _) = transfer.batch_hop_ix(0, 0, config.num_hops);
+    transfer.send(ix, &owner).await.expect("Ein Batch über alle Hops des Profils");
+    let mut moved = 0;
+    for hop in 0..config.num_hops {
+        let mut hop_total = 0;
+        for split in 0..config.real_splits {
+            hop_total += transfer.lamports(transfer.split_pda(hop, split)).await;
+        }
+        assert_eq!(hop_total, hop_amount(amount, config.num_hops, hop), "Hop {} trägt seinen Anteil", hop);
+        moved += hop_total;
+    }
+    assert_eq!(moved, amount);
+
+    let ix = transfer.finalize_ix().await;
+    transfer.send(ix, &owner).await.expect("Finalisierung nach dem Batch");
+    assert_eq!(transfer.lamports(transfer.recipient).await, amount, "Empfänger erhält den vollen Betrag");
+    assert!(transfer.state().await.is_completed());
+}
+
+// Nur der Besitzer holt zurück, und der State schließt erst ohne finanzierte Splits
+#[tokio::test]
+async fn test_reclaim_requires_owner_and_empty_splits() {
+    let num_hops = BlackoutConfig::new().num_hops;
+    let mut transfer = SeededTransfer::start_at_hop(FAKE_MODE_FUNDED, AMOUNT, num_hops).await;
+    let owner = transfer.owner.insecure_clone();
+    let ix = transfer.finalize_ix().await;
+    transfer.send(ix, &owner).await.expect("Finalisierung nach allen Hops");
+
+    // Die Real-Splits sind geleert, die primären Fakes halten noch ihre Miete
+    let per_hop = accounts_per_hop(transfer.config.real_splits, transfer.config.fake_splits);
+    let fake_keys: Vec<u16> = (0..num_hops)
+        .flat_map(|hop| (transfer.config.real_splits..per_hop).map(move |split| split_key(hop, split)))
+        .collect();
+    assert_eq!(transfer.state().await.funded_splits as usize, fake_keys.len());
+
+    // Ein Fremder darf den State nicht schließen
+    let stranger = Keypair::new();
+    let ix = transfer.reclaim_ix(stranger.pubkey(), vec![], true);
+    assert!(transfer.send(ix, &stranger).await.is_err());
+
+    // Auch der Besitzer nicht, solange Splits finanziert sind
+    let ix = transfer.reclaim_ix(owner.pubkey(), vec![], true);
+    assert!(transfer.send(ix, &owner).await.is_err());
+    assert!(transfer.client.get_account(transfer.state_pda).await.unwrap().is_some());
+
+    // Mit allen Fakes im selben Reclaim wird der State geschlossen
+    let owner_before = transfer.lamports(owner.pubkey()).await;
+    let ix = transfer.reclaim_ix(owner.pubkey(), fake_keys, true);
+    transfer.send(ix, &owner).await.expect("Reclaim aller finanzierten Splits");
+    assert!(transfer.client.get_account(transfer.state_pda).await.unwrap().is_none());
+    assert!(transfer.lamports(owner.pubkey()).await > owner_before);
+}
+
+// Nur der Besitzer ändert die Konfiguration, auch mit einem selbst gewählten Admin-Konto
+#[tokio::test]
+async fn test_config_update_requires_owner() {
+    let mut transfer = SeededTransfer::start(FAKE_MODE_FUNDED).await;
+    let owner = transfer.owner.insecure_clone();
+    let params = ConfigUpdateParams {
+        reserve_percent: Some(40),
+        fee_multiplier: None,
+        cu_budget_per_hop: None,
+        profile: None,
+        committed_fakes: None,
+        fake_root: None,
+    };
+
+    // Ein Fremder, der sich selbst als Admin nennt, hängt sein Konto an
+    let stranger = Keypair::new();
+    let mut ix = transfer.config_update_ix(stranger.pubkey(), params);
+    ix.accounts.insert(1, AccountMeta::new(stranger.pubkey(), false));
+    assert!(transfer.send(ix, &stranger).await.is_err());
+    let ix = transfer.config_update_ix(stranger.pubkey(), params);
+    assert!(transfer.send(ix, &stranger).await.is_err());
+    assert_eq!(transfer.state().await.config.reserve_percent, transfer.config.reserve_percent);
+
+    let ix = transfer.config_update_ix(owner.pubkey(), params);
+    transfer.send(ix, &owner).await.expect("Konfigurationsänderung durch den Besitzer");
+    assert_eq!(transfer.state().await.config.reserve_percent, 40);
+}
+
+// Nach ausgeführten Hops erstattet der State, was er hält, und der Reclaim den Rest
+#[tokio::test]
+async fn test_refund_after_hops_returns_everything() {
+    let hops_done = 2;
+    let mut transfer = SeededTransfer::start_at_hop(FAKE_MODE_FUNDED, AMOUNT, hops_done).await;
+    let owner = transfer.owner.insecure_clone();
+    let per_hop = accounts_per_hop(transfer.config.real_splits, transfer.config.fake_splits);
+    let split_keys: Vec<u16> = (0..hops_done)
+        .flat_map(|hop| (0..per_hop).map(move |split| split_key(hop, split)))
+        .collect();
+
+    // Alle Lamports des Transfers: State plus die bereits finanzierten Splits
+    let mut total = transfer.lamports(transfer.state_pda).await;
+    for &key in &split_keys {
+        total += transfer.lamports(transfer.split_pda((key >> 8) as u8, key as u8)).await;
+    }
+    assert!(transfer.lamports(transfer.state_pda).await < total - AMOUNT / 2,
+            "Die Hops haben einen Teil des Betrags aus dem State bewegt");
+
+    // Nur der Besitzer darf erstatten
+    let stranger = Keypair::new();
+    let dev_account = Pubkey::new_unique();
+    let ix = transfer.refund_ix(stranger.pubkey(), stranger.pubkey());
+    assert!(transfer.send(ix, &stranger).await.is_err());
+
+    let owner_before = transfer.lamports(owner.pubkey()).await;
+    let ix = transfer.refund_ix(owner.pubkey(), dev_account);
+    transfer.send(ix, &owner).await.expect("Erstattung nach zwei Hops");
+    assert!(transfer.state().await.is_refund_triggered());
+    let dev_share = transfer.lamports(dev_account).await;
+    assert_eq!(dev_share, AMOUNT * 5 / 100);
+
+    // Der Reclaim holt die Splits und den State zurück
+    let ix = transfer.reclaim_ix(owner.pubkey(), split_keys, true);
+    transfer.send(ix, &owner).await.expect("Reclaim nach der Erstattung");
+    assert!(transfer.client.get_account(transfer.state_pda).await.unwrap().is_none());
+    assert_eq!(transfer.lamports(owner.pubkey()).await - owner_before, total - dev_share,
+               "Bis auf den DEV-Anteil kommt alles zum Besitzer zurück");
+}
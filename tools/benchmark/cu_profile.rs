@@ -0,0 +1,599 @@
+//! Compute unit profiling harness
+//!
+//! Runs all seven ZEclipse instructions in `solana-program-test` for a set of
+//! configuration variants and writes the per-phase compute units reported by
+//! the program's `CuProfileRecorded` event to `cu_profile.json` and
+//! `cu_profile.csv` in this directory (or the directory given with `--out`).
+//!
+//! The phases are only measured by a program built with the `cu-profile`
+//! feature, loaded as SBF so the compute meter is real:
+//!
+//! ```bash
+//! cargo build-sbf --manifest-path programs/zeclipse/Cargo.toml --features cu-profile
+//! SBF_OUT_DIR=$PWD/target/deploy cargo run --release \
+//!     --manifest-path tools/benchmark/Cargo.toml --bin cu_profile
+//! ```
+//!
+//! Every instruction runs against a freshly seeded `TransferState` and is
+//! simulated with the maximum compute limit, so one instruction's result
+//! never depends on another. The seeded state uses the variant's
+//! configuration; `finalize` runs against a state after its last hop whose
+//! real split PDAs hold the committed split plan. The HyperPlonk proofs are
+//! built with `build_hyperplonk_proof` for the challenge each instruction
+//! derives (`hop_challenge`, `finalize_challenge` at the bank's clock), so
+//! hops, batches and finalize run through all their phases. Only
+//! `initialize` stops early: its range proof opening takes a 32-bit grind the
+//! harness does not attempt, so its row ends at the range proof. The
+//! `unattributed` column is the transaction total minus all phases: account
+//! deserialization, Anchor constraints, the compute budget instruction and
+//! the checkpoint syscalls themselves.
+
+use anchor_lang::{AnchorDeserialize, Discriminator, InstructionData};
+use base64::{engine::general_purpose::STANDARD, Engine};
+use solana_program_test::*;
+use solana_sdk::{
+    account::Account,
+    clock::Clock,
+    compute_budget::ComputeBudgetInstruction,
+    instruction::{AccountMeta, Instruction},
+    pubkey::Pubkey,
+    rent::Rent,
+    signature::{Keypair, Signer},
+    system_program,
+    sysvar,
+    transaction::Transaction,
+};
+use std::{fmt::Write as _, fs, path::PathBuf};
+
+use zeclipse::{
+    batch_plan::funded_fake_splits,
+    cu_profile::{CuInstruction, CuPhase, CuProfileRecorded, CU_PHASE_COUNT},
+    hash_context::HashContext,
+    instructions::config_update::ConfigUpdateParams,
+    stealth_pda::{compute_bump_table, find_stealth_pda},
+    state::{BlackoutConfig, PerformanceProfile, TransferState, FAKE_MODE_COMMITTED},
+    utils::{
+        build_hyperplonk_proof, calculate_fees, check_bloom_filter, fake_split_path, fake_split_position,
+        fake_split_root, finalize_challenge, generate_bloom_filter, hop_challenge, split_plan,
+    },
+};
+
+const TRANSFER_AMOUNT: u64 = 100_000_000; // 0.1 SOL
+const MAX_COMPUTE_UNITS: u32 = 1_400_000;
+/// Canonical BN254 scalar (first byte 0), like every challenge the program derives
+const CHALLENGE: [u8; 32] = {
+    let mut challenge = [7u8; 32];
+    challenge[0] = 0;
+    challenge
+};
+const STEALTH_SEED: [u8; 32] = [42u8; 32];
+
+/// One configuration the instructions are profiled with
+struct Variant {
+    name: &'static str,
+    reserve_percent: u8,
+    fee_multiplier: u16,
+    /// Hops per batch transaction
+    batch_hops: u8,
+    /// Split accounts per hop in a batch (4 real, the rest fake)
+    accounts_per_hop: u8,
+    /// Layout of the seeded state and of the `config_update` call; the
+    /// profile's batch size (`BlackoutConfig::budget_batch_hops`) must equal
+    /// `batch_hops`
+    profile: Option<PerformanceProfile>,
+    /// Fake splits only committed (`FAKE_MODE_COMMITTED`): batches carry the
+    /// real splits, `reveal_fake` materializes its fake split
+    committed_fakes: bool,
+}
+
+const VARIANTS: [Variant; 9] = [
+    Variant { name: "default", reserve_percent: 10, fee_multiplier: 200, batch_hops: 4, accounts_per_hop: 8, profile: None, committed_fakes: false },
+    Variant { name: "real-splits-only", reserve_percent: 10, fee_multiplier: 200, batch_hops: 4, accounts_per_hop: 4, profile: None, committed_fakes: false },
+    Variant { name: "two-hop-batches", reserve_percent: 10, fee_multiplier: 200, batch_hops: 2, accounts_per_hop: 8, profile: None, committed_fakes: false },
+    Variant { name: "single-hop-batches", reserve_percent: 10, fee_multiplier: 200, batch_hops: 1, accounts_per_hop: 8, profile: None, committed_fakes: false },
+    Variant { name: "high-reserve", reserve_percent: 40, fee_multiplier: 500, batch_hops: 4, accounts_per_hop: 8, profile: None, committed_fakes: false },
+    Variant { name: "committed-fakes", reserve_percent: 10, fee_multiplier: 200, batch_hops: 4, accounts_per_hop: 4, profile: None, committed_fakes: true },
+    // Performance profiles: the measured batch rows calibrate `batch_plan`
+    Variant { name: "profile-latency", reserve_percent: 10, fee_multiplier: 200, batch_hops: 3, accounts_per_hop: 8, profile: Some(PerformanceProfile::Latency), committed_fakes: false },
+    Variant { name: "profile-balanced", reserve_percent: 10, fee_multiplier: 200, batch_hops: 3, accounts_per_hop: 8, profile: Some(PerformanceProfile::Balanced), committed_fakes: false },
+    Variant { name: "profile-max-anonymity", reserve_percent: 10, fee_multiplier: 200, batch_hops: 4, accounts_per_hop: 8, profile: Some(PerformanceProfile::MaxAnonymity), committed_fakes: false },
+];
+
+/// Result of one simulated instruction
+struct ProfileRow {
+    variant: &'static str,
+    instruction: CuInstruction,
+    /// `None` on success, otherwise the transaction error
+    error: Option<String>,
+    total_units: u64,
+    /// `None` if the program emitted no profile (not built with `cu-profile`,
+    /// or the instruction failed before its handler ran)
+    phases: Option<[u32; CU_PHASE_COUNT]>,
+}
+
+impl Variant {
+    /// Configuration of the seeded state
+    fn config(&self) -> BlackoutConfig {
+        let mut config = self.profile.map_or_else(BlackoutConfig::new, BlackoutConfig::for_profile);
+        if self.profile.is_some() {
+            assert_eq!(config.budget_batch_hops(), self.batch_hops, "{}: batch size differs from the profile", self.name);
+        }
+        config.reserve_percent = self.reserve_percent;
+        config.fee_multiplier = self.fee_multiplier;
+        config
+    }
+
+    /// Root of the committed fake split tree over `fake_blindings`, `None`
+    /// with funded fake splits
+    fn fake_root(&self) -> Option<[u8; 32]> {
+        let config = self.config();
+        self.committed_fakes.then(|| {
+            fake_split_root(&mut HashContext::new(), &config, &fake_blindings(&config)).expect("fake split root")
+        })
+    }
+}
+
+impl ProfileRow {
+    fn unattributed(&self) -> u64 {
+        let profiled: u64 = self.phases.map_or(0, |p| p.iter().map(|&u| u as u64).sum());
+        self.total_units.saturating_sub(profiled)
+    }
+}
+
+struct Harness {
+    context: ProgramTestContext,
+    program_id: Pubkey,
+    owner: Keypair,
+    variant: &'static Variant,
+}
+
+impl Harness {
+    /// Fresh bank with the SBF program and, unless `current_hop` is `None`,
+    /// a seeded `TransferState` at that hop
+    async fn new(variant: &'static Variant, current_hop: Option<u8>) -> Self {
+        let program_id = zeclipse::ID;
+        let mut program_test = ProgramTest::new("zeclipse", program_id, None);
+        program_test.prefer_bpf(true);
+
+        let owner = Keypair::new();
+        program_test.add_account(owner.pubkey(), Account::new(10_000_000_000, 0, &system_program::ID));
+        if let Some(current_hop) = current_hop {
+            for (address, account) in seeded_transfer_state(&program_id, &owner.pubkey(), variant, current_hop) {
+                program_test.add_account(address, account);
+            }
+        }
+
+        Self { context: program_test.start_with_context().await, program_id, owner, variant }
+    }
+
+    fn transfer_pda(&self) -> Pubkey {
+        Pubkey::find_program_address(&[b"transfer", self.owner.pubkey().as_ref()], &self.program_id).0
+    }
+
+    /// Simulates `ix` with the maximum compute limit and extracts the profile
+    async fn profile(&mut self, instruction: CuInstruction, ix: Instruction) -> ProfileRow {
+        let tx = Transaction::new_signed_with_payer(
+            &[ComputeBudgetInstruction::set_compute_unit_limit(MAX_COMPUTE_UNITS), ix],
+            Some(&self.context.payer.pubkey()),
+            &[&self.context.payer, &self.owner],
+            self.context.last_blockhash,
+        );
+
+        let mut row = ProfileRow {
+            variant: self.variant.name,
+            instruction,
+            error: None,
+            total_units: 0,
+            phases: None,
+        };
+        match self.context.banks_client.simulate_transaction(tx).await {
+            Ok(simulation) => {
+                if let Some(Err(err)) = simulation.result {
+                    row.error = Some(err.to_string());
+                }
+                if let Some(details) = simulation.simulation_details {
+                    row.total_units = details.units_consumed;
+                    row.phases = details.logs.iter().rev().find_map(|log| decode_profile(log, instruction));
+                }
+            }
+            Err(err) => row.error = Some(err.to_string()),
+        }
+        row
+    }
+
+    async fn run_all(&mut self) -> Vec<ProfileRow> {
+        let mut rows = Vec::with_capacity(CuInstruction::ALL.len());
+        let owner = self.owner.pubkey();
+        let transfer_pda = self.transfer_pda();
+        let seed = self.stealth_seed().await;
+
+        // config_update, execute_hop, batch_hop, reveal_fake and refund against
+        // a state at hop 0
+        let config_ix = Instruction {
+            program_id: self.program_id,
+            accounts: vec![
+                AccountMeta::new(owner, true),
+                AccountMeta::new(transfer_pda, false),
+                AccountMeta::new_readonly(system_program::ID, false),
+            ],
+            data: zeclipse::instruction::UpdateConfig {
+                update_params: ConfigUpdateParams {
+                    reserve_percent: Some(self.variant.reserve_percent),
+                    fee_multiplier: Some(self.variant.fee_multiplier),
+                    cu_budget_per_hop: None,
+                    profile: self.variant.profile,
+                    committed_fakes: Some(self.variant.committed_fakes),
+                    fake_root: self.variant.fake_root(),
+                },
+            }.data(),
+        };
+        rows.push(self.profile(CuInstruction::ConfigUpdate, config_ix).await);
+
+        let clock: Clock = self.context.banks_client.get_sysvar().await.expect("clock sysvar");
+        let hop_proof = hyperplonk_proof(&hop_challenge(clock.unix_timestamp, 0, &owner, &seed));
+        let (split_pda, _) = find_stealth_pda(&self.program_id, &seed, 0, 0, false);
+        let mut hop_ix = Instruction {
+            program_id: self.program_id,
+            accounts: vec![
+                AccountMeta::new(owner, true),
+                AccountMeta::new(transfer_pda, false),
+                AccountMeta::new(split_pda, false),
+                AccountMeta::new(self.program_id, false),
+                AccountMeta::new_readonly(system_program::ID, false),
+                AccountMeta::new_readonly(sysvar::clock::ID, false),
+            ],
+            data: zeclipse::instruction::ExecuteHop {
+                hop_index: 0,
+                proof_data: hop_proof,
+            }.data(),
+        };
+        // Real splits 1..4 of the hop follow split 0
+        for split in 1..4 {
+            hop_ix.accounts.push(AccountMeta::new(find_stealth_pda(&self.program_id, &seed, 0, split, false).0, false));
+        }
+        rows.push(self.profile(CuInstruction::ExecuteHop, hop_ix).await);
+
+        let (split_keys, pdas) = self.batch_accounts(&seed, 0).await;
+        let mut batch_ix = Instruction {
+            program_id: self.program_id,
+            accounts: vec![
+                AccountMeta::new(owner, true),
+                AccountMeta::new(transfer_pda, false),
+                AccountMeta::new_readonly(system_program::ID, false),
+            ],
+            data: zeclipse::instruction::ExecuteBatchHop {
+                batch_index: 0,
+                hop_count: self.variant.batch_hops,
+                split_keys,
+            }.data(),
+        };
+        batch_ix.accounts.extend(pdas.iter().map(|pda| AccountMeta::new(*pda, false)));
+        rows.push(self.profile(CuInstruction::BatchHop, batch_ix).await);
+
+        let fake_split = self.first_fake_split(0).await;
+        let (fake_pda, _) = find_stealth_pda(&self.program_id, &seed, 0, fake_split, true);
+        // Committed fakes are opened against the seeded root
+        let (blinding, path) = if self.variant.committed_fakes {
+            let config = self.variant.config();
+            let blindings = fake_blindings(&config);
+            let position = fake_split_position(&config, 0, fake_split).expect("fake split of the layout");
+            let path = fake_split_path(&mut HashContext::new(), &config, &blindings, 0, fake_split).expect("fake split path");
+            (blindings[position], path)
+        } else {
+            ([0u8; 32], Vec::new())
+        };
+        let reveal_ix = Instruction {
+            program_id: self.program_id,
+            accounts: vec![
+                AccountMeta::new(owner, true),
+                AccountMeta::new(transfer_pda, false),
+                AccountMeta::new(fake_pda, false),
+                AccountMeta::new_readonly(system_program::ID, false),
+            ],
+            data: zeclipse::instruction::RevealFakeSplit { hop_index: 0, split_index: fake_split, blinding, path }.data(),
+        };
+        rows.push(self.profile(CuInstruction::RevealFake, reveal_ix).await);
+
+        let dev_account = Pubkey::new_unique();
+        let refund_ix = Instruction {
+            program_id: self.program_id,
+            accounts: vec![
+                AccountMeta::new(owner, true),
+                AccountMeta::new(transfer_pda, false),
+                AccountMeta::new(owner, false),
+                AccountMeta::new(dev_account, false),
+                AccountMeta::new_readonly(system_program::ID, false),
+            ],
+            data: zeclipse::instruction::TriggerRefund {}.data(),
+        };
+        rows.push(self.profile(CuInstruction::Refund, refund_ix).await);
+
+        rows
+    }
+
+    /// `finalize` against a state after its last hop
+    async fn finalize_ix(&mut self) -> Instruction {
+        let owner = self.owner.pubkey();
+        let state = self.load_state().await;
+        let (recipient, seed, config) = (state.recipients[0], state.seed, state.config);
+        let clock: Clock = self.context.banks_client.get_sysvar().await.expect("clock sysvar");
+        let proof_data = hyperplonk_proof(&finalize_challenge(clock.unix_timestamp, &owner, &recipient, &seed));
+
+        let mut accounts = vec![
+            AccountMeta::new(owner, true),
+            AccountMeta::new(self.transfer_pda(), false),
+            AccountMeta::new(recipient, false),
+            AccountMeta::new_readonly(system_program::ID, false),
+        ];
+        // Single recipient: no multiproof, then the real splits of every hop
+        for hop in 0..config.num_hops {
+            for split in 0..config.real_splits {
+                accounts.push(AccountMeta::new(find_stealth_pda(&self.program_id, &seed, hop, split, false).0, false));
+            }
+        }
+        Instruction {
+            program_id: self.program_id,
+            accounts,
+            data: zeclipse::instruction::FinalizeTransfer { proof_data, recipient_proof: vec![] }.data(),
+        }
+    }
+
+    /// Split keys and PDAs of the first batch: `accounts_per_hop` splits per
+    /// hop, the 4 real splits first, then fake splits from the Bloom filter
+    async fn batch_accounts(&mut self, seed: &[u8; 32], first_hop: u8) -> (Vec<u16>, Vec<Pubkey>) {
+        let bloom = self.load_state().await.fake_bloom;
+        let mut keys = Vec::new();
+        let mut pdas = Vec::new();
+        for hop in first_hop..first_hop + self.variant.batch_hops {
+            let fakes = (4..48u8).filter(|&split| check_bloom_filter(&bloom, hop, split));
+            let splits = (0..4u8).chain(fakes).take(self.variant.accounts_per_hop as usize);
+            for split in splits {
+                let (pda, _) = find_stealth_pda(&self.program_id, seed, hop, split, split >= 4);
+                keys.push(zeclipse::batch_plan::split_key(hop, split));
+                pdas.push(pda);
+            }
+        }
+        (keys, pdas)
+    }
+
+    async fn first_fake_split(&mut self, hop: u8) -> u8 {
+        let bloom = self.load_state().await.fake_bloom;
+        (4..48u8).find(|&split| check_bloom_filter(&bloom, hop, split)).unwrap_or(4)
+    }
+
+    async fn stealth_seed(&mut self) -> [u8; 32] {
+        self.load_state().await.seed
+    }
+
+    async fn load_state(&mut self) -> TransferState {
+        let account = self.context.banks_client
+            .get_account(self.transfer_pda())
+            .await
+            .expect("banks client")
+            .expect("seeded transfer state");
+        bytemuck::pod_read_unaligned::<TransferState>(&account.data[8..TransferState::SIZE])
+    }
+}
+
+/// Zero-copy transfer state with committed bumps, as `initialize` writes it,
+/// after `current_hop` hops: their real split PDAs hold the split plan
+fn seeded_transfer_state(program_id: &Pubkey, owner: &Pubkey, variant: &Variant, current_hop: u8) -> Vec<(Pubkey, Account)> {
+    let (pda, bump) = Pubkey::find_program_address(&[b"transfer", owner.as_ref()], program_id);
+    let config = variant.config();
+    let (total_fees, reserve) = calculate_fees(TRANSFER_AMOUNT, &config).expect("fees of the variant");
+
+    let mut recipients = [Pubkey::default(); 6];
+    recipients[0] = Pubkey::new_unique();
+
+    let batch_proof = hyperplonk_proof(&CHALLENGE);
+    let mut state = TransferState::new(
+        *owner,
+        TRANSFER_AMOUNT,
+        STEALTH_SEED,
+        bump,
+        recipients,
+        1,
+        config,
+        batch_proof,
+        mock_range_proof(),
+        CHALLENGE,
+        [0u8; 32],
+        generate_bloom_filter(&config, &CHALLENGE),
+        compute_bump_table(program_id, &STEALTH_SEED, config.real_splits),
+        0,
+    );
+    state.total_fees = total_fees;
+    state.reserve = reserve;
+    state.current_hop = current_hop;
+    state.batch_count = current_hop.min(1);
+    state.funded_splits = current_hop as u16 * config.real_splits as u16;
+    if let Some(fake_root) = variant.fake_root() {
+        state.fake_mode = FAKE_MODE_COMMITTED;
+        state.fake_root = fake_root;
+    }
+
+    let mut data = Vec::with_capacity(TransferState::SIZE);
+    data.extend_from_slice(&TransferState::DISCRIMINATOR);
+    data.extend_from_slice(bytemuck::bytes_of(&state));
+
+    let rent = Rent::default();
+    let fake_rent = funded_fake_splits(config.num_hops, config.fake_splits) * rent.minimum_balance(0);
+    let mut lamports = rent.minimum_balance(data.len()) + TRANSFER_AMOUNT + total_fees + reserve + fake_rent;
+
+    // The hops already done moved their row of the plan into the real splits
+    let mut accounts = Vec::new();
+    let plan = split_plan(&mut HashContext::new(), &batch_proof, TRANSFER_AMOUNT, config.num_hops, &CHALLENGE)
+        .expect("split plan of the seeded proof");
+    for hop in 0..current_hop {
+        for split in 0..config.real_splits {
+            let split_lamports = plan[hop as usize][split as usize];
+            let (split_pda, _) = find_stealth_pda(program_id, &STEALTH_SEED, hop, split, false);
+            accounts.push((split_pda, Account::new(split_lamports, 0, &system_program::ID)));
+            lamports -= split_lamports;
+        }
+    }
+    accounts.push((pda, Account { lamports, data, owner: *program_id, executable: false, rent_epoch: 0 }));
+    accounts
+}
+
+/// Blindings of the committed fake splits in tree order (canonical BN254 scalars)
+fn fake_blindings(config: &BlackoutConfig) -> Vec<[u8; 32]> {
+    (0..config.num_hops as usize * config.fake_splits as usize)
+        .map(|position| {
+            let mut blinding = [5u8; 32];
+            blinding[0] = 0;
+            blinding[31] = position as u8;
+            blinding
+        })
+        .collect()
+}
+
+/// HyperPlonk proof the program accepts for `challenge`
+fn hyperplonk_proof(challenge: &[u8; 32]) -> [u8; 128] {
+    build_hyperplonk_proof(&mut HashContext::new(), challenge, TRANSFER_AMOUNT).expect("canonical challenge")
+}
+
+/// Plonky2 range proof in the layout of the test framework
+fn mock_range_proof() -> [u8; 128] {
+    let mut proof = [0u8; 128];
+    proof[0..4].copy_from_slice(b"P2R1");
+    proof[84..116].copy_from_slice(&CHALLENGE);
+    proof[116] = 0x1;
+    proof[117] = 0x1;
+    proof[118] = 0x0A;
+    proof[124..128].copy_from_slice(b"PSMC");
+    proof
+}
+
+/// Phases of a `CuProfileRecorded` event in a `Program data:` log line
+fn decode_profile(log: &str, instruction: CuInstruction) -> Option<[u32; CU_PHASE_COUNT]> {
+    let data = STANDARD.decode(log.strip_prefix("Program data: ")?).ok()?;
+    if data.len() < 8 || data[..8] != CuProfileRecorded::DISCRIMINATOR {
+        return None;
+    }
+    let event = CuProfileRecorded::try_from_slice(&data[8..]).ok()?;
+    (event.instruction == instruction as u8).then_some(event.phases)
+}
+
+fn write_csv(rows: &[ProfileRow]) -> String {
+    let mut out = String::from("variant,instruction,status,total_units,unattributed");
+    for phase in CuPhase::ALL {
+        write!(out, ",{}", phase.name()).unwrap();
+    }
+    out.push('\n');
+    for row in rows {
+        let status = row.error.as_deref().unwrap_or("ok").replace(',', ";");
+        write!(out, "{},{},{},{},{}", row.variant, row.instruction.name(), status, row.total_units, row.unattributed()).unwrap();
+        for phase in CuPhase::ALL {
+            match row.phases {
+                Some(phases) => write!(out, ",{}", phases[phase as usize]).unwrap(),
+                None => out.push(','),
+            }
+        }
+        out.push('\n');
+    }
+    out
+}
+
+fn write_json(rows: &[ProfileRow]) -> String {
+    let mut out = String::from("[\n");
+    for (i, row) in rows.iter().enumerate() {
+        let error = match &row.error {
+            Some(err) => format!("\"{}\"", err.replace('\\', "\\\\").replace('"', "\\\"")),
+            None => "null".to_string(),
+        };
+        write!(
+            out,
+            "  {{\"variant\": \"{}\", \"instruction\": \"{}\", \"error\": {}, \"total_units\": {}, \"unattributed\": {}, \"phases\": ",
+            row.variant, row.instruction.name(), error, row.total_units, row.unattributed()
+        ).unwrap();
+        match row.phases {
+            Some(phases) => {
+                out.push('{');
+                for (j, phase) in CuPhase::ALL.iter().enumerate() {
+                    let sep = if j == 0 { "" } else { ", " };
+                    write!(out, "{}\"{}\": {}", sep, phase.name(), phases[*phase as usize]).unwrap();
+                }
+                out.push('}');
+            }
+            None => out.push_str("null"),
+        }
+        out.push_str(if i + 1 == rows.len() { "}\n" } else { "},\n" });
+    }
+    out.push_str("]\n");
+    out
+}
+
+#[tokio::main]
+async fn main() -> Result<(), Box<dyn std::error::Error>> {
+    let mut args = std::env::args().skip(1);
+    let mut out_dir = PathBuf::from(env!("CARGO_MANIFEST_DIR"));
+    while let Some(arg) = args.next() {
+        match arg.as_str() {
+            "--out" => out_dir = PathBuf::from(args.next().ok_or("--out needs a directory")?),
+            other => return Err(format!("unknown argument: {}", other).into()),
+        }
+    }
+
+    let mut rows = Vec::new();
+    for variant in VARIANTS.iter() {
+        println!("Profiling variant '{}'...", variant.name);
+
+        // initialize creates the transfer state itself
+        let mut harness = Harness::new(variant, None).await;
+        let payer = harness.owner.pubkey();
+        let merkle_root = Keypair::new();
+        let (transfer_pda, _) = Pubkey::find_program_address(&[b"transfer", payer.as_ref()], &harness.program_id);
+        let seed = Pubkey::find_program_address(&[b"zeclipse", &CHALLENGE, payer.as_ref()], &harness.program_id).0.to_bytes();
+        let init_ix = Instruction {
+            program_id: harness.program_id,
+            accounts: vec![
+                AccountMeta::new(payer, true),
+                AccountMeta::new(transfer_pda, false),
+                AccountMeta::new_readonly(Pubkey::new_unique(), false),
+                AccountMeta::new_readonly(merkle_root.pubkey(), false),
+                AccountMeta::new_readonly(system_program::ID, false),
+                AccountMeta::new_readonly(sysvar::clock::ID, false),
+                // No transfer registry: nonce 0 is the payer's default transfer
+                AccountMeta::new_readonly(harness.program_id, false),
+            ],
+            data: zeclipse::instruction::Initialize {
+                nonce: 0,
+                amount: TRANSFER_AMOUNT,
+                hyperplonk_proof: hyperplonk_proof(&CHALLENGE),
+                range_proof: mock_range_proof(),
+                challenge: CHALLENGE,
+                stealth_bumps: compute_bump_table(&harness.program_id, &seed, 4),
+                recipient_count: 1,
+            }.data(),
+        };
+        rows.push(harness.profile(CuInstruction::Initialize, init_ix).await);
+
+        let mut harness = Harness::new(variant, Some(0)).await;
+        rows.extend(harness.run_all().await);
+
+        // finalize needs all hops of the variant's configuration done
+        let mut harness = Harness::new(variant, Some(variant.config().num_hops)).await;
+        let finalize_ix = harness.finalize_ix().await;
+        rows.push(harness.profile(CuInstruction::Finalize, finalize_ix).await);
+    }
+
+    for row in &rows {
+        println!(
+            "{:<20} {:<14} {:>8} CU  {}",
+            row.variant,
+            row.instruction.name(),
+            row.total_units,
+            row.error.as_deref().unwrap_or("ok")
+        );
+    }
+    if rows.iter().all(|row| row.phases.is_none()) {
+        println!("No CuProfileRecorded events found: build the program with --features cu-profile");
+    }
+
+    fs::create_dir_all(&out_dir)?;
+    fs::write(out_dir.join("cu_profile.csv"), write_csv(&rows))?;
+    fs::write(out_dir.join("cu_profile.json"), write_json(&rows))?;
+    println!("Wrote {} rows to {}", rows.len(), out_dir.display());
+    Ok(())
+}
@@ -0,0 +1,576 @@
+//! Load generator for the full transfer lifecycle
+//!
+//! Drives `--transfers` transfers, at most `--concurrency` of them at a time,
+//! through initialize -> batch hops -> finalize against one in-process bank
+//! (`solana-program-test` with the SBF program, so compute units are real) and
+//! writes throughput, end-to-end latency percentiles, compute units per phase
+//! and the failed/refunded counts to `load_test.json` in this directory (or
+//! the directory given with `--out`):
+//!
+//! ```bash
+//! cargo build-sbf --manifest-path programs/zeclipse/Cargo.toml
+//! SBF_OUT_DIR=$PWD/target/deploy cargo run --release \
+//!     --manifest-path tools/benchmark/Cargo.toml --bin load_test -- \
+//!     --transfers 256 --concurrency 32
+//! ```
+//!
+//! Runs are comparable: owners, recipients and challenges are derived from
+//! `--seed`, transfers start in index order and the batch layout comes from
+//! `batch_plan`, so compute units and outcome counts repeat exactly between
+//! runs of the same build. Latency and throughput depend on the host; compare
+//! them only between runs on the same machine.
+//!
+//! HyperPlonk proofs come from `utils::build_hyperplonk_proof`, so the batch
+//! hops and finalize verify them for real; the finalize proof is built for the
+//! bank clock just before it is sent. `initialize` also checks the opening of
+//! the range proof, which takes a 32-bit grind the harness does not attempt,
+//! so by default every transfer starts from a state written the way
+//! `initialize` writes it. `--initialize` sends `initialize` instead; with the
+//! range proofs built here that phase fails for every transfer.
+//!
+//! A transfer that fails a phase is counted with that phase and the error,
+//! and refunded unless `--no-refund` is given. The run exits with an error
+//! when no transfer completes.
+
+use anchor_lang::{Discriminator, InstructionData};
+use solana_program_test::*;
+use solana_sdk::{
+    account::Account,
+    clock::Clock,
+    compute_budget::ComputeBudgetInstruction,
+    instruction::{AccountMeta, Instruction},
+    pubkey::Pubkey,
+    rent::Rent,
+    signature::{Keypair, Signer},
+    signer::keypair::keypair_from_seed,
+    system_program,
+    sysvar,
+    transaction::Transaction,
+};
+use std::{
+    collections::BTreeMap,
+    fmt::Write as _,
+    fs,
+    path::PathBuf,
+    sync::Arc,
+    time::{Duration, Instant},
+};
+use tokio::{sync::Semaphore, task::JoinSet};
+
+use zeclipse::{
+    batch_plan::{accounts_per_hop, funded_fake_splits, is_primary_fake, max_batch_hops, split_key, MAX_TRANSACTION_CU},
+    stealth_pda::{compute_bump_table, find_stealth_pda},
+    state::{BlackoutConfig, TransferState},
+    hash_context::HashContext,
+    utils::{build_hyperplonk_proof, calculate_fees, finalize_challenge, generate_bloom_filter},
+};
+
+const TRANSFER_AMOUNT: u64 = 100_000_000; // 0.1 SOL
+const OWNER_LAMPORTS: u64 = 10_000_000_000;
+
+/// Instructions of a transfer, in lifecycle order
+#[derive(Clone, Copy, Debug, PartialEq, Eq, PartialOrd, Ord)]
+enum Phase {
+    Initialize,
+    BatchHop,
+    Finalize,
+    Refund,
+}
+
+impl Phase {
+    const ALL: [Phase; 4] = [Phase::Initialize, Phase::BatchHop, Phase::Finalize, Phase::Refund];
+
+    fn name(self) -> &'static str {
+        match self {
+            Phase::Initialize => "initialize",
+            Phase::BatchHop => "batch_hop",
+            Phase::Finalize => "finalize",
+            Phase::Refund => "refund",
+        }
+    }
+}
+
+struct Options {
+    transfers: usize,
+    concurrency: usize,
+    seed: u64,
+    seeded: bool,
+    refund: bool,
+    out_dir: PathBuf,
+}
+
+impl Options {
+    fn parse() -> Result<Self, Box<dyn std::error::Error>> {
+        let mut options = Options {
+            transfers: 64,
+            concurrency: 16,
+            seed: 1,
+            seeded: true,
+            refund: true,
+            out_dir: PathBuf::from(env!("CARGO_MANIFEST_DIR")),
+        };
+        let mut args = std::env::args().skip(1);
+        while let Some(arg) = args.next() {
+            let mut value = |name: &str| args.next().ok_or(format!("{} needs a value", name));
+            match arg.as_str() {
+                "--transfers" => options.transfers = value("--transfers")?.parse()?,
+                "--concurrency" => options.concurrency = value("--concurrency")?.parse()?,
+                "--seed" => options.seed = value("--seed")?.parse()?,
+                "--out" => options.out_dir = PathBuf::from(value("--out")?),
+                "--initialize" => options.seeded = false,
+                "--no-refund" => options.refund = false,
+                other => return Err(format!("unknown argument: {}", other).into()),
+            }
+        }
+        if options.transfers == 0 || options.concurrency == 0 {
+            return Err("--transfers and --concurrency must be at least 1".into());
+        }
+        Ok(options)
+    }
+}
+
+/// Deterministic inputs of one transfer
+struct TransferSpec {
+    owner: Keypair,
+    recipient: Pubkey,
+    challenge: [u8; 32],
+}
+
+impl TransferSpec {
+    fn new(run_seed: u64, index: usize) -> Self {
+        let material = |tag: u8| {
+            let mut bytes = [tag; 32];
+            bytes[..8].copy_from_slice(&run_seed.to_le_bytes());
+            bytes[8..16].copy_from_slice(&(index as u64).to_le_bytes());
+            bytes
+        };
+        Self {
+            owner: keypair_from_seed(&material(1)).expect("32-byte keypair seed"),
+            recipient: keypair_from_seed(&material(2)).expect("32-byte keypair seed").pubkey(),
+            // Canonical BN254 scalar (first byte 0), as the proofs require
+            challenge: { let mut challenge = material(3); challenge[0] = 0; challenge },
+        }
+    }
+
+    fn transfer_pda(&self, program_id: &Pubkey) -> (Pubkey, u8) {
+        Pubkey::find_program_address(&[b"transfer", self.owner.pubkey().as_ref()], program_id)
+    }
+
+    /// Stealth seed as `initialize` derives it from challenge and payer
+    fn stealth_seed(&self, program_id: &Pubkey) -> [u8; 32] {
+        Pubkey::find_program_address(
+            &[b"zeclipse", &self.challenge, self.owner.pubkey().as_ref()],
+            program_id,
+        ).0.to_bytes()
+    }
+}
+
+/// One submitted transaction
+struct Sample {
+    phase: Phase,
+    latency: Duration,
+    units: u64,
+    ok: bool,
+}
+
+#[derive(Default)]
+struct TransferOutcome {
+    samples: Vec<Sample>,
+    /// End-to-end latency of a finalized transfer
+    completed: Option<Duration>,
+    /// Phase and error of the first failure
+    failure: Option<(Phase, String)>,
+    refunded: bool,
+}
+
+/// Sends `ix` with the maximum compute limit and waits for its result
+async fn submit(client: &mut BanksClient, payer: &Keypair, phase: Phase, ix: Instruction) -> (Sample, Result<(), String>) {
+    let start = Instant::now();
+    let outcome = async {
+        let blockhash = client.get_latest_blockhash().await?;
+        let tx = Transaction::new_signed_with_payer(
+            &[ComputeBudgetInstruction::set_compute_unit_limit(MAX_TRANSACTION_CU), ix],
+            Some(&payer.pubkey()),
+            &[payer],
+            blockhash,
+        );
+        client.process_transaction_with_metadata(tx).await
+    }.await;
+    let latency = start.elapsed();
+
+    let (units, result) = match outcome {
+        Ok(processed) => (
+            processed.metadata.map_or(0, |metadata| metadata.compute_units_consumed),
+            processed.result.map_err(|err| err.to_string()),
+        ),
+        Err(err) => (0, Err(err.to_string())),
+    };
+    (Sample { phase, latency, units, ok: result.is_ok() }, result)
+}
+
+/// Runs one transfer through its lifecycle, refunding it on failure
+async fn run_transfer(mut client: BanksClient, program_id: Pubkey, spec: TransferSpec, options: Arc<Options>) -> TransferOutcome {
+    let mut outcome = TransferOutcome::default();
+    let owner = spec.owner.pubkey();
+    let (transfer_pda, _) = spec.transfer_pda(&program_id);
+    let seed = spec.stealth_seed(&program_id);
+    let start = Instant::now();
+
+    let mut phases = Vec::new();
+    if !options.seeded {
+        phases.push((Phase::Initialize, initialize_ix(&program_id, &spec, transfer_pda, &seed)));
+    }
+    phases.extend(batch_hop_ixs(&program_id, owner, transfer_pda, &seed).into_iter().map(|ix| (Phase::BatchHop, ix)));
+
+    let mut state_exists = options.seeded;
+    for (phase, ix) in phases {
+        let (sample, result) = submit(&mut client, &spec.owner, phase, ix).await;
+        outcome.samples.push(sample);
+        match result {
+            Ok(()) => state_exists = true,
+            Err(err) => {
+                outcome.failure = Some((phase, err));
+                break;
+            }
+        }
+    }
+
+    // The final proof is bound to the clock; one retry covers a timestamp
+    // that moved on between reading the clock and processing the transaction
+    if outcome.failure.is_none() {
+        for attempt in 1..=2 {
+            let result = match finalize_ix(&mut client, &program_id, &spec, transfer_pda, &seed).await {
+                Ok(ix) => {
+                    let (sample, result) = submit(&mut client, &spec.owner, Phase::Finalize, ix).await;
+                    outcome.samples.push(sample);
+                    result
+                }
+                Err(err) => Err(err),
+            };
+            match result {
+                Ok(()) => break,
+                Err(err) if attempt == 2 => outcome.failure = Some((Phase::Finalize, err)),
+                Err(_) => {}
+            }
+        }
+    }
+
+    if outcome.failure.is_none() {
+        outcome.completed = Some(start.elapsed());
+    } else if options.refund && state_exists {
+        let (sample, result) = submit(&mut client, &spec.owner, Phase::Refund, refund_ix(&program_id, owner, transfer_pda)).await;
+        outcome.samples.push(sample);
+        outcome.refunded = result.is_ok();
+    }
+    outcome
+}
+
+/// HyperPlonk proof the program accepts for `challenge`
+fn hyperplonk_proof(challenge: &[u8; 32]) -> [u8; 128] {
+    build_hyperplonk_proof(&mut HashContext::new(), challenge, TRANSFER_AMOUNT)
+        .expect("HyperPlonk proof for a canonical challenge")
+}
+
+/// Plonky2 range proof in the layout of the test framework
+fn mock_range_proof(challenge: &[u8; 32]) -> [u8; 128] {
+    let mut proof = [0u8; 128];
+    proof[0..4].copy_from_slice(b"P2R1");
+    proof[84..116].copy_from_slice(challenge);
+    proof[116] = 0x1;
+    proof[117] = 0x1;
+    proof[118] = 0x0A;
+    proof[124..128].copy_from_slice(b"PSMC");
+    proof
+}
+
+fn initialize_ix(program_id: &Pubkey, spec: &TransferSpec, transfer_pda: Pubkey, seed: &[u8; 32]) -> Instruction {
+    Instruction {
+        program_id: *program_id,
+        accounts: vec![
+            AccountMeta::new(spec.owner.pubkey(), true),
+            AccountMeta::new(transfer_pda, false),
+            AccountMeta::new_readonly(spec.recipient, false),
+            // Single-recipient transfer: the root is committed but never opened
+            AccountMeta::new_readonly(Pubkey::new_from_array(spec.challenge), false),
+            AccountMeta::new_readonly(system_program::ID, false),
+            AccountMeta::new_readonly(sysvar::clock::ID, false),
+            // No transfer registry for nonce 0
+            AccountMeta::new_readonly(*program_id, false),
+        ],
+        data: zeclipse::instruction::Initialize {
+            nonce: 0,
+            amount: TRANSFER_AMOUNT,
+            hyperplonk_proof: hyperplonk_proof(&spec.challenge),
+            range_proof: mock_range_proof(&spec.challenge),
+            challenge: spec.challenge,
+            stealth_bumps: compute_bump_table(program_id, seed, 4),
+            recipient_count: 1,
+        }.data(),
+    }
+}
+
+/// Batch hops over all hops of the default layout, as many hops per batch as
+/// fit into one transaction (real splits plus primary fake splits per hop)
+fn batch_hop_ixs(program_id: &Pubkey, owner: Pubkey, transfer_pda: Pubkey, seed: &[u8; 32]) -> Vec<Instruction> {
+    let config = BlackoutConfig::new();
+    let per_hop = accounts_per_hop(config.real_splits, config.fake_splits);
+    let mut ixs = Vec::new();
+    let mut hop = 0;
+    while hop < config.num_hops {
+        let hop_count = max_batch_hops(config.num_hops - hop, per_hop).max(1);
+        let mut split_keys = Vec::new();
+        let mut accounts = vec![
+            AccountMeta::new(owner, true),
+            AccountMeta::new(transfer_pda, false),
+            AccountMeta::new_readonly(system_program::ID, false),
+        ];
+        for batch_hop in hop..hop + hop_count {
+            for split in 0..per_hop {
+                let is_fake = is_primary_fake(split, config.real_splits);
+                let (pda, _) = find_stealth_pda(program_id, seed, batch_hop, split, is_fake);
+                split_keys.push(split_key(batch_hop, split));
+                accounts.push(AccountMeta::new(pda, false));
+            }
+        }
+        ixs.push(Instruction {
+            program_id: *program_id,
+            accounts,
+            data: zeclipse::instruction::ExecuteBatchHop {
+                batch_index: ixs.len() as u8,
+                hop_count,
+                split_keys,
+            }.data(),
+        });
+        hop += hop_count;
+    }
+    ixs
+}
+
+/// Finalize with a proof for the current bank clock
+async fn finalize_ix(
+    client: &mut BanksClient,
+    program_id: &Pubkey,
+    spec: &TransferSpec,
+    transfer_pda: Pubkey,
+    seed: &[u8; 32],
+) -> Result<Instruction, String> {
+    let clock: Clock = client.get_sysvar().await.map_err(|err| err.to_string())?;
+    let challenge = finalize_challenge(clock.unix_timestamp, &spec.owner.pubkey(), &spec.recipient, seed);
+    let proof_data = build_hyperplonk_proof(&mut HashContext::new(), &challenge, TRANSFER_AMOUNT)
+        .map_err(|err| err.to_string())?;
+
+    let config = BlackoutConfig::new();
+    let mut accounts = vec![
+        AccountMeta::new(spec.owner.pubkey(), true),
+        AccountMeta::new(transfer_pda, false),
+        AccountMeta::new(spec.recipient, false),
+        AccountMeta::new_readonly(system_program::ID, false),
+    ];
+    // The real splits of every hop carry the payout
+    for hop in 0..config.num_hops {
+        for split in 0..config.real_splits {
+            accounts.push(AccountMeta::new(find_stealth_pda(program_id, seed, hop, split, false).0, false));
+        }
+    }
+    Ok(Instruction {
+        program_id: *program_id,
+        accounts,
+        data: zeclipse::instruction::FinalizeTransfer {
+            proof_data,
+            recipient_proof: vec![],
+        }.data(),
+    })
+}
+
+fn refund_ix(program_id: &Pubkey, owner: Pubkey, transfer_pda: Pubkey) -> Instruction {
+    Instruction {
+        program_id: *program_id,
+        accounts: vec![
+            AccountMeta::new(owner, true),
+            AccountMeta::new(transfer_pda, false),
+            AccountMeta::new(owner, false),
+            AccountMeta::new(dev_account(), false),
+            AccountMeta::new_readonly(system_program::ID, false),
+        ],
+        data: zeclipse::instruction::TriggerRefund {}.data(),
+    }
+}
+
+/// Receives the DEV share of all refunds (funded at genesis)
+fn dev_account() -> Pubkey {
+    Pubkey::new_from_array([0xDE; 32])
+}
+
+/// Transfer state at hop 0, as `initialize` writes it (unless `--initialize`)
+fn seeded_transfer_state(program_id: &Pubkey, spec: &TransferSpec) -> (Pubkey, Account) {
+    let (pda, bump) = spec.transfer_pda(program_id);
+    let seed = spec.stealth_seed(program_id);
+    let config = BlackoutConfig::new();
+    let (total_fees, reserve) = calculate_fees(TRANSFER_AMOUNT, &config).expect("fees of the default configuration");
+
+    let mut recipients = [Pubkey::default(); 6];
+    recipients[0] = spec.recipient;
+    let mut state = TransferState::new(
+        spec.owner.pubkey(),
+        TRANSFER_AMOUNT,
+        seed,
+        bump,
+        recipients,
+        1,
+        config,
+        hyperplonk_proof(&spec.challenge),
+        mock_range_proof(&spec.challenge),
+        spec.challenge,
+        spec.challenge,
+        generate_bloom_filter(&config, &spec.challenge),
+        compute_bump_table(program_id, &seed, config.real_splits),
+        0,
+    );
+    state.total_fees = total_fees;
+    state.reserve = reserve;
+
+    let mut data = Vec::with_capacity(TransferState::SIZE);
+    data.extend_from_slice(&TransferState::DISCRIMINATOR);
+    data.extend_from_slice(bytemuck::bytes_of(&state));
+
+    let rent = Rent::default();
+    let fake_rent = funded_fake_splits(config.num_hops, config.fake_splits) * rent.minimum_balance(0);
+    let lamports = rent.minimum_balance(data.len()) + TRANSFER_AMOUNT + total_fees + reserve + fake_rent;
+    (pda, Account { lamports, data, owner: *program_id, executable: false, rent_epoch: 0 })
+}
+
+/// Nearest-rank percentile of sorted values
+fn percentile(sorted: &[u64], percent: u64) -> u64 {
+    if sorted.is_empty() {
+        return 0;
+    }
+    let rank = ((sorted.len() as u64 * percent + 99) / 100).max(1) as usize;
+    sorted[rank.min(sorted.len()) - 1]
+}
+
+/// `{"p50": .., "p95": .., "p99": .., "max": ..}` of microsecond values, in ms
+fn latency_json(mut micros: Vec<u64>) -> String {
+    micros.sort_unstable();
+    let ms = |value: u64| value as f64 / 1000.0;
+    format!(
+        "{{\"p50\": {:.3}, \"p95\": {:.3}, \"p99\": {:.3}, \"max\": {:.3}}}",
+        ms(percentile(&micros, 50)),
+        ms(percentile(&micros, 95)),
+        ms(percentile(&micros, 99)),
+        ms(micros.last().copied().unwrap_or(0)),
+    )
+}
+
+fn write_json(options: &Options, outcomes: &[TransferOutcome], wall_time: Duration) -> String {
+    let completed = outcomes.iter().filter(|outcome| outcome.completed.is_some()).count();
+    let failed = outcomes.len() - completed;
+    let refunded = outcomes.iter().filter(|outcome| outcome.refunded).count();
+    let transactions: usize = outcomes.iter().map(|outcome| outcome.samples.len()).sum();
+    let seconds = wall_time.as_secs_f64().max(f64::EPSILON);
+
+    let mut out = String::from("{\n");
+    writeln!(
+        out,
+        "  \"config\": {{\"transfers\": {}, \"concurrency\": {}, \"seed\": {}, \"seeded\": {}, \"refund\": {}, \"amount\": {}}},",
+        options.transfers, options.concurrency, options.seed, options.seeded, options.refund, TRANSFER_AMOUNT
+    ).unwrap();
+    writeln!(out, "  \"wall_time_ms\": {:.3},", wall_time.as_secs_f64() * 1000.0).unwrap();
+    writeln!(out, "  \"throughput\": {{\"transfers_per_sec\": {:.3}, \"transactions_per_sec\": {:.3}}},",
+             completed as f64 / seconds, transactions as f64 / seconds).unwrap();
+    writeln!(out, "  \"transfers\": {{\"completed\": {}, \"failed\": {}, \"refunded\": {}}},", completed, failed, refunded).unwrap();
+    let end_to_end = outcomes.iter().filter_map(|outcome| outcome.completed).map(|latency| latency.as_micros() as u64).collect();
+    writeln!(out, "  \"end_to_end_latency_ms\": {},", latency_json(end_to_end)).unwrap();
+
+    out.push_str("  \"phases\": {\n");
+    for (i, phase) in Phase::ALL.iter().enumerate() {
+        let samples: Vec<&Sample> = outcomes.iter().flat_map(|outcome| &outcome.samples).filter(|sample| sample.phase == *phase).collect();
+        let ok: Vec<&&Sample> = samples.iter().filter(|sample| sample.ok).collect();
+        let mut units: Vec<u64> = ok.iter().map(|sample| sample.units).collect();
+        units.sort_unstable();
+        let mean = if units.is_empty() { 0 } else { units.iter().sum::<u64>() / units.len() as u64 };
+        write!(
+            out,
+            "    \"{}\": {{\"transactions\": {}, \"failed\": {}, \"compute_units\": {{\"mean\": {}, \"p50\": {}, \"max\": {}}}, \"latency_ms\": {}}}",
+            phase.name(),
+            samples.len(),
+            samples.len() - ok.len(),
+            mean,
+            percentile(&units, 50),
+            units.last().copied().unwrap_or(0),
+            latency_json(samples.iter().map(|sample| sample.latency.as_micros() as u64).collect()),
+        ).unwrap();
+        out.push_str(if i + 1 == Phase::ALL.len() { "\n" } else { ",\n" });
+    }
+    out.push_str("  },\n");
+
+    // Failures grouped by phase and error, in a stable order
+    let mut failures: BTreeMap<(Phase, &str), usize> = BTreeMap::new();
+    for (phase, error) in outcomes.iter().filter_map(|outcome| outcome.failure.as_ref()) {
+        *failures.entry((*phase, error.as_str())).or_default() += 1;
+    }
+    out.push_str("  \"failures\": [");
+    for (i, ((phase, error), count)) in failures.iter().enumerate() {
+        let sep = if i == 0 { "\n" } else { ",\n" };
+        write!(
+            out,
+            "{}    {{\"phase\": \"{}\", \"error\": \"{}\", \"count\": {}}}",
+            sep, phase.name(), error.replace('\\', "\\\\").replace('"', "\\\""), count
+        ).unwrap();
+    }
+    out.push_str(if failures.is_empty() { "]\n" } else { "\n  ]\n" });
+    out.push_str("}\n");
+    out
+}
+
+#[tokio::main]
+async fn main() -> Result<(), Box<dyn std::error::Error>> {
+    let options = Arc::new(Options::parse()?);
+    let program_id = zeclipse::ID;
+
+    let mut program_test = ProgramTest::new("zeclipse", program_id, None);
+    program_test.prefer_bpf(true);
+    program_test.add_account(dev_account(), Account::new(1_000_000_000, 0, &system_program::ID));
+    let specs: Vec<TransferSpec> = (0..options.transfers).map(|index| TransferSpec::new(options.seed, index)).collect();
+    for spec in &specs {
+        program_test.add_account(spec.owner.pubkey(), Account::new(OWNER_LAMPORTS, 0, &system_program::ID));
+        if options.seeded {
+            let (pda, account) = seeded_transfer_state(&program_id, spec);
+            program_test.add_account(pda, account);
+        }
+    }
+    let context = program_test.start_with_context().await;
+
+    println!("Running {} transfers, {} concurrent{}...",
+             options.transfers, options.concurrency, if options.seeded { " (seeded)" } else { "" });
+    let limit = Arc::new(Semaphore::new(options.concurrency));
+    let mut tasks = JoinSet::new();
+    let start = Instant::now();
+    for (index, spec) in specs.into_iter().enumerate() {
+        // Start in index order; the permit is held for the whole transfer
+        let permit = limit.clone().acquire_owned().await?;
+        let client = context.banks_client.clone();
+        let options = options.clone();
+        tasks.spawn(async move {
+            let outcome = run_transfer(client, program_id, spec, options).await;
+            drop(permit);
+            (index, outcome)
+        });
+    }
+    let mut outcomes: Vec<(usize, TransferOutcome)> = Vec::with_capacity(options.transfers);
+    while let Some(result) = tasks.join_next().await {
+        outcomes.push(result?);
+    }
+    let wall_time = start.elapsed();
+    outcomes.sort_by_key(|(index, _)| *index);
+    let outcomes: Vec<TransferOutcome> = outcomes.into_iter().map(|(_, outcome)| outcome).collect();
+
+    let report = write_json(&options, &outcomes, wall_time);
+    print!("{}", report);
+    fs::create_dir_all(&options.out_dir)?;
+    fs::write(options.out_dir.join("load_test.json"), report)?;
+    println!("Wrote load_test.json to {}", options.out_dir.display());
+    if outcomes.iter().all(|outcome| outcome.completed.is_none()) {
+        return Err("no transfer completed; see \"failures\" in load_test.json".into());
+    }
+    Ok(())
+}
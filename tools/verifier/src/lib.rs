@@ -0,0 +1,272 @@
+//! # ZEclipse batch verifier
+//!
+//! Host-only pre-validation of client-submitted proofs, for relayers that
+//! want to reject bad proofs before paying the fees to send them.
+//!
+//! The verdicts come from the program's own verifiers
+//! (`zeclipse::utils::verify_hyperplonk_proof` and `verify_range_proof`), run
+//! on the host with the same Poseidon parameters as the `sol_poseidon`
+//! syscall, so a proof is accepted here exactly when the program accepts it.
+//! Throughput comes from verifying many proofs at once across all cores and
+//! from dropping the program's `msg!` output, which on the host would
+//! otherwise be formatted and printed for every check.
+//!
+//! ```ignore
+//! let verifier = BatchVerifier::new();
+//! let verdicts = verifier.verify_batch(&jobs);
+//! ```
+
+use std::sync::Once;
+
+use anchor_lang::solana_program::program_error::ProgramError;
+use anchor_lang::solana_program::program_stubs::{set_syscall_stubs, SyscallStubs};
+use rayon::prelude::*;
+use rayon::{ThreadPool, ThreadPoolBuilder};
+use zeclipse::hash_context::HashContext;
+use zeclipse::utils::{verify_hyperplonk_proof, verify_range_proof};
+
+/// One proof check, mirroring the verifier calls of an instruction
+#[derive(Clone, Copy, Debug)]
+pub enum ProofJob {
+    /// `initialize`: the HyperPlonk proof, then the range proof over the
+    /// (still empty) split commitments
+    Initialize {
+        hyperplonk_proof: [u8; 128],
+        range_proof: [u8; 128],
+        challenge: [u8; 32],
+    },
+    /// A single HyperPlonk proof (`execute_hop`, `finalize`)
+    HyperPlonk {
+        proof: [u8; 128],
+        challenge: [u8; 32],
+    },
+    /// A single range proof against explicit split commitments
+    Range {
+        proof: [u8; 128],
+        commitments: [[u8; 32]; 8],
+        challenge: [u8; 32],
+    },
+}
+
+/// Outcome of a proof check
+#[derive(Clone, Debug, PartialEq)]
+pub enum Verdict {
+    Valid,
+    /// Rejected with the error the program would return
+    Rejected(ProgramError),
+}
+
+impl Verdict {
+    pub fn is_valid(&self) -> bool {
+        matches!(self, Verdict::Valid)
+    }
+}
+
+/// Verifies one job on the current thread
+pub fn verify(job: &ProofJob) -> Verdict {
+    let mut hash_ctx = HashContext::new();
+    let result = match job {
+        ProofJob::Initialize { hyperplonk_proof, range_proof, challenge } => {
+            verify_hyperplonk_proof(&mut hash_ctx, hyperplonk_proof, challenge)
+                .and_then(|()| verify_range_proof(&mut hash_ctx, range_proof, &[[0; 32]; 8], challenge))
+        }
+        ProofJob::HyperPlonk { proof, challenge } => {
+            verify_hyperplonk_proof(&mut hash_ctx, proof, challenge)
+        }
+        ProofJob::Range { proof, commitments, challenge } => {
+            verify_range_proof(&mut hash_ctx, proof, commitments, challenge)
+        }
+    };
+    match result {
+        Ok(()) => Verdict::Valid,
+        Err(err) => Verdict::Rejected(err.into()),
+    }
+}
+
+/// Syscall stubs that discard program logs
+struct QuietStubs;
+
+impl SyscallStubs for QuietStubs {
+    fn sol_log(&self, _message: &str) {}
+    fn sol_log_compute_units(&self) {}
+    fn sol_log_data(&self, _fields: &[&[u8]]) {}
+}
+
+static QUIET: Once = Once::new();
+
+/// Discards the program's `msg!` output for the rest of the process
+///
+/// Syscall stubs are process-wide: do not call this in a process that runs
+/// `solana-program-test`, which installs its own stubs.
+pub fn silence_program_logs() {
+    QUIET.call_once(|| {
+        set_syscall_stubs(Box::new(QuietStubs));
+    });
+}
+
+/// Verifies batches of proofs on a dedicated thread pool
+pub struct BatchVerifier {
+    pool: ThreadPool,
+}
+
+impl BatchVerifier {
+    /// One worker per core; silences program logs (see `silence_program_logs`)
+    pub fn new() -> Self {
+        Self::with_threads(0)
+    }
+
+    /// `threads` workers (0 = one per core); silences program logs
+    pub fn with_threads(threads: usize) -> Self {
+        silence_program_logs();
+        let pool = ThreadPoolBuilder::new()
+            .num_threads(threads)
+            .thread_name(|index| format!("zeclipse-verifier-{}", index))
+            .build()
+            .expect("failed to start the verifier thread pool");
+        Self { pool }
+    }
+
+    /// Number of worker threads
+    pub fn threads(&self) -> usize {
+        self.pool.current_num_threads()
+    }
+
+    /// Verifies all jobs in parallel; verdicts are in job order
+    pub fn verify_batch(&self, jobs: &[ProofJob]) -> Vec<Verdict> {
+        self.pool.install(|| jobs.par_iter().map(verify).collect())
+    }
+
+    /// Indices of the jobs that would be rejected on-chain
+    pub fn rejected(&self, jobs: &[ProofJob]) -> Vec<usize> {
+        self.verify_batch(jobs)
+            .iter()
+            .enumerate()
+            .filter(|(_, verdict)| !verdict.is_valid())
+            .map(|(index, _)| index)
+            .collect()
+    }
+}
+
+impl Default for BatchVerifier {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use rand::rngs::SmallRng;
+    use rand::{Rng, SeedableRng};
+    use zeclipse::utils::build_hyperplonk_proof;
+
+    /// Plonky2 range proof in the layout of the program's test framework
+    fn shaped_range_proof(challenge: &[u8; 32]) -> [u8; 128] {
+        let mut proof = [0u8; 128];
+        proof[0..4].copy_from_slice(b"P2R1");
+        proof[84..116].copy_from_slice(challenge);
+        proof[116] = 0x1;
+        proof[117] = 0x1;
+        proof[118] = 0x0A;
+        proof[124..128].copy_from_slice(b"PSMC");
+        proof
+    }
+
+    /// Canonical BN254 scalar, like every challenge the program derives
+    fn challenge(rng: &mut SmallRng) -> [u8; 32] {
+        let mut challenge: [u8; 32] = rng.gen();
+        challenge[0] = 0;
+        challenge
+    }
+
+    /// Jobs whose verdict is known by construction: accepted HyperPlonk
+    /// proofs, and the same proofs tampered (proof part, signature, other
+    /// challenge) or paired with a range proof that cannot open.
+    /// Returns the jobs and the indices that must be rejected.
+    fn jobs(count: usize) -> (Vec<ProofJob>, Vec<usize>) {
+        let mut rng = SmallRng::seed_from_u64(7);
+        let mut hash_ctx = HashContext::new();
+        let mut bad = Vec::new();
+        let jobs = (0..count)
+            .map(|i| {
+                let challenge = challenge(&mut rng);
+                let mut proof = build_hyperplonk_proof(&mut hash_ctx, &challenge, 1_000_000 + i as u64).unwrap();
+                let job = match i % 5 {
+                    0 | 1 => return ProofJob::HyperPlonk { proof, challenge },
+                    2 => {
+                        proof[96 + rng.gen_range(0..32)] ^= 0x01;
+                        ProofJob::HyperPlonk { proof, challenge }
+                    }
+                    3 => {
+                        proof[0] = b'X';
+                        ProofJob::HyperPlonk { proof, challenge }
+                    }
+                    _ if i % 2 == 0 => {
+                        let other = self::challenge(&mut rng);
+                        ProofJob::HyperPlonk { proof, challenge: other }
+                    }
+                    _ => ProofJob::Initialize {
+                        hyperplonk_proof: proof,
+                        range_proof: shaped_range_proof(&challenge),
+                        challenge,
+                    },
+                };
+                bad.push(i);
+                job
+            })
+            .collect();
+        (jobs, bad)
+    }
+
+    #[test]
+    fn test_batch_verdicts_by_construction() {
+        let (jobs, bad) = jobs(100);
+        assert!(bad.len() < jobs.len(), "the batch must contain accepted proofs");
+
+        for threads in [1, 4] {
+            let verifier = BatchVerifier::with_threads(threads);
+            let verdicts = verifier.verify_batch(&jobs);
+            for (index, verdict) in verdicts.iter().enumerate() {
+                assert_eq!(verdict.is_valid(), !bad.contains(&index), "job {}: {:?}", index, verdict);
+            }
+            assert_eq!(verifier.rejected(&jobs), bad);
+        }
+    }
+
+    /// Parses a big-endian hex digest
+    fn digest(hex: &str) -> [u8; 32] {
+        let mut bytes = [0u8; 32];
+        for (i, byte) in bytes.iter_mut().enumerate() {
+            *byte = u8::from_str_radix(&hex[2 * i..2 * i + 2], 16).unwrap();
+        }
+        bytes
+    }
+
+    #[test]
+    fn test_poseidon_vectors_on_workers() {
+        // Known-answer vectors of tests/poseidon_test_vectors.rs (circomlib
+        // Poseidon over BN254, x^5, big-endian)
+        let zero = [0u8; 32];
+        let mut one = [0u8; 32];
+        one[31] = 1;
+        let mut two = [0u8; 32];
+        two[31] = 2;
+        let vectors: [(&[&[u8]], &str); 4] = [
+            (&[&zero], "2a09a9fd93c590c26b91effbb2499f07e8f7aa12e2b4940a3aed2411cb65e11c"),
+            (&[&one], "29176100eaa962bdc1fe6c654d6a3c130e96a4d1168b33848b897dc502820133"),
+            (&[&zero, &zero], "2098f5fb9e239eab3ceac3f27b81e481dc3124d55ffed523a839ee8446b64864"),
+            (&[&one, &two], "115cc0f5e7d690413df64c6b9662e9cf2a3617f2743245519e19607a4417189a"),
+        ];
+
+        let verifier = BatchVerifier::with_threads(4);
+        let digests: Vec<[u8; 32]> = verifier.pool.install(|| {
+            vectors
+                .par_iter()
+                .map(|(inputs, _)| HashContext::new().hash(inputs).unwrap())
+                .collect()
+        });
+        for ((_, expected), digest) in vectors.iter().zip(&digests) {
+            assert_eq!(*digest, self::digest(expected));
+        }
+    }
+}